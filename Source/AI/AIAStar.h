@@ -20,51 +20,139 @@ class Heuristic
 };
 */
 
-#define FAST_ERASE 0
-//FAST_ERASE==0   -  
-//FAST_ERASE!=0   -  
-//    
+///////////////////////AIAStarOpenList/////////////
+//   AIAStar  AIAStarGraph.
+//  (f,  ),    f,
+//  f -    ( ,    multimap,
+//      ).
+//
+//    :   g 
+//  ,  push  ,   
+//    (. OnePoint::open_order).
+//
+//   FindPath  , clear 
+// ,      .
+
+// 
+template<class TypeH>
+class AIAStarHeap
+{
+	struct Element
+	{
+		TypeH f;
+		DWORD order;
+		int index;
+	};
 
-template<class Heuristic,class TypeH=float>
-class AIAStar
+	// std::push_heap  ""   -  
+	struct Greater
+	{
+		bool operator()(const Element& a,const Element& b) const
+		{
+			if(a.f!=b.f)
+				return b.f<a.f;
+			return a.order>b.order;
+		}
+	};
+
+	vector<Element> heap;
+	DWORD order;
+public:
+	AIAStarHeap(){order=0;}
+
+	void clear(){heap.clear();order=0;}
+	bool empty() const{return heap.empty();}
+	int size() const{return heap.size();}
+
+	DWORD push(TypeH f,int index)
+	{
+		Element e;
+		e.f=f;
+		e.order=++order;
+		e.index=index;
+		heap.push_back(e);
+		push_heap(heap.begin(),heap.end(),Greater());
+		return e.order;
+	}
+
+	int pop(DWORD& out_order)
+	{
+		pop_heap(heap.begin(),heap.end(),Greater());
+		const Element& e=heap.back();
+		out_order=e.order;
+		int index=e.index;
+		heap.pop_back();
+		return index;
+	}
+};
+
+//   multimap,     astar_benchmark
+template<class TypeH>
+class AIAStarMultimap
 {
+	typedef multimap<TypeH,pair<DWORD,int> > Map;
+	Map open_map;
+	DWORD order;
 public:
-#if FAST_ERASE
-  struct OnePoint;
-  typedef multimap<TypeH, OnePoint*> type_point_map;
-#else
-  typedef multimap<TypeH,POINT> type_point_map;
-#endif
+	AIAStarMultimap(){order=0;}
+
+	void clear(){open_map.clear();order=0;}
+	bool empty() const{return open_map.empty();}
+	int size() const{return open_map.size();}
+
+	DWORD push(TypeH f,int index)
+	{
+		open_map.insert(typename Map::value_type(f,pair<DWORD,int>(++order,index)));
+		return order;
+	}
 
+	int pop(DWORD& out_order)
+	{
+		typename Map::iterator low=open_map.begin();
+		out_order=low->second.first;
+		int index=low->second.second;
+		open_map.erase(low);
+		return index;
+	}
+};
+
+//   
+template<class TypeH>
+class AIAStarOpenList : public AIAStarHeap<TypeH>
+{
+};
+
+template<class Heuristic,class TypeH=float,class OpenList=AIAStarOpenList<TypeH> >
+class AIAStar
+{
+public:
 	struct OnePoint
 	{
 		TypeH g;//     
 		TypeH h;//     
 		DWORD used;
+		DWORD open_order;//    open_list
 		OnePoint* parent;
 		bool is_open;
 
-#if FAST_ERASE
-		POINT pt;
-		type_point_map::iterator self_it;
-#endif
-
 		inline TypeH f(){return g+h;}
 	};
 protected:
 	int dx,dy;
 	OnePoint* chart;
-	type_point_map open_map;
+	OpenList open_list;
 
 	DWORD is_used_num;// is_used_num==used,   
 
 	int num_point_examine;//  
-	int num_find_erase;//     
+	int num_find_erase;//     open_list
 	Heuristic* heuristic;
 public:
 	AIAStar();
 	~AIAStar();
 
+	//Init   ,  FindPath  
+	//     
 	void Init(int dx,int dy);
 	bool FindPath(POINT from,Heuristic* h,vector<POINT>& path);
 	void GetStatistic(int* num_point_examine,int* num_find_erase);
@@ -76,37 +164,34 @@ protected:
 	void clear();
 	inline POINT PosBy(OnePoint* p)
 	{
-#if FAST_ERASE
-		return p->pt;
-#else
 		int offset=p-chart;
 		POINT pos;
 		pos.x=offset%dx;
 		pos.y=offset/dx;
 		return pos;
-#endif
 	}
 };
 
-template<class Heuristic,class TypeH>
-AIAStar<Heuristic,TypeH>::AIAStar()
+template<class Heuristic,class TypeH,class OpenList>
+AIAStar<Heuristic,TypeH,OpenList>::AIAStar()
 {
 	chart=NULL;
 	heuristic=NULL;
 }
 
-template<class Heuristic,class TypeH>
-void AIAStar<Heuristic,TypeH>::Init(int _dx,int _dy)
+template<class Heuristic,class TypeH,class OpenList>
+void AIAStar<Heuristic,TypeH,OpenList>::Init(int _dx,int _dy)
 {
 	dx=_dx;dy=_dy;
 
 	int size=dx*dy;
+	delete[] chart;
 	chart=new OnePoint[size];
 	clear();
 }
 
-template<class Heuristic,class TypeH>
-void AIAStar<Heuristic,TypeH>::clear()
+template<class Heuristic,class TypeH,class OpenList>
+void AIAStar<Heuristic,TypeH,OpenList>::clear()
 {
 	int size=dx*dy;
 	is_used_num=0;
@@ -114,23 +199,26 @@ void AIAStar<Heuristic,TypeH>::clear()
 		chart[i].used=0;
 }
 
-template<class Heuristic,class TypeH>
-AIAStar<Heuristic,TypeH>::~AIAStar()
+template<class Heuristic,class TypeH,class OpenList>
+AIAStar<Heuristic,TypeH,OpenList>::~AIAStar()
 {
 	delete[] chart;
 }
 
-template<class Heuristic,class TypeH>
-bool AIAStar<Heuristic,TypeH>::FindPath(POINT from,Heuristic* hr,vector<POINT>& path)
+template<class Heuristic,class TypeH,class OpenList>
+bool AIAStar<Heuristic,TypeH,OpenList>::FindPath(POINT from,Heuristic* hr,vector<POINT>& path)
 {
 	num_point_examine=0;
 	num_find_erase=0;
 
 	is_used_num++;
-	open_map.clear();
+	open_list.clear();
 	path.clear();
 	if(is_used_num==0)
+	{
 		clear();// ,    ,   
+		is_used_num++;
+	}
 	xassert(from.x>=0 && from.x<dx && from.y>=0 && from.y<dy);
 	heuristic=hr;
 
@@ -141,31 +229,25 @@ bool AIAStar<Heuristic,TypeH>::FindPath(POINT from,Heuristic* hr,vector<POINT>&
 	p->is_open=true;
 	p->parent=NULL;
 
-#if FAST_ERASE
-	p->pt = from;
-	p->self_it = open_map.insert(type_point_map::value_type(p->f(),p));
-#else
-	open_map.insert(type_point_map::value_type(p->f(),from));
-#endif
+	p->open_order=open_list.push(p->f(),p-chart);
 
 	const int size_child=8;
 	const int sx[size_child]={-1,+1,+1,-1, 0,-1, 0,+1};
 	const int sy[size_child]={-1,-1,+1,+1,-1, 0,+1, 0};
 
-
-	while(!open_map.empty())
+	while(!open_list.empty())
 	{
-		type_point_map::iterator low=open_map.begin();
-#if FAST_ERASE
-		OnePoint* parent=low->second;
-		POINT pt = parent->pt;
-#else
-		POINT pt=(*low).second;
-		OnePoint* parent=chart+pt.y*dx+pt.x;
-#endif
+		DWORD order;
+		OnePoint* parent=chart+open_list.pop(order);
+		if(!parent->is_open || parent->open_order!=order)
+		{
+			//     f
+			num_find_erase++;
+			continue;
+		}
 
+		POINT pt=PosBy(parent);
 		parent->is_open=false;
-		open_map.erase(low);
 
 		if(heuristic->IsEndPoint(pt.x,pt.y))
 		{
@@ -180,7 +262,7 @@ bool AIAStar<Heuristic,TypeH>::FindPath(POINT from,Heuristic* hr,vector<POINT>&
 				{
 					POINT pp;
 					pp=PosBy(parent->parent);
-					xassert(abs(p.x-pp.x)<=1 && 
+					xassert(abs(p.x-pp.x)<=1 &&
 						abs(p.y-pp.y)<=1);
 				}
 
@@ -197,7 +279,7 @@ bool AIAStar<Heuristic,TypeH>::FindPath(POINT from,Heuristic* hr,vector<POINT>&
 			POINT child={pt.x+sx[i],pt.y+sy[i]};
 			num_point_examine++;
 
-			if(child.x<0 || child.y<0 || 
+			if(child.x<0 || child.y<0 ||
 			   child.x>=dx || child.y>=dy)continue;
 			p=chart+child.y*dx+child.x;
 
@@ -209,50 +291,13 @@ bool AIAStar<Heuristic,TypeH>::FindPath(POINT from,Heuristic* hr,vector<POINT>&
 			{
 				if(!p->is_open)continue;
 				if(p->g<=newg)continue;
-
-#if FAST_ERASE
-				open_map.erase(p->self_it);
-#else
-				//   open_map
-				TypeH f=p->f();
-				type_point_map::iterator cur=open_map.find(p->f());
-				bool erase=false;
-				while(cur!=open_map.end())
-				{
-					if((*cur).first!=f)break;
-					if((*cur).second.x==child.x && (*cur).second.y==child.y)
-					{
-						open_map.erase(cur);
-						erase=true;
-						break;
-					}
-					num_find_erase++;
-					cur++;
-				}
-				num_find_erase++;
-				//xassert(erase);
-				if(!erase)continue;
-#endif
+				//   open_list  
 			}
 
 			p->parent=parent;
-/*
-			{
-				POINT pp=PosBy(parent);
-				POINT pc=PosBy(p);
-				xassert(abs(pc.x-pp.x)<=1 && 
-						abs(pc.y-pp.y)<=1);
-			}
-*/
 			p->g=newg;
 			p->h=heuristic->GetH(child.x,child.y);
-
-#if FAST_ERASE
-			p->pt = child;
-			p->self_it = open_map.insert(type_point_map::value_type(p->f(),p));
-#else
-			open_map.insert(type_point_map::value_type(p->f(),child));
-#endif
+			p->open_order=open_list.push(p->f(),p-chart);
 			p->is_open=true;
 			p->used=is_used_num;
 		}
@@ -261,8 +306,8 @@ bool AIAStar<Heuristic,TypeH>::FindPath(POINT from,Heuristic* hr,vector<POINT>&
 	return false;
 }
 
-template<class Heuristic,class TypeH>
-void AIAStar<Heuristic,TypeH>::GetStatistic(
+template<class Heuristic,class TypeH,class OpenList>
+void AIAStar<Heuristic,TypeH,OpenList>::GetStatistic(
 		int* p_num_point_examine,int* p_num_find_erase)
 {
 	if(p_num_point_examine)
@@ -292,37 +337,76 @@ class Heuristic
 };
 */
 
-template<class Heuristic,class Node,class TypeH=float>
-class AIAStarGraph
+// :     .
+//   Heuristic,      
+//     (. ClusterFind).
+//Init       .
+template<class Node,class TypeH=float,class OpenList=AIAStarOpenList<TypeH> >
+class AIAStarGraphContext
 {
 public:
-	struct OnePoint;
-	typedef multimap<TypeH, OnePoint*> type_point_map;
-
 	struct OnePoint
 	{
 		TypeH g;//     
 		TypeH h;//     
 		DWORD used;
+		DWORD open_order;//    open_list
 		OnePoint* parent;
 		bool is_open;
 
 		Node* node;
-		typename type_point_map::iterator self_it;
 
 		inline TypeH f(){return g+h;}
 	};
-protected:
-	vector<OnePoint> chart;
-	type_point_map open_map;
 
+	vector<OnePoint> chart;
+	OpenList open_list;
 	DWORD is_used_num;// is_used_num==used,   
 
+	AIAStarGraphContext(){is_used_num=0;}
+
+	//   .     
+	//,   .
+	void Init(vector<Node>& all_node)
+	{
+		int size=all_node.size();
+		chart.resize(size);
+
+		for(int i=0;i<size;i++)
+		{
+			OnePoint* c=&chart[i];
+			c->node=&all_node[i];
+			c->node->AIAStarPointer=(void*)c;
+		}
+		clear();
+	}
+
+	void clear()
+	{
+		is_used_num=0;
+		typename vector<OnePoint>::iterator it;
+		FOR_EACH(chart,it)
+			it->used=0;
+	}
+};
+
+template<class Heuristic,class Node,class TypeH=float,class OpenList=AIAStarOpenList<TypeH> >
+class AIAStarGraph
+{
+public:
+	typedef AIAStarGraphContext<Node,TypeH,OpenList> Context;
+	typedef typename Context::OnePoint OnePoint;
+protected:
+	Context own_context;
+	Context* context;
+
 	int num_point_examine;//  
-	int num_find_erase;//     
+	int num_find_erase;//     open_list
 	Heuristic* heuristic;
 public:
 	AIAStarGraph();
+	//  ,   , Init  
+	AIAStarGraph(Context& shared_context);
 
 	//  . ,    ,
 	//  ,   .
@@ -332,60 +416,56 @@ public:
 	void GetStatistic(int* num_point_examine,int* num_find_erase);
 
 	//Debug
-	OnePoint* GetInternalBuffer(){return chart;};
-	DWORD GetUsedNum(){return is_used_num;}
+	OnePoint* GetInternalBuffer(){return &context->chart[0];};
+	DWORD GetUsedNum(){return context->is_used_num;}
 protected:
-	void clear();
 	inline Node* PosBy(OnePoint* p)
 	{
 		return p->node;
 	}
 };
 
-template<class Heuristic,class Node,class TypeH>
-AIAStarGraph<Heuristic,Node,TypeH>::AIAStarGraph()
+template<class Heuristic,class Node,class TypeH,class OpenList>
+AIAStarGraph<Heuristic,Node,TypeH,OpenList>::AIAStarGraph()
 {
+	context=&own_context;
 	heuristic=NULL;
 }
 
-template<class Heuristic,class Node,class TypeH>
-void AIAStarGraph<Heuristic,Node,TypeH>::Init(vector<Node>& all_node)
+template<class Heuristic,class Node,class TypeH,class OpenList>
+AIAStarGraph<Heuristic,Node,TypeH,OpenList>::AIAStarGraph(Context& shared_context)
 {
-	int size=all_node.size();
-	chart.resize(size);
-
-	for(int i=0;i<size;i++)
-	{
-		OnePoint* c=&chart[i];
-		c->node=&all_node[i];
-		c->node->AIAStarPointer=(void*)c;
-	}
-	clear();
+	context=&shared_context;
+	heuristic=NULL;
 }
 
-template<class Heuristic,class Node,class TypeH>
-void AIAStarGraph<Heuristic,Node,TypeH>::clear()
+template<class Heuristic,class Node,class TypeH,class OpenList>
+void AIAStarGraph<Heuristic,Node,TypeH,OpenList>::Init(vector<Node>& all_node)
 {
-	is_used_num=0;
-	vector<OnePoint>::iterator it;
-	FOR_EACH(chart,it)
-		it->used=0;
+	context->Init(all_node);
 }
 
-template<class Heuristic,class Node,class TypeH>
-bool AIAStarGraph<Heuristic,Node,TypeH>::FindPath(Node* from,Heuristic* hr,vector<Node*>& path)
+template<class Heuristic,class Node,class TypeH,class OpenList>
+bool AIAStarGraph<Heuristic,Node,TypeH,OpenList>::FindPath(Node* from,Heuristic* hr,vector<Node*>& path)
 {
 	num_point_examine=0;
 	num_find_erase=0;
 
-	is_used_num++;
-	open_map.clear();
+	OnePoint* chart=&context->chart[0];
+	OpenList& open_list=context->open_list;
+
+	DWORD is_used_num=++context->is_used_num;
+	open_list.clear();
 	path.clear();
 	if(is_used_num==0)
-		clear();// ,    ,   
+	{
+		context->clear();// ,    ,   
+		is_used_num=++context->is_used_num;
+	}
 	heuristic=hr;
 
 	OnePoint* p=(OnePoint*)from->AIAStarPointer;
+	xassert(p>=chart && p<chart+context->chart.size());
 	Node* from_node=p->node;
 	p->g=0;
 	p->h=heuristic->GetH(p->node);
@@ -393,17 +473,21 @@ bool AIAStarGraph<Heuristic,Node,TypeH>::FindPath(Node* from,Heuristic* hr,vecto
 	p->is_open=true;
 	p->parent=NULL;
 
-	p->self_it = open_map.insert(type_point_map::value_type(p->f(),p));
+	p->open_order=open_list.push(p->f(),p-chart);
 
-	while(!open_map.empty())
+	while(!open_list.empty())
 	{
-		type_point_map::iterator low=open_map.begin();
+		DWORD order;
+		OnePoint* parent=chart+open_list.pop(order);
+		if(!parent->is_open || parent->open_order!=order)
+		{
+			//     f
+			num_find_erase++;
+			continue;
+		}
 
-		OnePoint* parent=low->second;
 		Node* node = parent->node;
-
 		parent->is_open=false;
-		open_map.erase(low);
 
 		if(heuristic->IsEndPoint(node))
 		{
@@ -423,7 +507,7 @@ bool AIAStarGraph<Heuristic,Node,TypeH>::FindPath(Node* from,Heuristic* hr,vecto
 		}
 
 		//   child  parent
-		Node::iterator it;
+		typename Node::iterator it;
 		FOR_EACH(*node,it)
 		{
 			Node* cur_node=*it;
@@ -437,17 +521,13 @@ bool AIAStarGraph<Heuristic,Node,TypeH>::FindPath(Node* from,Heuristic* hr,vecto
 			{
 				if(!p->is_open)continue;
 				if(p->g<=newg)continue;
-
-				open_map.erase(p->self_it);
-				num_find_erase++;
+				//   open_list  
 			}
 
 			p->parent=parent;
 			p->g=newg;
 			p->h=heuristic->GetH(cur_node);
-
-			p->self_it = open_map.insert(type_point_map::value_type(p->f(),p));
-
+			p->open_order=open_list.push(p->f(),p-chart);
 			p->is_open=true;
 			p->used=is_used_num;
 		}
@@ -456,8 +536,8 @@ bool AIAStarGraph<Heuristic,Node,TypeH>::FindPath(Node* from,Heuristic* hr,vecto
 	return false;
 }
 
-template<class Heuristic,class Node,class TypeH>
-void AIAStarGraph<Heuristic,Node,TypeH>::GetStatistic(
+template<class Heuristic,class Node,class TypeH,class OpenList>
+void AIAStarGraph<Heuristic,Node,TypeH,OpenList>::GetStatistic(
 		int* p_num_point_examine,int* p_num_find_erase)
 {
 	if(p_num_point_examine)
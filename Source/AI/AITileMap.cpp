@@ -54,9 +54,9 @@ AITileMap::AITileMap(int hsize,int vsize)
 : Map2D<AITile, AITile::tile_size_world_shl>(hsize,vsize)
 { 
 	pWalkMap=NULL;
+	chaos_revision=0;
 
 	path_finder = new ClusterFind(sizeX(), sizeY(), terrainPathFind.clusterSize);
-	path_finder2 = new ClusterFind(sizeX(), sizeY(), terrainPathFind.clusterSize);
 	path_hard_map = new ClusterFind(sizeX(), sizeY(), terrainPathFind.clusterSize);
 
 	InitialUpdate(); 
@@ -65,7 +65,6 @@ AITileMap::~AITileMap()
 {
 	RELEASE(pWalkMap);
 	delete path_finder;
-	delete path_finder2;
 	delete path_hard_map;
 }
 
@@ -74,12 +73,13 @@ void AITileMap::InitialUpdate()
 	for(int y=0;y < sizeY();y++)
 		for(int x=0;x < sizeX();x++)
 			(*this)(x,y).update(x,y);
+	chaos_revision++;
+	chaos_changes.clear();
 
 	rebuildWalkMap(path_finder->GetWalkMap());
 	path_finder->Set(terrainPathFind.enableSmoothing);
-
-	memcpy(path_finder2->GetWalkMap(),path_finder->GetWalkMap(),sizeX()*sizeY()*sizeof(path_finder2->GetWalkMap()[0]));
-	path_finder2->SetLater(terrainPathFind.enableSmoothing, terrainPathFind.rebuildQuants);
+	path_clusters_built = path_finder->GetNumCluster();
+	path_changed.clear();
 
 	updateHardMap();
 }
@@ -92,14 +92,59 @@ void AITileMap::UpdateRect(int x1,int y1,int dx,int dy)
 	x1 = w2mFloor(x1);
 	y1 = w2mFloor(y1);
 
+	int xc1 = sizeX(), yc1 = sizeY(), xc2 = -1, yc2 = -1;
+	int xh1 = sizeX(), yh1 = sizeY(), xh2 = -1, yh2 = -1;
 	for(int y = y1;y <= y2; y++)
 	for(int x = x1; x <= x2; x++)
-		if((*this)(x,y).update(x,y))
+	{
+		AITile& tile = (*this)(x,y);
+		BYTE walk = walkValue(tile);
+		bool chaos = !tile.height_min;
+		if(tile.update(x,y))
 		{
 			list<AIPlayer*>::iterator it;
 			FOR_EACH(call_back,it)
 				(*it)->changeTileState(x,y);
 		}
+		if(chaos != !tile.height_min)
+		{
+			xh1 = min(xh1, x); yh1 = min(yh1, y);
+			xh2 = max(xh2, x); yh2 = max(yh2, y);
+		}
+		if(walk != walkValue(tile))
+		{
+			xc1 = min(xc1, x); yc1 = min(yc1, y);
+			xc2 = max(xc2, x); yc2 = max(yc2, y);
+		}
+	}
+
+	if(xc1 <= xc2)
+		path_changed.push_back(sRect(xc1, yc1, xc2 - xc1, yc2 - yc1));
+
+	if(xh1 <= xh2)
+	{
+		ChaosChange change;
+		change.revision = ++chaos_revision;
+		change.rect = sRect(xh1, yh1, xh2 - xh1, yh2 - yh1);
+		chaos_changes.push_back(change);
+		if(chaos_changes.size() > CHAOS_CHANGES_MAX)
+			chaos_changes.pop_front();
+	}
+}
+
+bool AITileMap::chaosChanges(int revision, vector<sRect>& rects) const
+{
+	rects.clear();
+	if(revision == chaos_revision)
+		return true;
+	//     
+	if(chaos_changes.empty() || chaos_changes.front().revision > revision + 1)
+		return false;
+	list<ChaosChange>::const_iterator it;
+	FOR_EACH(chaos_changes, it)
+		if(it->revision > revision)
+			rects.push_back(it->rect);
+	return true;
 }
 
 void AITileMap::placeBuilding(const Vect2i& v1, const Vect2i& size, bool place)
@@ -251,6 +296,12 @@ bool AITileMap::findPath(const Vect2i& from_w, const Vect2i& to_w, vector<Vect2i
 	return b;
 }
 
+// ,  rebuildWalkMap    (  )
+BYTE AITileMap::walkValue(const AITile& tile)
+{
+	return tile.height_min ? 0 : ClusterHeuristicDitch::heuristic_ditch;
+}
+
 void AITileMap::rebuildWalkMap(BYTE* walk_map)
 {
 	int size = sizeY()*sizeX();
@@ -360,12 +411,30 @@ void AITileMap::recalcPathFind()
 {
 	start_timer_auto(calcPathMap,STATISTICS_GROUP_TOTAL);
 
-	if(path_finder2->SetLaterQuant()){
-		swap(path_finder2,path_finder);
+	BYTE* walk_map = path_finder->GetWalkMap();
+	vector<sRect>::iterator ri;
+	FOR_EACH(path_changed, ri)
+	{
+		for(int y = ri->y; y <= ri->y1(); y++)
+		for(int x = ri->x; x <= ri->x1(); x++)
+			walk_map[y*sizeX() + x] = walkValue((*this)(x,y));
 
-		rebuildWalkMap(path_finder2->GetWalkMap());
-		path_finder2->SetLater(terrainPathFind.enableSmoothing,terrainPathFind.rebuildQuants);
+		path_finder->UpdateRect(ri->x, ri->y, ri->x1(), ri->y1(), terrainPathFind.enableSmoothing);
+	}
+	statistics_add(calcPathMap_rects, STATISTICS_GROUP_AI, path_changed.size());
+
+	//      ,     
+	if(!path_changed.empty() && path_finder->GetNumCluster() > path_clusters_built*3/2){
+		start_timer_auto(calcPathMap_rebuild,STATISTICS_GROUP_AI);
+		rebuildWalkMap(walk_map);
+		path_finder->Set(terrainPathFind.enableSmoothing);
+		path_clusters_built = path_finder->GetNumCluster();
 	}
+
+	if(terrainPathFind.showMap==1 && !path_changed.empty())
+		updateWalkMap(walk_map);
+
+	path_changed.clear();
 }
 
 void AITileMap::updateWalkMap(BYTE* walk_map)
@@ -38,6 +38,12 @@ public:
 	void InitialUpdate();
 	void UpdateRect(int x,int y,int dx,int dy); // world coords
 
+	// ,       height_min == 0 ()
+	int chaosRevision() const { return chaos_revision; }
+	//  (map coords)     revision.
+	// false -  ,  
+	bool chaosChanges(int revision, vector<sRect>& rects) const;
+
 	//   
 	void placeBuilding(const Vect2i& v1, const Vect2i& size, bool place); // map coords
 	bool readyForBuilding(const Vect2i& v1, const Vect2i& size); // map coords
@@ -57,10 +63,24 @@ public:
 protected:
 	list<class AIPlayer*> call_back;
 	ClusterFind* path_finder;
-	ClusterFind* path_finder2;
 	ClusterFind* path_hard_map;
 
+	// (map coords),   ;   recalcPathFind
+	vector<sRect> path_changed;
+	int path_clusters_built; //     
+	int chaos_revision;
+
+	//   ,    
+	enum { CHAOS_CHANGES_MAX = 64 };
+	struct ChaosChange
+	{
+		int revision;
+		sRect rect;
+	};
+	list<ChaosChange> chaos_changes;
+
 	void rebuildWalkMap(BYTE* walk_map);
+	static BYTE walkValue(const AITile& tile);
 
 	cTexture* pWalkMap;
 	void updateWalkMap(BYTE* walk_map);
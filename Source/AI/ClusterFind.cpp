@@ -77,6 +77,7 @@ void ClusterFind::Set(bool enable_smooting)
 
 	//,     
 	all_cluster.clear();
+	free_cluster.clear();
 	all_cluster.resize(1);
 	all_cluster.reserve(max_cluster_size);
 
@@ -117,21 +118,150 @@ void ClusterFind::Relink()
 	vector<Cluster>::iterator it;
 
 	FOR_EACH(all_cluster,it)
+		Relink(*it);
+
+	astar_context.Init(all_cluster);
+}
+
+void ClusterFind::Relink(Cluster& c)
+{
+	int size=c.index_link.size();
+	c.link.resize(size);
+
+	for(int i=0;i<size;i++)
 	{
-		Cluster& c=*it;
-		int size=c.index_link.size();
-		c.link.resize(size);
+		DWORD il=c.index_link[i];
+		xassert(//il>=0 && 
+			il<all_cluster.size());
+		c.link[i]=&all_cluster[il];
+	}
+}
 
-		for(int i=0;i<size;i++)
+void ClusterFind::UpdateRect(int x0,int y0,int x1,int y1,bool enable_smooting)
+{
+	start_timer_auto(ClusterFind_UpdateRect, STATISTICS_GROUP_AI);
+	xassert(ready());
+
+	x0=max(x0,0);y0=max(y0,0);
+	x1=min(x1,dx-1);y1=min(y1,dy-1);
+	if(x0>x1 || y0>y1)
+		return;
+
+	if(enable_smooting)
+		Smooting(x0,y0,x1,y1);
+
+	//,  . temp_set=false -  
+	repair_cluster.clear();
+	int x,y;
+	for(y=y0;y<=y1;y++)
+	for(x=x0;x<=x1;x++)
+	{
+		DWORD p=pmap[y*dx+x];
+		Cluster& c=all_cluster[p-1];
+		if(c.temp_set)
+		{
+			c.temp_set=false;
+			repair_cluster.push_back(p-1);
+		}
+	}
+	int num_removed=repair_cluster.size();
+
+	//   max_distance   ,
+	//      2*max_distance  
+	int bx0=max(x0-2*max_distance,0),by0=max(y0-2*max_distance,0);
+	int bx1=min(x1+2*max_distance,dx-1),by1=min(y1+2*max_distance,dy-1);
+	for(y=by0;y<=by1;y++)
+	for(x=bx0;x<=bx1;x++)
+	{
+		DWORD& p=pmap[y*dx+x];
+		if(!all_cluster[p-1].temp_set)
+			p=0;
+	}
+
+	//     
+	int i;
+	for(i=0;i<num_removed;i++)
+	{
+		Cluster& c=all_cluster[repair_cluster[i]];
+		vector<DWORD>::iterator it;
+		FOR_EACH(c.index_link,it)
 		{
-			DWORD il=c.index_link[i];
-			xassert(//il>=0 && 
-				il<all_cluster.size());
-			c.link[i]=&all_cluster[il];
+			Cluster& cn=all_cluster[*it];
+			if(!cn.temp_set)
+				continue;
+			vector<DWORD>::iterator itn=cn.index_link.begin();
+			while(itn!=cn.index_link.end())
+			{
+				if(all_cluster[*itn].temp_set)
+					++itn;
+				else
+					itn=cn.index_link.erase(itn);
+			}
+			repair_cluster.push_back(*it);
 		}
 	}
+
+	for(i=0;i<num_removed;i++)
+	{
+		Cluster& c=all_cluster[repair_cluster[i]];
+		c.index_link.clear();
+		c.link.clear();
+		c.x=c.y=0;
+		c.xcenter=c.ycenter=0;
+		c.walk=0;
+		c.temp_set=true;
+		free_cluster.push_back(repair_cluster[i]);
+	}
+
+	//   ,    ,   Set
+	const Cluster* old_begin=&all_cluster[0];
+	int old_size=all_cluster.size();
+	int num_added=0;
+	for(y=by0;y<=by1;y++)
+	for(x=bx0;x<=bx1;x++)
+	{
+		if(pmap[y*dx+x])
+			continue;
+
+		DWORD index;
+		if(free_cluster.empty())
+		{
+			index=all_cluster.size();
+			all_cluster.resize(index+1);
+		}else
+		{
+			index=free_cluster.back();
+			free_cluster.pop_back();
+		}
+		ClusterOne(x,y,index+1,all_cluster[index]);
+		repair_cluster.push_back(index);
+		num_added++;
+	}
+
+	if(&all_cluster[0]!=old_begin)
+		Relink();
+	else
+	{
+		vector<DWORD>::iterator it;
+		FOR_EACH(repair_cluster,it)
+			Relink(all_cluster[*it]);
+
+		if((int)all_cluster.size()!=old_size)
+			astar_context.Init(all_cluster);
+	}
+
+	statistics_add(ClusterFind_removed, STATISTICS_GROUP_AI, num_removed);
+	statistics_add(ClusterFind_added, STATISTICS_GROUP_AI, num_added);
 }
 
+#ifndef _FINAL_VERSION_
+bool ClusterFind::astarBenchmark()
+{
+	static bool enabled = check_command_line("astar_benchmark") != 0;
+	return enabled;
+}
+#endif
+
 void ClusterFind::CheckAllLink()
 {
 	Cluster* first=&all_cluster[0];
@@ -210,7 +340,7 @@ void ClusterFind::ClusterOne(int x,int y,int id,Cluster& c)
 					if(ct.temp_set)
 					{
 
-						xassert(pd<all_cluster.size());
+						xassert(pd<=all_cluster.size());
 						ct.temp_set=false;
 						vtemp_set.push_back(pd-1);
 					}
@@ -748,15 +878,23 @@ void ClusterFind::FindClusterFront(int x,int y,DWORD to,
 }
 
 void ClusterFind::Smooting()
+{
+	Smooting(0,0,dx-1,dy-1);
+}
+
+void ClusterFind::Smooting(int x0,int y0,int x1,int y1)
 {// 
 	const int size_child=4;
 	const int sx[size_child]={ 0,+1, 0,-1};
 	const int sy[size_child]={-1, 0,+1, 0};
 
-	for(int y=1;y<dy-1;y++)
+	x0=max(x0,1);y0=max(y0,1);
+	x1=min(x1,dx-2);y1=min(y1,dy-2);
+
+	for(int y=y0;y<=y1;y++)
 	{
 		BYTE* p=walk_map+y*dx;
-		for(int x=1;x<dx-1;x++)
+		for(int x=x0;x<=x1;x++)
 		{
 			int b=p[x];
 			int up,down,center;
@@ -1004,6 +1142,7 @@ void ClusterFind::SetLater(bool enable_smooting,int _quant_of_build)
 	memset(pmap,0,dx*dy*sizeof(pmap[0]));
 
 	all_cluster.clear();
+	free_cluster.clear();
 	all_cluster.reserve(max_cluster_size);
 	all_cluster.resize(1);
 	Cluster* first_element=&all_cluster[0];
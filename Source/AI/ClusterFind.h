@@ -150,15 +150,18 @@ public:
 	bool SetLaterQuant();//true -  
 	bool ready() const { return cur_quant_build >= quant_of_build; }
 
+	//    walk_map   ():
+	//,  ,    ,
+	//     .
+	void UpdateRect(int x0,int y0,int x1,int y1,bool enable_smooting);
+
 	template<class ClusterHeuristic>
 	bool FindPath(const Vect2i& from, const Vect2i& to, vector<Vect2i>& out_path, ClusterHeuristic& heuristic)
 	{
 		heuristic.end = getCluster(to);
 
-		vector<Cluster*> path;
-		AIAStarGraph<ClusterHeuristic,Cluster> astar;
-		astar.Init(all_cluster);
-		if(!astar.FindPath(getCluster(from), &heuristic, path))
+		vector<Cluster*>& path = astar_path;
+		if(!findClusterPath(getCluster(from), heuristic, path))
 			return false;
 
 		SoftPath(path, from, to, out_path);
@@ -180,10 +183,8 @@ public:
 		FOR_EACH(to, vi)
 			heuristic.addEnd(*vi, getCluster(*vi));
 
-		vector<Cluster*> path;
-		AIAStarGraph<ClusterHeuristic,Cluster> astar;
-		astar.Init(all_cluster);
-		if(!astar.FindPath(getCluster(from), &heuristic, path))
+		vector<Cluster*>& path = astar_path;
+		if(!findClusterPath(getCluster(from), heuristic, path))
 			return false;
 
 		xassert(!path.empty());
@@ -199,7 +200,7 @@ public:
 		return true;
 	}
 
-	int GetNumCluster() { return all_cluster.size(); }
+	int GetNumCluster() { return all_cluster.size() - free_cluster.size(); }
 
 	inline Cluster* getCluster(const Vect2i& point)
 	{
@@ -228,6 +229,59 @@ protected:
 	int size_one,size_two;
 
 	vector<Cluster> all_cluster;
+	vector<DWORD> free_cluster;//  UpdateRect  all_cluster
+	vector<DWORD> repair_cluster;// UpdateRect
+
+	// A*   ,   all_cluster  Relink
+	typedef AIAStarGraphContext<Cluster> AStarContext;
+	AStarContext astar_context;
+	vector<Cluster*> astar_path;
+
+	template<class ClusterHeuristic>
+	bool findClusterPath(Cluster* from, ClusterHeuristic& heuristic, vector<Cluster*>& path)
+	{
+#ifndef _FINAL_VERSION_
+		if(astarBenchmark())
+			return benchmarkClusterPath(from, heuristic, path);
+#endif
+		AIAStarGraph<ClusterHeuristic,Cluster> astar(astar_context);
+		return astar.FindPath(from, &heuristic, path);
+	}
+
+#ifndef _FINAL_VERSION_
+	//   astar_benchmark:   
+	//    multimap,  ,     AI.
+	//       play_reel.
+	static bool astarBenchmark();
+
+	template<class ClusterHeuristic>
+	bool benchmarkClusterPath(Cluster* from, ClusterHeuristic& heuristic, vector<Cluster*>& path)
+	{
+		typedef AIAStarGraph<ClusterHeuristic,Cluster,float,AIAStarMultimap<float> > LegacyAStar;
+		static vector<Cluster*> legacy_path;
+		bool legacy_found;
+		{
+			LegacyAStar astar;
+			astar.Init(all_cluster);
+			start_timer(AIAStar_multimap, STATISTICS_GROUP_AI);
+			legacy_found = astar.FindPath(from, &heuristic, legacy_path);
+			stop_timer(AIAStar_multimap, STATISTICS_GROUP_AI);
+		}
+
+		astar_context.Init(all_cluster);
+		AIAStarGraph<ClusterHeuristic,Cluster> astar(astar_context);
+		start_timer(AIAStar_heap, STATISTICS_GROUP_AI);
+		bool found = astar.FindPath(from, &heuristic, path);
+		stop_timer(AIAStar_heap, STATISTICS_GROUP_AI);
+
+		int num_point_examine;
+		astar.GetStatistic(&num_point_examine, 0);
+		statistics_add(AIAStar_points, STATISTICS_GROUP_AI, num_point_examine);
+
+		xassert(found == legacy_found && path == legacy_path);
+		return found;
+	}
+#endif
 
 	BYTE* is_used;// SoftPath
 	DWORD is_used_size;
@@ -242,7 +296,9 @@ protected:
 	/////////////////////////
 	//	Private Members
 	void Relink();
+	void Relink(Cluster& c);
 	void Smooting();
+	void Smooting(int x0,int y0,int x1,int y1);
 	//,  temp_set==true
 	vector<DWORD> vtemp_set;// ClusterOne
 	void ClusterOne(int x,int y,int id,Cluster& c);
@@ -1467,6 +1467,14 @@ SOURCE=.\HT\StreamInterpolation.cpp
 
 SOURCE=.\HT\StreamInterpolation.h
 # End Source File
+# Begin Source File
+
+SOURCE=.\HT\LogicJobs.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\HT\LogicJobs.h
+# End Source File
 # End Group
 # Begin Source File
 
@@ -89,7 +89,6 @@ terPlayer::terPlayer(const PlayerData& playerData)
 energy_region_(vMap.V_SIZE),
 core_column_(vMap.V_SIZE),
 field_region_(vMap.V_SIZE),
-defenceMap_(vMap.H_SIZE, vMap.V_SIZE),
 playerStrategyIndex_(0)
 {
 	MTINIT(lock_burn_zeroplast);
@@ -105,6 +104,7 @@ playerStrategyIndex_(0)
 	ignoreIntfCommands = false;
 
 	UnitCount = 0;
+	memset(unitCounts_, 0, sizeof(unitCounts_));
 
 	setColorIndex(playerData.colorIndex);
 	belligerent_ = playerData.belligerent;
@@ -158,9 +158,6 @@ playerStrategyIndex_(0)
 	chooseEnemyDistance_ = FLT_INF;
 	chooseEnemyIndex_ = 0;
 
-	defenceMapPlayer_ = 0;
-	defenceMapGunIndex_ = -1;
-
 	lastFramePosition_ = Vect2f::ZERO;
 
 	voiceDispatcher_.setOwner(this);
@@ -274,7 +271,6 @@ void terPlayer::Quant()
 			log_var((*ui)->position());
 		}
 
-	rebuildDefenceMapQuant();
 	chooseEnemyQuant();
 	
 	if(frame())
@@ -356,7 +352,9 @@ void terPlayer::AvatarQuant()
 	if((*ui)->alive())
 	{
 		(*ui)->AvatarQuant();
-		(*ui)->AvatarInterpolation();
+		//   
+		if(!terHeadless)
+			(*ui)->AvatarInterpolation();
 	}
 }
 
@@ -397,6 +395,8 @@ void terPlayer::addUnit(terUnitBase* unit)
 
 	CUNITS_LOCK(this);
 	Units.push_back(unit);
+	unitCounts_[unit->attr().ID]++;
+	universe()->changeUnitCount(unit->attr().ID);
 
 	if(unit->attr().isBuilding()){// && unit->isBuilding()
 		BuildingList[unit->attr().ID].push_back(safe_cast<terBuilding*>(unit));
@@ -427,7 +427,12 @@ void terPlayer::removeUnit(terUnitBase* unit)
 	}
 
 	CUNITS_LOCK(this);
-	Units.erase(remove(Units.begin(), Units.end(), unit), Units.end());
+	UnitList::iterator ui = remove(Units.begin(), Units.end(), unit);
+	if(ui != Units.end()){
+		Units.erase(ui, Units.end());
+		unitCounts_[unit->attr().ID]--;
+		universe()->changeUnitCount(unit->attr().ID);
+	}
 
 	if(frame_ == unit)
 		clearFrame();
@@ -860,8 +865,8 @@ void terPlayer::showDebugInfo()
 	if(showDebugPlayer.trustMap)
 		TrustMap->Show();
 
-	if(showDebugPlayer.defenceMap && active())
-		defenceMap_.showDebugInfo();
+	if(showDebugPlayer.defenceMap && active() && universe()->hasDefenceMap(clan()))
+		defenceMap().showDebugInfo();
 
 	if(showDebugPlayer.enemyPlayer && frame() && enemyPlayer() && enemyPlayer()->frame()){
 		float t = 0.8f;
@@ -1178,16 +1183,8 @@ void terPlayer::ClusterActionPoint(Vect3f v,CommandSelectionMode mode,CommandID
 int terPlayer::countUnits(terUnitAttributeID id) const
 {
 	MTL();
-	if(id < UNIT_ATTRIBUTE_STRUCTURE_MAX)
-		return buildingList(id).size();
-
-	int count  = 0;
-	UnitList::const_iterator ui;
-	FOR_EACH(Units, ui)
-		if((*ui)->attr().ID == id)
-			++count;
-	
-	return count;
+	xassert(id >= 0 && id < UNIT_ATTRIBUTE_MAX);
+	return unitCounts_[id];
 }
 
 int terPlayer::countBuildingsConstructed(terUnitAttributeID id) const
@@ -1281,48 +1278,9 @@ void terPlayer::chooseEnemyQuant()
 	}
 }
 
-void terPlayer::rebuildDefenceMapQuant()
+DefenceMap& terPlayer::defenceMap()
 {
-	if(!defenceMap_.recalcMapQuant())
-		return;
-
-	PlayerVect& players = universe()->Players;
-
-	if(defenceMapPlayer_){
-		if(defenceMapGunIndex_ == -1){
-			defenceMap_.analizeField(defenceMapPlayer_->playerID());
-			defenceMapGunIndex_ = 0;
-			return;
-		}
-		int index = defenceMapGunIndex_++;
-		for(int id = UNIT_ATTRIBUTE_LASER_CANNON; id <= UNIT_ATTRIBUTE_GUN_SUBCHASER; id++){
-			terBuildingList& guns = defenceMapPlayer_->buildingList(id);
-			if(index >= guns.size())
-				index -= guns.size();
-			else{
-				defenceMap_.addGun(guns[index]->position2D(), guns[index]->attr().fireRadius());
-				return;
-			}
-		}
-		for(int i = defenceMapPlayer_->playerID() + 1; i < players.size() - 1; i++)
-			if(players[i]->clan() != clan()){
-				defenceMapPlayer_ = players[i];
-				defenceMapGunIndex_ = -1;
-				return;
-			}
-		defenceMapPlayer_ = 0;
-	}
-	defenceMap_.startRecalcMap();
-	defenceMap_.set(0);
-	defenceMap_.analizeChaos();
-
-	PlayerVect::iterator pi;
-	FOR_EACH(players, pi)
-		if((*pi)->clan() != clan()){
-			defenceMapPlayer_ = *pi;
-			defenceMapGunIndex_ = -1;
-			break;
-		}
+	return universe()->defenceMap(clan());
 }
 
 terUnitBase* terPlayer::findPathToTarget(DefenceMap& defenceMap, terUnitAttributeID id, terUnitBase* ignoreUnit, const Vect2f& nearPosition, Vect2iVect& path)
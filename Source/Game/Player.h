@@ -382,7 +382,6 @@ public:
 	void DestroyLink();
 	void DeleteQuant();
 	void MoveQuant();
-	void CollisionQuant();
 
 	void RefreshAttribute();
 
@@ -438,7 +437,7 @@ public:
 	bool findPathToPoint(DefenceMap& defenceMap, const Vect2i& from_w, const Vect2i& to_w, vector<Vect2i>& out_path);
 	terUnitBase* findPathToTarget(DefenceMap& defenceMap, terUnitAttributeID id, terUnitBase* ignoreUnit, const Vect2f& nearPosition, Vect2iVect& path);
 	terUnitBase* findPathToTarget(DefenceMap& defenceMap, int unitClass, terUnitBase* ignoreUnit, const Vect2f& nearPosition, Vect2iVect& path);
-	DefenceMap& defenceMap() { return defenceMap_; } //    ,    
+	DefenceMap& defenceMap(); //    ,     (  )
 
 	bool soundEvent(SoundEventID event_id);
 	bool soundEvent(const SoundEventSetup* ev);
@@ -484,7 +483,6 @@ public:
 	//-----------------------------------------
 	TriggerChain* getStrategyToEdit();
 
-	void rebuildDefenceMapQuant();
 	void chooseEnemyQuant();
 
 	Vect2f lastFramePosition() const { return lastFramePosition_; }
@@ -571,6 +569,7 @@ private:
 
 	bool buildingBlockRequest_;
 	terBuildingList BuildingList[UNIT_ATTRIBUTE_STRUCTURE_MAX];
+	int unitCounts_[UNIT_ATTRIBUTE_MAX]; //   addUnit/removeUnit
 	
 	Column structure_column_; 
 
@@ -600,10 +599,6 @@ private:
 	typedef multimap<int, EnergyConsumer*> EnergyConsumerMap;
 	EnergyConsumerMap energyConsumers;
 
-	DefenceMap defenceMap_;
-	int defenceMapGunIndex_;
-	terPlayer* defenceMapPlayer_;
-
 	terVoiceDispatcher voiceDispatcher_;
 
 	terPlayer* enemyPlayer_;
@@ -4,6 +4,7 @@
 #include "ForceField.h"
 #include "Config.h"
 #include "Terra.h"
+#include "..\terra\crc.h"
 
 //////////////////////////////////////////////////////////////////////////////////
 //			Region
@@ -929,11 +930,15 @@ add_operation(1),
 size_y(sy),
 rasterized_(false)
 {
+	revision_ = 0;
+	crcRevision_ = -1;
+	crc_ = 0;
 	shapeToolzer();
 }
 
 void RegionDispatcher::clear()
 {
+	revision_++;
 	Region::clear();
 	edit_column.clear();
 	rasterize_column.clear();
@@ -978,6 +983,7 @@ void RegionDispatcher::moveToolzer(const Point& p_)
 
 void RegionDispatcher::line(const Point& p0, const Point& p1, float radius, int operation)
 {
+	revision_++;
 	Shape circle;
 	circle.circle(radius);
 	Point prev_pos = Vect3f::ZERO;
@@ -1009,6 +1015,7 @@ void RegionDispatcher::postOperateAnalyze()
 
 void RegionDispatcher::vectorize(int minimalRegionSize, bool initSpline)
 {
+	revision_++;
 	start_timer_auto(vectorize, STATISTICS_GROUP_AI);
 
 	SeedList seeds;
@@ -1091,6 +1098,7 @@ void RegionDispatcher::save(XBuffer& buf) const
 
 void RegionDispatcher::load(XBuffer& buf)
 {
+	revision_++;
 	Region::clear();
 	buf > IDs;
 	Region::load(buf);
@@ -1099,7 +1107,13 @@ void RegionDispatcher::load(XBuffer& buf)
 
 void RegionDispatcher::saveEditing(XBuffer& buf) const 
 {
-	save(buf);
+	buf < IDs;
+	saveEditingData(buf);
+}
+
+void RegionDispatcher::saveEditingData(XBuffer& buf) const 
+{
+	Region::save(buf);
 	write_container(buf, edit_column);
 	write_container(buf, segments);
 }
@@ -1109,9 +1123,21 @@ void RegionDispatcher::loadEditing(XBuffer& buf)
 	load(buf);
 	read_vector(buf, edit_column, READ_CONTAINER_REWRITE);
 	read_container(buf, segments, READ_CONTAINER_CLEAR);
+	revision_++;
 	xassert(edit_column.size() == rasterize_column.size());
 }
 
+unsigned int RegionDispatcher::editingCRC() const
+{
+	if(crcRevision_ != revision_){
+		XBuffer buf(1024, 1);
+		saveEditingData(buf);
+		crc_ = crc32((const unsigned char*)buf.address(), buf.tell(), startCRC32);
+		crcRevision_ = revision_;
+	}
+	return crc_;
+}
+
 void RegionDispatcher::write_state(XBuffer& out)
 {
 	if(!enable_write_state)
@@ -1680,6 +1706,7 @@ RegionDispatcher::Segment::ClipResult RegionDispatcher::Segment::clip(const Poin
 
 void RegionDispatcher::clip_by_segment(const Point& p0_, const Point& p1_, float clip_radius, int saved_segments_number)
 {
+	revision_++;
 	Point p0(p0_), p1(p1_);
 	Point dir = p1 - p0;
 	float len = dir.norm();
@@ -1742,6 +1769,7 @@ next_segment: ;
 
 void RegionDispatcher::clip_by_circle(const Point& p, float clip_radius, int saved_segments_number)
 {
+	revision_++;
 	if(segments.size() <= saved_segments_number)
 		return;
 
@@ -1852,6 +1880,7 @@ void RegionMetaDispatcher::endLine()
 void RegionMetaDispatcher::lineto(const Point& p, int permanent)
 {
 	checkLocked();
+	active_layer->revision_++; // segments   
 	// Disable short segments
 	if(prev_segment_point.distance(p) < 0.1)
 		permanent = 0;
@@ -1969,6 +1998,18 @@ RegionMetaDispatcher& RegionMetaDispatcher::operator=(const RegionMetaDispatcher
 	return *this;
 }
 
+unsigned int RegionMetaDispatcher::editingCRC() const
+{
+	checkLocked();
+	unsigned int crc = startCRC32;
+	const_iterator i;
+	FOR_EACH(regions, i){
+		unsigned int layer = (*i)->editingCRC();
+		crc = crc32((const unsigned char*)&layer, sizeof(layer), crc);
+	}
+	return crc;
+}
+
 void RegionMetaDispatcher::Lock() const
 {
 	xassert(multithreaded);
@@ -304,6 +304,8 @@ public:
 
 	void saveEditing(XBuffer& buf) const;
 	void loadEditing(XBuffer& buf); 
+	// crc32  saveEditing    IDs,    
+	unsigned int editingCRC() const;
 	
 	Region* locateEdit(const Vect2i& p) { return rasterize_column[at_y(p.y)].locate(p.x); }
 	int filledEdit(const Vect2i& p) const { return rasterize_column[at_y(p.y)].filled(p.x); }
@@ -311,13 +313,13 @@ public:
 	Region* locateRasterized(const Vect2i& p) { return rasterize_column[at_y(p.y)].locate(p.x); } // xassert(rasterized_); 
 	int filledRasterized(const Vect2i& p) const { return rasterize_column[at_y(p.y)].filled(p.x); } // xassert(rasterized_); 
 	
-	Column& getEditColumn() { return edit_column; }
+	Column& getEditColumn() { revision_++; return edit_column; } //    -  
 	Column& getRasterizeColumn() { return rasterize_column; } // xassert(rasterized_); 
 	const Column& getEditColumn() const { return edit_column; }
 	const Column& getRasterizeColumn() const { xassert(rasterized_); return rasterize_column; }
 
 	//    
-	void operateByCircle(const Point& pos, float radius, int add) { edit_column.operateByCircle(pos, radius, add); }
+	void operateByCircle(const Point& pos, float radius, int add) { revision_++; edit_column.operateByCircle(pos, radius, add); }
 	void vectorize(int minimalRegionSize, bool initSpline);
 	void postOperateAnalyze(); //        (rasterize_column)
 
@@ -351,7 +353,13 @@ private:
 	
 	typedef list<Segment> SegmentList;
 	SegmentList segments;
+
+	//     , edit_column  segments
+	int revision_;
+	mutable int crcRevision_;
+	mutable unsigned int crc_;
 	
+	void saveEditingData(XBuffer& buf) const;
 	void shapeToolzer();
 	void rasterize();
 	void line(const Point& p0, const Point& p1, float radius, int operation);
@@ -442,6 +450,7 @@ public:
 
 	bool changed() const { checkLocked(); const_iterator i; FOR_EACH(regions, i) if(!(*i)->empty()) return true; return false; }
 	void saveEditing(XBuffer& buf) const { checkLocked(); const_iterator i; FOR_EACH(regions, i) (*i)->saveEditing(buf); }
+	unsigned int editingCRC() const;
 	void loadEditing(XBuffer& buf) { checkLocked(); iterator i; FOR_EACH(regions, i) (*i)->loadEditing(buf); }
 };
 
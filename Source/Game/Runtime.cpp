@@ -29,6 +29,7 @@
 #include "..\PluginMax\ZIPStream.h"
 
 #include "Universe.h"
+#include "SaveWriter.h"
 #include "..\resource.h"
 
 #include <commdlg.h>
@@ -62,6 +63,9 @@ const char* currentShortVersion =
 #endif
 
 static int terMissionEdit = 0;
+#ifndef _HEADLESS_
+bool terHeadless = false;
+#endif
 
 cLogicGeneric* terLogicGeneric = NULL;
 cVisGeneric* terVisGeneric = NULL;
@@ -119,7 +123,7 @@ bool applicationHasFocus()
 
 bool applicationIsGo()
 {
-	return applicationHasFocus() || (gameShell && gameShell->alwaysRun());
+	return terHeadless || applicationHasFocus() || (gameShell && gameShell->alwaysRun());
 }
 
 STARFORCE_API void SetShadowType(int shadow_map,int shadow_size,bool update)
@@ -210,8 +214,73 @@ void HTManager::init()
 	if(IniManager("Perimeter.ini").getInt("Game","ZIP"))
 		ZIPOpen("resource.pak");
 
+	//  :       
+	if(check_command_line("zip_bench")){
+		sZIPBench bench;
+		if(ZIPBenchmark(bench)){
+			statistics_add(zipBench_files, STATISTICS_GROUP_NUMERIC, bench.files);
+			statistics_add(zipBench_bytes, STATISTICS_GROUP_NUMERIC, bench.bytes);
+			statistics_add(zipBench_index, STATISTICS_GROUP_TOTAL, bench.index_time);
+			statistics_add(zipBench_lookup, STATISTICS_GROUP_TOTAL, bench.lookup_time);
+			statistics_add(zipBench_read, STATISTICS_GROUP_TOTAL, bench.read_time);
+		}
+	}
+
+	if(check_command_line("net_bench")){
+		sNetBenchSettings settings;
+		check_command_line_parameter("net_bench_peers", settings.peers);
+		check_command_line_parameter("net_bench_quants", settings.quants);
+		check_command_line_parameter("net_bench_commands", settings.commands);
+		check_command_line_parameter("net_bench_latency", settings.simulation.latency);
+		check_command_line_parameter("net_bench_jitter", settings.simulation.jitter);
+		check_command_line_parameter("net_bench_udp_port", settings.udpPort);
+		int loss = 0;
+		check_command_line_parameter("net_bench_loss", loss);
+		settings.simulation.loss = loss/100.f;
+		sNetBench bench;
+		if(netTransportBenchmark(settings, bench)){
+			statistics_add(netBench_commandsPerQuant, STATISTICS_GROUP_NUMERIC, bench.commandsPerQuant);
+			statistics_add(netBench_bytesPerQuant, STATISTICS_GROUP_NUMERIC, bench.bytesPerQuant);
+			statistics_add(netBench_lateQuants, STATISTICS_GROUP_NUMERIC, bench.lateQuants);
+			statistics_add(netBench_datagrams, STATISTICS_GROUP_NUMERIC, bench.datagrams);
+			statistics_add(netBench_dropped, STATISTICS_GROUP_NUMERIC, bench.dropped);
+			statistics_add(netBench_resent, STATISTICS_GROUP_NUMERIC, bench.resent);
+			statistics_add(netBench_time, STATISTICS_GROUP_TOTAL, bench.time);
+		}
+	}
+
+	if(check_command_line("net_codec_bench")){
+		sNetCodecBenchSettings settings;
+		check_command_line_parameter("net_bench_players", settings.players);
+		check_command_line_parameter("net_bench_quants", settings.quants);
+		check_command_line_parameter("net_bench_commands", settings.commands);
+		sNetCodecBench bench;
+		if(netCommandCodecBenchmark(settings, bench)){
+			xassert(bench.valid && "Quant commands codec: decoded commands differ");
+			statistics_add(netCodecBench_commands, STATISTICS_GROUP_NUMERIC, bench.commands);
+			statistics_add(netCodecBench_legacyBytes, STATISTICS_GROUP_NUMERIC, bench.legacyBytes);
+			statistics_add(netCodecBench_legacyPackets, STATISTICS_GROUP_NUMERIC, bench.legacyPackets);
+			statistics_add(netCodecBench_batchBytes, STATISTICS_GROUP_NUMERIC, bench.batchBytes);
+			statistics_add(netCodecBench_batchPackets, STATISTICS_GROUP_NUMERIC, bench.batchPackets);
+			statistics_add(netCodecBench_legacyEncode, STATISTICS_GROUP_TOTAL, bench.legacyEncodeTime);
+			statistics_add(netCodecBench_legacyDecode, STATISTICS_GROUP_TOTAL, bench.legacyDecodeTime);
+			statistics_add(netCodecBench_batchEncode, STATISTICS_GROUP_TOTAL, bench.batchEncodeTime);
+			statistics_add(netCodecBench_batchDecode, STATISTICS_GROUP_TOTAL, bench.batchDecodeTime);
+		}
+	}
+
 	PerimeterDataChannelLoad();
 
+	//  ,      
+#ifndef _HEADLESS_
+	terHeadless = check_command_line("headless") != 0;
+#endif
+	if(terHeadless){
+		terFullScreen = 0;
+		terScreenSizeX = 320;
+		terScreenSizeY = 240;
+	}
+
 	terMissionEdit = IniManager("Perimeter.ini").getInt("Game","MissionEdit");
 	check_command_line_parameter("edit", terMissionEdit);
 
@@ -224,7 +293,10 @@ void HTManager::init()
 
 	allocation_tracking("PerimeterGraphicsInit");
 	
-	InitSound(IniManager("Perimeter.ini").getInt("Sound","SoundEnable"), IniManager("Perimeter.ini").getInt("Sound","MusicEnable"));
+	if(terHeadless)
+		InitSound(false, false);
+	else
+		InitSound(IniManager("Perimeter.ini").getInt("Sound","SoundEnable"), IniManager("Perimeter.ini").getInt("Sound","MusicEnable"));
 
 	gameShell = new GameShell(terMissionEdit);
 	gameShell->setWindowClientSize(windowClientSize);
@@ -236,16 +308,20 @@ void HTManager::init()
 
 void HTManager::done()
 {
-	if(!terMissionEdit)
+	if(!terMissionEdit && !terHeadless)
 		PerimeterDataChannelSave();
 
 	PerimeterAviFinit();
 	
+	//      
+	GameSaveWriter::instance().wait();
+
 	// Logic
 	delete gameShell;
 	gameShell = 0;
 
-	FinitSound();
+	if(!terHeadless)
+		FinitSound();
 	finitGraphics();
 
 	ZIPClose();
@@ -287,16 +363,18 @@ bool HTManager::LogicQuant()
 
 void HTManager::GraphQuant()
 {
+	//quantCounter()    AvatarQuant,   :
+	//    ,   
+	int frame_quant=stream_interpolator.AcquireFrame();
 	if(universe())
 	{
-		int quant_counter=universe()->quantCounter();
-		if(terVisGeneric->GetGraphLogicQuant()!=quant_counter)
+		if(terVisGeneric->GetGraphLogicQuant()!=frame_quant)
 		{
 			interpolation_timer_ = 0; 
 			interpolation_factor_ = 0; 
 		}
 
-		terVisGeneric->SetGraphLogicQuant(quant_counter);
+		terVisGeneric->SetGraphLogicQuant(frame_quant);
 		interpolation_timer_ += scale_time.delta();
 		interpolation_factor_ = clamp(interpolation_timer_*terLogicTimePeriodInv, 0, 1);
 	}
@@ -325,8 +403,14 @@ cInterfaceRenderDevice* SetGraph(int Mode,int xScr,int yScr,int FullScr,int Colo
 //	if(HTManager::instance()->IsUseHT())
 		ModeRender|=RENDERDEVICE_MODE_MULTITHREAD;
 
+#ifdef _HEADLESS_
+	//    ,    
+	ModeRender|=RENDERDEVICE_MODE_NULLREF;
+	hWndVisGeneric = Win32_CreateWindow("Perimeter",0,0,xScr,yScr,VisPerimetrClient_WndProc,WS_POPUP);
+#else
 	hWndVisGeneric = Win32_CreateWindow("Perimeter",0,0,xScr,yScr,VisPerimetrClient_WndProc,
 		(FullScr ? 0 : WS_OVERLAPPEDWINDOW)|WS_POPUP|WS_VISIBLE);
+#endif
 
 	if(IRenderDevice->Init(xScr,yScr,ModeRender,hWndVisGeneric,RefreshRateInHz))
 	{
@@ -366,6 +450,8 @@ void HTManager::initGraphics()
 	terVisGeneric->SetMipMapLevel(terMipMapLevel);
 
 	terRenderDevice = SetGraph(1, terScreenSizeX,terScreenSizeY,terFullScreen,terBitPerPixel,tepRefreshRateInHz);
+	if(terHeadless)
+		ShowWindow(hWndVisGeneric, SW_HIDE);
 
 //	terRenderDevice = (cInterfaceRenderDevice*)(terVisGeneric -> CreateGraph(terGraphicsMode));
 //	terVisGeneric -> SetGraph(terRenderDevice,terScreenSizeX,terScreenSizeY,terFullScreen,16);
@@ -395,6 +481,17 @@ void HTManager::initGraphics()
 
 	terCamera = new terCameraType(terScene->CreateCamera());
 
+	//  : effect_bench:<  RESOURCE\FX>
+	const char* effect_lib=check_command_line("effect_bench:");
+	if(effect_lib){
+		sEffectBench bench;
+		cEffect::Benchmark(terScene, terVisGeneric->GetEffectLibrary(effect_lib), 1000, 50, bench);
+		statistics_add(effectBench_effects, STATISTICS_GROUP_NUMERIC, bench.effects);
+		statistics_add(effectBench_particles, STATISTICS_GROUP_NUMERIC, bench.particles);
+		statistics_add(effectBench_time, STATISTICS_GROUP_TOTAL, bench.time);
+		statistics_add(effectBench_timeScalar, STATISTICS_GROUP_TOTAL, bench.time_scalar);
+	}
+
 //For AVI
 /*	if(terWinVideoEnable){
 		terRenderDevice->Fill(0,0,0);
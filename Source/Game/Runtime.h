@@ -26,6 +26,14 @@ extern class cScene* terScene;
 extern class cUnkLight* terLight;
 extern class cTileMap* terMapPoint;
 
+//   ,      (-headless).
+// Headless (_HEADLESS_)   :  NULLREF,    
+#ifdef _HEADLESS_
+const bool terHeadless = true;
+#else
+extern bool terHeadless;
+#endif
+
 extern int terFullScreen;
 extern int terScreenSizeX;
 extern int terScreenSizeY;
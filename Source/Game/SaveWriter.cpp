@@ -0,0 +1,339 @@
+#include "StdAfx.h"
+#include "Runtime.h"
+#include "terra.h"
+#include "Universe.h"
+#include "BinaryArchive.h"
+#include "SaveWriter.h"
+#include <process.h>
+
+string saveTempName(const char* fname)
+{
+	return string(fname) + ".tmp";
+}
+
+bool replaceSaveFile(const char* tempName, const char* fname)
+{
+	if(MoveFileEx(tempName, fname, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		return true;
+	//  ( ,  ) -    ,   
+	if(GetLastError() != ERROR_CALL_NOT_IMPLEMENTED)
+		return false;
+	// Win9x MoveFileEx  
+	remove(fname);
+	return MoveFile(tempName, fname) != 0;
+}
+
+//-------------------------------------------------
+//:  "\t" (  - ),  - "end".
+//  "end"   -   .
+static const char* saveCommitEnd = "end";
+
+static string saveCommitJournalName(const char* saveName)
+{
+	return string(saveName) + ".commit";
+}
+
+static bool fileExists(const char* fname)
+{
+	return GetFileAttributes(fname) != 0xFFFFFFFF;
+}
+
+SaveCommit::SaveCommit(const char* saveName)
+: saveName_(saveName), journalName_(saveCommitJournalName(saveName))
+{
+	applied_ = false;
+}
+
+SaveCommit::~SaveCommit()
+{
+	if(applied_)
+		return;
+	vector<string>::iterator i;
+	FOR_EACH(tempNames_, i)
+		if(!i->empty())
+			::remove(i->c_str());
+}
+
+void SaveCommit::replace(const string& tempName, const string& fname)
+{
+	tempNames_.push_back(tempName);
+	fileNames_.push_back(fname);
+}
+
+void SaveCommit::remove(const string& fname)
+{
+	tempNames_.push_back(string());
+	fileNames_.push_back(fname);
+}
+
+bool SaveCommit::apply()
+{
+	string journal;
+	for(int i = 0; i < fileNames_.size(); i++)
+		journal += tempNames_[i] + "\t" + fileNames_[i] + "\n";
+	journal += saveCommitEnd;
+	journal += "\n";
+
+	//       
+	HANDLE file = CreateFile(journalName_.c_str(), GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_FLAG_WRITE_THROUGH, 0);
+	DWORD written = 0;
+	bool error = file == INVALID_HANDLE_VALUE || !WriteFile(file, journal.c_str(), journal.size(), &written, 0) || written != journal.size();
+	if(file != INVALID_HANDLE_VALUE)
+		CloseHandle(file);
+	if(error){
+		::remove(journalName_.c_str());
+		return false; //   
+	}
+	applied_ = true;
+	return completeSaveCommit(saveName_.c_str());
+}
+
+bool completeSaveCommit(const char* saveName)
+{
+	string journalName = saveCommitJournalName(saveName);
+	XStream ff(0);
+	if(!ff.open(journalName.c_str(), XS_IN))
+		return true;
+	string journal(ff.size(), 0);
+	if(!journal.empty())
+		ff.read(&journal[0], journal.size());
+	ff.close();
+
+	vector<string> tempNames, fileNames;
+	bool complete = false;
+	string::size_type pos = 0;
+	while(pos < journal.size()){
+		string::size_type end = journal.find('\n', pos);
+		if(end == string::npos)
+			break;
+		string line = journal.substr(pos, end - pos);
+		pos = end + 1;
+		if(line == saveCommitEnd){
+			complete = true;
+			break;
+		}
+		string::size_type tab = line.find('\t');
+		if(tab == string::npos)
+			break;
+		tempNames.push_back(line.substr(0, tab));
+		fileNames.push_back(line.substr(tab + 1));
+	}
+
+	bool result = true;
+	for(int i = 0; i < fileNames.size(); i++){
+		if(tempNames[i].empty()){
+			if(complete)
+				remove(fileNames[i].c_str());
+		}
+		else if(!complete)
+			remove(tempNames[i].c_str());
+		//  -   
+		else if(fileExists(tempNames[i].c_str()) && !replaceSaveFile(tempNames[i].c_str(), fileNames[i].c_str()))
+			result = false;
+	}
+	//       
+	if(result)
+		remove(journalName.c_str());
+	return result && complete;
+}
+
+//-------------------------------------------------
+GameSaveSnapshot::GameSaveSnapshot()
+{
+	map = 0;
+}
+
+GameSaveSnapshot::~GameSaveSnapshot()
+{
+	delete map;
+}
+
+bool GameSaveSnapshot::write(volatile LONG* steps)
+{
+	SavePrm data;
+	BinaryIArchive bia;
+	if(savePrm.empty() || !bia.open(&savePrm[0], savePrm.size()))
+		return false;
+	bia >> WRAP_NAME(data, "SavePrm");
+	bia.close();
+
+	string missionName = mission.saveName();
+	SaveCommit commit(missionName.c_str());
+
+	string tempName = saveTempName(missionName.c_str());
+	commit.replace(tempName, missionName);
+	if(!mission.writeMissionFile(data, tempName.c_str()))
+		return false;
+	if(steps)
+		InterlockedIncrement(steps);
+
+	if(map){
+		tempName = saveTempName(mapName.c_str());
+		commit.replace(tempName, mapName);
+		if(!map->save(tempName.c_str()))
+			return false;
+	}
+	else if(!removeMapName.empty())
+		commit.remove(removeMapName);
+	if(steps)
+		InterlockedIncrement(steps);
+
+	if(!regions.empty()){
+		tempName = saveTempName(regionName.c_str());
+		commit.replace(tempName, regionName);
+		XStream ff(tempName.c_str(), XS_OUT, 0);
+		ff.write(&regions[0], regions.size());
+		bool error = ff.ioError();
+		ff.close();
+		if(error)
+			return false;
+	}
+	else
+		commit.remove(regionName);
+
+	bool result = commit.apply();
+	if(steps)
+		InterlockedIncrement(steps);
+	return result;
+}
+
+//-------------------------------------------------
+unsigned __stdcall game_save_writer_thread(void* argument)
+{
+	((GameSaveWriter*)argument)->workerLoop();
+	return 0;
+}
+
+GameSaveWriter::GameSaveWriter()
+{
+	thread_ = 0;
+	wakeEvent_ = 0;
+	idleEvent_ = 0;
+	exit_ = false;
+	busy_ = false;
+	stepsDone_ = 0;
+	stepsTotal_ = 0;
+	failed_ = false;
+	failedCount_ = 0;
+}
+
+GameSaveWriter::~GameSaveWriter()
+{
+	if(thread_){
+		wait();
+		exit_ = true;
+		SetEvent(wakeEvent_);
+		WaitForSingleObject(thread_, INFINITE);
+		CloseHandle(thread_);
+		CloseHandle(wakeEvent_);
+		CloseHandle(idleEvent_);
+	}
+}
+
+GameSaveWriter& GameSaveWriter::instance()
+{
+	static GameSaveWriter writer;
+	return writer;
+}
+
+void GameSaveWriter::start()
+{
+	wakeEvent_ = CreateEvent(0, FALSE, FALSE, 0);
+	idleEvent_ = CreateEvent(0, TRUE, TRUE, 0);
+	unsigned thread_id;
+	thread_ = (HANDLE)_beginthreadex(0, 0, game_save_writer_thread, this, 0, &thread_id);
+	if(thread_)
+		SetThreadPriority(thread_, THREAD_PRIORITY_BELOW_NORMAL);
+}
+
+void GameSaveWriter::push(GameSaveSnapshot* snapshot)
+{
+	MTAuto lock(&lock_);
+	if(!thread_){
+		start();
+		if(!thread_){
+			//   -  
+			if(!snapshot->write()){
+				failed_ = true;
+				failedCount_++;
+			}
+			delete snapshot;
+			return;
+		}
+	}
+
+	if(!busy_){
+		stepsDone_ = 0;
+		stepsTotal_ = 0;
+	}
+	stepsTotal_ += GameSaveSnapshot::STEPS;
+	busy_ = true;
+	ResetEvent(idleEvent_);
+	queue_.push_back(snapshot);
+	SetEvent(wakeEvent_);
+}
+
+bool GameSaveWriter::wait()
+{
+	if(thread_)
+		WaitForSingleObject(idleEvent_, INFINITE);
+
+	MTAuto lock(&lock_);
+	bool result = !failed_;
+	failed_ = false;
+	return result;
+}
+
+float GameSaveWriter::progress() const
+{
+	if(!busy_ || !stepsTotal_)
+		return 1;
+	return (float)stepsDone_/stepsTotal_;
+}
+
+void GameSaveWriter::reportStatistics()
+{
+	MTAuto lock(&lock_);
+	vector<double>::iterator ti;
+	FOR_EACH(writeTimes_, ti)
+		statistics_add(saveWrite, STATISTICS_GROUP_TOTAL, *ti);
+	writeTimes_.clear();
+	if(failedCount_)
+		statistics_add(saveWriteFailed, STATISTICS_GROUP_NUMERIC, failedCount_);
+	failedCount_ = 0;
+}
+
+void GameSaveWriter::workerLoop()
+{
+	for(;;){
+		WaitForSingleObject(wakeEvent_, INFINITE);
+		for(;;){
+			GameSaveSnapshot* snapshot;
+			{
+				MTAuto lock(&lock_);
+				if(queue_.empty()){
+					busy_ = false;
+					SetEvent(idleEvent_);
+					break;
+				}
+				snapshot = queue_.front();
+				queue_.pop_front();
+			}
+
+			double time = clockf();
+			bool result = snapshot->write(&stepsDone_);
+			time = clockf() - time;
+			delete snapshot;
+
+			MTAuto lock(&lock_);
+			if(result)
+				writeTimes_.push_back(time);
+			else{
+				failed_ = true;
+				failedCount_++;
+			}
+		}
+		if(exit_)
+			return;
+	}
+}
@@ -0,0 +1,115 @@
+#ifndef __SAVE_WRITER_H__
+#define __SAVE_WRITER_H__
+
+/*
+   .
+
+terUniverse::universalSave    ( lock_logic)  :
+SavePrm   BinaryOArchive   -    ShareHandle
+  ,  - WorldChunksSnapshot  ,  -  .
+ ,   spg,       -
+  GameSaveWriter,    .
+
+   (spg, gmp, dat)   - SaveCommit:
+    ,     ,  .
+    ,      
+  (completeSaveCommit).
+*/
+
+class WorldChunksSnapshot;
+
+class GameSaveSnapshot
+{
+public:
+	GameSaveSnapshot();
+	~GameSaveSnapshot();
+
+	//      (MissionDescription::saveData)
+	MissionDescription mission;
+	vector<char> savePrm; //SavePrm  BinaryOArchive
+
+	string mapName;
+	WorldChunksSnapshot* map; //0 -   
+	string removeMapName; // , 
+
+	string regionName;
+	vector<char> regions; // -  regionName 
+
+	// ,  GameSaveWriter::progress()
+	enum { STEPS = 3 };
+
+	//    , steps    
+	bool write(volatile LONG* steps = 0);
+};
+
+class GameSaveWriter
+{
+public:
+	GameSaveWriter();
+	~GameSaveWriter();
+
+	// ,    
+	void push(GameSaveSnapshot* snapshot);
+	//   , false - -   
+	bool wait();
+
+	bool busy() const { return busy_; }
+	//    ,    
+	float progress() const;
+
+	//   -   
+	void reportStatistics();
+
+	static GameSaveWriter& instance();
+
+private:
+	list<GameSaveSnapshot*> queue_;
+	MTSection lock_;
+	HANDLE thread_;
+	HANDLE wakeEvent_;
+	HANDLE idleEvent_; //,       
+	volatile bool exit_;
+	volatile bool busy_;
+
+	volatile LONG stepsDone_;
+	int stepsTotal_;
+
+	bool failed_;
+	vector<double> writeTimes_;
+	int failedCount_;
+
+	void start();
+	void workerLoop();
+	friend unsigned __stdcall game_save_writer_thread(void* argument);
+};
+
+//    fname
+string saveTempName(const char* fname);
+//   fname,  fname 
+bool replaceSaveFile(const char* tempName, const char* fname);
+
+class SaveCommit
+{
+public:
+	SaveCommit(const char* saveName);
+	~SaveCommit(); // apply -   
+
+	//tempName  ,  fname
+	void replace(const string& tempName, const string& fname);
+	void remove(const string& fname);
+
+	//,  ; false -         
+	bool apply();
+
+private:
+	string saveName_;
+	string journalName_;
+	vector<string> tempNames_; // -  
+	vector<string> fileNames_;
+	bool applied_;
+};
+
+//    saveName,    GameSaveWriter
+bool completeSaveCommit(const char* saveName);
+
+#endif //__SAVE_WRITER_H__
@@ -0,0 +1,230 @@
+#include "StdAfx.h"
+#include "Runtime.h"
+#include "Universe.h"
+#include "GenericUnit.h"
+
+////////////////////////////////////////////////////////////////////
+//	 UnitGrid    .
+//	   (, , collisionGroup)   
+//	        Grid2D,   
+//	 -   ( , COLLISION_GROUP_REAL)
+//	    ( search_radius).
+//	 -    : op,    ,
+//	  .
+////////////////////////////////////////////////////////////////////
+struct UnitGridBenchElement : GridElementType
+{
+	int x, y, side;
+	int group;
+
+	mutable int pass_counter; //  
+	GridRectangle cells;
+
+	char payload[2048];
+};
+
+typedef Grid2D<UnitGridBenchElement, 5, GridVector<UnitGridBenchElement, 8> > UnitGridBenchGrid;
+
+//  :      
+class UnitGridBenchLegacy
+{
+public:
+	UnitGridBenchLegacy(int map_sx, int map_sy)
+	{
+		size_x = map_sx >> 5;
+		size_y = map_sy >> 5;
+		cells.resize(size_x*size_y);
+		pass_counter = 0;
+	}
+
+	void insert(UnitGridBenchElement& el)
+	{
+		el.pass_counter = 0;
+		el.cells = rectangle(el.x - el.side, el.y - el.side, el.x + el.side, el.y + el.side);
+		for(int y = el.cells.y0;y <= el.cells.y1;y++)
+			for(int x = el.cells.x0;x <= el.cells.x1;x++)
+				cells[y*size_x + x].push_back(&el);
+	}
+
+	template <class Op>
+	void scan(int x0, int y0, int x1, int y1, Op& op)
+	{
+		pass_counter++;
+		GridRectangle rect = rectangle(x0, y0, x1, y1);
+		for(int y = rect.y0;y <= rect.y1;y++)
+			for(int x = rect.x0;x <= rect.x1;x++){
+				vector<UnitGridBenchElement*>& cell = cells[y*size_x + x];
+				vector<UnitGridBenchElement*>::iterator i;
+				FOR_EACH(cell, i)
+					if((*i)->pass_counter != pass_counter){
+						(*i)->pass_counter = pass_counter;
+						op(*i);
+					}
+			}
+	}
+
+private:
+	vector<vector<UnitGridBenchElement*> > cells;
+	int size_x, size_y;
+	int pass_counter;
+
+	GridRectangle rectangle(int x0, int y0, int x1, int y1) const
+	{
+		return GridRectangle(clamp(x0 >> 5, 0, size_x - 1), clamp(y0 >> 5, 0, size_y - 1),
+			clamp(x1 >> 5, 0, size_x - 1), clamp(y1 >> 5, 0, size_y - 1));
+	}
+};
+
+//  op- :    ,     
+struct UnitGridBenchCollisionOp
+{
+	const UnitGridBenchElement* unit;
+	int hits;
+
+	UnitGridBenchCollisionOp() : unit(0), hits(0) {}
+
+	void operator()(const UnitGridBenchElement* p)
+	{
+		if(p != unit && (p->group & COLLISION_GROUP_REAL) &&
+		  sqr(p->x - unit->x) + sqr(p->y - unit->y) < sqr(p->side + unit->side))
+			hits++;
+	}
+};
+
+struct UnitGridBenchBatchOp
+{
+	const vector<UnitGridBenchElement*>& units;
+	UnitGridBenchCollisionOp op;
+
+	UnitGridBenchBatchOp(const vector<UnitGridBenchElement*>& units_) : units(units_) {}
+
+	void operator()(int index, const UnitGridBenchElement* p)
+	{
+		op.unit = units[index];
+		op(p);
+	}
+};
+
+struct UnitGridBenchTargetOp
+{
+	Vect2f center;
+	float radius2;
+	int targets;
+
+	UnitGridBenchTargetOp(float radius) : radius2(sqr(radius)), targets(0) {}
+
+	void operator()(const UnitGridBenchElement* p)
+	{
+		if(center.distance2(Vect2f(p->x, p->y)) <= radius2)
+			targets++;
+	}
+};
+
+void terUniverse::benchmarkUnitGrid(sUnitGridBench& result, int passes, float search_radius)
+{
+	vector<UnitGridBenchElement*> units;
+	PlayerVect::iterator pi;
+	FOR_EACH(Players, pi){
+		UnitList::iterator ui;
+		FOR_EACH((*pi)->Units, ui){
+			terUnitBase* unit = *ui;
+			if(!unit->alive())
+				continue;
+			UnitGridBenchElement* el = new UnitGridBenchElement;
+			el->x = round(unit->position().x);
+			el->y = round(unit->position().y);
+			el->side = round(unit->radius());
+			el->group = unit->collisionGroup();
+			units.push_back(el);
+		}
+	}
+
+	result = sUnitGridBench();
+	result.units = units.size();
+	if(units.empty())
+		return;
+
+	UnitGridBenchLegacy legacy(vMap.H_SIZE, vMap.V_SIZE);
+	UnitGridBenchGrid grid(vMap.H_SIZE, vMap.V_SIZE);
+	vector<GridQuery> queries;
+	int i;
+	for(i = 0;i < units.size();i++){
+		UnitGridBenchElement& el = *units[i];
+		legacy.insert(el);
+		grid.Insert(el, el.x, el.y, el.side, el.group);
+		if(el.group & COLLISION_GROUP_REAL)
+			queries.push_back(GridQuery(el.x, el.y, el.side, COLLISION_GROUP_REAL, i));
+	}
+	result.queries = queries.size();
+
+	int legacy_hits = 0, scan_hits = 0, mask_hits = 0, batch_hits = 0;
+	int legacy_targets = 0, circle_targets = 0;
+
+	for(int pass = 0;pass < passes;pass++){
+		// 
+		double time = clockf();
+		for(i = 0;i < queries.size();i++){
+			UnitGridBenchCollisionOp op;
+			op.unit = units[queries[i].index];
+			legacy.scan(queries[i].x0, queries[i].y0, queries[i].x1, queries[i].y1, op);
+			legacy_hits += op.hits;
+		}
+		result.legacyCollision += clockf() - time;
+
+		time = clockf();
+		for(i = 0;i < queries.size();i++){
+			UnitGridBenchCollisionOp op;
+			op.unit = units[queries[i].index];
+			grid.Scan(queries[i].x0, queries[i].y0, queries[i].x1, queries[i].y1, op);
+			scan_hits += op.hits;
+		}
+		result.scanCollision += clockf() - time;
+
+		time = clockf();
+		for(i = 0;i < queries.size();i++){
+			UnitGridBenchCollisionOp op;
+			op.unit = units[queries[i].index];
+			grid.ScanMask(queries[i].x0, queries[i].y0, queries[i].x1, queries[i].y1, COLLISION_GROUP_REAL, op);
+			mask_hits += op.hits;
+		}
+		result.maskCollision += clockf() - time;
+
+		//     -  CollisionQuant    
+		time = clockf();
+		vector<GridQuery> sorted = queries;
+		grid.SortQueries(&sorted[0], sorted.size());
+		UnitGridBenchBatchOp batch(units);
+		grid.ScanBatch(&sorted[0], sorted.size(), batch);
+		batch_hits += batch.op.hits;
+		result.batchCollision += clockf() - time;
+
+		//  
+		time = clockf();
+		for(i = 0;i < units.size();i++){
+			UnitGridBenchTargetOp op(search_radius);
+			op.center = Vect2f(units[i]->x, units[i]->y);
+			int side = search_radius;
+			legacy.scan(units[i]->x - side, units[i]->y - side, units[i]->x + side, units[i]->y + side, op);
+			legacy_targets += op.targets;
+		}
+		result.legacyTargets += clockf() - time;
+
+		time = clockf();
+		for(i = 0;i < units.size();i++){
+			UnitGridBenchTargetOp op(search_radius);
+			op.center = Vect2f(units[i]->x, units[i]->y);
+			grid.ScanCircle(op.center, search_radius, -1, op);
+			circle_targets += op.targets;
+		}
+		result.circleTargets += clockf() - time;
+	}
+
+	result.hits = legacy_hits/passes;
+	result.targets = legacy_targets/passes;
+	result.valid = scan_hits == legacy_hits && mask_hits == legacy_hits && batch_hits == legacy_hits && circle_targets == legacy_targets;
+
+	for(i = 0;i < units.size();i++){
+		grid.Remove(*units[i]);
+		delete units[i];
+	}
+}
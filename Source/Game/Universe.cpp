@@ -64,14 +64,23 @@
 #include "PerimeterShellUI.h"
 #include "ExternalShow.h"
 #include "..\ht\ht.h"
+#include "..\ht\LogicJobs.h"
 
 #include "qd_textdb.h"
 
 #include "XPrmArchive.h"
 #include "BinaryArchive.h"
+#include "SaveWriter.h"
 
 const int REGION_DATA_FILE_VERSION = 8383;
 
+//   ( BinaryOArchive).
+//   serialize:      if(ar.laterThan(<>)) -
+//    ,    true.
+const int SAVE_BINARY_VERSION = 1;
+
+bool MissionDescription::binarySaves = false;
+
 RandomGenerator logicRND;
 int terRealCollisionCount = 0;
 int terMapUpdatedCount = 0;
@@ -85,6 +94,27 @@ void UpdateRegionMap(int x1,int y1,int x2,int y2)
 		terMapPoint->UpdateMap(Vect2i(x1,y1), Vect2i(x2,y2));
 }
 
+//  Terra ( ) -   
+class terTerraJobRunner : public TerraJobRunner
+{
+	class Job : public LogicJob
+	{
+		TerraJob& job_;
+	public:
+		Job(TerraJob& job) : job_(job) {}
+		void execute(int index) { job_.execute(index); }
+	};
+
+public:
+	void run(TerraJob& job, int jobs)
+	{
+		Job logic_job(job);
+		LogicJobDispatcher::instance().run(logic_job, jobs);
+	}
+};
+
+static terTerraJobRunner terraJobRunner;
+
 terUniverse::terUniverse(PNetCenter* net_client, MissionDescription& mission, SavePrm& data, PROGRESSCALLBACK loadProgressUpdate) :
 	terHyperSpace(net_client, mission), //mission     rePlay-
 	UnitGrid(vMap.H_SIZE, vMap.V_SIZE),
@@ -104,6 +134,7 @@ terUniverse::terUniverse(PNetCenter* net_client, MissionDescription& mission, Sa
 	xm_random_generator.set(1);
 
 	ai_tile_map = new AITileMap(1 << vMap.H_SIZE_POWER, 1 << vMap.V_SIZE_POWER);
+	vMap.jobRunner = &terraJobRunner;
 
 	field_dispatcher = terScene->CreateForceFieldDispatcher(vMap.H_SIZE,vMap.V_SIZE,vMap.hZeroPlast,terTextureField01,terTextureField02);
 
@@ -113,6 +144,10 @@ terUniverse::terUniverse(PNetCenter* net_client, MissionDescription& mission, Sa
 	terMapUpdatedCount = 0;
 
 	quant_counter_ = 0;
+	unitCountStamp_ = 0;
+	memset(unitCountStamps_, 0, sizeof(unitCountStamps_));
+	gridBenchQuant_ = 0;
+	check_command_line_parameter("grid_bench:", gridBenchQuant_);
 
 	if(terObjectReflection)
 		field_dispatcher->SetAttr(ATTRUNKOBJ_REFLECTION);
@@ -146,7 +181,20 @@ terUniverse::terUniverse(PNetCenter* net_client, MissionDescription& mission, Sa
 	XStream ffMap(0);
 	if(ffMap.open(mapName.c_str(), XS_IN)){
 		ffMap.close();
-		vMap.loadGameMap(mapName.c_str(), IniManager("Perimeter.ini").getInt("TD","FastLoad"));
+		bool oldFormat = !vrtMap::isWorldChunksFile(mapName.c_str());
+		f3d.stat = sF3DStat();
+		//      ,     
+		if(!vMap.loadGameMap(mapName.c_str(), IniManager("Perimeter.ini").getInt("TD","FastLoad")))
+			ErrH.Abort("Game map is corrupted or belongs to another world: ", XERR_USER, 0, mapName.c_str());
+		statistics_add(gameMapLoad, STATISTICS_GROUP_TOTAL, vMap.chunksStat.totalTime);
+		statistics_add(gameMapLoad_unpack, STATISTICS_GROUP_TOTAL, vMap.chunksStat.unpackTime);
+		statistics_add(gameMapLoad_packedKb, STATISTICS_GROUP_NUMERIC, vMap.chunksStat.packedSize >> 10);
+		if(f3d.stat.time){
+			statistics_add(gameMapLoad_surface, STATISTICS_GROUP_TOTAL, f3d.stat.time);
+			statistics_add(gameMapLoad_surfaceCached, STATISTICS_GROUP_NUMERIC, f3d.stat.cached);
+		}
+		if(oldFormat && check_command_line("convert_gmp"))
+			vMap.saveGameMap(mapName.c_str());
 		UpdateRegionMap(0,0,vMap.H_SIZE - 1,vMap.V_SIZE - 1);
 		loadedGmpName_ = mapName;
 	}
@@ -278,8 +326,14 @@ terUniverse::~terUniverse()
 		delete *pi;
 	Players.clear();
 
+	DefenceMapTable::iterator di;
+	FOR_EACH(defenceMaps_, di)
+		delete di->second;
+	defenceMaps_.clear();
+
 	delete ai_tile_map;
 	ai_tile_map = 0;
+	vMap.jobRunner = 0;
 
 	RELEASE(field_dispatcher);
 
@@ -374,12 +428,12 @@ void terUniverse::Quant()
 
 	terRealCollisionCount++;
 	terMapUpdatedCount++;
-	PlayerVect::iterator pi;
-	FOR_EACH(Players, pi)
-		(*pi)->CollisionQuant();
+	CollisionQuant();
 
 	multibody_dispatcher.resolve();
 
+	PlayerVect::iterator pi;
+
 	FOR_EACH(Players, pi)
 		(*pi)->MoveQuant();
 
@@ -387,6 +441,10 @@ void terUniverse::Quant()
 		(*pi)->Quant();
 	monks.quant();
 
+	DefenceMapTable::iterator di;
+	FOR_EACH(defenceMaps_, di)
+		di->second->update();
+
 	ChangeOwnerList::iterator iChange;
 	FOR_EACH(changeOwnerList,iChange)
 		if(iChange->unit_->alive()){
@@ -430,28 +488,55 @@ void terUniverse::Quant()
 	
 	check_determinacy_quant(false);
 
-	vMap.renderQuant();
+	if(gridBenchQuant_ && quant_counter_ == gridBenchQuant_){
+		sUnitGridBench bench;
+		benchmarkUnitGrid(bench);
+		xassert(bench.valid && "UnitGrid: scan results differ from the pass counter grid");
+		statistics_add(gridBench_units, STATISTICS_GROUP_NUMERIC, bench.units);
+		statistics_add(gridBench_hits, STATISTICS_GROUP_NUMERIC, bench.hits);
+		statistics_add(gridBench_targets, STATISTICS_GROUP_NUMERIC, bench.targets);
+		statistics_add(gridBench_legacyCollision, STATISTICS_GROUP_TOTAL, bench.legacyCollision);
+		statistics_add(gridBench_scanCollision, STATISTICS_GROUP_TOTAL, bench.scanCollision);
+		statistics_add(gridBench_maskCollision, STATISTICS_GROUP_TOTAL, bench.maskCollision);
+		statistics_add(gridBench_batchCollision, STATISTICS_GROUP_TOTAL, bench.batchCollision);
+		statistics_add(gridBench_legacyTargets, STATISTICS_GROUP_TOTAL, bench.legacyTargets);
+		statistics_add(gridBench_circleTargets, STATISTICS_GROUP_TOTAL, bench.circleTargets);
+	}
+
+	if(!terHeadless){
+		start_timer_auto(TerrainRender, STATISTICS_GROUP_LOGIC);
+		vMap.renderQuant();
+	}
+	else{
+		//renderBox     ,     renderQuant
+		vMap.renderAreas.clear();
+	}
+	if(vMap.renderStat.rows){
+		statistics_add(TerrainRender_rows, STATISTICS_GROUP_NUMERIC, vMap.renderStat.rows);
+		statistics_add(TerrainRender_bands, STATISTICS_GROUP_NUMERIC, vMap.renderStat.bands);
+	}
 }
 
 void terUniverse::AvatarQuant()
 {
 	quant_counter_++;
 
-	stream_interpolator.Lock();
-	stream_interpolator.SetInAvatar(true);
+#ifndef _HEADLESS_
+	stream_interpolator.BeginWrite(quant_counter_);
 	start_timer_auto(AvatarQuant, STATISTICS_GROUP_LOGIC);
 
-	stream_interpolator.ClearData();
-
 	PlayerVect::iterator pi;
 	FOR_EACH(Players, pi)
 		(*pi)->AvatarQuant();
-	monks.avatarInterpolation();
+	if(!terHeadless)
+		monks.avatarInterpolation();
 
-	stream_interpolator.SetInAvatar(false);
-	stream_interpolator.Unlock();
+	stream_interpolator.EndWrite();
+	statistics_add(StreamInterpolator_records, STATISTICS_GROUP_NUMERIC, stream_interpolator.GetRecords());
 
-	select.ShowCircles();
+	if(!terHeadless)
+		select.ShowCircles();
+#endif
 }
  
 void terUniverse::ShowInfo()
@@ -706,7 +791,12 @@ MissionDescription::MissionDescription(const char* fname, GameType gameType)
 	else{
 		setSaveName(fname);
 
-		if(getExtention(saveName()) == "spg"){
+		//    -       spg.
+		//   ,     .
+		BinaryIArchive bia;
+		if(bia.open(saveName()))
+			bia >> WRAP_NAME(*this, "MissionDescriptionPrm");
+		else if(getExtention(saveName()) == "spg"){
 			string headerName = setExtention(saveName(), "sph");
 			XPrmIArchive ia;
 			if(ia.open(headerName.c_str()))
@@ -715,12 +805,8 @@ MissionDescription::MissionDescription(const char* fname, GameType gameType)
 				return;
 			ia >> WRAP_NAME(*this, "MissionDescriptionPrm");
 		}
-		else{
-			BinaryIArchive bia;
-			if(!bia.open(saveName()))
-				return;
-			bia >> WRAP_NAME(*this, "MissionDescriptionPrm");
-		}
+		else
+			return;
 
 		worldID_ = vMap.getWorldID(worldName);
 		xassert_s(worldID() != -1 && "    worlds.prm: ", worldName);
@@ -755,27 +841,38 @@ MissionDescription::MissionDescription(const char* fname, GameType gameType)
 
 bool MissionDescription::loadMission(SavePrm& savePrm) const
 {
+	//     ,      
+	GameSaveWriter::instance().wait();
+	completeSaveCommit(saveName());
+
 	savePrm = SavePrm();
 	MissionDescription missionDescription;
 	
-	if(getExtention(saveName()) == "spg"){
+	BinaryIArchive bia;
+	if(bia.open(saveName())){
+		if(bia.version() > SAVE_BINARY_VERSION)
+			return false; //    
+		bia >> WRAP_NAME(missionDescription, "MissionDescriptionPrm");
+		bia >> WRAP_NAME(savePrm, "SavePrm");
+	}
+	else if(getExtention(saveName()) == "spg"){
 		XPrmIArchive ia;
 		if(!ia.open(saveName()))
 			return false;
 		ia >> WRAP_NAME(missionDescription, "MissionDescriptionPrm");
 		ia >> WRAP_NAME(savePrm, "SavePrm");
 	}
-	else{
-		BinaryIArchive bia;
-		if(!bia.open(saveName()))
-			return false;
-		bia >> WRAP_NAME(missionDescription, "MissionDescriptionPrm");
-		bia >> WRAP_NAME(savePrm, "SavePrm");
-	}
+	else
+		return false;
 	return true;
 }
 
 bool MissionDescription::saveMission(const SavePrm& savePrm, bool userSave) const 
+{
+	return saveData(savePrm, userSave).writeMission(savePrm);
+}
+
+MissionDescription MissionDescription::saveData(const SavePrm& savePrm, bool userSave) const 
 {
 	MissionDescription data = *this;
 	
@@ -796,14 +893,34 @@ bool MissionDescription::saveMission(const SavePrm& savePrm, bool userSave) cons
 		data.originalSaveName = strstr(name.c_str(), "resource");
 	}
 
-//	BinaryOArchive boa(setExtention(saveName(), "spb").c_str());
-//	boa << WRAP_NAME(data, "MissionDescriptionPrm");
-//	boa << WRAP_NAME(savePrm, "SavePrm");
+	return data;
+}
 
-	XPrmOArchive oa(setExtention(saveName(), "spg").c_str());
-	oa << WRAP_NAME(data, "MissionDescriptionPrm");
-	oa << WRAP_NAME(savePrm, "SavePrm");
-	return oa.close();
+bool MissionDescription::writeMission(const SavePrm& savePrm) const 
+{
+	string fname = saveName();
+	string tempName = saveTempName(fname.c_str());
+	if(!writeMissionFile(savePrm, tempName.c_str())){
+		remove(tempName.c_str());
+		return false;
+	}
+	return replaceSaveFile(tempName.c_str(), fname.c_str());
+}
+
+bool MissionDescription::writeMissionFile(const SavePrm& savePrm, const char* fname) const 
+{
+	if(binarySaves || getExtention(saveName()) == "spb"){
+		BinaryOArchive boa(fname, SAVE_BINARY_VERSION);
+		boa << WRAP_NAME(*this, "MissionDescriptionPrm");
+		boa << WRAP_NAME(savePrm, "SavePrm");
+		return boa.close();
+	}
+	else{
+		XPrmOArchive oa(fname);
+		oa << WRAP_NAME(*this, "MissionDescriptionPrm");
+		oa << WRAP_NAME(savePrm, "SavePrm");
+		return oa.close();
+	}
 }
 
 void MissionDescription::restart() 
@@ -846,8 +963,15 @@ void MissionDescription::setReelName(const char* name)
 }
 
 //---------------------------------------------------------
-bool terUniverse::universalSave(const MissionDescription& mission, bool userSave)
+bool terUniverse::universalSave(const MissionDescription& mission, bool userSave, bool background)
 {
+	GameSaveWriter& writer = GameSaveWriter::instance();
+	writer.reportStatistics();
+	//    -    
+	if(!background)
+		writer.wait();
+
+	double time = clockf();
 	SavePrm data;
 
 	data.manualData = gameShell->manualData();
@@ -880,19 +1004,25 @@ bool terUniverse::universalSave(const MissionDescription& mission, bool userSave
 
 	gameShell->fillControlState(data.manualData.controls);
 	
-	if(!mission.saveMission(data, userSave))
-		return false;
+	GameSaveSnapshot* snapshot = new GameSaveSnapshot;
+	snapshot->mission = mission.saveData(data, userSave);
+	{
+		BinaryOArchive boa;
+		boa << WRAP_NAME(data, "SavePrm");
+		const char* buffer = boa.buffer();
+		snapshot->savePrm.assign(buffer, buffer + boa.buffer().tell());
+	}
 
 	//---------------------
 	// Map changes
 	string mapName = setExtention(mission.saveNameBinary(), "gmp");
 	if(vMap.IsChanged() || (loadedGmpName_ != "" && (!XStream(0).open(mapName.c_str(), XS_IN) || mapName != loadedGmpName_)) || check_command_line("force_save_gmp")){
-		if(!vMap.saveGameMap(mapName.c_str()))
-			return false;
+		snapshot->map = vMap.snapshotGameMap();
+		snapshot->mapName = mapName;
 		loadedGmpName_ = mapName;
 	}
 	else if(loadedGmpName_ == "")
-		remove(mapName.c_str());
+		snapshot->removeMapName = mapName;
 
 	if(gameShell->missionEditor() && gameShell->missionEditor()->hardnessChanged()){
 		gameShell->missionEditor()->clearHardnessChanged();
@@ -919,15 +1049,26 @@ bool terUniverse::universalSave(const MissionDescription& mission, bool userSave
 		int size = binaryData.tell();
 		binaryData.set(0);
 		binaryData < REGION_DATA_FILE_VERSION < changedCounter;
-		XStream ff(setExtention(mission.saveNameBinary(), "dat").c_str(), XS_OUT, 0);
-		ff.write(binaryData, size);
-		if(ff.ioError())
-			return false;
+		snapshot->regionName = setExtention(mission.saveNameBinary(), "dat");
+		snapshot->regions.assign(binaryData.address(), binaryData.address() + size);
 	}
 	else
-		remove(setExtention(mission.saveName(), "dat").c_str());
+		snapshot->regionName = setExtention(mission.saveName(), "dat");
 
-	return true;
+	statistics_add(saveSnapshot, STATISTICS_GROUP_TOTAL, clockf() - time);
+	if(snapshot->map)
+		statistics_add(saveSnapshotMap, STATISTICS_GROUP_NUMERIC, snapshot->map->size());
+
+	if(background){
+		writer.push(snapshot);
+		return true;
+	}
+
+	time = clockf();
+	bool result = snapshot->write();
+	delete snapshot;
+	statistics_add(saveWrite, STATISTICS_GROUP_TOTAL, clockf() - time);
+	return result;
 }
 
 void terUniverse::relaxLoading()
@@ -1016,6 +1157,14 @@ void terUniverse::SetActivePlayer(int id)
 	*activeRegionDispatcher_ = *activePlayer()->RegionPoint;
 }
 
+DefenceMap& terUniverse::defenceMap(int clan)
+{
+	DefenceMapTable::iterator di = defenceMaps_.find(clan);
+	if(di == defenceMaps_.end())
+		di = defenceMaps_.insert(DefenceMapTable::value_type(clan, new DefenceMap(vMap.H_SIZE, vMap.V_SIZE, clan))).first;
+	return *di->second;
+}
+
 terPlayer* terUniverse::addPlayer(const PlayerData& playerData)
 {
 	terPlayer* player = new AIPlayer(playerData);
@@ -1103,23 +1252,176 @@ struct terRealCollisionOperator
 	}
 };
 
-void terPlayer::CollisionQuant()
+//   ,    " "
+inline bool terRealCollisionAllowed(terUnitBase* unit, terUnitBase* p)
 {
-	MTL();
-	UnitList::iterator i_unit;
-	FOR_EACH(Units,i_unit){
-		terUnitBase* p = *i_unit;
-		if(p->alive()){
-			if(p->collisionGroup() & COLLISION_GROUP_REAL){
-				int x = p->position2D().xi();
-				int y = p->position2D().yi();
-				int r = round(p->radius());
-				terRealCollisionOperator op(p);
-				universe()->UnitGrid.Scan(x, y, r, op);
+	if(!p->alive() || p == unit->GetIgnoreUnit() || unit == p->GetIgnoreUnit() || 
+	  (unit->excludeCollision() & p->excludeCollision()))
+		return false;
+	if(!unit->isEnemy(p) && ((unit->collisionGroup() | p->collisionGroup()) & COLLISION_GROUP_ENEMY_ONLY))
+		return false;
+	return (p->collisionGroup() & COLLISION_GROUP_REAL) != 0;
+}
+
+struct terRealCollisionDetectOperator
+{
+	float Radius;
+	Vect3f Position;
+	MatXf Matrix;
+ 	const RigidBody* BodyPoint;
+ 	terUnitBase* unit_;
+	int order_;
+	terUniverse::CollisionUnitList& units_;
+	int chunk_;
+	vector<terUniverse::CollisionHit>& hits_;
+
+	terRealCollisionDetectOperator(terUniverse::CollisionUnitList& units, int chunk, vector<terUniverse::CollisionHit>& hits)
+	: units_(units), hits_(hits)
+	{
+		chunk_ = chunk;
+		order_ = -1;
+	}
+
+	//   ScanBatch: order -    collisionUnits_
+	void begin(int order)
+	{
+		order_ = order;
+		terUniverse::CollisionUnit& cu = units_[order];
+		cu.chunk = chunk_;
+		cu.hitsBegin = cu.hitsEnd = hits_.size();
+		unit_ = cu.unit;
+		BodyPoint = unit_->GetRigidBodyPoint();
+		Matrix = BodyPoint->matrix();
+		Position = BodyPoint->position();
+		Radius = BodyPoint->radius();
+	}
+
+	//   ,   terRealCollisionOperator,  " " 
+	//   ,    RealCollisionCount
+	void operator()(int order, terUnitBase* p)
+	{
+		if(order != order_)
+			begin(order);
+		if(p->realCollisionBefore(terRealCollisionCount, order_) && terRealCollisionAllowed(unit_, p)){
+			const RigidBody* b = p->GetRigidBodyPoint();
+			MatXf X12 = b->matrix();
+			if(Position.distance2(X12.trans()) < sqr(Radius + b->radius())){
+				X12.invert();
+				X12.postmult(Matrix);
+				terUniverse::CollisionHit hit;
+				if(universe()->multiBodyDispatcher().detect(*BodyPoint, *b, X12, hit.penetration, hit.cp1, hit.cp2)){
+					hit.unit = p;
+					hits_.push_back(hit);
+					units_[order_].hitsEnd = hits_.size();
+				}
 			}
 		}
-		p->SetRealCollisionCount(terRealCollisionCount);
 	}
+};
+
+class terCollisionJob : public LogicJob
+{
+	terUniverse& universe_;
+public:
+	terCollisionJob(terUniverse& universe) : universe_(universe) {}
+	void execute(int chunk) { universe_.detectCollisions(chunk); }
+};
+
+void terUniverse::detectCollisions(int chunk)
+{
+	CollisionHitList& hits = collisionHits_[chunk];
+	hits.clear();
+
+	int begin = chunk*collisionChunkSize_;
+	int end = min(begin + collisionChunkSize_, (int)collisionQueries_.size());
+	terRealCollisionDetectOperator op(collisionUnits_, chunk, hits);
+	UnitGrid.ScanBatch(&collisionQueries_[begin], end - begin, op);
+}
+
+//       ,   .
+//   Collision()   ,   . Collision()
+//       ,     -
+//     .   
+//   : ,      Collision()
+// ( ,  ),     .
+//        (   
+//  ),   , terRealCollisionOperator.
+//       (   
+//   ),      
+//    -     .
+void terUniverse::CollisionQuant()
+{
+	start_timer_auto(CollisionQuant, STATISTICS_GROUP_LOGIC);
+
+	LogicJobDispatcher& dispatcher = LogicJobDispatcher::instance();
+	PlayerVect::iterator pi;
+	UnitList::iterator ui;
+
+	collisionUnits_.clear();
+	collisionQueries_.clear();
+	FOR_EACH(Players, pi)
+		FOR_EACH((*pi)->Units, ui){
+			terUnitBase* p = *ui;
+			int order = collisionUnits_.size();
+			p->SetRealCollisionOrder(terRealCollisionCount, order);
+			CollisionUnit cu;
+			cu.unit = p;
+			cu.chunk = 0;
+			cu.hitsBegin = cu.hitsEnd = 0;
+			collisionUnits_.push_back(cu);
+			if(p->alive() && (p->collisionGroup() & COLLISION_GROUP_REAL))
+				collisionQueries_.push_back(GridQuery(p->position2D().xi(), p->position2D().yi(), round(p->radius()), COLLISION_GROUP_REAL, order));
+		}
+
+	//     ,      
+	if(!collisionQueries_.empty())
+		UnitGrid.SortQueries(&collisionQueries_[0], collisionQueries_.size());
+
+	const int chunks_per_thread = 4;
+	int chunks = dispatcher.threads()*chunks_per_thread;
+	collisionChunkSize_ = max((int)(collisionQueries_.size() + chunks - 1)/chunks, 1);
+	chunks = (collisionQueries_.size() + collisionChunkSize_ - 1)/collisionChunkSize_;
+	if((int)collisionHits_.size() < chunks)
+		collisionHits_.resize(chunks);
+
+	{
+		start_timer_auto(CollisionDetect, STATISTICS_GROUP_LOGIC);
+		terCollisionJob job(*this);
+		dispatcher.run(job, chunks);
+	}
+
+	int index = 0;
+	bool snapshot = true;
+	FOR_EACH(Players, pi)
+		FOR_EACH((*pi)->Units, ui){
+			terUnitBase* p = *ui;
+			if(snapshot && (index >= (int)collisionUnits_.size() || collisionUnits_[index].unit != p))
+				snapshot = false;
+
+			if(p->alive() && (p->collisionGroup() & COLLISION_GROUP_REAL)){
+				if(snapshot){
+					const CollisionUnit& cu = collisionUnits_[index];
+					const CollisionHitList& hits = collisionHits_[cu.chunk];
+					for(int i = cu.hitsBegin; i < cu.hitsEnd; i++){
+						const CollisionHit& hit = hits[i];
+						if(terRealCollisionAllowed(p, hit.unit)){
+							multibody_dispatcher.pushContact(*p->GetRigidBodyPoint(), *hit.unit->GetRigidBodyPoint(), hit.penetration, hit.cp1, hit.cp2);
+							p->Collision(hit.unit);
+							hit.unit->Collision(p);
+						}
+					}
+				}
+				else{
+					int x = p->position2D().xi();
+					int y = p->position2D().yi();
+					int r = round(p->radius());
+					terRealCollisionOperator op(p);
+					UnitGrid.Scan(x, y, r, op);
+				}
+			}
+			p->SetRealCollisionCount(terRealCollisionCount);
+			index++;
+		}
 }
 
 //-----------------------------------------------------
@@ -1237,6 +1539,43 @@ void terUniverse::triggerQuant()
 		(*pi)->triggerQuant();
 }
 
+void terUniverse::calcQuantHash(QuantHash& hash)
+{
+	start_timer_auto(CalcQuantHash,STATISTICS_GROUP_TOTAL);
+
+	unsigned int& units = hash.crc[QUANT_HASH_UNITS];
+	unsigned int& regions = hash.crc[QUANT_HASH_REGIONS];
+	unsigned int& energy = hash.crc[QUANT_HASH_ENERGY];
+
+	PlayerVect::iterator pi;
+	FOR_EACH(Players, pi){
+		terPlayer* player = *pi;
+
+		const UnitList& unit_list = player->units();
+		UnitList::const_iterator ui;
+		FOR_EACH(unit_list, ui){
+			terUnitBase* unit = *ui;
+			unsigned int id = unit->unitID();
+			int alive_elements = unit->damageMolecula().aliveElementCount();
+			units = crc32((const unsigned char*)&id, sizeof(id), units);
+			units = crc32((const unsigned char*)&unit->position(), sizeof(Vect3f), units);
+			units = crc32((const unsigned char*)&alive_elements, sizeof(alive_elements), units);
+		}
+
+		// crc      
+		unsigned int region_crc;
+		{
+			MetaRegionLock lock(player->RegionPoint);
+			region_crc = player->RegionPoint->editingCRC();
+		}
+		regions = crc32((const unsigned char*)&region_crc, sizeof(region_crc), regions);
+
+		const terEnergyDataType& data = player->energyData();
+		float values[] = { data.produced(), data.used(), data.requested(), data.accumulated(), data.capacity(), data.returned() };
+		energy = crc32((const unsigned char*)values, sizeof(values), energy);
+	}
+}
+
 void terUniverse::clearLinkAndDelete()
 {
 	PlayerVect::iterator pi;
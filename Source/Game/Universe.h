@@ -17,6 +17,24 @@ typedef void(*PROGRESSCALLBACK)(float);
 
 typedef Grid2D<terUnitGeneric, 5, GridVector<terUnitGeneric, 8> > terUnitGridType;
 
+// terUniverse::benchmarkUnitGrid:  - ms   
+struct sUnitGridBench
+{
+	int units;
+	int queries; //   (  COLLISION_GROUP_REAL)
+	int hits; //   
+	int targets; //    
+	bool valid; //     ,   
+	double legacyCollision; //  ,    
+	double scanCollision; // Scan
+	double maskCollision; // ScanMask
+	double batchCollision; // SortQueries + ScanBatch
+	double legacyTargets;
+	double circleTargets; // ScanCircle
+
+	sUnitGridBench() { units = queries = hits = targets = 0; valid = true; legacyCollision = scanCollision = maskCollision = batchCollision = legacyTargets = circleTargets = 0; }
+};
+
 ///////////////////////////////////////
 //		 
 ///////////////////////////////////////
@@ -31,8 +49,10 @@ public:
 	void AvatarQuant();
 	void PrepareQuant();
 	void triggerQuant();
+	void calcQuantHash(QuantHash& hash);
 
-	bool universalSave(const MissionDescription& mission, bool userSave);
+	//background -   GameSaveWriter,   
+	bool universalSave(const MissionDescription& mission, bool userSave, bool background = false);
 	void relaxLoading();
 
 	void addLinkToResolve(const SaveUnitLink* link) { saveUnitLinks_.push_back(link); }
@@ -54,6 +74,12 @@ public:
 
 	void checkEvent(const class Event& event);
 
+	//    (  )  ,  :
+	//,    stamp,  ,  unitCountStamp(id) <= stamp
+	void changeUnitCount(terUnitAttributeID id) { unitCountStamps_[id] = ++unitCountStamp_; }
+	int unitCountStamp(terUnitAttributeID id) const { return unitCountStamps_[id]; }
+	int unitCountStamp() const { return unitCountStamp_; }
+
 	void ShowInfo();
 
 	void makeCommand(CommandID id, int data);
@@ -106,6 +132,13 @@ public:
 
 	MultiBodyDispatcher& multiBodyDispatcher() { return multibody_dispatcher; }
 
+	//      AI,    
+	DefenceMap& defenceMap(int clan);
+	bool hasDefenceMap(int clan) const { return defenceMaps_.find(clan) != defenceMaps_.end(); }
+
+	// UnitGrid       (grid_bench:<>)
+	void benchmarkUnitGrid(sUnitGridBench& result, int passes = 10, float search_radius = 300);
+
 	PlayerVect Players;
 	
 	terUnitGridType UnitGrid;
@@ -132,8 +165,12 @@ private:
 	
 	bool enableEventChecking_;
 
+	int unitCountStamp_;
+	int unitCountStamps_[UNIT_ATTRIBUTE_MAX];
+
 	int quant_counter_;
 	float interpolation_factor_;
+	int gridBenchQuant_;
 
 	bool fieldTransparent_;
 
@@ -156,6 +193,38 @@ private:
 	typedef vector<const SaveUnitLink*> SaveUnitLinkList;
 	SaveUnitLinkList saveUnitLinks_;
 
+	typedef map<int, DefenceMap*> DefenceMapTable;
+	DefenceMapTable defenceMaps_;
+
+	//-------------------------------
+	// CollisionQuant:      LogicJobDispatcher,
+	//  -     
+	struct CollisionHit
+	{
+		terUnitBase* unit;
+		float penetration;
+		Vect3f cp1, cp2;
+	};
+	typedef vector<CollisionHit> CollisionHitList;
+
+	struct CollisionUnit
+	{
+		terUnitBase* unit;
+		int chunk;
+		int hitsBegin, hitsEnd;
+	};
+	typedef vector<CollisionUnit> CollisionUnitList;
+
+	CollisionUnitList collisionUnits_;
+	vector<GridQuery> collisionQueries_; //UnitGrid.ScanBatch,   collisionChunkSize_
+	vector<CollisionHitList> collisionHits_;
+	int collisionChunkSize_;
+
+	void CollisionQuant();
+	void detectCollisions(int chunk);
+	friend class terCollisionJob;
+	friend struct terRealCollisionDetectOperator;
+
 	static terUniverse* universe_;
 
 	//-------------------------------
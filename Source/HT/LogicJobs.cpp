@@ -0,0 +1,113 @@
+#include "StdAfx.h"
+#include "LogicJobs.h"
+#include <process.h>
+
+unsigned __stdcall logic_job_thread(void* argument)
+{
+	tls_is_graph = MT_LOGIC_JOB_THREAD;
+	((LogicJobDispatcher*)argument)->workerLoop();
+	return 0;
+}
+
+LogicJobDispatcher::LogicJobDispatcher()
+{
+	job_ = 0;
+	jobs_ = 0;
+	next_index_ = 0;
+	active_workers_ = 0;
+	exit_ = false;
+	serial_ = check_command_line("logic_serial") != 0;
+
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	//   -  ,   - 
+	int workers = (int)info.dwNumberOfProcessors - 2;
+	check_command_line_parameter("logic_threads:", workers);
+	if(workers < 0)
+		workers = 0;
+
+	start_semaphore_ = CreateSemaphore(0, 0, max(workers, 1), 0);
+	done_event_ = CreateEvent(0, FALSE, FALSE, 0);
+
+	for(int i = 0; i < workers; i++){
+		unsigned thread_id;
+		HANDLE thread = (HANDLE)_beginthreadex(0, 1000000, logic_job_thread, this, 0, &thread_id);
+		if(!thread)
+			break;
+		SetThreadPriority(thread, THREAD_PRIORITY_ABOVE_NORMAL);
+		workers_.push_back(thread);
+	}
+}
+
+LogicJobDispatcher::~LogicJobDispatcher()
+{
+	exit_ = true;
+	if(!workers_.empty()){
+		ReleaseSemaphore(start_semaphore_, workers_.size(), 0);
+		WaitForMultipleObjects(workers_.size(), &workers_[0], TRUE, INFINITE);
+	}
+
+	vector<HANDLE>::iterator i;
+	FOR_EACH(workers_, i)
+		CloseHandle(*i);
+
+	CloseHandle(start_semaphore_);
+	CloseHandle(done_event_);
+}
+
+LogicJobDispatcher& LogicJobDispatcher::instance()
+{
+	static LogicJobDispatcher dispatcher;
+	return dispatcher;
+}
+
+void LogicJobDispatcher::run(LogicJob& job, int jobs)
+{
+	MTL();
+	if(jobs <= 0)
+		return;
+
+	if(serial() || jobs == 1){
+		for(int i = 0; i < jobs; i++)
+			job.execute(i);
+		return;
+	}
+
+	job_ = &job;
+	jobs_ = jobs;
+	next_index_ = 0;
+	active_workers_ = workers_.size();
+	ReleaseSemaphore(start_semaphore_, workers_.size(), 0);
+
+	execute();
+
+	DWORD ret = WaitForSingleObject(done_event_, INFINITE);
+	xassert(ret == WAIT_OBJECT_0);
+	job_ = 0;
+}
+
+void LogicJobDispatcher::execute()
+{
+	for(;;){
+		int index = InterlockedIncrement(&next_index_) - 1;
+		if(index >= jobs_)
+			break;
+		job_->execute(index);
+	}
+}
+
+void LogicJobDispatcher::workerLoop()
+{
+	for(;;){
+		WaitForSingleObject(start_semaphore_, INFINITE);
+		if(exit_)
+			break;
+
+		//        -  
+		//    ,  active_workers_   .
+		execute();
+
+		if(!InterlockedDecrement(&active_workers_))
+			SetEvent(done_event_);
+	}
+}
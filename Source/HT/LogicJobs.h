@@ -0,0 +1,56 @@
+#pragma once
+/*
+     .
+
+ -      0..jobs-1.
+LogicJob::execute       (  ),
+       ,
+          .
+   MT_LOGIC_JOB_THREAD:    
+ (MTL())  execute  .
+
+  :
+	logic_serial -      (  )
+	logic_threads:N -    (   - 2)
+*/
+
+class LogicJob
+{
+public:
+	virtual void execute(int index) = 0;
+};
+
+class LogicJobDispatcher
+{
+public:
+	LogicJobDispatcher();
+	~LogicJobDispatcher();
+
+	// job.execute(0..jobs-1), ,   .
+	//    .
+	void run(LogicJob& job, int jobs);
+
+	bool serial() const { return serial_ || workers_.empty(); }
+	void setSerial(bool serial) { serial_ = serial; }
+
+	//     
+	int threads() const { return serial() ? 1 : workers_.size() + 1; }
+
+	static LogicJobDispatcher& instance();
+
+private:
+	vector<HANDLE> workers_;
+	HANDLE start_semaphore_;
+	HANDLE done_event_;
+
+	LogicJob* job_;
+	int jobs_;
+	volatile LONG next_index_;
+	volatile LONG active_workers_;
+	volatile bool exit_;
+	bool serial_;
+
+	void execute();
+	void workerLoop();
+	friend unsigned __stdcall logic_job_thread(void* argument);
+};
@@ -20,280 +20,275 @@ UpdateVertex - 
 
 StreamInterpolator stream_interpolator;
 
-#define INERROR() xassert(in_avatar);
+void InterpolationFrame::clear()
+{
+	sprites.clear();
+	lines.clear();
+	poses.clear();
+	phases.clear();
+	angles.clear();
+	colors.clear();
+	diffuse_colors.clear();
+	particle_rates.clear();
+}
+
+int InterpolationFrame::size() const
+{
+	return sprites.size()+lines.size()+poses.size()+phases.size()+
+		angles.size()+colors.size()+diffuse_colors.size()+particle_rates.size();
+}
 
 StreamInterpolator::StreamInterpolator()
 {
-	MTINIT(lock);
+	write_frame=0;
+	ready_frame=1;
+	read_frame=2;
 	in_avatar=false;
+	write_quant=0;
+	records=0;
+	for(int i=0;i<FRAMES;i++)
+		frames[i].quant=0;
 }
 
 StreamInterpolator::~StreamInterpolator()
 {
-	MTDONE(lock);
 }
 
-StreamInterpolator& StreamInterpolator::set(InterpolateFunction func,cIUnkClass* obj)
+void StreamInterpolator::BeginWrite(int quant)
 {
-	INERROR();
-	int sz=stream.size();
-	xassert(sizeof(func)==4);
-	stream.resize(sz+sizeof(func)+sizeof(obj));
-	char* pos=&stream[sz];
-	(*(InterpolateFunction*)pos)=func;
-	pos+=sizeof(func);
-	(*(cIUnkClass**)pos)=obj;
-	return *this;
+	xassert(!in_avatar);
+	in_avatar=true;
+	write_quant=quant;
+	frames[write_frame].clear();
 }
 
-StreamInterpolator& StreamInterpolator::operator<<(Vect3f f[2])
+void StreamInterpolator::EndWrite()
 {
-	INERROR();
-	int sz=stream.size();
-	stream.resize(sz+sizeof(f[0])*2);
-	char* pos=&stream[sz];
-	((Vect3f*)pos)[0]=f[0];
-	((Vect3f*)pos)[1]=f[1];
-	return *this;
+	xassert(in_avatar);
+	in_avatar=false;
+	records=frames[write_frame].size();
+	Publish();
 }
 
-StreamInterpolator& StreamInterpolator::operator<<(Se3f f[2])
+void StreamInterpolator::Publish()
 {
-	INERROR();
-	int sz=stream.size();
-	stream.resize(sz+sizeof(f[0])*2);
-	char* pos=&stream[sz];
-	((Se3f*)pos)[0]=f[0];
-	((Se3f*)pos)[1]=f[1];
-	return *this;
+	//  ,   ,   .
+	//     -   .
+	frames[write_frame].quant=write_quant;
+	write_frame=InterlockedExchange(&ready_frame,write_frame|FRAME_FRESH)&FRAME_MASK;
+	frames[write_frame].clear();
 }
 
-StreamInterpolator& StreamInterpolator::operator<<(float f[2])
+void StreamInterpolator::ClearData()
 {
-	INERROR();
-	int sz=stream.size();
-	stream.resize(sz+sizeof(f[0])*2);
-	char* pos=&stream[sz];
-	((float*)pos)[0]=f[0];
-	((float*)pos)[1]=f[1];
-	return *this;
+	//   ,   AvatarQuant:
+	//       ProcessData
+	frames[write_frame].clear();
+	Publish();
+	records=0;
 }
 
-StreamInterpolator& StreamInterpolator::operator<<(sColor4c f[2])
+void StreamInterpolator::AddSprite(cIUnkObj* obj,const Vect3f x[2])
 {
-	INERROR();
-	int sz=stream.size();
-	stream.resize(sz+sizeof(f[0])*2);
-	char* pos=&stream[sz];
-	((sColor4c*)pos)[0]=f[0];
-	((sColor4c*)pos)[1]=f[1];
-	return *this;
+	out().sprites.push_back(sInterpolateSprite());
+	sInterpolateSprite& r=out().sprites.back();
+	r.object=obj;
+	r.x[0]=x[0];
+	r.x[1]=x[1];
 }
 
-StreamInterpolator& StreamInterpolator::operator<<(sColor4f f[2])
+void StreamInterpolator::AddLine(cIUnkObj* obj,const Vect3f x0[2],const Vect3f x1[2])
 {
-	INERROR();
-	int sz=stream.size();
-	stream.resize(sz+sizeof(f[0])*2);
-	char* pos=&stream[sz];
-	((sColor4f*)pos)[0]=f[0];
-	((sColor4f*)pos)[1]=f[1];
-	return *this;
+	out().lines.push_back(sInterpolateLine());
+	sInterpolateLine& r=out().lines.back();
+	r.object=obj;
+	r.x0[0]=x0[0];
+	r.x0[1]=x0[1];
+	r.x1[0]=x1[0];
+	r.x1[1]=x1[1];
 }
 
-StreamInterpolator& StreamInterpolator::operator<<(sColorInterpolate f[2])
+void StreamInterpolator::AddPose(cIUnkObj* obj,const Se3f x[2])
 {
-	INERROR();
-	int sz=stream.size();
-	stream.resize(sz+sizeof(f[0])*2);
-	char* pos=&stream[sz];
-	((sColorInterpolate*)pos)[0]=f[0];
-	((sColorInterpolate*)pos)[1]=f[1];
-	return *this;
+	out().poses.push_back(sInterpolatePose());
+	sInterpolatePose& r=out().poses.back();
+	r.object=obj;
+	r.x[0]=x[0];
+	r.x[1]=x[1];
 }
 
-StreamInterpolator& StreamInterpolator::operator<<(int f)
+void StreamInterpolator::AddPhase(cIUnkObj* obj,const float x[2],int recursive)
 {
-	INERROR();
-	int sz=stream.size();
-	stream.resize(sz+sizeof(f));
-	char* pos=&stream[sz];
-	(*(int*)pos)=f;
-	return *this;
+	out().phases.push_back(sInterpolatePhase());
+	sInterpolatePhase& r=out().phases.back();
+	r.object=obj;
+	r.x[0]=x[0];
+	r.x[1]=x[1];
+	r.recursive=recursive;
 }
 
-void StreamInterpolator::ClearData()
+void StreamInterpolator::AddAngle(cIUnkObj* obj,const float x[2],eAxis axis)
 {
-/*	
-	Lock();
-	timer=HTManager::instance()->interpolationFactor();
-	timer_=1-timer;
-	char* front=&stream[0];
-	char* cur=front;
-	int size=stream.size();
-	char* end=front+size;
-	int sz=0;
-	while(cur<end)
-	{
-		InterpolateFunction func=*(InterpolateFunction*)cur;
-		cur+=4;
-		cIUnkObj* cur_object=*(cIUnkObj**)cur;
-		cur+=4;
-		int sz=func(cur_object,cur);
-		if(func==fSe3fInterpolation)
-		{
-			cur_object->ClearAttr(ATTRUNKOBJ_TEMP_USED);
-		}
-
-		cur+=sz;
-		
-	}
-
-	xassert(cur-front==size);
-	Unlock();
-*/
-	stream.clear();
+	out().angles.push_back(sInterpolateAngle());
+	sInterpolateAngle& r=out().angles.back();
+	r.object=obj;
+	r.x[0]=x[0];
+	r.x[1]=x[1];
+	r.axis=axis;
 }
 
-void StreamInterpolator::ProcessData()
+void StreamInterpolator::AddColor(cIUnkObj* obj,const sColorInterpolate x[2])
 {
-	Lock();
-	timer=HTManager::instance()->interpolationFactor();
-	timer_=1-timer;
-	int size=stream.size();
-	if(size)
-	{
-		char* front=&stream[0];
-		char* cur=front;
-		char* end=front+size;
-		int sz=0;
-		while(cur<end)
-		{
-			InterpolateFunction func=*(InterpolateFunction*)cur;
-			cur+=4;
-			cIUnkObj* cur_object=*(cIUnkObj**)cur;
-			cur+=4;
-			int sz=func(cur_object,cur);
-			cur+=sz;
-			
-		}
-		xassert(cur-front==size);
-	}
-
-	Unlock();
+	out().colors.push_back(sInterpolateColor());
+	sInterpolateColor& r=out().colors.back();
+	r.object=obj;
+	r.x[0]=x[0];
+	r.x[1]=x[1];
 }
 
-/////////////////////////////////////////////////////////////
-int fSpriteInterpolation(cIUnkObj* cur,void* data)
+void StreamInterpolator::AddColorDiffuse(cIUnkObj* obj,const sColor4f x[2])
 {
-	Vect3f* p=(Vect3f*)data;
-	Vect3f out;
-	out.x=p[0].x*timer_+p[1].x*timer;
-	out.y=p[0].y*timer_+p[1].y*timer;
-	out.z=p[0].z*timer_+p[1].z*timer;
-
-	((cSprite*)cur)->SetPos(out);
-
-	return sizeof(Vect3f)*2;
+	out().diffuse_colors.push_back(sInterpolateColorDiffuse());
+	sInterpolateColorDiffuse& r=out().diffuse_colors.back();
+	r.object=obj;
+	r.x[0]=x[0];
+	r.x[1]=x[1];
 }
 
-int fLineInterpolation(cIUnkObj* cur,void* data)
+void StreamInterpolator::AddParticleRate(cIUnkObj* obj,const float x[2])
 {
-	Vect3f* p=(Vect3f*)data;
-
-	Vect3f x0 = p[0];
-	Vect3f x1 = p[1];
-
-	Vect3f out[2];
-
-	out[0].x=x0.x*timer_+x1.x*timer;
-	out[0].y=x0.y*timer_+x1.y*timer;
-	out[0].z=x0.z*timer_+x1.z*timer;
-
-	x0 = p[2];
-	x1 = p[3];
-
-	out[1].x=x0.x*timer_+x1.x*timer;
-	out[1].y=x0.y*timer_+x1.y*timer;
-	out[1].z=x0.z*timer_+x1.z*timer;
-
-	((cLine3d*)cur)->UpdateVertexPos(2,out);
-
-	return sizeof(Vect3f)*4;
+	out().particle_rates.push_back(sInterpolateParticleRate());
+	sInterpolateParticleRate& r=out().particle_rates.back();
+	r.object=obj;
+	r.x[0]=x[0];
+	r.x[1]=x[1];
 }
 
-int fParticleRateInterpolation(cIUnkObj* cur,void* data)
+/////////////////////////////////////////////////////////////
+static void interpolateSprites(const vector<sInterpolateSprite>& lst)
 {
-	float* f=(float*)data;
-	cEffect* eff=(cEffect*)cur;
-	float rate=f[0]*timer_+f[1]*timer;
-	eff->SetParticleRate(rate);
-	return sizeof(float)*2;
+	vector<sInterpolateSprite>::const_iterator it;
+	FOR_EACH(lst,it)
+	{
+		const Vect3f* p=it->x;
+		Vect3f out;
+		out.x=p[0].x*timer_+p[1].x*timer;
+		out.y=p[0].y*timer_+p[1].y*timer;
+		out.z=p[0].z*timer_+p[1].z*timer;
+		((cSprite*)it->object)->SetPos(out);
+	}
 }
 
-int fSe3fInterpolation(cIUnkObj* cur,void* data)
+static void interpolateLines(const vector<sInterpolateLine>& lst)
 {
-	Se3f* p=(Se3f*)data;
-	Se3f s;
-	s.trans().interpolate(p[0].trans(), p[1].trans(), timer);
-	s.rot().slerp(p[0].rot(), p[1].rot(), timer);
-	MatXf m(s);
+	vector<sInterpolateLine>::const_iterator it;
+	FOR_EACH(lst,it)
+	{
+		Vect3f out[2];
+		out[0].x=it->x0[0].x*timer_+it->x0[1].x*timer;
+		out[0].y=it->x0[0].y*timer_+it->x0[1].y*timer;
+		out[0].z=it->x0[0].z*timer_+it->x0[1].z*timer;
 
-	cur->SetPosition(m);
+		out[1].x=it->x1[0].x*timer_+it->x1[1].x*timer;
+		out[1].y=it->x1[0].y*timer_+it->x1[1].y*timer;
+		out[1].z=it->x1[0].z*timer_+it->x1[1].z*timer;
 
-	return sizeof(Se3f)*2;
+		((cLine3d*)it->object)->UpdateVertexPos(2,out);
+	}
 }
 
-int fPhaseInterpolation(cIUnkObj* cur,void* data)
+static void interpolatePoses(const vector<sInterpolatePose>& lst)
 {
-	float* p=(float*)data;
-	int recursive=*(int*)(p+2);
-	cObjectNode* node=(cObjectNode*)cur;
-	static float eps1=1+FLT_EPS;
-	float phase = cycle(p[0] + getDist(p[1], p[0], eps1)*timer, eps1);
-	node->SetPhase(phase,recursive?true:false);
-	return sizeof(float)*2+sizeof(int);
+	vector<sInterpolatePose>::const_iterator it;
+	FOR_EACH(lst,it)
+	{
+		const Se3f* p=it->x;
+		Se3f s;
+		s.trans().interpolate(p[0].trans(), p[1].trans(), timer);
+		s.rot().slerp(p[0].rot(), p[1].rot(), timer);
+		MatXf m(s);
+		it->object->SetPosition(m);
+	}
 }
 
-int fAngleInterpolation(cIUnkObj* cur,void* data)
+static void interpolatePhases(const vector<sInterpolatePhase>& lst)
 {
-	float* p=(float*)data;
-	eAxis axis=(eAxis)*(int*)(p+2);
-	cObjectNode* node=(cObjectNode*)cur;
+	static float eps1=1+FLT_EPS;
+	vector<sInterpolatePhase>::const_iterator it;
+	FOR_EACH(lst,it)
+	{
+		const float* p=it->x;
+		float phase = cycle(p[0] + getDist(p[1], p[0], eps1)*timer, eps1);
+		((cObjectNode*)it->object)->SetPhase(phase,it->recursive?true:false);
+	}
+}
 
-//	float angle=p[0]*timer_+p[1]*timer;
+static void interpolateAngles(const vector<sInterpolateAngle>& lst)
+{
 	static float M_PI2=2*M_PI;
-	float angle=cycle(p[0] + getDist(p[1], p[0], M_PI2)*timer, M_PI2);
-	node->SetRotate(&Mat3f(angle,axis));
-
-	return sizeof(float)*2+sizeof(int);
+	vector<sInterpolateAngle>::const_iterator it;
+	FOR_EACH(lst,it)
+	{
+		const float* p=it->x;
+		float angle=cycle(p[0] + getDist(p[1], p[0], M_PI2)*timer, M_PI2);
+		((cObjectNode*)it->object)->SetRotate(&Mat3f(angle,it->axis));
+	}
 }
 
-int fFloatInterpolation(cIUnkObj* cur,void* data)
+static void interpolateColors(const vector<sInterpolateColor>& lst)
 {
-	return sizeof(float)*2;
+	vector<sInterpolateColor>::const_iterator it;
+	FOR_EACH(lst,it)
+	{
+		sColor4f color,add_color;
+		color.interpolate(it->x[0].color,it->x[1].color,timer);
+		add_color.interpolate(it->x[0].add_color,it->x[1].add_color,timer);
+		((cObjectNode*)it->object)->SetColor(&add_color,&color,&add_color);
+	}
 }
 
-int fColorInterpolation(cIUnkObj* cur,void* data)
+static void interpolateDiffuseColors(const vector<sInterpolateColorDiffuse>& lst)
 {
-	sColorInterpolate* p=(sColorInterpolate*)data;
-	cObjectNode* node=(cObjectNode*)cur;
+	vector<sInterpolateColorDiffuse>::const_iterator it;
+	FOR_EACH(lst,it)
+	{
+		sColor4f color;
+		color.interpolate(it->x[0],it->x[1],timer);
+		((cObjectNode*)it->object)->SetColor(NULL,&color,NULL);
+	}
+}
 
-	sColor4f color,add_color;
-	color.interpolate(p[0].color,p[1].color,timer);
-	add_color.interpolate(p[0].add_color,p[1].add_color,timer);
-	node->SetColor(&add_color,&color,&add_color);
+static void interpolateParticleRates(const vector<sInterpolateParticleRate>& lst)
+{
+	vector<sInterpolateParticleRate>::const_iterator it;
+	FOR_EACH(lst,it)
+	{
+		float rate=it->x[0]*timer_+it->x[1]*timer;
+		((cEffect*)it->object)->SetParticleRate(rate);
+	}
+}
 
-	return sizeof(sColorInterpolate)*2;
+int StreamInterpolator::AcquireFrame()
+{
+	//  ,    , 
+	//    timer
+	if(ready_frame&FRAME_FRESH)
+		read_frame=InterlockedExchange(&ready_frame,read_frame)&FRAME_MASK;
+	return frames[read_frame].quant;
 }
 
-int fColorDiffuseInterpolation(cIUnkObj* cur,void* data)
+void StreamInterpolator::ProcessData()
 {
-	sColor4f* p=(sColor4f*)data;
-	cObjectNode* node=(cObjectNode*)cur;
-	sColor4f color;
-	color.interpolate(p[0],p[1],timer);
-	node->SetColor(NULL,&color,NULL);
+	timer=HTManager::instance()->interpolationFactor();
+	timer_=1-timer;
 
-	return sizeof(sColor4f)*2;
+	const InterpolationFrame& frame=frames[read_frame];
+	interpolateSprites(frame.sprites);
+	interpolateLines(frame.lines);
+	interpolatePoses(frame.poses);
+	interpolatePhases(frame.phases);
+	interpolateAngles(frame.angles);
+	interpolateColors(frame.colors);
+	interpolateDiffuseColors(frame.diffuse_colors);
+	interpolateParticleRates(frame.particle_rates);
 }
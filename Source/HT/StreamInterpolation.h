@@ -1,14 +1,14 @@
 #pragma once
 /*
   .
-  -   .
-int command(void* data);
-    data,
-  .
+  (AvatarQuant)    BeginWrite  EndWrite,
+       .
+     - ProcessData 
+   ,      .
+ :   ,   ,  
+ -     .
 */
 
-typedef int (*InterpolateFunction)(cIUnkObj* cur,void* data);
-
 struct sColorInterpolate
 {
 	sColor4f color,add_color;
@@ -20,41 +20,118 @@ struct sAngleInterpolate
 	eAxis axis;
 };
 
+struct sInterpolateSprite
+{
+	cIUnkObj* object;
+	Vect3f x[2];
+};
+
+struct sInterpolateLine
+{
+	cIUnkObj* object;
+	Vect3f x0[2],x1[2];
+};
+
+struct sInterpolatePose
+{
+	cIUnkObj* object;
+	Se3f x[2];
+};
+
+struct sInterpolatePhase
+{
+	cIUnkObj* object;
+	float x[2];
+	int recursive;
+};
+
+struct sInterpolateAngle
+{
+	cIUnkObj* object;
+	float x[2];
+	eAxis axis;
+};
+
+struct sInterpolateColor
+{
+	cIUnkObj* object;
+	sColorInterpolate x[2];
+};
+
+struct sInterpolateColorDiffuse
+{
+	cIUnkObj* object;
+	sColor4f x[2];
+};
+
+struct sInterpolateParticleRate
+{
+	cIUnkObj* object;
+	float x[2];
+};
+
+//    
+struct InterpolationFrame
+{
+	vector<sInterpolateSprite> sprites;
+	vector<sInterpolateLine> lines;
+	vector<sInterpolatePose> poses;
+	vector<sInterpolatePhase> phases;
+	vector<sInterpolateAngle> angles;
+	vector<sInterpolateColor> colors;
+	vector<sInterpolateColorDiffuse> diffuse_colors;
+	vector<sInterpolateParticleRate> particle_rates;
+	int quant;// ,  
+
+	//    -      
+	void clear();
+	int size() const;
+};
+
 class StreamInterpolator
 {
-	vector<char> stream;
-	MTDECLARE(lock);
+	enum {
+		FRAMES=3,
+		FRAME_MASK=3,
+		FRAME_FRESH=4//ready_frame      
+	};
+
+	InterpolationFrame frames[FRAMES];
+	int write_frame;// 
+	int read_frame;// 
+	volatile LONG ready_frame;
 	bool in_avatar;
+	int write_quant;//,    
+	int records;
+
+	InterpolationFrame& out(){xassert(in_avatar); return frames[write_frame];}
+	void Publish();
 public:
 	StreamInterpolator();
 	~StreamInterpolator();
-	void Init(){stream.clear();}
-	void ProcessData();
-	void ClearData();
 
-	void Lock(){MTENTER(lock);};
-	void Unlock(){MTLEAVE(lock);};
+	//:     
+	void BeginWrite(int quant);
+	void EndWrite();
+	//     
+	int GetRecords()const{return records;}
 
-	void SetInAvatar(bool in){in_avatar=in;}
+	//:    ,   .
+	//  ,     
+	int AcquireFrame();
+	//:   
+	void ProcessData();
+	//  -  ProcessData    
+	void ClearData();
 
-	StreamInterpolator& set(InterpolateFunction func,cIUnkClass* obj);
-	StreamInterpolator& operator<<(Vect3f f[2]);
-	StreamInterpolator& operator<<(Se3f f[2]);
-	StreamInterpolator& operator<<(float f[2]);
-	StreamInterpolator& operator<<(sColor4c f[2]);
-	StreamInterpolator& operator<<(sColor4f f[2]);
-	StreamInterpolator& operator<<(int f);
-	StreamInterpolator& operator<<(sColorInterpolate f[2]);
+	void AddSprite(cIUnkObj* obj,const Vect3f x[2]);
+	void AddLine(cIUnkObj* obj,const Vect3f x0[2],const Vect3f x1[2]);
+	void AddPose(cIUnkObj* obj,const Se3f x[2]);
+	void AddPhase(cIUnkObj* obj,const float x[2],int recursive);
+	void AddAngle(cIUnkObj* obj,const float x[2],eAxis axis);
+	void AddColor(cIUnkObj* obj,const sColorInterpolate x[2]);
+	void AddColorDiffuse(cIUnkObj* obj,const sColor4f x[2]);
+	void AddParticleRate(cIUnkObj* obj,const float x[2]);
 };
 
 extern StreamInterpolator stream_interpolator;
-
-int fSpriteInterpolation(cIUnkObj* cur,void* data);
-int fLineInterpolation(cIUnkObj* cur,void* data);
-int fSe3fInterpolation(cIUnkObj* cur,void* data);
-int fPhaseInterpolation(cIUnkObj* cur,void* data);
-int fAngleInterpolation(cIUnkObj* cur,void* data);
-int fFloatInterpolation(cIUnkObj* cur,void* data);
-int fColorInterpolation(cIUnkObj* cur,void* data);
-int fColorDiffuseInterpolation(cIUnkObj* cur,void* data);
-int fParticleRateInterpolation(cIUnkObj* cur,void* data);
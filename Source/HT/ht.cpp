@@ -5,6 +5,7 @@
 #include "StreamInterpolation.h"
 #include "GenericControls.h"
 #include "Config.h"
+#include "Runtime.h"
 #include "universe.h"
 #include "LagStatistic.h"
 
@@ -35,6 +36,12 @@ HTManager::HTManager(bool ht)
 	start_timer=false;
 	dtime=100;
 	time=0;
+
+	headless_quants=0;
+	headless_quant_limit=0;
+	headless_time=0;
+	check_command_line_parameter("headless_quants", headless_quant_limit);
+
 	init();
 }
 
@@ -176,6 +183,9 @@ bool HTManager::Quant()
 		GameStart(missionToStart_);
 	}
 
+	if(terHeadless)
+		return HeadlessQuant();
+
 	if(use_ht)
 	{
 		if(init_logic)
@@ -234,6 +244,43 @@ bool HTManager::Quant()
 	return gameShell->GameContinue;
 }
 
+bool HTManager::HeadlessQuant()
+{
+	//    -    ,
+	// ClearDeleteUnit   
+	tls_is_graph=MT_LOGIC_THREAD|MT_GRAPH_THREAD;
+	gameShell->NetQuant();
+
+	double quant_time=clockf();
+	if(LogicQuant()){
+		headless_time+=clockf()-quant_time;
+		headless_quants++;
+		if(universe())
+			terVisGeneric->SetGraphLogicQuant(universe()->quantCounter());
+	}
+	else
+		Sleep(1); //    
+
+	gameShell->NetQuant();
+	tls_is_graph=MT_GRAPH_THREAD;
+
+	if(universe() && (universe()->replayFinished() || (headless_quant_limit && headless_quants>=headless_quant_limit)))
+		gameShell->GameContinue=false;
+
+	if(!gameShell->GameContinue)
+		HeadlessReport();
+	return gameShell->GameContinue;
+}
+
+void HTManager::HeadlessReport()
+{
+	statistics_add(headlessQuants, STATISTICS_GROUP_NUMERIC, headless_quants);
+	if(headless_time > 0)
+		statistics_add(headlessQuantsPerSecond, STATISTICS_GROUP_NUMERIC, headless_quants*1000./headless_time);
+	if(universe())
+		statistics_add(headlessSignature, STATISTICS_GROUP_NUMERIC, universe()->lastQuantSignature());
+}
+
 void HTManager::DeleteUnit(terUnitBase* unit)
 {
 	MTL();
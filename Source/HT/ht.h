@@ -49,6 +49,13 @@ protected:
 	bool LogicQuant();
 	void GraphQuant();
 
+	//terHeadless:   ,  
+	bool HeadlessQuant();
+	void HeadlessReport();
+	int headless_quants;
+	int headless_quant_limit; //0 -     
+	double headless_time;
+
 	bool use_ht;
 	cFont* pDefaultFont;
 	void init();
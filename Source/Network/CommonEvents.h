@@ -105,6 +105,12 @@ enum terEventID
 	NETCOM_4C_ID_CLIENT_IS_NOT_RESPONCE,
 
 	EVENT_ID_SERVER_TIME_CONTROL,
+
+	//  -   ,     
+	NETCOM_4C_ID_QUANT_COMMANDS,
+	NETCOM_4H_ID_REQUEST_QUANT_COMMANDS,
+	NETCOM_4C_ID_REQUEST_QUANT_HASHES,
+	NETCOM_4H_ID_QUANT_HASHES,
 };
 
 //-------------------------------
@@ -163,6 +169,10 @@ public:
 	bool operator == (const netCommandGame &secop) const;
 };
 
+inline bool isGameCommand(int id){
+	return id==NETCOM_4G_ID_UNIT_COMMAND || id==NETCOM_4G_ID_REGION || id==NETCOM_4G_ID_FORCED_DEFEAT;
+}
+
 // !    "" 
 class netCommand4G_ForcedDefeat : public netCommandGame
 {
@@ -299,6 +309,58 @@ public:
 	unsigned char* pData_;
 };
 
+//     ,   QuantCommandCodec.
+//     - records_    ,
+//        .
+struct netCommand4C_QuantCommands : public netCommandGeneral
+{
+	unsigned int quant_;
+	unsigned int baseQuant_; // ,    , 0 -  
+	unsigned int count_;
+	unsigned int size_;
+	const char* records_;
+
+	netCommand4C_QuantCommands(unsigned int quant, unsigned int baseQuant, unsigned int count, const char* records, unsigned int size) : netCommandGeneral(NETCOM_4C_ID_QUANT_COMMANDS) {
+		quant_=quant;
+		baseQuant_=baseQuant;
+		count_=count;
+		records_=records;
+		size_=size;
+	}
+	netCommand4C_QuantCommands(XBuffer& in) : netCommandGeneral(NETCOM_4C_ID_QUANT_COMMANDS) {
+		in.read(&quant_, sizeof(quant_));
+		in.read(&baseQuant_, sizeof(baseQuant_));
+		in.read(&count_, sizeof(count_));
+		in.read(&size_, sizeof(size_));
+		xassert(size_ <= in.length() - in.tell());
+		records_=in.address() + in.tell();
+		in.set(size_, XB_CUR);
+	}
+	void Write(XBuffer& out) const {
+		out.write(&quant_, sizeof(quant_));
+		out.write(&baseQuant_, sizeof(baseQuant_));
+		out.write(&count_, sizeof(count_));
+		out.write(&size_, sizeof(size_));
+		out.write(records_, size_);
+	}
+};
+
+//    ,     :
+//  ,    
+struct netCommand4H_RequestQuantCommands : netCommandGeneral
+{
+	unsigned int lastQuant_;
+	netCommand4H_RequestQuantCommands(unsigned int lastQuant) : netCommandGeneral(NETCOM_4H_ID_REQUEST_QUANT_COMMANDS) {
+		lastQuant_=lastQuant;
+	}
+	netCommand4H_RequestQuantCommands(XBuffer& in) : netCommandGeneral(NETCOM_4H_ID_REQUEST_QUANT_COMMANDS) {
+		in.read(&lastQuant_, sizeof(lastQuant_));
+	}
+	void Write(XBuffer& out) const {
+		out.write(&lastQuant_, sizeof(lastQuant_));
+	}
+};
+
 ////////////////////////////////////
 //CHAT
 class netCommand4G_ChatMessage : public netCommandGeneral
@@ -410,12 +472,33 @@ public:
 
 
 
+//, CRC     (terHyperSpace::logQuant)
+enum QuantHashSubsystem {
+	QUANT_HASH_LOG,		//net_log_buffer,   NetLog
+	QUANT_HASH_UNITS,	// : id, , 
+	QUANT_HASH_WORLD,	//vMap.getWorldCRC
+	QUANT_HASH_REGIONS,	//  (RegionPoint)
+	QUANT_HASH_ENERGY,	// 
+	QUANT_HASH_MAX
+};
+
+struct QuantHash {
+	unsigned int quant;
+	unsigned int crc[QUANT_HASH_MAX];
+
+	static const char* subsystemName(int subsystem){
+		static const char* names[QUANT_HASH_MAX] = { "log", "units", "world", "regions", "energy" };
+		return subsystem >= 0 && subsystem < QUANT_HASH_MAX ? names[subsystem] : "unknown";
+	}
+};
+
 struct netCommand4H_BackGameInformation2 : public netCommandGeneral {
 public:
-	netCommand4H_BackGameInformation2 (unsigned int lagQuant, unsigned int quant, unsigned int signature, bool replay=0, int state=0) : netCommandGeneral(NETCOM_4H_ID_BACK_GAME_INFORMATION_2){
+	netCommand4H_BackGameInformation2 (unsigned int lagQuant, unsigned int quant, unsigned int signature, const unsigned int subsystemSignature[QUANT_HASH_MAX], bool replay=0, int state=0) : netCommandGeneral(NETCOM_4H_ID_BACK_GAME_INFORMATION_2){
 		lagQuant_=lagQuant;
 		quant_=quant;
 		signature_=signature;
+		memcpy(subsystemSignature_, subsystemSignature, sizeof(subsystemSignature_));
 		replay_=replay;
 		state_=state;
 	}
@@ -423,6 +506,7 @@ public:
 		in.read(&lagQuant_, sizeof(lagQuant_));
 		in.read(&quant_, sizeof(quant_));
 		in.read(&signature_, sizeof(signature_));
+		in.read(subsystemSignature_, sizeof(subsystemSignature_));
 		in.read(&replay_, sizeof(replay_));
 		in.read(&state_, sizeof(state_));
 	}
@@ -431,6 +515,7 @@ public:
 		out.write(&lagQuant_, sizeof(lagQuant_));
 		out.write(&quant_, sizeof(quant_));
 		out.write(&signature_, sizeof(signature_));
+		out.write(subsystemSignature_, sizeof(subsystemSignature_));
 		out.write(&replay_, sizeof(replay_));
 		out.write(&state_, sizeof(state_));
 	}
@@ -442,11 +527,48 @@ public:
 	}
 	unsigned int lagQuant_;
 	unsigned int quant_;
-	unsigned int signature_;
+	unsigned int signature_; //CRC    
+	unsigned int subsystemSignature_[QUANT_HASH_MAX]; //CRC   
 	unsigned int replay_;
 	unsigned int state_;
 };
 
+//    [begQuant, endQuant] -   
+struct netCommand4C_RequestQuantHashes : public netCommandGeneral {
+public:
+	netCommand4C_RequestQuantHashes(unsigned int _begQuant, unsigned int _endQuant) : netCommandGeneral(NETCOM_4C_ID_REQUEST_QUANT_HASHES){
+		begQuant=_begQuant;
+		endQuant=_endQuant;
+	}
+	netCommand4C_RequestQuantHashes(XBuffer& in) : netCommandGeneral(NETCOM_4C_ID_REQUEST_QUANT_HASHES){
+		in > begQuant > endQuant;
+	}
+	void Write(XBuffer& out) const {
+		out < begQuant < endQuant;
+	};
+	unsigned int begQuant;
+	unsigned int endQuant;
+};
+
+struct netCommand4H_QuantHashes : public netCommandGeneral {
+public:
+	netCommand4H_QuantHashes() : netCommandGeneral(NETCOM_4H_ID_QUANT_HASHES){
+	}
+	netCommand4H_QuantHashes(XBuffer& in) : netCommandGeneral(NETCOM_4H_ID_QUANT_HASHES){
+		unsigned int size;
+		in > size;
+		hashes.resize(size);
+		if(size)
+			in.read(&hashes[0], size*sizeof(QuantHash));
+	}
+	void Write(XBuffer& out) const {
+		out < (unsigned int)hashes.size();
+		if(!hashes.empty())
+			out.write(&hashes[0], hashes.size()*sizeof(QuantHash));
+	};
+	vector<QuantHash> hashes;
+};
+
 
 struct netCommand4C_DisplayDistrincAreas : public netCommandGeneral {
 public:
@@ -769,14 +891,16 @@ struct netCommand4H_ResponceLastQuantsCommands : netCommandGeneral
 	unsigned int finGeneraCommandCounter;
 	unsigned int sizeCommandBuf;
 	unsigned char* pData;
+	bool flag_ownData;
 
-	netCommand4H_ResponceLastQuantsCommands(unsigned int _bQC, unsigned int _eQC, unsigned int _fGCC, unsigned int _szBuf, unsigned char* _pData) : netCommandGeneral(NETCOM_4H_ID_RESPONCE_LAST_QUANTS_COMMANDS) {
+	//  :   ,  _pData 
+	netCommand4H_ResponceLastQuantsCommands(unsigned int _bQC, unsigned int _eQC, unsigned int _fGCC, unsigned int _szBuf, const char* _pData) : netCommandGeneral(NETCOM_4H_ID_RESPONCE_LAST_QUANTS_COMMANDS) {
 		beginQuantCommandTransmit=_bQC;
 		endQuantCommandTransmit=_eQC;
 		finGeneraCommandCounter=_fGCC;
 		sizeCommandBuf=_szBuf;
-		pData= new unsigned char[sizeCommandBuf];
-		memcpy(pData, _pData, sizeCommandBuf);
+		pData=(unsigned char*)_pData;
+		flag_ownData=false;
 	}
 	netCommand4H_ResponceLastQuantsCommands(XBuffer& in) : netCommandGeneral(NETCOM_4H_ID_RESPONCE_LAST_QUANTS_COMMANDS) {
 		in.read(&beginQuantCommandTransmit, sizeof(beginQuantCommandTransmit));
@@ -785,9 +909,11 @@ struct netCommand4H_ResponceLastQuantsCommands : netCommandGeneral
 		in.read(&sizeCommandBuf, sizeof(sizeCommandBuf));
 		pData= new unsigned char[sizeCommandBuf];
 		in.read(pData, sizeCommandBuf);
+		flag_ownData=true;
 	}
 	~netCommand4H_ResponceLastQuantsCommands(void){
-		delete pData;
+		if(flag_ownData)
+			delete pData;
 	}
 	void Write(XBuffer& out) const{
 		out.write(&beginQuantCommandTransmit, sizeof(beginQuantCommandTransmit));
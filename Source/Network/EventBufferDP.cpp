@@ -413,3 +413,317 @@ unsigned long InOutNetComBuffer::getQuantAmount()
 	}
 	return cntQuant;
 }
+
+////////////////////////////////////////////////////////////////////////////
+//			Quant commands codec
+////////////////////////////////////////////////////////////////////////////
+
+QuantCommandCodec::QuantCommandCodec()
+: records_(4096, 1), command_(REFERENCE_SIZE_MAX, 1)
+{
+	reset();
+	quant_=0;
+	baseQuant_=0;
+	count_=0;
+}
+
+void QuantCommandCodec::reset()
+{
+	references_.clear();
+	stored_.clear();
+	lastQuant_=0;
+	read_=end_=0;
+	left_=0;
+	error_=false;
+}
+
+unsigned int QuantCommandCodec::player(const netCommandGame& command)
+{
+	switch(command.EventID){
+	case NETCOM_4G_ID_UNIT_COMMAND:
+		return static_cast<const netCommand4G_UnitCommand&>(command).owner().playerID();
+	case NETCOM_4G_ID_REGION:
+		return static_cast<const netCommand4G_Region&>(command).playerID_;
+	case NETCOM_4G_ID_FORCED_DEFEAT:
+		return static_cast<const netCommand4G_ForcedDefeat&>(command).userID;
+	}
+	return 0;
+}
+
+void QuantCommandCodec::beginEncode(unsigned int quant)
+{
+	xassert(quant && "Quant commands: zero quant");
+	if(!lastQuant_)
+		references_.clear();
+	baseQuant_=lastQuant_;
+	lastQuant_=quant;
+	quant_=quant;
+	count_=0;
+	records_.init();
+}
+
+void QuantCommandCodec::encode(const netCommandGame& command)
+{
+	xassert(command.EventID < DELTA);
+	command_.init();
+	command.Write(command_);
+	unsigned int size=command_.tell();
+	unsigned char header[2] = { command.EventID, player(command) };
+	count_++;
+
+	if(size <= REFERENCE_SIZE_MAX){
+		vector<char>& reference=references_[key(command.EventID, header[1])];
+		if(reference.size()==size){
+			unsigned char mask[(REFERENCE_SIZE_MAX + 7)/8];
+			unsigned int maskSize=(size + 7)/8;
+			memset(mask, 0, maskSize);
+			unsigned int changed=0;
+			unsigned int i;
+			for(i=0; i<size; i++)
+				if(reference[i]!=command_.buf[i]){
+					mask[i >> 3] |= 1 << (i & 7);
+					changed++;
+				}
+			if(maskSize + changed < sizeof(size) + size){
+				header[0] |= DELTA;
+				records_.write(header, sizeof(header));
+				records_.write(mask, maskSize);
+				for(i=0; i<size; i++)
+					if(mask[i >> 3] & (1 << (i & 7))){
+						records_.write(&command_.buf[i], 1);
+						reference[i]=command_.buf[i];
+					}
+				return;
+			}
+		}
+		reference.assign(command_.buf, command_.buf + size);
+	}
+
+	records_.write(header, sizeof(header));
+	records_.write(&size, sizeof(size));
+	records_.write(command_.buf, size);
+}
+
+netCommand4C_QuantCommands QuantCommandCodec::encoded() const
+{
+	return netCommand4C_QuantCommands(quant_, baseQuant_, count_, records_.buf, records_.tell());
+}
+
+void QuantCommandCodec::storeEncoded()
+{
+	stored_.push_back(StoredPacket());
+	StoredPacket& packet=stored_.back();
+	packet.quant=quant_;
+	packet.baseQuant=baseQuant_;
+	packet.count=count_;
+	packet.records.assign(records_.buf, records_.buf + records_.tell());
+	if(stored_.size() > STORED_MAX)
+		stored_.pop_front();
+}
+
+bool QuantCommandCodec::encodedAfter(unsigned int quant, vector<netCommand4C_QuantCommands>& packets) const
+{
+	packets.clear();
+	if(quant==lastQuant_)
+		return true;
+	//baseQuant_  ,     
+	StoredList::const_iterator i;
+	FOR_EACH(stored_, i)
+		if(i->baseQuant==quant)
+			break;
+	//      ( reset),    
+	if(i==stored_.end() && !stored_.empty() && !stored_.front().baseQuant && quant < stored_.front().quant)
+		i=stored_.begin();
+	if(i==stored_.end())
+		return false;
+	for(; i!=stored_.end(); ++i)
+		packets.push_back(netCommand4C_QuantCommands(i->quant, i->baseQuant, i->count, i->records.empty() ? 0 : &i->records[0], i->records.size()));
+	return true;
+}
+
+bool QuantCommandCodec::beginDecode(const netCommand4C_QuantCommands& batch)
+{
+	read_=end_=0;
+	left_=0;
+	if(!batch.baseQuant_)
+		references_.clear();
+	else if(batch.baseQuant_!=lastQuant_){
+		error_=true;
+		return false;
+	}
+	lastQuant_=batch.quant_;
+	read_=batch.records_;
+	end_=batch.records_ + batch.size_;
+	left_=batch.count_;
+	error_=false;
+	return true;
+}
+
+bool QuantCommandCodec::decode(terEventID& id, char*& data, unsigned int& size)
+{
+	if(!left_ || error_)
+		return false;
+	if(end_ - read_ < 2){
+		error_=true;
+		return false;
+	}
+	unsigned char type=read_[0];
+	unsigned int commandPlayer=(unsigned char)read_[1];
+	read_+=2;
+	id=(terEventID)(type & ~DELTA);
+
+	if(type & DELTA){
+		ReferenceMap::iterator ri=references_.find(key(id, commandPlayer));
+		if(ri==references_.end() || ri->second.empty()){
+			error_=true;
+			return false;
+		}
+		vector<char>& reference=ri->second;
+		size=reference.size();
+		unsigned int maskSize=(size + 7)/8;
+		if((unsigned int)(end_ - read_) < maskSize){
+			error_=true;
+			return false;
+		}
+		const char* mask=read_;
+		read_+=maskSize;
+		for(unsigned int i=0; i<size; i++)
+			if(mask[i >> 3] & (1 << (i & 7))){
+				if(read_==end_){
+					error_=true;
+					return false;
+				}
+				reference[i]=*read_++;
+			}
+		data=&reference[0];
+	}
+	else{
+		if((unsigned int)(end_ - read_) < sizeof(size)){
+			error_=true;
+			return false;
+		}
+		memcpy(&size, read_, sizeof(size));
+		read_+=sizeof(size);
+		if((unsigned int)(end_ - read_) < size){
+			error_=true;
+			return false;
+		}
+		data=const_cast<char*>(read_);
+		read_+=size;
+		if(size <= REFERENCE_SIZE_MAX)
+			references_[key(id, commandPlayer)].assign(data, data + size);
+	}
+
+	if(!--left_ && read_!=end_)
+		error_=true;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//			Codec benchmark
+////////////////////////////////////////////////////////////////////////////
+
+bool netCommandCodecBenchmark(const sNetCodecBenchSettings& settings, sNetCodecBench& result)
+{
+	if(settings.players <= 0 || settings.quants <= 0 || settings.commands <= 0)
+		return false;
+
+	result=sNetCodecBench();
+	result.valid=true;
+
+	InOutNetComBuffer out(1<<16, true);
+	InOutNetComBuffer in(1<<16, true);
+	QuantCommandCodec encoder;
+	QuantCommandCodec decoder;
+	vector<netCommand4G_UnitCommand> commands;
+
+	//         
+	vector<Vect3f> cursor(settings.players, Vect3f(1024, 1024, 0));
+	unsigned int random=83838383;
+	unsigned int counter=0;
+
+	for(int quant=1; quant<=settings.quants; quant++){
+		commands.clear();
+		for(int player=0; player<settings.players; player++){
+			for(int c=0; c<settings.commands; c++){
+				random=random*1103515245 + 12345;
+				cursor[player].x+=(int)((random >> 16) & 63) - 32;
+				cursor[player].y+=(int)((random >> 22) & 63) - 32;
+				netCommand4G_UnitCommand command(terUnitID((random >> 8) & 15, player), UnitCommand(COMMAND_ID_POINT, cursor[player], 0));
+				command.setCurCommandQuantAndCounter(quant, counter++);
+				commands.push_back(command);
+			}
+		}
+		commands.back().setFlagLastCommandInQuant();
+		result.commands+=commands.size();
+
+		//   
+		double time=clockf();
+		vector<netCommand4G_UnitCommand>::iterator ci;
+		FOR_EACH(commands, ci){
+			out.putNetCommand(&*ci);
+			result.legacyBytes+=out.filled_size;
+			result.legacyPackets++;
+			in.putBufferPacket((unsigned char*)out.buf, out.filled_size);
+			out.init();
+			out.reset();
+		}
+		result.legacyEncodeTime+=clockf() - time;
+
+		time=clockf();
+		ci=commands.begin();
+		while(in.currentNetCommandID()){
+			netCommand4G_UnitCommand command(in);
+			if(ci==commands.end() || !(command==*ci))
+				result.valid=false;
+			else
+				++ci;
+			in.nextNetCommand();
+		}
+		result.legacyDecodeTime+=clockf() - time;
+
+		// 
+		time=clockf();
+		encoder.beginEncode(quant);
+		FOR_EACH(commands, ci)
+			encoder.encode(*ci);
+		netCommand4C_QuantCommands batch=encoder.encoded();
+		out.putNetCommand(&batch);
+		result.batchBytes+=out.filled_size;
+		result.batchPackets++;
+		in.putBufferPacket((unsigned char*)out.buf, out.filled_size);
+		out.init();
+		out.reset();
+		result.batchEncodeTime+=clockf() - time;
+
+		time=clockf();
+		ci=commands.begin();
+		while(in.currentNetCommandID()){
+			if(in.currentNetCommandID()==NETCOM_4C_ID_QUANT_COMMANDS){
+				netCommand4C_QuantCommands nc(in);
+				if(!decoder.beginDecode(nc))
+					result.valid=false;
+				terEventID id;
+				char* data;
+				unsigned int size;
+				while(decoder.decode(id, data, size)){
+					XBuffer view(data, size);
+					netCommand4G_UnitCommand command(view);
+					if(id!=NETCOM_4G_ID_UNIT_COMMAND || ci==commands.end() || !(command==*ci))
+						result.valid=false;
+					else
+						++ci;
+				}
+				if(decoder.decodeError())
+					result.valid=false;
+			}
+			else
+				in.ignoreNetCommand();
+			in.nextNetCommand();
+		}
+		if(ci!=commands.end())
+			result.valid=false;
+		result.batchDecodeTime+=clockf() - time;
+	}
+	return true;
+}
@@ -113,6 +113,104 @@ public:
 	}
 
 };
+
+///////////////////////////////////////////////////////////////////////////////////
+//  netCommand4C_QuantCommands.
+//: [id][player],   [size][ Write()] ,
+// (id|DELTA)       
+//     id  .
+//       (    ),
+//baseQuant_  ,      ,   .
+// reset     ,    .
+class QuantCommandCodec
+{
+public:
+	QuantCommandCodec();
+
+	void reset();
+
+	//:    ,   
+	void beginEncode(unsigned int quant);
+	void encode(const netCommandGame& command);
+	//     -    beginEncode
+	netCommand4C_QuantCommands encoded() const;
+	//  encoded()   
+	void storeEncoded();
+	//,      quant,   .
+	//   . false -     
+	bool encodedAfter(unsigned int quant, vector<netCommand4C_QuantCommands>& packets) const;
+
+	//: false -      ( )
+	bool beginDecode(const netCommand4C_QuantCommands& batch);
+	//     Write():       ,
+	//   decode
+	bool decode(terEventID& id, char*& data, unsigned int& size);
+	bool decodeError() const { return error_; }
+	//   
+	unsigned int lastQuant() const { return lastQuant_; }
+
+private:
+	enum {
+		DELTA = 0x80,
+		REFERENCE_SIZE_MAX = 256, //  ()      
+		STORED_MAX = 256 //   
+	};
+
+	struct StoredPacket {
+		unsigned int quant;
+		unsigned int baseQuant;
+		unsigned int count;
+		vector<char> records;
+	};
+	typedef list<StoredPacket> StoredList;
+	StoredList stored_;
+
+	typedef map<unsigned int, vector<char> > ReferenceMap;
+	ReferenceMap references_;
+	unsigned int lastQuant_; //  , 0 - 
+
+	XBuffer records_;
+	XBuffer command_;
+	unsigned int quant_;
+	unsigned int baseQuant_;
+	unsigned int count_;
+
+	const char* read_;
+	const char* end_;
+	unsigned int left_;
+	bool error_;
+
+	static unsigned int player(const netCommandGame& command);
+	static unsigned int key(int id, unsigned int player) { return (id << 8) | (player & 0xff); }
+};
+
+//:    players   commands  ,
+//     ( )     
+struct sNetCodecBenchSettings
+{
+	int players;
+	int quants;
+	int commands; //   
+	sNetCodecBenchSettings() { players = 8; quants = 2000; commands = 2; }
+};
+
+struct sNetCodecBench
+{
+	int commands;
+	int legacyBytes;
+	int legacyPackets;
+	int batchBytes;
+	int batchPackets;
+	double legacyEncodeTime; //ms
+	double legacyDecodeTime;
+	double batchEncodeTime;
+	double batchDecodeTime;
+	bool valid; //   
+
+	sNetCodecBench() { commands = legacyBytes = legacyPackets = batchBytes = batchPackets = 0; legacyEncodeTime = legacyDecodeTime = batchEncodeTime = batchDecodeTime = 0; valid = false; }
+};
+
+bool netCommandCodecBenchmark(const sNetCodecBenchSettings& settings, sNetCodecBench& result);
 #endif //__EVENT_BUFFER_DP
 
 
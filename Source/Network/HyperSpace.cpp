@@ -51,12 +51,295 @@ public:
 cMonowideFont* pMonowideFont;
 #endif _FINAL_VERSION_
 
+//-------------------------------------------------
+CommandHistory::CommandHistory()
+: buffer_(16384, 1)
+{
+	clear();
+}
+
+void CommandHistory::clear()
+{
+	buffer_.init();
+	entries_.clear();
+	quantBegin_.clear();
+}
+
+void CommandHistory::addEntry(unsigned int offset, unsigned int quant, unsigned int counter)
+{
+	xassert(quant + 1 >= quantBegin_.size() && "Command history: decreasing quant");
+	while(quantBegin_.size() <= quant)
+		quantBegin_.push_back(size());
+
+	Entry entry;
+	entry.offset = offset;
+	entry.quant = quant;
+	entry.counter = counter;
+	entries_.push_back(entry);
+}
+
+void CommandHistory::push_back(const netCommandGame& command)
+{
+	//  ,    InOutNetComBuffer::putNetCommand
+	unsigned int offset = buffer_.tell();
+	unsigned long commandSize = 0;
+	buffer_.write(&commandSize, sizeof(commandSize));
+	buffer_.write(&command.EventID, sizeof(command.EventID));
+	command.Write(buffer_);
+	commandSize = buffer_.tell() - offset - sizeof(commandSize);
+	memcpy(buffer_.buf + offset, &commandSize, sizeof(commandSize));
+
+	addEntry(offset, command.curCommandQuant_, command.curCommandCounter_);
+}
+
+bool CommandHistory::assign(const char* data, unsigned int length, unsigned int maxQuant)
+{
+	clear();
+	buffer_.write(data, length);
+
+	unsigned int offset = 0;
+	while(length - offset >= HEADER_SIZE){
+		unsigned long commandSize = *(unsigned long*)(buffer_.buf + offset);
+		if(commandSize < sizeof(terEventID) || commandSize > length - offset - sizeof(commandSize))
+			break;
+
+		XBuffer in(buffer_.buf + offset + HEADER_SIZE, commandSize - sizeof(terEventID));
+		unsigned int quant, counter;
+		switch(*(terEventID*)(buffer_.buf + offset + sizeof(commandSize))){
+		case NETCOM_4G_ID_UNIT_COMMAND:
+			{
+				netCommand4G_UnitCommand nc(in);
+				quant = nc.curCommandQuant_;
+				counter = nc.curCommandCounter_;
+			}
+			break;
+		case NETCOM_4G_ID_REGION:
+			{
+				netCommand4G_Region nc(in);
+				quant = nc.curCommandQuant_;
+				counter = nc.curCommandCounter_;
+			}
+			break;
+		case NETCOM_4G_ID_FORCED_DEFEAT:
+			{
+				netCommand4G_ForcedDefeat nc(in);
+				quant = nc.curCommandQuant_;
+				counter = nc.curCommandCounter_;
+			}
+			break;
+		default:
+			clear();
+			return false;
+		}
+		if(in.tell() != in.length() || quant + 1 < quantBegin_.size())
+			break;
+		if(quant > maxQuant){
+			//,     (  ,  ) -
+			//   .   ,   -   
+			buffer_.set(offset);
+			return true;
+		}
+
+		addEntry(offset, quant, counter);
+		offset += sizeof(commandSize) + commandSize;
+	}
+
+	if(offset != length){
+		clear();
+		return false;
+	}
+	return true;
+}
+
+int CommandHistory::eraseAfter(unsigned int quant)
+{
+	int begin = firstCommand(quant + 1);
+	int erased = size() - begin;
+	if(erased){
+		buffer_.set(entries_[begin].offset);
+		entries_.erase(entries_.begin() + begin, entries_.end());
+	}
+	if(quantBegin_.size() > quant + 1)
+		quantBegin_.erase(quantBegin_.begin() + quant + 1, quantBegin_.end());
+	return erased;
+}
+
+bool CommandHistory::equal(int index, const netCommandGame& command) const
+{
+	if(id(index) != command.EventID)
+		return false;
+	unsigned int commandSize = dataSize(index);
+	XBuffer buffer(commandSize + 16, 1);
+	command.Write(buffer);
+	return buffer.tell() == commandSize && !memcmp(buffer.buf, buffer_.buf + entries_[index].offset + HEADER_SIZE, commandSize);
+}
+
+//-------------------------------------------------
+QuantLogHistory::QuantLogHistory()
+: buffer_(65536, 1)
+{
+	clear();
+}
+
+void QuantLogHistory::clear()
+{
+	buffer_.init();
+	offsets_.clear();
+	erased_ = 0;
+	firstQuant_ = 0;
+}
+
+void QuantLogHistory::push_back(unsigned int quant, XBuffer& log)
+{
+	if(offsets_.size() == erased_){
+		clear();
+		firstQuant_ = quant;
+	}
+	else if(quant != firstQuant_ + offsets_.size() - erased_){
+		xassert(0 && "Quant log: missed quant");
+		clear();
+		firstQuant_ = quant;
+	}
+	offsets_.push_back(buffer_.tell());
+	buffer_.write(log.address(), log.tell());
+}
+
+void QuantLogHistory::eraseUntil(unsigned int quant)
+{
+	if(quant < firstQuant_)
+		return;
+	unsigned int erased = min(quant - firstQuant_ + 1, (unsigned int)offsets_.size() - erased_);
+	erased_ += erased;
+	firstQuant_ += erased;
+	if(erased_ > offsets_.size()/2)
+		compact();
+}
+
+void QuantLogHistory::compact()
+{
+	unsigned int shift = position(erased_);
+	unsigned int used = buffer_.tell() - shift;
+	if(used)
+		memmove(buffer_.buf, buffer_.buf + shift, used);
+	buffer_.set(used);
+
+	offsets_.erase(offsets_.begin(), offsets_.begin() + erased_);
+	erased_ = 0;
+	vector<unsigned int>::iterator i;
+	FOR_EACH(offsets_, i)
+		*i -= shift;
+}
+
+void QuantLogHistory::write(XStream& file) const
+{
+	unsigned int begin = position(erased_);
+	file.write(buffer_.buf + begin, buffer_.tell() - begin);
+}
+
+//-------------------------------------------------
+QuantHashRing::QuantHashRing()
+{
+	clear();
+}
+
+void QuantHashRing::clear()
+{
+	lastQuant_ = 0;
+	count_ = 0;
+}
+
+void QuantHashRing::push_back(const QuantHash& hash)
+{
+	if(count_ && hash.quant != lastQuant_ + 1){
+		xassert(0 && "Quant hash: missed quant");
+		count_ = 0;
+	}
+	hashes_[hash.quant & (SIZE - 1)] = hash;
+	lastQuant_ = hash.quant;
+	if(count_ < SIZE)
+		count_++;
+}
+
+bool QuantHashRing::signature(unsigned int begin, unsigned int end, unsigned int subsystemSignature[QUANT_HASH_MAX]) const
+{
+	bool complete = true;
+	for(int s = 0; s < QUANT_HASH_MAX; s++)
+		subsystemSignature[s] = startCRC32;
+	for(unsigned int i = begin; i <= end; i++){
+		if(!present(i)){
+			complete = false;
+			continue;
+		}
+		const QuantHash& hash = (*this)[i];
+		for(int s = 0; s < QUANT_HASH_MAX; s++)
+			subsystemSignature[s] = crc32((const unsigned char*)&hash.crc[s], sizeof(hash.crc[s]), subsystemSignature[s]);
+	}
+	return complete;
+}
+
+unsigned int QuantHashRing::signature(const unsigned int subsystemSignature[QUANT_HASH_MAX])
+{
+	return crc32((const unsigned char*)subsystemSignature, QUANT_HASH_MAX*sizeof(subsystemSignature[0]), startCRC32);
+}
+
+void QuantHashRing::write(XStream& file) const
+{
+	vector<QuantHash> hashes;
+	for(unsigned int i = lastQuant_ + 1 - count_; count_ && i <= lastQuant_; i++)
+		hashes.push_back((*this)[i]);
+	writeQuantHashes(file, hashes);
+}
+
+unsigned int findQuantHashMismatch(const vector<QuantHash>& first, const vector<QuantHash>& second, unsigned int& quant)
+{
+	//    ,   
+	vector<QuantHash>::const_iterator i1 = first.begin();
+	vector<QuantHash>::const_iterator i2 = second.begin();
+	while(i1 != first.end() && i2 != second.end()){
+		if(i1->quant < i2->quant)
+			++i1;
+		else if(i2->quant < i1->quant)
+			++i2;
+		else{
+			unsigned int mask = 0;
+			for(int s = 0; s < QUANT_HASH_MAX; s++)
+				if(i1->crc[s] != i2->crc[s])
+					mask |= 1 << s;
+			if(mask){
+				quant = i1->quant;
+				return mask;
+			}
+			++i1;
+			++i2;
+		}
+	}
+	return 0;
+}
+
+void writeQuantHashes(XStream& file, const vector<QuantHash>& hashes)
+{
+	file < "Quant";
+	for(int s = 0; s < QUANT_HASH_MAX; s++)
+		file < " " < QuantHash::subsystemName(s);
+	file < "\r\n";
+
+	vector<QuantHash>::const_iterator i;
+	FOR_EACH(hashes, i){
+		file <= i->quant;
+		for(int s = 0; s < QUANT_HASH_MAX; s++)
+			file < " " <= i->crc[s];
+		file < "\r\n";
+	}
+}
+
 terHyperSpace::terHyperSpace(PNetCenter* net_client, MissionDescription& mission)
 {
 	InitializeCriticalSection(&m_FullListGameCommandLock);
 
 	flag_HostMigrate=false;
 	flag_stopSavePlayReel=false;
+	flag_requestQuantCommands=false;
+	flag_quantCommandsBroken=false;
 	netPause=true;
 
 	pNetCenter = net_client;
@@ -103,7 +386,6 @@ terHyperSpace::terHyperSpace(PNetCenter* net_client, MissionDescription& mission
 	lagQuant=0;
 	dropQuant=0;
 	confirmQuant=0;
-	signatureGame=startCRC32;
 
 #ifndef _FINAL_VERSION_
 	pMonowideFont= new cMonowideFont();
@@ -113,10 +395,10 @@ terHyperSpace::terHyperSpace(PNetCenter* net_client, MissionDescription& mission
 	{
 		//Lock!
 		CAutoLock lock(&m_FullListGameCommandLock);
-		clearListGameCommands(fullListGameCommands);
+		fullListGameCommands.clear();
 	}
 	lastQuant_inFullListGameCommands=0;
-	clearListGameCommands(replayListGameCommands);
+	replayListGameCommands.clear();
 	endQuant_inReplayListGameCommands=0;
 
 
@@ -168,6 +450,27 @@ terHyperSpace::terHyperSpace(PNetCenter* net_client, MissionDescription& mission
 
 	vMap.selectUsedWorld(mission.worldID());
 	vMap.fullLoad(IniManager("Perimeter.ini").getInt("TD","FastLoad"));
+	statistics_add(worldLoad, STATISTICS_GROUP_TOTAL, vMap.chunksStat.totalTime);
+	statistics_add(worldLoad_unpack, STATISTICS_GROUP_TOTAL, vMap.chunksStat.unpackTime);
+	statistics_add(worldLoad_packedKb, STATISTICS_GROUP_NUMERIC, vMap.chunksStat.packedSize >> 10);
+
+	if(check_command_line("convert_world"))
+		vMap.convertWorld2Chunks();
+
+	//  :     _TERRA_TILED_  
+	if(check_command_line("terra_bench")){
+		sTerraLayoutBench bench;
+		vMap.benchmarkLayout(bench);
+		statistics_add(terraBench_tiled, STATISTICS_GROUP_NUMERIC, bench.tiled);
+		statistics_add(terraBench_rowScan, STATISTICS_GROUP_TOTAL, bench.rowScan);
+		statistics_add(terraBench_columnScan, STATISTICS_GROUP_TOTAL, bench.columnScan);
+		statistics_add(terraBench_toolzer, STATISTICS_GROUP_TOTAL, bench.toolzer);
+		statistics_add(terraBench_geo, STATISTICS_GROUP_TOTAL, bench.geo);
+		statistics_add(terraBench_deltaZone, STATISTICS_GROUP_TOTAL, bench.deltaZone);
+		statistics_add(terraBench_renderBox, STATISTICS_GROUP_TOTAL, bench.renderBox);
+		//   - 
+		vMap.fullLoad(IniManager("Perimeter.ini").getInt("TD","FastLoad"));
+	}
 }
 
 void getMissionDescriptionInThePlayReelFile(const char* fname, MissionDescription& md)
@@ -214,40 +517,9 @@ bool terHyperSpace::loadPlayReel(const char* fname)
 
 	int sizePlayReelData=sizeOtherData-mdBuf.tell();
 	xassert(sizePlayReelData >= 0);
-//	unsigned char* tbuf=new unsigned char[sizePlayReelData];
-//	fi.read(tbuf, sizePlayReelData);
-	InOutNetComBuffer in_buffer(sizePlayReelData, 1); //  !
-	in_buffer.putBufferPacket((unsigned char*)(mdBuf.address()+mdBuf.tell()), sizePlayReelData);
-//	delete [] tbuf;
-
-	while(in_buffer.currentNetCommandID()!=NETCOM_ID_NONE) {
-		terEventID event = (terEventID)in_buffer.currentNetCommandID();
-		switch(event){
-		case NETCOM_4G_ID_UNIT_COMMAND: 
-			{
-				netCommand4G_UnitCommand*  pnc= new netCommand4G_UnitCommand(in_buffer);
-				replayListGameCommands.push_back(pnc);
-			}
-			break;
-		case NETCOM_4G_ID_REGION:
-			{
-				netCommand4G_Region*  pnc= new netCommand4G_Region(in_buffer);
-				replayListGameCommands.push_back(pnc);
-			}
-			break;
-		case NETCOM_4G_ID_FORCED_DEFEAT:
-			{
-				netCommand4G_ForcedDefeat* pnc=new netCommand4G_ForcedDefeat(in_buffer);
-				replayListGameCommands.push_back(pnc);
-			}
-
-		default:
-			xassert(0&&"Incorrect commanf in playReel file!");
-			break;
-		}
-		in_buffer.nextNetCommand();
-	}
-	curRePlayPosition=replayListGameCommands.begin();
+	//       -   
+	if(!replayListGameCommands.assign(mdBuf.address()+mdBuf.tell(), sizePlayReelData, endQuant_inReplayListGameCommands+1))
+		ErrH.Abort("Incorrect play reel file!:", XERR_USER, 0, fname);
 	return true;
 }
 
@@ -279,17 +551,12 @@ terHyperSpace::SAVE_REPLAY_RESULT terHyperSpace::savePlayReel(const char* fname)
 	}
 
 
-	vector<netCommandGame*>::iterator p;
-	InOutNetComBuffer out_buffer(1024,1);
 	{
 		//Lock!
 		CAutoLock lock(&m_FullListGameCommandLock);
-		for(p=fullListGameCommands.begin(); p!=fullListGameCommands.end(); p++){
-			//xassert( ((*p)->EventID==NETCOM_4G_ID_UNIT_COMMAND) || ((*p)->EventID==NETCOM_4G_ID_REGION) || ((*p)->EventID==NETCOM_4G_ID_FORCED_DEFEAT) );
-			out_buffer.putNetCommand((*p));
-		}
+		//     -   ,    
+		fo.write(fullListGameCommands.address(0), fullListGameCommands.bytes(0, fullListGameCommands.firstCommand(lastQuant_inFullListGameCommands + 1)));
 	}
-	out_buffer.write2File(fo);
 	return fo.ioError() ? SAVE_REPLAY_RW_ERROR_OR_DISK_FULL : SAVE_REPLAY_OK;
 }
 
@@ -324,15 +591,16 @@ terHyperSpace::~terHyperSpace()
 	allSavePlayReel();
 
 	// 
-	clearLogList();
+	logList.clear();
+	hashRing.clear();
 	//  
 	{
 		//Lock!
 		CAutoLock lock(&m_FullListGameCommandLock);
-		clearListGameCommands(fullListGameCommands);
+		fullListGameCommands.clear();
 	}
 	lastQuant_inFullListGameCommands=0;
-	clearListGameCommands(replayListGameCommands);
+	replayListGameCommands.clear();
 	endQuant_inReplayListGameCommands=0;
 
 
@@ -366,37 +634,7 @@ bool terHyperSpace::MultiQuant()
 		currentQuant++;		//currentQuant=lastQuant_inFullListGameCommands;
 
 		lastQuant_inFullListGameCommands=currentQuant;
-		//     
-		vector<netCommandGame*>::iterator p;
-		p=fullListGameCommands.end();
-		while(p!=fullListGameCommands.begin()) {
-			p--;
-			if( (*p)->curCommandQuant_ < currentQuant ){
-				p++; break;
-			}
-		}
-		// p      
-		for(; p!=fullListGameCommands.end(); p++) {
-			if((*p)->curCommandQuant_ != currentQuant ) break; //    
-			if((*p)->EventID==NETCOM_4G_ID_UNIT_COMMAND){
-				netCommand4G_UnitCommand* pNC_UnitCommant=static_cast<netCommand4G_UnitCommand*>(*p);
-				receiveCommand(*pNC_UnitCommant);
-				log_var(pNC_UnitCommant->unitCommand().commandID());
-				log_var(pNC_UnitCommant->unitCommand().position());
-			}
-			else if((*p)->EventID==NETCOM_4G_ID_REGION){
-				netCommand4G_Region* pNC_Region=static_cast<netCommand4G_Region*>(*p);
-				receiveCommand(*pNC_Region);
-				log_var(pNC_Region->playerID_);
-			}
-			else if((*p)->EventID==NETCOM_4G_ID_FORCED_DEFEAT){
-				///
-				netCommand4G_ForcedDefeat* pNC_ForceDefeate=static_cast<netCommand4G_ForcedDefeat*>(*p);
-				forcedDefeat(pNC_ForceDefeate->userID);
-				log_var(pNC_ForceDefeate->userID);
-			}
-			else xassert(0&&"Incorrect net comman in fullListGameCommands");
-		}
+		executeCommands(fullListGameCommands, fullListGameCommands.firstCommand(currentQuant), fullListGameCommands.firstCommand(currentQuant+1));
 
 		lagQuant=getInternalLagQuant(); // 
 
@@ -414,7 +652,7 @@ bool terHyperSpace::MultiQuant()
 
 		// 
 		///unsigned int gridCRC=vMap.getGridCRC(false, currentQuant);
-		log_var(vMap.getGridCRC(false, currentQuant));
+		log_var(vMap.getWorldCRC());
 		///XBuffer vmapbuf(4096, 1);
 		///vMap.generateChAreasInformation(vmapbuf);
 		///pNetCenter->SendEvent(&netCommand4H_BackGameInformation(currentQuant, vmapbuf, net_log_buffer));
@@ -441,34 +679,50 @@ bool terHyperSpace::MultiQuant()
 
 const unsigned int periodSendLogQuant=8; // !
 const unsigned int maskPeriodSendLogQuant=periodSendLogQuant-1;//
+void terHyperSpace::hashQuant()
+{
+	QuantHash hash;
+	hash.quant=currentQuant;
+	for(int s=0; s<QUANT_HASH_MAX; s++)
+		hash.crc[s]=startCRC32;
+	hash.crc[QUANT_HASH_LOG]=crc32((unsigned char*)net_log_buffer.address(), net_log_buffer.tell(), startCRC32);
+	hash.crc[QUANT_HASH_WORLD]=vMap.getWorldCRC();
+	calcQuantHash(hash);
+	hashRing.push_back(hash);
+}
+
+unsigned int terHyperSpace::lastQuantSignature() const
+{
+	if(!hashRing.present(currentQuant))
+		return 0;
+	return QuantHashRing::signature(hashRing[currentQuant].crc);
+}
+
 void terHyperSpace::logQuant()
 {
 	lagQuant=getInternalLagQuant(); // 
 
-	signatureGame=crc32((unsigned char*)net_log_buffer.address(), net_log_buffer.tell(), signatureGame);
-	if((currentQuant & maskPeriodSendLogQuant)==0){ // 8   
-		pNetCenter->SendEvent(&netCommand4H_BackGameInformation2(lagQuant, currentQuant, signatureGame, false, pNetCenter->m_state));
-		signatureGame=startCRC32;
-	}
-	pushBackLogList(currentQuant, net_log_buffer);
+	hashQuant();
+
+	if((currentQuant & maskPeriodSendLogQuant)==0) // 8   
+		sendSignature(currentQuant, false);
+	logList.push_back(currentQuant, net_log_buffer);
 	//sendLog(currentQuant);
 	net_log_buffer.init();
 }
 void terHyperSpace::sendLog(unsigned int quant)
 {
 	xassert(quant);//,    (   1-!)
-	if(quant && ((quant & maskPeriodSendLogQuant)==0) ){
-		unsigned int begLogQuant=((quant-1) & (~maskPeriodSendLogQuant)) +1;
-		unsigned int sgn=startCRC32;
-		int i;
-		for(i=begLogQuant; i<=quant; i++){
-			sLogElement* pLogElemente=getLogElement(i);
-			xassert(pLogElemente);
-			sgn=crc32((unsigned char*)pLogElemente->pLog->address(), pLogElemente->pLog->tell(), sgn);
-
-		}
-		pNetCenter->SendEvent(&netCommand4H_BackGameInformation2(0, quant, sgn, true, pNetCenter->m_state));
-	}
+	if(quant && ((quant & maskPeriodSendLogQuant)==0) )
+		sendSignature(quant, true);
+}
+void terHyperSpace::sendSignature(unsigned int quant, bool replay)
+{
+	unsigned int begLogQuant=((quant-1) & (~maskPeriodSendLogQuant)) +1;
+	unsigned int subsystemSignature[QUANT_HASH_MAX];
+	if(!hashRing.signature(begLogQuant, quant, subsystemSignature))
+		xassert(!replay && "Quant hash ring: quant overwritten");
+	pNetCenter->SendEvent(&netCommand4H_BackGameInformation2(replay ? 0 : lagQuant, quant, QuantHashRing::signature(subsystemSignature), subsystemSignature, replay, pNetCenter->m_state));
 }
 
 
@@ -479,9 +733,9 @@ void terHyperSpace::sendCommand(const netCommand4G_UnitCommand& command)
 		//Lock!
 		CAutoLock lock(&m_FullListGameCommandLock);
 
-		netCommand4G_UnitCommand* pnc=new netCommand4G_UnitCommand(command);
-		pnc->setCurCommandQuantAndCounter(currentQuant+1,0);
-		fullListGameCommands.push_back(pnc);
+		netCommand4G_UnitCommand nc(command);
+		nc.setCurCommandQuantAndCounter(currentQuant+1,0);
+		fullListGameCommands.push_back(nc);
 		/////receiveCommand(command);
 	}
 	else {
@@ -496,9 +750,9 @@ void terHyperSpace::sendCommand(const netCommand4G_Region& command)
 		//Lock!
 		CAutoLock lock(&m_FullListGameCommandLock);
 
-		netCommand4G_Region* pnc=new netCommand4G_Region(command);
-		pnc->setCurCommandQuantAndCounter(currentQuant+1,0);
-		fullListGameCommands.push_back(pnc);
+		netCommand4G_Region nc(command);
+		nc.setCurCommandQuantAndCounter(currentQuant+1,0);
+		fullListGameCommands.push_back(nc);
 		/////receiveCommand(command);
 	}
 	else {
@@ -506,6 +760,41 @@ void terHyperSpace::sendCommand(const netCommand4G_Region& command)
 	}
 }
 
+void terHyperSpace::executeCommands(CommandHistory& history, int begin, int end)
+{
+	//     
+	for(int i=begin; i<end; i++){
+		XBuffer in(history.data(i), history.dataSize(i));
+		switch(history.id(i)){
+		case NETCOM_4G_ID_UNIT_COMMAND:
+			{
+				netCommand4G_UnitCommand nc(in);
+				receiveCommand(nc);
+				log_var(nc.unitCommand().commandID());
+				log_var(nc.unitCommand().position());
+			}
+			break;
+		case NETCOM_4G_ID_REGION:
+			{
+				netCommand4G_Region nc(in);
+				receiveCommand(nc);
+				log_var(nc.playerID_);
+			}
+			break;
+		case NETCOM_4G_ID_FORCED_DEFEAT:
+			{
+				netCommand4G_ForcedDefeat nc(in);
+				forcedDefeat(nc.userID);
+				log_var(nc.userID);
+			}
+			break;
+		default:
+			xassert(0&&"Incorrect net comman in command history");
+			break;
+		}
+	}
+}
+
 //----------------------------- Dread Place ----------------------------
 bool terHyperSpace::SingleQuant()
 {
@@ -517,34 +806,7 @@ bool terHyperSpace::SingleQuant()
 	if(!flag_stopSavePlayReel) lastQuant_inFullListGameCommands=currentQuant;
 
 	if(flag_rePlayReel){
-		vector<netCommandGame*>::iterator p;
-		
-		for(p=curRePlayPosition; p!=replayListGameCommands.end(); p++){
-			if((*p)->curCommandQuant_==currentQuant){
-				if((*p)->EventID==NETCOM_4G_ID_UNIT_COMMAND){
-					netCommand4G_UnitCommand* pNC_UnitCommant=static_cast<netCommand4G_UnitCommand*>(*p);
-					receiveCommand(*pNC_UnitCommant);
-					log_var(pNC_UnitCommant->unitCommand().commandID());
-					log_var(pNC_UnitCommant->unitCommand().position());
-				}
-				else if((*p)->EventID==NETCOM_4G_ID_REGION){
-					netCommand4G_Region* pNC_Region=static_cast<netCommand4G_Region*>(*p);
-					receiveCommand(*pNC_Region);
-					log_var(pNC_Region->playerID_);
-				}
-				else if((*p)->EventID==NETCOM_4G_ID_FORCED_DEFEAT){
-					netCommand4G_ForcedDefeat* pNC_ForceDefeate=static_cast<netCommand4G_ForcedDefeat*>(*p);
-					forcedDefeat(pNC_ForceDefeate->userID);
-					log_var(pNC_ForceDefeate->userID);
-				}
-
-				else xassert(0&&"Incorrect net comman in replayListGameCommands");
-			}
-			else {
-				curRePlayPosition=p;
-				break;
-			}
-		}
+		executeCommands(replayListGameCommands, replayListGameCommands.firstCommand(currentQuant), replayListGameCommands.firstCommand(currentQuant+1));
 
 		if(currentQuant > endQuant_inReplayListGameCommands)
 			_pShellDispatcher->OnInterfaceMessage(UNIVERSE_INTERFACE_MESSAGE_GAME_DEFEAT); 
@@ -553,30 +815,11 @@ bool terHyperSpace::SingleQuant()
 		//Lock!
 		CAutoLock lock(&m_FullListGameCommandLock);
 
-		for(curGameComPosition; curGameComPosition<fullListGameCommands.size(); curGameComPosition++){
-			if(fullListGameCommands[curGameComPosition]->curCommandQuant_==currentQuant){
-				if(fullListGameCommands[curGameComPosition]->EventID==NETCOM_4G_ID_UNIT_COMMAND){
-					netCommand4G_UnitCommand* pNC_UnitCommant=static_cast<netCommand4G_UnitCommand*>(fullListGameCommands[curGameComPosition]);
-					receiveCommand(*pNC_UnitCommant);
-					log_var(pNC_UnitCommant->unitCommand().commandID());
-					log_var(pNC_UnitCommant->unitCommand().position());
-				}
-				else if(fullListGameCommands[curGameComPosition]->EventID==NETCOM_4G_ID_REGION){
-					netCommand4G_Region* pNC_Region=static_cast<netCommand4G_Region*>(fullListGameCommands[curGameComPosition]);
-					receiveCommand(*pNC_Region);
-					log_var(pNC_Region->playerID_);
-				}
-				else if(fullListGameCommands[curGameComPosition]->EventID==NETCOM_4G_ID_FORCED_DEFEAT){
-					netCommand4G_ForcedDefeat* pNC_ForceDefeate=static_cast<netCommand4G_ForcedDefeat*>(fullListGameCommands[curGameComPosition]);
-					forcedDefeat(pNC_ForceDefeate->userID);
-					log_var(pNC_ForceDefeate->userID);
-				}
-				else xassert(0&&"Incorrect net comman in fullListGameCommands");
-			}
-			else {
-				xassert("Strange error!");
-			}
-		}
+		//  ,    ,   
+		xassert(curGameComPosition==fullListGameCommands.firstCommand(currentQuant));
+		int end=fullListGameCommands.firstCommand(currentQuant+1);
+		executeCommands(fullListGameCommands, curGameComPosition, end);
+		curGameComPosition=end;
 	}
 
 	log_var(currentQuant);
@@ -585,12 +828,18 @@ bool terHyperSpace::SingleQuant()
 
 	// 
 	///unsigned int gridCRC=vMap.getGridCRC(false, currentQuant);
-	log_var(vMap.getGridCRC(false, currentQuant));
+	log_var(vMap.getWorldCRC());
 
 	allowedRealizingQuant=currentQuant+1;
 
 	lastRealizedQuant=currentQuant;
 
+	//       -     
+	if(terHeadless){
+		hashQuant();
+		net_log_buffer.init();
+	}
+
 	return true;
 }
 
@@ -646,15 +895,11 @@ void terHyperSpace::ShowInfo()
 //    .. reJoin      (stopGame_HostMigrate)
 void terHyperSpace::sendListGameCommand2Host(unsigned int begQuant, unsigned int endQuant)
 {
-	vector<netCommandGame*>::iterator p;
-	InOutNetComBuffer out_buffer(1024,1);
 	if(lastQuant_inFullListGameCommands < endQuant) endQuant=lastQuant_inFullListGameCommands; /// 
-	for(p=fullListGameCommands.begin(); p!=fullListGameCommands.end(); p++){
-		xassert( ((*p)->EventID==NETCOM_4G_ID_UNIT_COMMAND) || ((*p)->EventID==NETCOM_4G_ID_REGION) || ((*p)->EventID==NETCOM_4G_ID_FORCED_DEFEAT) );
-		if( ((*p)->curCommandQuant_ >=begQuant) && ((*p)->curCommandQuant_ <=endQuant))
-			out_buffer.putNetCommand((*p));
-	}
-	netCommand4H_ResponceLastQuantsCommands nco(begQuant, endQuant, clientGeneralCommandCounterInListCommand, out_buffer.filled_size, (unsigned char*) out_buffer.address() );
+	//  [begQuant, endQuant]     -   
+	int begin=fullListGameCommands.firstCommand(begQuant);
+	int end=begQuant <= endQuant ? fullListGameCommands.firstCommand(endQuant+1) : begin;
+	netCommand4H_ResponceLastQuantsCommands nco(begQuant, endQuant, clientGeneralCommandCounterInListCommand, fullListGameCommands.bytes(begin, end), fullListGameCommands.address(begin));
 	if(pNetCenter){
 		pNetCenter->SendEvent(&nco);
 	}
@@ -678,17 +923,7 @@ void terHyperSpace::stopGame_HostMigrate()
 
 	xassert(allowedRealizingQuant==lastRealizedQuant);
 	xassert(allowedRealizingQuant==lastQuant_inFullListGameCommands);
-	vector<netCommandGame*>::iterator p;
-	while(!fullListGameCommands.empty()){
-		p=fullListGameCommands.end();
-		p--;
-		if((*p)->curCommandQuant_ > lastQuant_inFullListGameCommands){
-			delete *p;
-			fullListGameCommands.erase(p);
-			clientGeneralCommandCounterInListCommand--;
-		}
-		else break;
-	}
+	clientGeneralCommandCounterInListCommand-=fullListGameCommands.eraseAfter(lastQuant_inFullListGameCommands);
 
 	lastQuantAllowedTimeCommand=0;
 	generalCommandCounter4TimeCommand=0;
@@ -702,22 +937,22 @@ void terHyperSpace::stopGame_HostMigrate()
 	flag_HostMigrate=true;
 }
 
-void terHyperSpace::putInputGameCommand2fullListGameCommandAndCheckAllowedRun(netCommandGame* pnc)
+void terHyperSpace::putInputGameCommand2fullListGameCommandAndCheckAllowedRun(const netCommandGame& nc)
 {
-	///if(pnc->curCommandQuant_ >= lastQuant_inFullListGameCommands) //    -   
-	if(pnc->curCommandQuant_ > allowedRealizingQuant) {//    -   
-		fullListGameCommands.push_back(pnc);
-		xassert(pnc->curCommandCounter_==clientGeneralCommandCounterInListCommand);
+	///if(nc.curCommandQuant_ >= lastQuant_inFullListGameCommands) //    -   
+	if(nc.curCommandQuant_ > allowedRealizingQuant) {//    -   
+		fullListGameCommands.push_back(nc);
+		xassert(nc.curCommandCounter_==clientGeneralCommandCounterInListCommand);
 		clientGeneralCommandCounterInListCommand++;
-//		receiveCommand(*pnc);
+//		receiveCommand(nc);
 
 		//  
-		if(pnc->flag_lastCommandInQuant_){ //    ,      
-			allowedRealizingQuant=pnc->curCommandQuant_;
+		if(nc.flag_lastCommandInQuant_){ //    ,      
+			allowedRealizingQuant=nc.curCommandQuant_;
 		}
 		else { //     ,      
-			if(pnc->curCommandQuant_>0){
-				allowedRealizingQuant=pnc->curCommandQuant_-1;
+			if(nc.curCommandQuant_>0){
+				allowedRealizingQuant=nc.curCommandQuant_-1;
 			}
 		} 
 		//         NEXT_COMMAND(TimeCommand)
@@ -730,12 +965,10 @@ void terHyperSpace::putInputGameCommand2fullListGameCommandAndCheckAllowedRun(ne
 	else {
 		xassert(0&&"host migrate ?");
 		//      
-		vector<netCommandGame*>::iterator p;
-		for(p=fullListGameCommands.begin(); p!=fullListGameCommands.end(); p++){
-			if((*p)->curCommandCounter_==pnc->curCommandCounter_) break;
-		}
-		if(p!=fullListGameCommands.end()){
-			if(**p==*pnc){
+		//       
+		int index=nc.curCommandCounter_;
+		if(index < fullListGameCommands.size() && fullListGameCommands.counter(index)==nc.curCommandCounter_){
+			if(fullListGameCommands.equal(index, nc)){
 				//good
 			}
 			else {
@@ -754,6 +987,73 @@ void terHyperSpace::putInputGameCommand2fullListGameCommandAndCheckAllowedRun(ne
 XStream netCommandLog("netcommandlog.log", XS_OUT);
 #endif
 
+//        (    )
+void terHyperSpace::receiveQuantCommands(const netCommand4C_QuantCommands& batch)
+{
+	if(flag_quantCommandsBroken)
+		return;
+	//    -    
+	if(batch.baseQuant_ && batch.quant_ <= quantCommandDecoder.lastQuant())
+		return;
+	if(!quantCommandDecoder.beginDecode(batch)){
+		//   ,    .    
+		// NEXT_QUANT,   ,     
+		//  
+		if(!flag_requestQuantCommands){
+			flag_requestQuantCommands=true;
+			netCommand4H_RequestQuantCommands nc(quantCommandDecoder.lastQuant());
+			if(pNetCenter)
+				pNetCenter->SendEvent(&nc);
+		}
+		return;
+	}
+	flag_requestQuantCommands=false;
+	terEventID id;
+	char* data;
+	unsigned int size;
+	bool broken=false;
+	while(!broken && quantCommandDecoder.decode(id, data, size)){
+		XBuffer in(data, size);
+		switch(id){
+		case NETCOM_4G_ID_UNIT_COMMAND:
+			{
+				netCommand4G_UnitCommand nc(in);
+				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(nc);
+			}
+			break;
+		case NETCOM_4G_ID_REGION:
+			{
+				netCommand4G_Region nc(in);
+				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(nc);
+			}
+			break;
+		case NETCOM_4G_ID_FORCED_DEFEAT:
+			{
+				netCommand4G_ForcedDefeat nc(in);
+				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(nc);
+			}
+			break;
+		default:
+			xassert(0 && "Quant commands: incorrect command");
+			broken=true;
+			break;
+		}
+	}
+	if(broken || quantCommandDecoder.decodeError()){
+		//     fullListGameCommands,  ,
+		//   -   
+		xassert(0 && "Quant commands: broken packet");
+		flag_quantCommandsBroken=true;
+		XStream f("outnet.log", XS_OUT);
+		f < currentVersion < "\r\n";
+		f < "Quant commands: broken packet" < " Quant=" <= batch.quant_ < " BaseQuant=" <= batch.baseQuant_ < "\r\n";
+		f.close();
+		::MessageBox(0, "Quant commands: broken packet; outnet.log saved", "Error network synchronization", MB_OK|MB_ICONERROR);
+		if(pNetCenter)
+			pNetCenter->ExecuteInterfaceCommand(PNC_INTERFACE_COMMAND_CRITICAL_ERROR_GAME_TERMINATED);
+	}
+}
+
 bool terHyperSpace::ReceiveEvent(terEventID event, InOutNetComBuffer& in_buffer)
 {
 //	if(flag_endCurQuant==false){
@@ -778,6 +1078,16 @@ bool terHyperSpace::ReceiveEvent(terEventID event, InOutNetComBuffer& in_buffer)
 
 			}
 			break;
+		case NETCOM_4C_ID_REQUEST_QUANT_HASHES:
+			{
+				netCommand4C_RequestQuantHashes nc(in_buffer);
+				netCommand4H_QuantHashes answer;
+				for(unsigned int i=nc.begQuant; i<=nc.endQuant; i++)
+					if(hashRing.present(i))
+						answer.hashes.push_back(hashRing[i]);
+				pNetCenter->SendEvent(&answer);
+			}
+			break;
 		case NETCOM_ID_NEXT_QUANT:
 			{
 				xassert(!flag_HostMigrate);
@@ -802,7 +1112,7 @@ bool terHyperSpace::ReceiveEvent(terEventID event, InOutNetComBuffer& in_buffer)
 				if(nc.quantConfirmation_!=netCommandNextQuant::NOT_QUANT_CONFIRMATION){ // quantConfirmation_    
 					confirmQuant=nc.quantConfirmation_;
 					//clear list 
-					eraseLogListUntil(nc.quantConfirmation_);
+					logList.eraseUntil(nc.quantConfirmation_);
 				}
 	#ifdef NETCOM_DBG_LOG
 				netCommandLog < "Quant=" <=nc.numberQuant_ <"\n";
@@ -817,25 +1127,32 @@ bool terHyperSpace::ReceiveEvent(terEventID event, InOutNetComBuffer& in_buffer)
 		case NETCOM_4G_ID_UNIT_COMMAND: 
 			{
 				xassert(!flag_HostMigrate);
-				netCommand4G_UnitCommand*  pnc= new netCommand4G_UnitCommand(in_buffer);
-				xassert(pnc->curCommandQuant_ < 0xcdcd0000);
-				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(pnc);
+				netCommand4G_UnitCommand nc(in_buffer);
+				xassert(nc.curCommandQuant_ < 0xcdcd0000);
+				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(nc);
 			}
 			break;
 		case NETCOM_4G_ID_REGION: 
 			{
 				xassert(!flag_HostMigrate);
-				netCommand4G_Region*  pnc= new netCommand4G_Region(in_buffer);
-				xassert(pnc->curCommandQuant_ < 0xcdcd0000);
-				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(pnc);
+				netCommand4G_Region nc(in_buffer);
+				xassert(nc.curCommandQuant_ < 0xcdcd0000);
+				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(nc);
 			}
 			break;
 		case NETCOM_4G_ID_FORCED_DEFEAT:
 			{
 				xassert(!flag_HostMigrate);
-				netCommand4G_ForcedDefeat*  pnc= new netCommand4G_ForcedDefeat(in_buffer);
-				xassert(pnc->curCommandQuant_ < 0xcdcd0000);
-				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(pnc);
+				netCommand4G_ForcedDefeat nc(in_buffer);
+				xassert(nc.curCommandQuant_ < 0xcdcd0000);
+				putInputGameCommand2fullListGameCommandAndCheckAllowedRun(nc);
+			}
+			break;
+		case NETCOM_4C_ID_QUANT_COMMANDS:
+			{
+				xassert(!flag_HostMigrate);
+				netCommand4C_QuantCommands nc(in_buffer);
+				receiveQuantCommands(nc);
 			}
 			break;
 		case NETCOM_4C_ID_SAVE_LOG:
@@ -858,7 +1175,8 @@ bool terHyperSpace::ReceiveEvent(terEventID event, InOutNetComBuffer& in_buffer)
 				XStream f(tb, XS_OUT);
 				//const char* currentVersion;
 				f < currentVersion < "\r\n";
-				writeLogList2File(f);
+				hashRing.write(f);
+				logList.write(f);
 				f.close();
 				::MessageBox(0, "Unique!!!; outnet.log saved", "Error network synchronization", MB_OK|MB_ICONERROR);
 				pNetCenter->ExecuteInterfaceCommand(PNC_INTERFACE_COMMAND_CRITICAL_ERROR_GAME_TERMINATED);
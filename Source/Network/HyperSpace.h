@@ -8,6 +8,122 @@ extern const char * KEY_REPLAY_REEL;
 void getMissionDescriptionInThePlayReelFile(const char* fname, MissionDescription& md);
 bool isCorrectPlayReelFile(const char* fname);
 
+//  .
+//         InOutNetComBuffer
+//([size][id][]),       
+//    ,  .
+//   , quantBegin_      O(1).
+class CommandHistory
+{
+public:
+	CommandHistory();
+
+	void clear();
+	void push_back(const netCommandGame& command);
+	//    ( ), false -  .
+	//   > maxQuant 
+	bool assign(const char* data, unsigned int length, unsigned int maxQuant);
+	//      > quant,   
+	int eraseAfter(unsigned int quant);
+
+	int size() const { return entries_.size(); }
+	bool empty() const { return entries_.empty(); }
+	//     >= quant
+	int firstCommand(unsigned int quant) const { return quant < quantBegin_.size() ? quantBegin_[quant] : size(); }
+
+	terEventID id(int index) const { return *(terEventID*)(buffer_.buf + entries_[index].offset + sizeof(unsigned long)); }
+	unsigned int quant(int index) const { return entries_[index].quant; }
+	unsigned int counter(int index) const { return entries_[index].counter; }
+	//    -     XBuffer
+	char* data(int index) { return buffer_.buf + entries_[index].offset + HEADER_SIZE; }
+	unsigned int dataSize(int index) const { return position(index + 1) - entries_[index].offset - HEADER_SIZE; }
+	//     command 
+	bool equal(int index, const netCommandGame& command) const;
+
+	// [begin, end)     
+	const char* address(int begin) const { return buffer_.buf + position(begin); }
+	unsigned int bytes(int begin, int end) const { xassert(begin <= end); return position(end) - position(begin); }
+
+private:
+	enum { HEADER_SIZE = sizeof(unsigned long) + sizeof(terEventID) };
+
+	struct Entry {
+		unsigned int offset;
+		unsigned int quant;
+		unsigned int counter;
+	};
+
+	XBuffer buffer_;
+	vector<Entry> entries_;
+	vector<int> quantBegin_;
+
+	unsigned int position(int index) const { return index < size() ? entries_[index].offset : buffer_.tell(); }
+	void addEntry(unsigned int offset, unsigned int quant, unsigned int counter);
+};
+
+//     ,  -  .
+//   ,    ,
+//      .
+class QuantLogHistory
+{
+public:
+	QuantLogHistory();
+
+	void clear();
+	void push_back(unsigned int quant, XBuffer& log);
+	//    
+	void eraseUntil(unsigned int quant);
+
+	bool present(unsigned int quant) const { return quant >= firstQuant_ && quant - firstQuant_ < offsets_.size() - erased_; }
+	const char* address(unsigned int quant) const { return buffer_.buf + offsets_[index(quant)]; }
+	unsigned int size(unsigned int quant) const { return position(index(quant) + 1) - offsets_[index(quant)]; }
+
+	void write(XStream& file) const;
+
+private:
+	XBuffer buffer_;
+	vector<unsigned int> offsets_;
+	unsigned int erased_; //    offsets_
+	unsigned int firstQuant_; // offsets_[erased_]
+
+	int index(unsigned int quant) const { xassert(present(quant)); return erased_ + quant - firstQuant_; }
+	unsigned int position(int index) const { return index < (int)offsets_.size() ? offsets_[index] : buffer_.tell(); }
+	void compact();
+};
+
+//    (QuantHash)    ,
+// -  ,   .
+//  CRC   ,   
+//   -     .
+class QuantHashRing
+{
+public:
+	enum { SIZE = 1024 }; // ,     
+
+	QuantHashRing();
+
+	void clear();
+	void push_back(const QuantHash& hash);
+
+	bool present(unsigned int quant) const { return count_ && quant <= lastQuant_ && lastQuant_ - quant < count_; }
+	const QuantHash& operator[](unsigned int quant) const { xassert(present(quant)); return hashes_[quant & (SIZE - 1)]; }
+
+	//CRC     [begin, end], false -    
+	bool signature(unsigned int begin, unsigned int end, unsigned int subsystemSignature[QUANT_HASH_MAX]) const;
+	static unsigned int signature(const unsigned int subsystemSignature[QUANT_HASH_MAX]);
+
+	void write(XStream& file) const;
+
+private:
+	QuantHash hashes_[SIZE];
+	unsigned int lastQuant_;
+	unsigned int count_;
+};
+
+// ,    ,     (0 - )
+unsigned int findQuantHashMismatch(const vector<QuantHash>& first, const vector<QuantHash>& second, unsigned int& quant);
+void writeQuantHashes(XStream& file, const vector<QuantHash>& hashes);
+
 
 class terHyperSpace
 {
@@ -41,6 +157,11 @@ public:
 
 	unsigned long getCurrentGameQuant() { return currentQuant; }
 	unsigned long getConfirmQuant() { return confirmQuant; }
+
+	//    
+	bool replayFinished() const { return flag_rePlayReel && currentQuant > endQuant_inReplayListGameCommands; }
+	//    (      ), 0 - 
+	unsigned int lastQuantSignature() const;
 protected:
 	PNetCenter* pNetCenter; //   this, !0 == MultiPlayer
 
@@ -52,8 +173,6 @@ private:
 	unsigned long dropQuant;
 	unsigned long confirmQuant;
 
-	unsigned int signatureGame;
-
 	int  m_nLastPlayerReceived;
 
 	bool netPause;
@@ -92,21 +211,21 @@ private:
 private:
 public:
 	//Command History
-	vector<netCommandGame*> fullListGameCommands;
+	CommandHistory fullListGameCommands;
 	unsigned int lastQuant_inFullListGameCommands; //   1-!
-	unsigned int curGameComPosition;
-
-	vector<netCommandGame*> replayListGameCommands;
+	int curGameComPosition;
+	//     
+	QuantCommandCodec quantCommandDecoder;
+	//     
+	bool flag_requestQuantCommands;
+	//     -  ,   
+	bool flag_quantCommandsBroken;
+
+	CommandHistory replayListGameCommands;
 	unsigned int endQuant_inReplayListGameCommands;
-	vector<netCommandGame*>::iterator curRePlayPosition;
 
-	static void clearListGameCommands(vector<netCommandGame*> & gcList){
-		vector<netCommandGame*>::iterator p;
-		for(p=gcList.begin(); p!=gcList.end(); p++){
-			delete *p;
-		}
-		gcList.clear();
-	}
+	//  history [begin, end)
+	void executeCommands(CommandHistory& history, int begin, int end);
 
 	void stopGame_HostMigrate();
 
@@ -115,7 +234,8 @@ public:
 	bool flag_autoSavePlayReel;
 
 	void sendListGameCommand2Host(unsigned int begQuant, unsigned int endQuant=ULONG_MAX);
-	void putInputGameCommand2fullListGameCommandAndCheckAllowedRun(netCommandGame* pnc);
+	void putInputGameCommand2fullListGameCommandAndCheckAllowedRun(const netCommandGame& nc);
+	void receiveQuantCommands(const netCommand4C_QuantCommands& batch);
 
 
 	bool loadPlayReel(const char* fname);
@@ -135,63 +255,8 @@ public:
 	MissionDescription curMission;
 
 	//report log
-	struct sLogElement{
-		sLogElement(){
-			pLog=0;
-		}
-		sLogElement(int _quant, XBuffer* _plog){
-			quant=_quant;
-			xassert(_plog);
-			pLog=_plog;
-		}
-		~sLogElement(){
-		}
-		int quant;
-		XBuffer* pLog;
-	};
-	list<sLogElement> logList;
-	sLogElement* getLogElement(unsigned int quant){
-		list<sLogElement>::iterator p;
-		for(p=logList.begin(); p!=logList.end(); p++){
-			if((*p).quant==quant) return &(*p);
-		}
-		return 0;
-	}
-	void pushBackLogList(int quant, XBuffer& xb){
-		XBuffer* pb=new XBuffer(xb.tell()+1);
-		pb->write(xb.address(), xb.tell());
-		logList.push_back(sLogElement(quant, pb));
-	}
-	XBuffer* getLogInLogList(int quant){
-		list<sLogElement>::iterator p;
-		for(p=logList.begin(); p!=logList.end(); p++){
-			if(p->quant==quant) return p->pLog;
-		}
-		return 0;
-	}
-	void clearLogList(){
-		list<sLogElement>::iterator p;
-		for(p=logList.begin(); p!=logList.end(); p++){
-			if(p->pLog) delete p->pLog;
-		}
-		logList.clear();
-	}
-	void eraseLogListUntil(int quant){
-		list<sLogElement>::iterator p;
-		for(p=logList.begin(); p!=logList.end(); ){
-			if(p->quant <= quant) {
-				if(p->pLog) delete p->pLog;
-				p=logList.erase(p);
-			}
-			else break;
-		}
-	}
-	void writeLogList2File(XStream& file){
-		list<sLogElement>::iterator p;
-		for(p=logList.begin(); p!=logList.end(); p++){
-			file.write(p->pLog->address(), p->pLog->tell());
-		}
-	}
+	QuantLogHistory logList;
+	QuantHashRing hashRing;
 
 	unsigned long clientGeneralCommandCounterInListCommand;//  fullListGameCommands.size()
 	unsigned long lastRealizedQuant; //   currentQuant
@@ -203,7 +268,12 @@ public:
 	long getInternalLagQuant(void);
 
 	void logQuant();
+	//  ( net_log_buffer)  hashRing
+	void hashQuant();
 	void sendLog(unsigned int quant);
+	void sendSignature(unsigned int quant, bool replay);
+	//      ( QUANT_HASH_LOG  QUANT_HASH_WORLD)
+	virtual void calcQuantHash(QuantHash& hash) {}
 
 	bool flag_HostMigrate;
 
@@ -92,6 +92,14 @@ public:
 
 	bool loadMission(SavePrm& savePrm) const; 
 	bool saveMission(const SavePrm& savePrm, bool userSave) const; 
+	//     -   
+	MissionDescription saveData(const SavePrm& savePrm, bool userSave) const;
+	// *this  ,    -    .
+	//spb  binarySaves -   (  spg,    )
+	bool writeMission(const SavePrm& savePrm) const;
+	//    fname,     
+	bool writeMissionFile(const SavePrm& savePrm, const char* fname) const;
+	static bool binarySaves;
 	void restart();
 
 	void setSaveName(const char* name);
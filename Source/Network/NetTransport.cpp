@@ -0,0 +1,612 @@
+#include "StdAfx.h"
+
+#include "P2P_interface.h"
+#include "NetTransport.h"
+
+#pragma comment(lib,"wsock32.lib")
+
+//-------------------------------------------------
+NetBatch::NetBatch()
+{
+	packets_ = 0;
+	bytes_ = 0;
+	batchCount_ = 0;
+}
+
+NetBatch::~NetBatch()
+{
+	vector<Batch*>::iterator i;
+	FOR_EACH(batches_, i)
+		delete *i;
+}
+
+void NetBatch::add(const char* buffer, int size, DPNID to, bool guaranteed)
+{
+	packets_++;
+	bytes_ += size;
+
+	Batch* batch = 0;
+	vector<Batch*>::iterator i;
+	FOR_EACH(batches_, i)
+		if((*i)->to == to && (*i)->guaranteed == guaranteed){
+			batch = *i;
+			break;
+		}
+	if(!batch){
+		batch = new Batch;
+		batch->to = to;
+		batch->guaranteed = guaranteed;
+		batches_.push_back(batch);
+		batchCount_++;
+	}
+	batch->data.write(buffer, size);
+}
+
+void NetBatch::take(vector<Batch*>& batches)
+{
+	batches.swap(batches_);
+	batches_.clear();
+}
+
+//-------------------------------------------------
+DPNID NetDPTransport::localID() const
+{
+	return center_.m_localDPNID;
+}
+
+int NetDPTransport::send(const char* buffer, int size, DPNID to, bool guaranteed)
+{
+	return center_.SendDP(buffer, size, to, guaranteed);
+}
+
+//-------------------------------------------------
+NetLoopbackHub::NetLoopbackHub()
+{
+	InitializeCriticalSection(&lock_);
+	nextID_ = 1;
+}
+
+NetLoopbackHub::~NetLoopbackHub()
+{
+	xassert(peers_.empty() && "Loopback peers are alive");
+	DeleteCriticalSection(&lock_);
+}
+
+NetLoopbackHub& NetLoopbackHub::instance()
+{
+	static NetLoopbackHub hub;
+	return hub;
+}
+
+NetLoopbackTransport* NetLoopbackHub::createPeer()
+{
+	CAutoLock lock(&lock_);
+	NetLoopbackTransport* peer = new NetLoopbackTransport(*this, nextID_++);
+	peers_.push_back(peer);
+	return peer;
+}
+
+void NetLoopbackHub::remove(NetLoopbackTransport* peer)
+{
+	CAutoLock lock(&lock_);
+	vector<NetLoopbackTransport*>::iterator i = find(peers_.begin(), peers_.end(), peer);
+	if(i != peers_.end())
+		peers_.erase(i);
+}
+
+void NetLoopbackHub::deliver(DPNID from, NetBatch::Batch* batch)
+{
+	CAutoLock lock(&lock_);
+	vector<NetLoopbackTransport*>::iterator i;
+	FOR_EACH(peers_, i){
+		NetLoopbackTransport* peer = *i;
+		if(batch->to == DPNID_ALL_PLAYERS_GROUP ? peer->id_ == from : peer->id_ != batch->to)
+			continue;
+		peer->incoming_.push_back(NetLoopbackTransport::Packet());
+		NetLoopbackTransport::Packet& packet = peer->incoming_.back();
+		packet.from = from;
+		packet.data.assign(batch->data.buf, batch->data.buf + batch->data.tell());
+	}
+}
+
+NetLoopbackTransport::~NetLoopbackTransport()
+{
+	hub_.remove(this);
+}
+
+int NetLoopbackTransport::send(const char* buffer, int size, DPNID to, bool guaranteed)
+{
+	outgoing_.add(buffer, size, to, guaranteed);
+	return size;
+}
+
+void NetLoopbackTransport::flush()
+{
+	vector<NetBatch::Batch*> batches;
+	outgoing_.take(batches);
+	vector<NetBatch::Batch*>::iterator i;
+	FOR_EACH(batches, i){
+		hub_.deliver(id_, *i);
+		delete *i;
+	}
+}
+
+void NetLoopbackTransport::poll()
+{
+	list<Packet> packets;
+	{
+		CAutoLock lock(&hub_.lock_);
+		packets.swap(incoming_);
+	}
+	list<Packet>::iterator i;
+	FOR_EACH(packets, i)
+		if(sink_ && !i->data.empty())
+			sink_->receivePacket(i->from, &i->data[0], i->data.size());
+}
+
+//-------------------------------------------------
+NetUDPTransport::NetUDPTransport(DPNID id, unsigned short port)
+{
+	InitializeCriticalSection(&lock_);
+	id_ = id;
+	socket_ = INVALID_SOCKET;
+	received_ = 0;
+	resent_ = 0;
+	receiveBuffer_.resize(MAX_RECEIVE);
+
+	WSADATA data;
+	if(WSAStartup(MAKEWORD(1, 1), &data))
+		return;
+
+	socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+	if(socket_ == INVALID_SOCKET)
+		return;
+
+	sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	address.sin_port = htons(port);
+	unsigned long nonBlocking = 1;
+	if(bind(socket_, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR || ioctlsocket(socket_, FIONBIO, &nonBlocking) == SOCKET_ERROR){
+		closesocket(socket_);
+		socket_ = INVALID_SOCKET;
+	}
+}
+
+NetUDPTransport::~NetUDPTransport()
+{
+	if(socket_ != INVALID_SOCKET)
+		closesocket(socket_);
+	WSACleanup();
+	DeleteCriticalSection(&lock_);
+}
+
+void NetUDPTransport::addPeer(DPNID id, unsigned int ip, unsigned short port)
+{
+	CAutoLock lock(&lock_);
+	xassert(!findPeer(id) && "UDP transport: peer already added");
+	peers_.push_back(Peer());
+	Peer& peer = peers_.back();
+	peer.id = id;
+	memset(&peer.address, 0, sizeof(peer.address));
+	peer.address.sin_family = AF_INET;
+	peer.address.sin_addr.s_addr = htonl(ip);
+	peer.address.sin_port = htons(port);
+	peer.sendSequence = 1;
+	peer.receiveSequence = 1;
+	peer.ackPending = false;
+}
+
+void NetUDPTransport::removePeer(DPNID id)
+{
+	CAutoLock lock(&lock_);
+	vector<Peer>::iterator i;
+	FOR_EACH(peers_, i)
+		if(i->id == id){
+			peers_.erase(i);
+			break;
+		}
+}
+
+NetUDPTransport::Peer* NetUDPTransport::findPeer(DPNID id)
+{
+	vector<Peer>::iterator i;
+	FOR_EACH(peers_, i)
+		if(i->id == id)
+			return &*i;
+	return 0;
+}
+
+int NetUDPTransport::send(const char* buffer, int size, DPNID to, bool guaranteed)
+{
+	CAutoLock lock(&lock_);
+	outgoing_.add(buffer, size, to, guaranteed);
+	return size;
+}
+
+void NetUDPTransport::sendRaw(const Peer& peer, const char* data, int size)
+{
+	sendto(socket_, data, size, 0, (const sockaddr*)&peer.address, sizeof(peer.address));
+}
+
+void NetUDPTransport::sendDatagram(Peer& peer, const char* data, int size, bool guaranteed, unsigned int time)
+{
+	Datagram datagram;
+	datagram.sequence = guaranteed ? peer.sendSequence++ : 0;
+	datagram.time = time;
+	datagram.data.resize(sizeof(UDPHeader) + size);
+	UDPHeader& header = *(UDPHeader*)&datagram.data[0];
+	header.from = id_;
+	header.sequence = datagram.sequence;
+	header.ack = peer.receiveSequence - 1;
+	if(size)
+		memcpy(&datagram.data[sizeof(UDPHeader)], data, size);
+	peer.ackPending = false;
+
+	sendRaw(peer, &datagram.data[0], datagram.data.size());
+	if(guaranteed)
+		peer.unacked.push_back(datagram);
+}
+
+void NetUDPTransport::flush()
+{
+	CAutoLock lock(&lock_);
+	unsigned int time = clocki();
+
+	vector<NetBatch::Batch*> batches;
+	outgoing_.take(batches);
+
+	vector<NetBatch::Batch*>::iterator bi;
+	FOR_EACH(batches, bi){
+		NetBatch::Batch* batch = *bi;
+		if(isOpen()){
+			const char* data = batch->data.buf;
+			unsigned int size = batch->data.tell();
+			unsigned int offset = 0;
+			while(offset < size){
+				//  ,     
+				unsigned int end = offset;
+				while(end < size){
+					unsigned int command = *(const unsigned long*)(data + end) + sizeof(unsigned long);
+					if(end > offset && end + command - offset > MAX_DATAGRAM)
+						break;
+					end += command;
+				}
+				end = min(end, size);
+
+				vector<Peer>::iterator pi;
+				FOR_EACH(peers_, pi)
+					if(batch->to == DPNID_ALL_PLAYERS_GROUP ? pi->id != id_ : pi->id == batch->to)
+						sendDatagram(*pi, data + offset, end - offset, batch->guaranteed, time);
+				offset = end;
+			}
+		}
+		delete batch;
+	}
+
+	if(!isOpen())
+		return;
+
+	vector<Peer>::iterator pi;
+	FOR_EACH(peers_, pi){
+		Peer& peer = *pi;
+		list<Datagram>::iterator di;
+		FOR_EACH(peer.unacked, di)
+			if(time - di->time >= RESEND_TIME){
+				//   -  
+				((UDPHeader*)&di->data[0])->ack = peer.receiveSequence - 1;
+				di->time = time;
+				sendRaw(peer, &di->data[0], di->data.size());
+				peer.ackPending = false;
+				resent_++;
+			}
+		if(peer.ackPending)
+			sendDatagram(peer, 0, 0, false, time);
+	}
+}
+
+void NetUDPTransport::receive(Peer& peer, const UDPHeader& header, const char* data, int size)
+{
+	while(!peer.unacked.empty() && peer.unacked.front().sequence <= header.ack)
+		peer.unacked.pop_front();
+
+	if(!header.sequence){
+		if(size)
+			deliver(peer, data, size);
+		return;
+	}
+
+	peer.ackPending = true;
+	if(header.sequence < peer.receiveSequence)
+		return; //  
+	if(header.sequence > peer.receiveSequence){
+		peer.outOfOrder[header.sequence].assign(data, data + size);
+		return;
+	}
+
+	deliver(peer, data, size);
+	peer.receiveSequence++;
+	DatagramMap::iterator i;
+	while((i = peer.outOfOrder.find(peer.receiveSequence)) != peer.outOfOrder.end()){
+		if(!i->second.empty())
+			deliver(peer, &i->second[0], i->second.size());
+		peer.outOfOrder.erase(i);
+		peer.receiveSequence++;
+	}
+}
+
+void NetUDPTransport::poll()
+{
+	if(!isOpen())
+		return;
+
+	list<Packet> packets;
+	{
+		CAutoLock lock(&lock_);
+		received_ = &packets;
+		for(;;){
+			sockaddr_in from;
+			int fromSize = sizeof(from);
+			int size = recvfrom(socket_, &receiveBuffer_[0], receiveBuffer_.size(), 0, (sockaddr*)&from, &fromSize);
+			if(size == SOCKET_ERROR){
+				//WSAECONNRESET - ICMP    ,  
+				if(WSAGetLastError() == WSAECONNRESET)
+					continue;
+				break;
+			}
+			if(size < (int)sizeof(UDPHeader))
+				continue;
+			const UDPHeader& header = *(const UDPHeader*)&receiveBuffer_[0];
+			Peer* peer = findPeer(header.from);
+			if(peer)
+				receive(*peer, header, &receiveBuffer_[sizeof(UDPHeader)], size - sizeof(UDPHeader));
+		}
+		received_ = 0;
+	}
+
+	//    -   
+	list<Packet>::iterator i;
+	FOR_EACH(packets, i)
+		if(sink_)
+			sink_->receivePacket(i->from, &i->data[0], i->data.size());
+}
+
+void NetUDPTransport::deliver(Peer& peer, const char* data, int size)
+{
+	received_->push_back(Packet());
+	Packet& packet = received_->back();
+	packet.from = peer.id;
+	packet.data.assign(data, data + size);
+}
+
+//-------------------------------------------------
+void sNetSimulation::load()
+{
+	IniManager ini("Network.ini", false);
+	latency = ini.getInt("Simulation", "Latency");
+	jitter = ini.getInt("Simulation", "Jitter");
+	loss = ini.getInt("Simulation", "Loss")/100.f;
+}
+
+NetSimulator::NetSimulator(NetTransport* transport, const sNetSimulation& settings)
+: transport_(transport), settings_(settings)
+{
+	InitializeCriticalSection(&lock_);
+	transport_->setSink(this);
+	random_ = 83838383;
+	time_ = 0;
+	dropped_ = 0;
+	delayed_ = 0;
+}
+
+NetSimulator::~NetSimulator()
+{
+	delete transport_;
+	DeleteCriticalSection(&lock_);
+}
+
+unsigned int NetSimulator::random(unsigned int range)
+{
+	random_ = random_*1103515245 + 12345;
+	return range ? (random_ >> 16) % range : 0;
+}
+
+int NetSimulator::send(const char* buffer, int size, DPNID to, bool guaranteed)
+{
+	CAutoLock lock(&lock_);
+
+	unsigned int time = time_ + settings_.latency + random(settings_.jitter + 1);
+	if(settings_.loss > 0 && random(10000) < settings_.loss*10000){
+		if(!guaranteed){
+			dropped_++;
+			return size;
+		}
+		//    
+		time += 2*settings_.latency + random(settings_.jitter + 1);
+		delayed_++;
+	}
+
+	if(guaranteed){
+		//    
+		unsigned int& last = lastTime_[to];
+		if(time < last)
+			time = last;
+		last = time;
+	}
+
+	list<Packet>::iterator i = queue_.end();
+	while(i != queue_.begin()){
+		--i;
+		if(i->time <= time){
+			++i;
+			break;
+		}
+	}
+	Packet& packet = *queue_.insert(i, Packet());
+	packet.time = time;
+	packet.to = to;
+	packet.guaranteed = guaranteed;
+	packet.data.assign(buffer, buffer + size);
+	return size;
+}
+
+void NetSimulator::flush(unsigned int time)
+{
+	CAutoLock lock(&lock_);
+	time_ = time;
+	while(!queue_.empty() && queue_.front().time <= time){
+		Packet& packet = queue_.front();
+		transport_->send(&packet.data[0], packet.data.size(), packet.to, packet.guaranteed);
+		queue_.pop_front();
+	}
+	transport_->flush();
+}
+
+void NetSimulator::receivePacket(DPNID from, const void* data, int size)
+{
+	if(sink_)
+		sink_->receivePacket(from, data, size);
+}
+
+//-------------------------------------------------
+class NetBenchPeer : public NetPacketSink
+{
+public:
+	NetSimulator* transport;
+	const NetBatch* batch; //   transport
+	NetUDPTransport* udp;
+	InOutNetComBuffer in;
+	InOutNetComBuffer out;
+
+	NetBenchPeer() : in(1 << 20, true), out(1 << 16, true) { transport = 0; batch = 0; udp = 0; }
+	~NetBenchPeer() { delete transport; }
+
+	void receivePacket(DPNID from, const void* data, int size){
+		in.putBufferPacket((unsigned char*)data, size);
+	}
+	void send(DPNID to){
+		if(!out.isEmpty())
+			transport->send(out.buf, out.filled_size, to, true);
+		out.init();
+		out.reset();
+	}
+};
+
+bool netTransportBenchmark(const sNetBenchSettings& settings, sNetBench& result)
+{
+	if(settings.peers < 2 || settings.quants <= 0)
+		return false;
+
+	result = sNetBench();
+
+	NetLoopbackHub hub;
+	vector<NetBenchPeer*> peers;
+	int i;
+	for(i = 0; i < settings.peers; i++){
+		NetBenchPeer* peer = new NetBenchPeer;
+		NetTransport* link;
+		if(settings.udpPort){
+			//  127.0.0.1,  udpPort + 
+			NetUDPTransport* udp = new NetUDPTransport(i + 1, settings.udpPort + i);
+			for(int j = 0; j < settings.peers; j++)
+				if(j != i)
+					udp->addPeer(j + 1, INADDR_LOOPBACK, settings.udpPort + j);
+			peer->batch = &udp->batch();
+			peer->udp = udp;
+			link = udp;
+		}
+		else{
+			NetLoopbackTransport* loopback = hub.createPeer();
+			peer->batch = &loopback->batch();
+			link = loopback;
+		}
+		peer->transport = new NetSimulator(link, settings.simulation);
+		peer->transport->setSink(peer);
+		peers.push_back(peer);
+	}
+	for(i = 0; i < settings.peers; i++)
+		if(peers[i]->udp && !peers[i]->udp->isOpen()){
+			for(i = 0; i < settings.peers; i++)
+				delete peers[i];
+			return false;
+		}
+	NetBenchPeer& host = *peers.front();
+	DPNID hostID = host.transport->localID();
+
+	double late = 0;
+	double time = clockf();
+	unsigned long commandCounter = 0;
+	//  -   
+	int tailQuants = (settings.simulation.latency*3 + settings.simulation.jitter*2)/max(settings.quantInterval, 1) + 2;
+	for(int quant = 1; quant <= settings.quants + tailQuants; quant++){
+		unsigned int virtualTime = quant*settings.quantInterval;
+		bool sending = quant <= settings.quants;
+
+		for(i = 1; i < settings.peers; i++){
+			NetBenchPeer& client = *peers[i];
+			for(int c = 0; sending && c < settings.commands; c++){
+				netCommand4G_UnitCommand command(terUnitID(c, i), UnitCommand(COMMAND_ID_POINT, Vect3f(quant, c, 0), quant));
+				client.out.putNetCommand(&command);
+			}
+			client.send(hostID);
+			client.transport->flush(virtualTime);
+		}
+
+		//:       
+		if(settings.udpPort)
+			Sleep(1); //   ,   
+		host.transport->poll();
+		unsigned int quantCommands = 0;
+		while(host.in.currentNetCommandID()){
+			if(host.in.currentNetCommandID() == NETCOM_4G_ID_UNIT_COMMAND){
+				netCommand4G_UnitCommand command(host.in);
+				command.setCurCommandQuantAndCounter(quant, commandCounter++);
+				host.out.putNetCommand(&command);
+				quantCommands++;
+			}
+			else
+				host.in.ignoreNetCommand();
+			host.in.nextNetCommand();
+		}
+		netCommandNextQuant next(quant, quantCommands, commandCounter);
+		host.out.putNetCommand(&next);
+		host.send(DPNID_ALL_PLAYERS_GROUP);
+		host.transport->flush(virtualTime);
+
+		if(settings.udpPort)
+			Sleep(1);
+		for(i = 1; i < settings.peers; i++){
+			NetBenchPeer& client = *peers[i];
+			client.transport->poll();
+			while(client.in.currentNetCommandID()){
+				if(client.in.currentNetCommandID() == NETCOM_4G_ID_UNIT_COMMAND){
+					netCommand4G_UnitCommand command(client.in);
+					result.commands++;
+					late += quant - command.unitCommand().commandData();
+				}
+				else
+					client.in.ignoreNetCommand();
+				client.in.nextNetCommand();
+			}
+		}
+	}
+	result.time = clockf() - time;
+
+	for(i = 0; i < settings.peers; i++){
+		NetBenchPeer* peer = peers[i];
+		result.dropped += peer->transport->dropped();
+		result.packets += peer->batch->packets();
+		result.bytes += peer->batch->bytes();
+		result.datagrams += peer->batch->batches();
+		if(peer->udp)
+			result.resent += peer->udp->resent();
+		delete peer;
+	}
+
+	result.quants = settings.quants;
+	result.commandsPerQuant = (float)result.commands/settings.quants;
+	result.bytesPerQuant = (float)result.bytes/settings.quants;
+	result.lateQuants = result.commands ? (float)(late/result.commands) : 0;
+	return true;
+}
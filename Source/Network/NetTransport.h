@@ -0,0 +1,323 @@
+#ifndef __NET_TRANSPORT_H__
+#define __NET_TRANSPORT_H__
+
+/*
+   PNetCenter.
+
+ -  InOutNetComBuffer ( [size][id][] ),
+ - DPNID  DPNID_ALL_PLAYERS_GROUP (,  ).
+     -   
+   InOutNetComBuffer::putBufferPacket.
+
+send     , flush  
+(    ), poll    NetPacketSink.
+
+:
+	NetDPTransport - DirectPlay (PNetCenter::SendDP),    
+		 DirectPlayMessageHandler;
+	NetLoopbackTransport -     (NetLoopbackHub);
+	NetUDPTransport - UDP  ,   
+		  ;
+	NetSimulator - //   .
+*/
+
+#include <winsock.h>
+
+class PNetCenter;
+
+class NetPacketSink
+{
+public:
+	virtual void receivePacket(DPNID from, const void* data, int size) = 0;
+};
+
+class NetTransport
+{
+public:
+	NetTransport() { sink_ = 0; }
+	virtual ~NetTransport() {}
+
+	void setSink(NetPacketSink* sink) { sink_ = sink; }
+
+	virtual DPNID localID() const = 0;
+	//guaranteed -   
+	virtual int send(const char* buffer, int size, DPNID to, bool guaranteed) = 0;
+	virtual void flush() {}
+	virtual void poll() {}
+
+protected:
+	NetPacketSink* sink_;
+};
+
+//-------------------------------------------------
+//     flush
+class NetBatch
+{
+public:
+	struct Batch {
+		DPNID to;
+		bool guaranteed;
+		XBuffer data;
+		Batch() : data(1024, 1) {}
+	};
+
+	NetBatch();
+	~NetBatch();
+
+	void add(const char* buffer, int size, DPNID to, bool guaranteed);
+	bool empty() const { return batches_.empty(); }
+	// ,   
+	void take(vector<Batch*>& batches);
+
+	//:     ,   
+	int packets() const { return packets_; }
+	int bytes() const { return bytes_; }
+	int batches() const { return batchCount_; }
+
+private:
+	vector<Batch*> batches_;
+	int packets_;
+	int bytes_;
+	int batchCount_;
+};
+
+//-------------------------------------------------
+class NetDPTransport : public NetTransport
+{
+public:
+	NetDPTransport(PNetCenter& center) : center_(center) {}
+
+	DPNID localID() const;
+	int send(const char* buffer, int size, DPNID to, bool guaranteed);
+
+private:
+	PNetCenter& center_;
+};
+
+//-------------------------------------------------
+class NetLoopbackTransport;
+
+class NetLoopbackHub
+{
+public:
+	NetLoopbackHub();
+	~NetLoopbackHub();
+
+	//   (PNCWM_LOOPBACK)
+	static NetLoopbackHub& instance();
+
+	//    DPNID;    
+	NetLoopbackTransport* createPeer();
+	int peers() const { return peers_.size(); }
+
+private:
+	vector<NetLoopbackTransport*> peers_;
+	DPNID nextID_;
+	CRITICAL_SECTION lock_;
+
+	void deliver(DPNID from, NetBatch::Batch* batch);
+	void remove(NetLoopbackTransport* peer);
+
+	friend class NetLoopbackTransport;
+};
+
+class NetLoopbackTransport : public NetTransport
+{
+public:
+	~NetLoopbackTransport();
+
+	const NetBatch& batch() const { return outgoing_; }
+
+	DPNID localID() const { return id_; }
+	int send(const char* buffer, int size, DPNID to, bool guaranteed);
+	void flush();
+	void poll();
+
+private:
+	NetLoopbackHub& hub_;
+	DPNID id_;
+	NetBatch outgoing_;
+
+	struct Packet {
+		DPNID from;
+		vector<char> data;
+	};
+	list<Packet> incoming_; // hub_.lock_
+
+	NetLoopbackTransport(NetLoopbackHub& hub, DPNID id) : hub_(hub), id_(id) {}
+	friend class NetLoopbackHub;
+};
+
+//-------------------------------------------------
+/*
+: UDPHeader,   .
+sequence -      -
+( 1), 0 - . ack -      
+ ;    -  .
+    RESEND_TIME,    
+ ,        .
+*/
+class NetUDPTransport : public NetTransport
+{
+public:
+	enum {
+		MAX_DATAGRAM = 1400, //    
+		MAX_RECEIVE = 65536,
+		RESEND_TIME = 200 //ms
+	};
+
+	NetUDPTransport(DPNID id, unsigned short port);
+	~NetUDPTransport();
+
+	bool isOpen() const { return socket_ != INVALID_SOCKET; }
+	//ip, port -    
+	void addPeer(DPNID id, unsigned int ip, unsigned short port);
+	void removePeer(DPNID id);
+
+	const NetBatch& batch() const { return outgoing_; }
+	int resent() const { return resent_; }
+
+	DPNID localID() const { return id_; }
+	int send(const char* buffer, int size, DPNID to, bool guaranteed);
+	void flush();
+	void poll();
+
+private:
+	struct UDPHeader {
+		DPNID from;
+		unsigned int sequence;
+		unsigned int ack;
+	};
+
+	struct Datagram {
+		unsigned int sequence;
+		unsigned int time; // 
+		vector<char> data; // 
+	};
+	typedef map<unsigned int, vector<char> > DatagramMap;
+
+	struct Packet {
+		DPNID from;
+		vector<char> data;
+	};
+
+	struct Peer {
+		DPNID id;
+		sockaddr_in address;
+		unsigned int sendSequence; //  
+		list<Datagram> unacked;
+		unsigned int receiveSequence; //  
+		DatagramMap outOfOrder; //  
+		bool ackPending;
+	};
+
+	SOCKET socket_;
+	DPNID id_;
+	NetBatch outgoing_;
+	vector<Peer> peers_;
+	vector<char> receiveBuffer_;
+	list<Packet>* received_; //  poll,  lock_
+	int resent_;
+
+	CRITICAL_SECTION lock_;
+
+	Peer* findPeer(DPNID id);
+	void sendDatagram(Peer& peer, const char* data, int size, bool guaranteed, unsigned int time);
+	void sendRaw(const Peer& peer, const char* data, int size);
+	void receive(Peer& peer, const UDPHeader& header, const char* data, int size);
+	void deliver(Peer& peer, const char* data, int size);
+};
+
+//-------------------------------------------------
+struct sNetSimulation
+{
+	int latency; //ms
+	int jitter; //ms,  [0, jitter]
+	float loss; //0..1,  ,     RTT
+
+	sNetSimulation() { latency = 0; jitter = 0; loss = 0; }
+	bool active() const { return latency || jitter || loss > 0; }
+	//Network.ini [Simulation] Latency, Jitter, Loss( )
+	void load();
+};
+
+class NetSimulator : public NetTransport, public NetPacketSink
+{
+public:
+	//transport  
+	NetSimulator(NetTransport* transport, const sNetSimulation& settings);
+	~NetSimulator();
+
+	DPNID localID() const { return transport_->localID(); }
+	int send(const char* buffer, int size, DPNID to, bool guaranteed);
+	void flush() { flush(clocki()); }
+	void poll() { transport_->poll(); }
+
+	// ,     time
+	void flush(unsigned int time);
+
+	void receivePacket(DPNID from, const void* data, int size);
+
+	int dropped() const { return dropped_; }
+	int delayed() const { return delayed_; }
+
+private:
+	NetTransport* transport_;
+	sNetSimulation settings_;
+	unsigned int random_;
+
+	struct Packet {
+		unsigned int time;
+		DPNID to;
+		bool guaranteed;
+		vector<char> data;
+	};
+	list<Packet> queue_; //  time   
+	typedef map<DPNID, unsigned int> LastTimeMap;
+	LastTimeMap lastTime_;
+	unsigned int time_;
+
+	int dropped_;
+	int delayed_;
+
+	CRITICAL_SECTION lock_;
+
+	unsigned int random(unsigned int range);
+};
+
+//-------------------------------------------------
+//:   peers-1   NetLoopbackHub ( NetUDPTransport
+// 127.0.0.1)  NetSimulator,    commands 
+// ,    
+struct sNetBenchSettings
+{
+	int peers;
+	int quants;
+	int commands; //   
+	int quantInterval; //ms  
+	int udpPort; //0 - NetLoopbackHub
+	sNetSimulation simulation;
+
+	sNetBenchSettings() { peers = 8; quants = 1000; commands = 4; quantInterval = 100; udpPort = 0; }
+};
+
+struct sNetBench
+{
+	int quants;
+	int commands; // 
+	int bytes; // 
+	int packets; //send
+	int datagrams; // 
+	int dropped;
+	int resent; // UDP
+	float commandsPerQuant;
+	float bytesPerQuant;
+	float lateQuants; //    
+	double time; //ms  
+
+	sNetBench() { quants = commands = bytes = packets = datagrams = dropped = resent = 0; commandsPerQuant = bytesPerQuant = lateQuants = 0; time = 0; }
+};
+
+bool netTransportBenchmark(const sNetBenchSettings& settings, sNetBench& result);
+
+#endif //__NET_TRANSPORT_H__
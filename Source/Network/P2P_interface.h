@@ -4,6 +4,7 @@
 #include "ConnectionDP.h"
 #include "EventBufferDP.h"
 #include "CommonEvents.h"
+#include "NetTransport.h"
 
 
 #define _DBG_COMMAND_LIST
@@ -93,6 +94,9 @@ struct PClientData
 	vector<netCommand4H_BackGameInformation2> backGameInf2List;
 	unsigned int curLastQuant;
 
+	vector<QuantHash> quantHashes; //  netCommand4C_RequestQuantHashes
+	bool quantHashesReceived;
+
 	unsigned int lastTimeBackPacket;
 
 	unsigned int missionDescriptionIdx;
@@ -248,12 +252,13 @@ enum e_PNCStateHost{
 
 
 class GameSpyInterface;
-class PNetCenter {
+class PNetCenter : public NetPacketSink {
 public:
 	enum e_PNCWorkMode{
 		PNCWM_LAN,
 		PNCWM_ONLINE_GAMESPY,
 		PNCWM_ONLINE_P2P,
+		PNCWM_LOOPBACK, //   ,  DirectPlay
 	};
 	list<e_PNCInternalCommand> internalCommandList;
 	HANDLE hSecondThreadInitComplete;
@@ -317,7 +322,10 @@ public:
 	string         m_GameName;
 	bool           m_bStarted;
 
-	list<netCommandGeneral*>   m_CommandList;
+	//   ;      
+	vector<netCommandGame*>   m_CommandList;
+	//     
+	QuantCommandCodec quantCommandEncoder;
 	list<netCommand4G_ForcedDefeat*> m_DeletePlayerCommand;
 
 	void PNetCenter::ClearCommandList();
@@ -500,6 +508,27 @@ public:
 
 	bool isConnected();
 	int Send(const char* buffer, int size, DPNID dpnid, bool flag_guaranted=1);
+	int SendDP(const char* buffer, int size, DPNID dpnid, bool flag_guaranted=1);
+
+	// , 0 -  DirectPlay
+	NetTransport* transport;
+	void transportQuant();
+	void receivePacket(DPNID from, const void* data, int size);
+
+	//PNCWM_LOOPBACK (P2P_interfaceLoopback.cpp):   NetLoopbackHub ,
+	//    DirectPlayMessageHandler,   DirectPlay
+	bool isLoopback() const { return workMode==PNCWM_LOOPBACK; }
+	NetLoopbackTransport* loopbackLink; // transport
+	int ServerStartLoopback();
+	int ConnectLoopback(GUID _hostID);
+	int ConnectLoopback(); //   
+	void CloseLoopback();
+	void RemovePlayerLoopback(DPNID dpnid);
+	void refreshLoopbackGameHostList();
+	void loopbackQuant();
+	bool isLoopbackSessionMember(DPNID dpnid);
+	//DPN_MSGID_CREATE_PLAYER: playerFlags - DPNPLAYER_LOCAL, DPNPLAYER_HOST
+	void playerCreated(DPNID dpnid, DWORD playerFlags, void* playerContext);
 	bool FindHost(const char* lpszHost);
 	bool StartFindHostDP(const char* lpszHost="");
 	void StopFindHostDP(void);
@@ -549,6 +578,15 @@ public:
 	unsigned long hostGeneralCommandCounter;
 	unsigned int quantConfirmation;
 
+	//:  ,       
+	unsigned int desyncQuant;
+	unsigned int desyncRequestTime;
+	void requestQuantHashes(unsigned int quant);
+	bool quantHashesReady();
+	void reportDesync();
+	//       
+	void reportQuantCommandsLost(DPNID dpnid, unsigned int lastQuant);
+
 	DPNID dpnidClientWhichWeWait; //dpnid          ;        
 
 
@@ -27,6 +27,8 @@ const char* PNetCenter::getStrWorkMode()
 		return ("PNCWM_ONLINE_GAMESPY");
 	case PNCWM_ONLINE_P2P:
 		return("PNCWM_ONLINE_P2P");
+	case PNCWM_LOOPBACK:
+		return("PNCWM_LOOPBACK");
 	default:
 		return("PNCWM_???");
 	}
@@ -163,6 +165,23 @@ PNetCenter::PNetCenter(PNetCenter::e_PNCWorkMode _workMode, const char* playerNa
 
 	flag_NetworkSimulation=false;
 	if(IniManager("Network.ini").getInt("General", "NetworkSimulator")) flag_NetworkSimulation=true;
+
+	transport=0;
+	loopbackLink=0;
+	sNetSimulation simulation;
+	simulation.load();
+	if(isLoopback()){
+		loopbackLink=NetLoopbackHub::instance().createPeer();
+		if(simulation.active())
+			transport=new NetSimulator(loopbackLink, simulation);
+		else
+			transport=loopbackLink;
+		transport->setSink(this);
+	}
+	else if(simulation.active()){
+		transport=new NetSimulator(new NetDPTransport(*this), simulation);
+		transport->setSink(this);
+	}
 	flag_HostMigrate=false;
 	if(IniManager("Network.ini").getInt("General", "HostMigrate")) flag_HostMigrate=true;
 	flag_NoUseDPNSVR=false;
@@ -183,6 +202,8 @@ PNetCenter::PNetCenter(PNetCenter::e_PNCWorkMode _workMode, const char* playerNa
 	flag_SkipProcessingGameCommand=0;
 	hostPause=0;
 	clientPause=0;
+	desyncQuant=0;
+	desyncRequestTime=0;
 	clientInPacketPause=0;
 
 	m_quantInterval=NORMAL_QUANT_INTERVAL;
@@ -310,6 +331,8 @@ PNetCenter::~PNetCenter()
 	//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 	m_DPPacketList.clear();
 
+	delete transport;
+
 
 
 	DeleteCriticalSection(&m_GeneralLock);
@@ -859,6 +882,10 @@ static const GUID zeroGUID= { 0, 0, 0, { 0, 0, 0, 0, 0, 0, 0, 0 } };
 
 void PNetCenter::refreshLanGameHostList()
 {
+	if(isLoopback()){
+		refreshLoopbackGameHostList();
+		return;
+	}
 	clearGameHostList();
 	char txtBufHostName[MAX_PATH];
 	char txtBufGameName[MAX_PATH];
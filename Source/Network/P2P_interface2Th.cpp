@@ -51,6 +51,7 @@ PClientData::PClientData(unsigned int mdIdx, DPNID dpnid, const char* descr)// :
 	curLastQuant=0;
 	lastTimeBackPacket=clocki();
 	confirmQuant=0;
+	quantHashesReceived=0;
 
 	requestPause=0;
 	clientPause=0;
@@ -318,6 +319,7 @@ bool PNetCenter::SecondThread(void)
 			}
 		}
 
+		transportQuant();
 		if(isHost()){
 			HostReceiveQuant();
 		}
@@ -339,6 +341,8 @@ bool PNetCenter::SecondThread(void)
 			m_nextQuantTime+=m_quantInterval;//m_quantPeriod;
 			if(minWakingTime > m_nextQuantTime) minWakingTime=m_nextQuantTime;
 			LLogicQuant();
+			CAutoLock _lock(&m_GeneralLock);
+			transportQuant();
 		}
 
 
@@ -449,9 +453,107 @@ void PNetCenter::ResetAllClients()
 		(*k)->m_flag_Ready=0;
 		(*k)->lastTimeBackPacket=curTime;//    
 		(*k)->backGameInf2List.clear();
+		(*k)->quantHashes.clear();
+		(*k)->quantHashesReceived=0;
 	}
 }
 
+void PNetCenter::requestQuantHashes(unsigned int quant)
+{
+	desyncQuant=quant;
+	desyncRequestTime=clocki();
+	ClientMapType::iterator k;
+	for(k=m_clients.begin(); k!=m_clients.end(); k++){
+		(*k)->quantHashes.clear();
+		(*k)->quantHashesReceived=0;
+	}
+	//   -     
+	unsigned int begQuant= quantConfirmation==netCommandNextQuant::NOT_QUANT_CONFIRMATION ? 1 : quantConfirmation+1;
+	SendEvent(netCommand4C_RequestQuantHashes(begQuant, quant), DPNID_ALL_PLAYERS_GROUP);
+}
+
+bool PNetCenter::quantHashesReady()
+{
+	if(clocki() > desyncRequestTime + TIMEOUT_CLIENT_OR_SERVER_RECEIVE_INFORMATION)
+		return true;
+	ClientMapType::iterator k;
+	for(k=m_clients.begin(); k!=m_clients.end(); k++){
+		if(!(*k)->quantHashesReceived)
+			return false;
+	}
+	return true;
+}
+
+void PNetCenter::reportDesync()
+{
+	SendEvent(netCommand4C_SaveLog(), DPNID_ALL_PLAYERS_GROUP/*m_dpnidGroupGame*/);
+
+	//     ,    
+	ClientMapType::iterator k;
+	PClientData* first=*m_clients.begin();
+	PClientData* desyncClient=0;
+	unsigned int desyncMask=0;
+	unsigned int firstQuant=UINT_MAX;
+	for(k=m_clients.begin()+1; k!=m_clients.end(); k++){
+		unsigned int quant;
+		unsigned int mask=findQuantHashMismatch(first->quantHashes, (*k)->quantHashes, quant);
+		if(mask && quant < firstQuant){
+			firstQuant=quant;
+			desyncMask=mask;
+			desyncClient=*k;
+		}
+	}
+
+	XBuffer subsystems(256, 1);
+	for(int s=0; s<QUANT_HASH_MAX; s++){
+		if(desyncMask & (1<<s))
+			subsystems < " " < QuantHash::subsystemName(s);
+	}
+
+	XBuffer to(1024,1);
+	XStream f("outnet.log", XS_OUT);
+	f < currentVersion < "\r\n";
+	f < "Unmatched game quants !" < "on Quant=" <= desyncQuant < "\r\n";
+	to < "Unmatched game quants !" < "on Quant=" <= desyncQuant;
+	if(desyncClient){
+		int n=hostMissionDescription.findPlayer(desyncClient->dpnidPlayer);
+		f < "First mismatch: Quant=" <= firstQuant < " subsystems:" < subsystems.address();
+		if(n!=-1) f < " player=" < hostMissionDescription.playersData[n].name();
+		f < "\r\n";
+		to < "\nFirst mismatch: Quant=" <= firstQuant < " subsystems:" < subsystems.address();
+	}
+	else
+		f < "Quant hashes are not received or equal\r\n";
+
+	for(k=m_clients.begin(); k!=m_clients.end(); k++){
+		int n=hostMissionDescription.findPlayer((*k)->dpnidPlayer);
+		f < "\r\nClient " < (n!=-1 ? hostMissionDescription.playersData[n].name() : (*k)->m_szDescription) < "\r\n";
+		writeQuantHashes(f, (*k)->quantHashes);
+	}
+	f.close();
+
+	::MessageBox(0, to, "Error network synchronization", MB_OK|MB_ICONERROR);
+}
+
+void PNetCenter::reportQuantCommandsLost(DPNID dpnid, unsigned int lastQuant)
+{
+	int n=hostMissionDescription.findPlayer(dpnid);
+	XBuffer to(1024,1);
+	XStream f("outnet.log", XS_OUT);
+	f < currentVersion < "\r\n";
+	f < "Quant commands history lost !" < " LastQuant=" <= lastQuant < " HostQuant=" <= m_numberGameQuant;
+	to < "Quant commands history lost !" < " LastQuant=" <= lastQuant < " HostQuant=" <= m_numberGameQuant;
+	if(n!=-1){
+		f < " player=" < hostMissionDescription.playersData[n].name();
+		to < "\nplayer=" < hostMissionDescription.playersData[n].name();
+	}
+	f < "\r\n";
+	f.close();
+	LogMsg("Quant commands: history lost\n");
+
+	::MessageBox(0, to, "Error network synchronization", MB_OK|MB_ICONERROR);
+}
+
 void PNetCenter::DumpClients()
 {
 	LogMsg("Dumping clients---------------------------\n");
@@ -518,7 +620,7 @@ void PNetCenter::SendEvent(netCommandGeneral& event, DPNID dpnid, bool flag_guar
 
 void PNetCenter::ClearCommandList()
 {
-	list<netCommandGeneral*>::iterator m;
+	vector<netCommandGame*>::iterator m;
 	for(m=m_CommandList.begin(); m!=m_CommandList.end(); m++)
 		delete *m;
 	m_CommandList.clear();
@@ -643,7 +745,9 @@ void PNetCenter::LLogicQuant()
 				quantConfirmation=netCommandNextQuant::NOT_QUANT_CONFIRMATION;
 				m_nQuantCommandCounter=0;
 				m_numberGameQuant= 1;//!
+				quantCommandEncoder.reset();
 				hostPause=0;
+				desyncQuant=0;
 
 			}
 		}
@@ -687,17 +791,15 @@ void PNetCenter::LLogicQuant()
 							else {
 								//   netCommand4H_BackGameInformation2
 								if( (*firstList.begin()).signature_ != (*secondList.begin()).signature_ ){
-									SendEvent(netCommand4C_SaveLog(), DPNID_ALL_PLAYERS_GROUP/*m_dpnidGroupGame*/);
-									XBuffer to(1024,1);
-									XStream f("outnet.log", XS_OUT);
-									f < currentVersion < "\r\n";
-									f < "Unmatched game quants !" < "on Quant=" <= (*firstList.begin()).quant_;
-									f.close();
-
-									to < "Unmatched game quants !" < "on Quant=" <= (*firstList.begin()).quant_;
-									::MessageBox(0, to, "Error network synchronization", MB_OK|MB_ICONERROR);
-									ExecuteInternalCommand(PNC_COMMAND__ABORT_PROGRAM, false);
-									return;
+									//   ,  -    
+									if(!desyncQuant)
+										requestQuantHashes((*firstList.begin()).quant_);
+									else if(quantHashesReady()){
+										reportDesync();
+										ExecuteInternalCommand(PNC_COMMAND__ABORT_PROGRAM, false);
+										return;
+									}
+									goto end_while_01;
 								}
 							}
 							///else xassert(0 && " ");
@@ -719,7 +821,6 @@ void PNetCenter::LLogicQuant()
 
 end_while_01:;
 
-			string notResponceClientList;
 			ClientMapType::iterator k;
 			unsigned int maxInternalLagQuant=0;
 			unsigned short minClientExecutionQuat=m_numberGameQuant;
@@ -730,11 +831,6 @@ end_while_01:;
 				if((*k)->lastExecuteQuant < minClientExecutionQuat) {//   
 					minClientExecutionQuat=(*k)->lastExecuteQuant;
 				}
-				if(clocki() > ((*k)->lastTimeBackPacket + TIMEOUT_CLIENT_OR_SERVER_RECEIVE_INFORMATION)){
-					DPNID d=(*k)->dpnidPlayer;
-					int n=hostMissionDescription.findPlayer(d);
-					if(n!=-1) { notResponceClientList+=hostMissionDescription.playersData[n].name(); notResponceClientList+=' '; }
-				}
 			}
 			///     !
 			//const unsigned int MAX_LAG_QUANT_WAIT=4;
@@ -796,67 +892,24 @@ end_while_01:;
 
 
 			//  , , 
-			if(!m_CommandList.empty()){
-				list<netCommandGeneral*>::iterator p=m_CommandList.end();
-				p--; // 
-				if((*p)->EventID==NETCOM_4G_ID_UNIT_COMMAND || (*p)->EventID==NETCOM_4G_ID_REGION || (*p)->EventID==NETCOM_4G_ID_FORCED_DEFEAT){
-					(static_cast<netCommandGame*>(*p))->setFlagLastCommandInQuant();
-				}
-				else xassert("Error in commands list on server");
-			}
+			if(!m_CommandList.empty())
+				m_CommandList.back()->setFlagLastCommandInQuant();
 
 			///hostGeneralCommandCounter+=m_CommandList.size(); //   PutGameCommand2Queue_andAutoDelete
 
-			if(0){
-				static bool flag_timeOut=0; //    !!!
-				if(!flag_timeOut) {
-					if(!notResponceClientList.empty()){
-						netCommandNextQuant* pcom=new netCommandNextQuant(m_numberGameQuant, m_nQuantCommandCounter, hostGeneralCommandCounter, quantConfirmation, true);
-						m_CommandList.push_back(pcom);
-
-						netCommand4C_ClientIsNotResponce* pnr=new netCommand4C_ClientIsNotResponce(notResponceClientList);
-						m_CommandList.push_back(pnr);
-						flag_timeOut=1;
-					}
-					else {
-						netCommandNextQuant* pcom=new netCommandNextQuant(m_numberGameQuant, m_nQuantCommandCounter, hostGeneralCommandCounter, quantConfirmation);
-						m_CommandList.push_back(pcom);
-					}
-				}
-				else {
-					if(!notResponceClientList.empty()){
-						netCommand4C_ClientIsNotResponce* pnr=new netCommand4C_ClientIsNotResponce(notResponceClientList);
-						m_CommandList.push_back(pnr);
-					}
-					else {
-						netCommandNextQuant* pcom=new netCommandNextQuant(m_numberGameQuant, m_nQuantCommandCounter, hostGeneralCommandCounter, quantConfirmation);
-						m_CommandList.push_back(pcom);
-					}
-				}
-			}
-			else {
-				//   
-				netCommandNextQuant* pcom=new netCommandNextQuant(m_numberGameQuant, m_nQuantCommandCounter, hostGeneralCommandCounter, quantConfirmation);
-				m_CommandList.push_back(pcom);
-			}
-
-
-	//		if(!DbgPause())
-	//		{
-				list<netCommandGeneral*>::iterator i;
+			if(!m_CommandList.empty()){
+				quantCommandEncoder.beginEncode(m_numberGameQuant);
+				vector<netCommandGame*>::iterator i;
 				FOR_EACH(m_CommandList, i)
-				{
-					if((**i).EventID==NETCOM_ID_NEXT_QUANT || (**i).EventID==NETCOM_4C_ID_CLIENT_IS_NOT_RESPONCE){
-						SendEvent(**i, DPNID_ALL_PLAYERS_GROUP/*m_dpnidGroupGame*/, false);//  !!!
-					}
-					else { 
-						SendEvent(**i, DPNID_ALL_PLAYERS_GROUP/*m_dpnidGroupGame*/);
-					}
-					delete *i;
-				}
+					quantCommandEncoder.encode(**i);
+				netCommand4C_QuantCommands nc=quantCommandEncoder.encoded();
+				quantCommandEncoder.storeEncoded();
+				SendEvent(nc, DPNID_ALL_PLAYERS_GROUP/*m_dpnidGroupGame*/);
+				ClearCommandList();
+			}
 
-				m_CommandList.clear();
-	//		}
+			netCommandNextQuant nextQuant(m_numberGameQuant, m_nQuantCommandCounter, hostGeneralCommandCounter, quantConfirmation);
+			SendEvent(nextQuant, DPNID_ALL_PLAYERS_GROUP/*m_dpnidGroupGame*/, false);//  !!!
 
 
 			m_numberGameQuant++;
@@ -1334,6 +1387,32 @@ void PNetCenter::HostReceiveQuant()
 							(*p)->lastTimeBackPacket=clocki();
 						}
 						break;
+					case NETCOM_4H_ID_QUANT_HASHES:
+						{
+							netCommand4H_QuantHashes nc(in_HostBuf);
+							(*p)->quantHashes.swap(nc.hashes);
+							(*p)->quantHashesReceived=1;
+							(*p)->lastTimeBackPacket=clocki();
+						}
+						break;
+					case NETCOM_4H_ID_REQUEST_QUANT_COMMANDS:
+						{
+							netCommand4H_RequestQuantCommands nc(in_HostBuf);
+							vector<netCommand4C_QuantCommands> packets;
+							if(quantCommandEncoder.encodedAfter(nc.lastQuant_, packets)){
+								vector<netCommand4C_QuantCommands>::iterator k;
+								FOR_EACH(packets, k)
+									SendEvent(*k, (*p)->dpnidPlayer);
+							}
+							else {
+								//     -    
+								// ,     
+								reportQuantCommandsLost((*p)->dpnidPlayer, nc.lastQuant_);
+								ExecuteInternalCommand(PNC_COMMAND__ABORT_PROGRAM, false);
+								return;
+							}
+						}
+						break;
 					case NETCOM_4H_ID_ALIFE_PACKET:
 						{
 							netCommand4H_AlifePacket nc(in_HostBuf);
@@ -1398,13 +1477,17 @@ void PNetCenter::HostReceiveQuant()
 							netCommandNextQuant netCommandNextQuant(nci.endQuantCommandTransmit, m_nQuantCommandCounter, hostGeneralCommandCounter, netCommandNextQuant::NOT_QUANT_CONFIRMATION);
 							SendEvent(netCommandNextQuant, DPNID_ALL_PLAYERS_GROUP/*m_dpnidGroupGame*/);
 
-							terHyperSpace::clearListGameCommands(tmpListGameCommands);
+							vector<netCommandGame*>::iterator k;
+							for(k=tmpListGameCommands.begin(); k!=tmpListGameCommands.end(); k++)
+								delete *k;
+							tmpListGameCommands.clear();
 
 							//Init game counter afte MigrateHost
 							//hostGeneralCommandCounter; //  
 							quantConfirmation=netCommandNextQuant::NOT_QUANT_CONFIRMATION;
 							m_nQuantCommandCounter=0;
 							m_numberGameQuant=nci.endQuantCommandTransmit+1;//!
+							quantCommandEncoder.reset();
 							///ClearDeletePlayerGameCommand();
 							ClearCommandList();
 							//   
@@ -1475,6 +1558,27 @@ void PNetCenter::HostReceiveQuant()
 }
 
 
+// m_GeneralLock
+void PNetCenter::transportQuant()
+{
+	if(transport){
+		transport->poll();
+		if(isLoopback())
+			loopbackQuant();
+		transport->flush();
+	}
+}
+
+void PNetCenter::receivePacket(DPNID from, const void* data, int size)
+{
+	CAutoLock _lock(&m_GeneralLock);
+	//      -       
+	if(isLoopback() && !isLoopbackSessionMember(from))
+		return;
+	m_DPPacketList.push_back(XDPacket());
+	m_DPPacketList.back().set(from, size, data);
+}
+
 void PNetCenter::UnLockInputPacket(void)
 {
 	if(flag_LockIputPacket) flag_LockIputPacket--;
@@ -122,6 +122,9 @@ XDPConnection::~XDPConnection()
 
 bool PNetCenter::Init(void)
 {
+	if(isLoopback())
+		return 1;
+
     HRESULT hr;
 //	hr = CoCreateInstance(CLSID_DirectPlay8Peer, NULL, 
 //                          CLSCTX_INPROC_SERVER,
@@ -181,6 +184,8 @@ bool PNetCenter::Init(void)
 int PNetCenter::ServerStart(const char* _name, int port)
 {
 	//m_mode = DP_SERVER;
+	if(isLoopback())
+		return ServerStartLoopback();
 
     HRESULT hr;
     PDIRECTPLAY8ADDRESS pDP8AddrLocal = NULL;
@@ -314,6 +319,8 @@ GUID PNetCenter::getHostGUIDInstance()
 
 void PNetCenter::SetConnectionTimeout(int ms)
 {
+	if(isLoopback())
+		return;
 /*	DPN_CAPS caps;
 	caps.dwSize = sizeof(DPN_CAPS);
 
@@ -351,6 +358,8 @@ void PNetCenter::SetConnectionTimeout(int ms)
 }
 int PNetCenter::GetConnectionTimeout(void)
 {
+	if(isLoopback())
+		return 0;
 	//DPN_CAPS caps;
 	//caps.dwSize = sizeof(DPN_CAPS);
 	//m_pDPPeer->GetCaps(&caps, 0);
@@ -406,6 +415,8 @@ void PNetCenter::RemovePlayer(DPNID dpnid)
 			ExecuteInternalCommand(PNC_COMMAND__END_GAME, false);
 			ExecuteInterfaceCommand(PNC_INTERFACE_COMMAND_HOST_TERMINATED_GAME);
 		}
+		else if(isLoopback())
+			RemovePlayerLoopback(dpnid);
 		else {
 			char destroyInfo[]={'t', '1', 0};
 			HRESULT hr = m_pDPPeer->DestroyPeer(dpnid, destroyInfo, sizeof(destroyInfo), 0);
@@ -538,6 +549,10 @@ void PNetCenter::Close(bool flag_immediatle)
 		break;
 	}
 	RELEASE(m_pDPServer);*/
+	if(isLoopback()){
+		CloseLoopback();
+		return;
+	}
 	if(flag_immediatle) m_pDPPeer->Close(DPNCLOSE_IMMEDIATE);
 	else m_pDPPeer->Close(0);
 	RELEASE(m_pDPPeer);
@@ -554,6 +569,9 @@ int PNetCenter::Connect(GUID _hostID) //const char* lpszHost, int port)
 
 	m_nClientSgnCheckError = 0;
 
+	if(isLoopback())
+		return ConnectLoopback(_hostID);
+
     // Create IDirectPlay8Client
 //    hr = CoCreateInstance(CLSID_DirectPlay8Client, 0, 
 //                          CLSCTX_INPROC_SERVER,
@@ -655,6 +673,8 @@ int PNetCenter::Connect(unsigned int ip)//, int port
 {
 	//if(!ip)
 	//	return Connect((const char*)0, port);
+	if(isLoopback())
+		return ConnectLoopback();
 
 	///ServerStart("qqq", PERIMETER_DEFAULT_PORT);
 	char ip_string[17];
@@ -747,6 +767,13 @@ bool PNetCenter::isConnected()
 
 
 int PNetCenter::Send(const char* buffer, int size, DPNID dpnid, bool flag_guaranted)
+{
+	if(transport)
+		return transport->send(buffer, size, dpnid, flag_guaranted);
+	return SendDP(buffer, size, dpnid, flag_guaranted);
+}
+
+int PNetCenter::SendDP(const char* buffer, int size, DPNID dpnid, bool flag_guaranted)
 {
 
 	DPNHANDLE hAsync;
@@ -905,6 +932,8 @@ bool PNetCenter::FindHost(const char* lpszHost)
 bool PNetCenter::StartFindHostDP(const char* lpszHost)
 {
 	clearInternalFoundHostList();
+	if(isLoopback())
+		return 1; //      refreshLanGameHostList
 
 	bool result=1;
     HRESULT hr;
@@ -1049,6 +1078,9 @@ bool PNetCenter::StartFindHostDP(const char* lpszHost)
 
 void PNetCenter::StopFindHostDP(void)
 {
+	if(isLoopback())
+		return;
+
     HRESULT hr;
 //	vector<DPNHANDLE>::iterator p;
 //	for(p=m_hEnumAsyncOp_Arr.begin(); p!=m_hEnumAsyncOp_Arr.end(); p++){
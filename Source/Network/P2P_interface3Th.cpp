@@ -170,15 +170,7 @@ HRESULT PNetCenter::DirectPlayMessageHandler(DWORD dwMessageId, PVOID pMsgBuffer
 
 				hr = m_pDP->GetPeerInfo( dpnid, pdpPlayerInfo, &dwSize, 0 );
 				if( SUCCEEDED(hr) ) {
-                    if( pdpPlayerInfo->dwPlayerFlags & DPNPLAYER_LOCAL )
-                        m_localDPNID=dpnid;
-					if( pdpPlayerInfo->dwPlayerFlags & DPNPLAYER_HOST )
-						m_hostDPNID=dpnid;
-					//
-					if( (pdpPlayerInfo->dwPlayerFlags&DPNPLAYER_LOCAL)==0 && isHost()){// 
-						setDPNIDInClientsDate((unsigned int)pCreatePlayerMsg->pvPlayerContext, pCreatePlayerMsg->dpnidPlayer);
-					}
-
+					playerCreated(dpnid, pdpPlayerInfo->dwPlayerFlags, pCreatePlayerMsg->pvPlayerContext);
 				}
 
 				hr=S_OK;
@@ -392,6 +384,19 @@ LErrorReturn:
 	return S_OK;
 }
 
+void PNetCenter::playerCreated(DPNID dpnid, DWORD playerFlags, void* playerContext)
+{
+	CAutoLock _lock(&m_GeneralLock);
+	if( playerFlags & DPNPLAYER_LOCAL )
+		m_localDPNID=dpnid;
+	if( playerFlags & DPNPLAYER_HOST )
+		m_hostDPNID=dpnid;
+	//
+	if( (playerFlags&DPNPLAYER_LOCAL)==0 && isHost()){// 
+		setDPNIDInClientsDate((unsigned int)playerContext, dpnid);
+	}
+}
+
 void PNetCenter::setDPNIDInClientsDate(const int missionDescriptionIdx, DPNID dpnid)
 {
 	hostMissionDescription.setChanged();
@@ -0,0 +1,351 @@
+#include "StdAfx.h"
+
+#include "P2P_interface.h"
+
+#include "P2P_interfaceAux.h"
+
+#include <algorithm>
+
+/*
+	 PNCWM_LOOPBACK:  PNetCenter     NetLoopbackHub.
+	  -   ;    (,  ,
+	 ,  )      
+	 loopbackQuant  PNetCenter   m_GeneralLock,   
+	 PNetCenter    .   - 
+	 ,     .
+*/
+
+enum {
+	LOOPBACK_CONNECT_TIMEOUT=10000
+};
+
+struct sLoopbackEvent {
+	DWORD messageID; //DPN_MSGID_INDICATE_CONNECT, CONNECT_COMPLETE, DESTROY_PLAYER, TERMINATE_SESSION
+	DPNID from;
+	DPNID dpnid;
+	DWORD reason;
+	HRESULT result;
+	vector<char> data; //sConnectInfo  sReplyConnectInfo
+};
+
+struct sLoopbackSession {
+	GUID guid;
+	DPNID host;
+	vector<DPNID> members; // 
+	string gameName;
+	sGameStatusInfo statusInfo;
+
+	bool isMember(DPNID dpnid) const {
+		return find(members.begin(), members.end(), dpnid)!=members.end();
+	}
+	void removeMember(DPNID dpnid) {
+		vector<DPNID>::iterator i=find(members.begin(), members.end(), dpnid);
+		if(i!=members.end())
+			members.erase(i);
+	}
+};
+
+class LoopbackSessions
+{
+public:
+	CRITICAL_SECTION lock;
+	list<sLoopbackSession> sessions;
+	map<DPNID, list<sLoopbackEvent> > events;
+
+	LoopbackSessions() { InitializeCriticalSection(&lock); }
+	~LoopbackSessions() { DeleteCriticalSection(&lock); }
+
+	sLoopbackSession* findByGUID(const GUID& guid) {
+		list<sLoopbackSession>::iterator i;
+		FOR_EACH(sessions, i)
+			if(i->guid==guid)
+				return &*i;
+		return 0;
+	}
+	sLoopbackSession* findByMember(DPNID dpnid) {
+		list<sLoopbackSession>::iterator i;
+		FOR_EACH(sessions, i)
+			if(i->isMember(dpnid))
+				return &*i;
+		return 0;
+	}
+	void removeSession(const sLoopbackSession* session) {
+		list<sLoopbackSession>::iterator i;
+		FOR_EACH(sessions, i)
+			if(&*i==session){
+				sessions.erase(i);
+				return;
+			}
+	}
+
+	sLoopbackEvent& post(DPNID to, DWORD messageID, DPNID from) {
+		list<sLoopbackEvent>& queue=events[to];
+		queue.push_back(sLoopbackEvent());
+		sLoopbackEvent& event=queue.back();
+		event.messageID=messageID;
+		event.from=from;
+		event.dpnid=0;
+		event.reason=0;
+		event.result=S_OK;
+		return event;
+	}
+	void postDestroyPlayer(DPNID to, DPNID dpnid, DWORD reason) {
+		sLoopbackEvent& event=post(to, DPN_MSGID_DESTROY_PLAYER, dpnid);
+		event.dpnid=dpnid;
+		event.reason=reason;
+	}
+	void postTerminateSession(DPNID to, DPNID from) {
+		post(to, DPN_MSGID_TERMINATE_SESSION, from).result=DPNERR_HOSTTERMINATEDSESSION;
+	}
+};
+
+static LoopbackSessions loopbackSessions;
+
+
+int PNetCenter::ServerStartLoopback()
+{
+	DPNID dpnid=loopbackLink->localID();
+	{
+		CAutoLock lock(&loopbackSessions.lock);
+		xassert(!loopbackSessions.findByMember(dpnid));
+		loopbackSessions.sessions.push_back(sLoopbackSession());
+		sLoopbackSession& session=loopbackSessions.sessions.back();
+		CoCreateGuid(&session.guid);
+		session.host=dpnid;
+		session.members.push_back(dpnid);
+		session.gameName=m_GameName;
+	}
+	playerCreated(dpnid, DPNPLAYER_LOCAL | DPNPLAYER_HOST, 0);
+	flag_connected=1;
+	LogMsg("Loopback session started, host 0x%X\n", dpnid);
+	return 1;
+}
+
+// DPNCONNECT_SYNC:   ,     loopbackQuant
+int PNetCenter::ConnectLoopback(GUID _hostID)
+{
+	DPNID dpnid=loopbackLink->localID();
+	DPNID hostID;
+	{
+		CAutoLock lock(&loopbackSessions.lock);
+		sLoopbackSession* session=loopbackSessions.findByGUID(_hostID);
+		if(!session)
+			return 0;
+		hostID=session->host;
+
+		static sDigitalGameVersion dgv(true);
+		sConnectInfo connectInfo;
+		connectInfo.set(internalPlayerData, gamePassword.c_str(), dgv);
+		sLoopbackEvent& event=loopbackSessions.post(hostID, DPN_MSGID_INDICATE_CONNECT, dpnid);
+		event.data.assign((char*)&connectInfo, (char*)&connectInfo + sizeof(connectInfo));
+	}
+
+	sLoopbackEvent reply;
+	bool replied=false;
+	int timeEnd=clocki() + LOOPBACK_CONNECT_TIMEOUT;
+	while(!replied && clocki() < timeEnd){
+		Sleep(10);
+		CAutoLock lock(&loopbackSessions.lock);
+		list<sLoopbackEvent>& queue=loopbackSessions.events[dpnid];
+		list<sLoopbackEvent>::iterator i;
+		FOR_EACH(queue, i)
+			if(i->messageID==DPN_MSGID_CONNECT_COMPLETE){
+				reply=*i;
+				queue.erase(i);
+				replied=true;
+				break;
+			}
+	}
+
+	if(!replied){
+		//      
+		CAutoLock lock(&loopbackSessions.lock);
+		sLoopbackSession* session=loopbackSessions.findByMember(dpnid);
+		if(session){
+			session->removeMember(dpnid);
+			loopbackSessions.postDestroyPlayer(session->host, dpnid, DPNDESTROYPLAYERREASON_CONNECTIONLOST);
+		}
+		reply.result=DPNERR_TIMEDOUT;
+	}
+	else if(SUCCEEDED(reply.result)){
+		playerCreated(dpnid, DPNPLAYER_LOCAL, 0);
+		playerCreated(hostID, DPNPLAYER_HOST, 0);
+	}
+
+	DPNMSG_CONNECT_COMPLETE msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.dwSize=sizeof(msg);
+	msg.hResultCode=reply.result;
+	if(!reply.data.empty()){
+		msg.pvApplicationReplyData=&reply.data[0];
+		msg.dwApplicationReplyDataSize=reply.data.size();
+	}
+	DirectPlayMessageHandler(DPN_MSGID_CONNECT_COMPLETE, &msg);
+
+	if(FAILED(reply.result))
+		return 0;
+	flag_connected=1;
+	return 1;
+}
+
+int PNetCenter::ConnectLoopback()
+{
+	GUID guid;
+	{
+		CAutoLock lock(&loopbackSessions.lock);
+		if(loopbackSessions.sessions.empty())
+			return 0;
+		guid=loopbackSessions.sessions.front().guid;
+	}
+	return ConnectLoopback(guid);
+}
+
+void PNetCenter::CloseLoopback()
+{
+	DPNID dpnid=loopbackLink->localID();
+	{
+		CAutoLock lock(&loopbackSessions.lock);
+		sLoopbackSession* session=loopbackSessions.findByMember(dpnid);
+		if(session){
+			vector<DPNID>::iterator i;
+			if(session->host==dpnid){
+				FOR_EACH(session->members, i)
+					if(*i!=dpnid)
+						loopbackSessions.postTerminateSession(*i, dpnid);
+				loopbackSessions.removeSession(session);
+			}
+			else {
+				session->removeMember(dpnid);
+				FOR_EACH(session->members, i)
+					loopbackSessions.postDestroyPlayer(*i, dpnid, DPNDESTROYPLAYERREASON_NORMAL);
+			}
+		}
+		loopbackSessions.events.erase(dpnid);
+	}
+	flag_connected=0;
+}
+
+void PNetCenter::RemovePlayerLoopback(DPNID dpnid)
+{
+	CAutoLock lock(&loopbackSessions.lock);
+	sLoopbackSession* session=loopbackSessions.findByMember(loopbackLink->localID());
+	if(!session || session->host!=loopbackLink->localID() || !session->isMember(dpnid))
+		return;
+	session->removeMember(dpnid);
+	loopbackSessions.postTerminateSession(dpnid, session->host);
+	vector<DPNID>::iterator i;
+	FOR_EACH(session->members, i)
+		loopbackSessions.postDestroyPlayer(*i, dpnid, DPNDESTROYPLAYERREASON_HOSTDESTROYEDPLAYER);
+}
+
+void PNetCenter::refreshLoopbackGameHostList()
+{
+	clearGameHostList();
+	DPNID dpnid=loopbackLink->localID();
+	CAutoLock lock(&loopbackSessions.lock);
+	list<sLoopbackSession>::iterator i;
+	FOR_EACH(loopbackSessions.sessions, i){
+		if(i->host==dpnid)
+			continue;
+		char txtBufPort[20];
+		sprintf(txtBufPort, "%u", i->host);
+		gameHostList.push_back(new sGameHostInfo(i->guid, "loopback", txtBufPort, i->gameName.c_str(), i->statusInfo));
+	}
+}
+
+bool PNetCenter::isLoopbackSessionMember(DPNID dpnid)
+{
+	CAutoLock lock(&loopbackSessions.lock);
+	sLoopbackSession* session=loopbackSessions.findByMember(loopbackLink->localID());
+	return session && session->isMember(dpnid);
+}
+
+// m_GeneralLock
+void PNetCenter::loopbackQuant()
+{
+	DPNID dpnid=loopbackLink->localID();
+
+	//       -   ,   DPN_MSGID_ENUM_HOSTS_QUERY
+	sGameStatusInfo statusInfo;
+	bool published=false;
+	if(isHost()){
+		DPNMSG_ENUM_HOSTS_QUERY query;
+		memset(&query, 0, sizeof(query));
+		query.dwSize=sizeof(query);
+		query.dwMaxResponseDataSize=sizeof(sGameStatusInfo);
+		DirectPlayMessageHandler(DPN_MSGID_ENUM_HOSTS_QUERY, &query);
+		if(query.dwResponseDataSize==sizeof(sGameStatusInfo)){
+			statusInfo=*(sGameStatusInfo*)query.pvResponseData;
+			published=true;
+		}
+	}
+
+	list<sLoopbackEvent> events;
+	{
+		CAutoLock lock(&loopbackSessions.lock);
+		map<DPNID, list<sLoopbackEvent> >::iterator queue=loopbackSessions.events.find(dpnid);
+		if(queue!=loopbackSessions.events.end())
+			events.swap(queue->second);
+		sLoopbackSession* session=loopbackSessions.findByMember(dpnid);
+		if(published && session && session->host==dpnid){
+			session->statusInfo=statusInfo;
+			session->gameName=m_GameName;
+		}
+	}
+
+	list<sLoopbackEvent>::iterator i;
+	FOR_EACH(events, i){
+		switch(i->messageID){
+		case DPN_MSGID_INDICATE_CONNECT:
+			{
+				DPNMSG_INDICATE_CONNECT msg;
+				memset(&msg, 0, sizeof(msg));
+				msg.dwSize=sizeof(msg);
+				if(!i->data.empty()){
+					msg.pvUserConnectData=&i->data[0];
+					msg.dwUserConnectDataSize=i->data.size();
+				}
+				HRESULT hr=DirectPlayMessageHandler(DPN_MSGID_INDICATE_CONNECT, &msg);
+				bool accepted=false;
+				if(SUCCEEDED(hr)){
+					CAutoLock lock(&loopbackSessions.lock);
+					sLoopbackSession* session=loopbackSessions.findByMember(dpnid);
+					if(session && session->host==dpnid){
+						session->members.push_back(i->from);
+						accepted=true;
+					}
+				}
+				if(accepted)
+					playerCreated(i->from, 0, msg.pvPlayerContext);
+				else if(SUCCEEDED(hr))
+					DeleteClientByMissionDescriptionIdx((unsigned int)msg.pvPlayerContext);
+
+				CAutoLock lock(&loopbackSessions.lock);
+				sLoopbackEvent& reply=loopbackSessions.post(i->from, DPN_MSGID_CONNECT_COMPLETE, dpnid);
+				reply.result=accepted ? S_OK : DPNERR_HOSTREJECTEDCONNECTION;
+				if(msg.pvReplyData)
+					reply.data.assign((char*)msg.pvReplyData, (char*)msg.pvReplyData + msg.dwReplyDataSize);
+			}
+			break;
+		case DPN_MSGID_DESTROY_PLAYER:
+			{
+				DPNMSG_DESTROY_PLAYER msg;
+				memset(&msg, 0, sizeof(msg));
+				msg.dwSize=sizeof(msg);
+				msg.dpnidPlayer=i->dpnid;
+				msg.dwReason=i->reason;
+				DirectPlayMessageHandler(DPN_MSGID_DESTROY_PLAYER, &msg);
+			}
+			break;
+		case DPN_MSGID_TERMINATE_SESSION:
+			{
+				DPNMSG_TERMINATE_SESSION msg;
+				memset(&msg, 0, sizeof(msg));
+				msg.dwSize=sizeof(msg);
+				msg.hResultCode=i->result;
+				DirectPlayMessageHandler(DPN_MSGID_TERMINATE_SESSION, &msg);
+			}
+			break;
+		}
+	}
+}
@@ -9,9 +9,25 @@ MultiBodyDispatcher::MultiBodyDispatcher()
 
 bool MultiBodyDispatcher::test(RigidBody& b1, RigidBody& b2, const MatXf& Xr1r2, bool addContact)
 {
+	float penetration;
 	Vect3f cp1, cp2;
+	if(!detect(b1, b2, Xr1r2, penetration, cp1, cp2))
+		return false;
+
+	if(addContact)
+		pushContact(b1, b2, penetration, cp1, cp2);
+
+	//Vect3f p1, p2;
+	//b1.matrix().xformPoint(cp1, p1);
+	//b2.matrix().xformPoint(cp2, p2);
+	//show_line(p1, p2, MAGENTA);
+	return true;
+}
+
+bool MultiBodyDispatcher::detect(const RigidBody& b1, const RigidBody& b2, const MatXf& Xr1r2, float& penetration, Vect3f& cp1, Vect3f& cp2) const
+{
 	float dist = Xr1r2.trans().norm();
-	float penetration = b1.inscribed_radius + b2.inscribed_radius - dist;
+	penetration = b1.inscribed_radius + b2.inscribed_radius - dist;
 	if(penetration > 0){
 		if(dist > FLT_EPS){	
 			cp1 = Xr1r2.trans();
@@ -45,29 +61,162 @@ bool MultiBodyDispatcher::test(RigidBody& b1, RigidBody& b2, const MatXf& Xr1r2,
 		}
 	}
 
-	if(penetration > 0){
-		if(addContact){
-			contacts.push_back(Contact());
-			if(!contacts.back().set(penetration, cp1, cp2, &b1, &b2))
-				contacts.pop_back();
-		}
-
-		//Vect3f p1, p2;
-		//b1.matrix().xformPoint(cp1, p1);
-		//b2.matrix().xformPoint(cp2, p2);
-		//show_line(p1, p2, MAGENTA);
-		return true;
-		}
+	//if(penetration <= 0)
+	//	show_line(b1.position(), b2.position(), GREEN);
+	return penetration > 0;
+}
 
-	//show_line(b1.position(), b2.position(), GREEN);
-	return false;
+void MultiBodyDispatcher::pushContact(RigidBody& b1, RigidBody& b2, float penetration, const Vect3f& cp1, const Vect3f& cp2)
+{
+	contacts.push_back(Contact());
+	if(!contacts.back().set(penetration, cp1, cp2, &b1, &b2))
+		contacts.pop_back();
 }
 
+//	Contacts are split into islands: contacts sharing a movable body.
+//	Resolving a contact changes velocities of its movable bodies only,
+//	so islands are independent and are resolved one by one. Inside an island
+//	the contact with the minimal normal velocity is kept on top of a heap,
+//	ties are broken by the contact list order, as the linear scan did.
 void MultiBodyDispatcher::resolve()
 {
 	if(contacts.empty())
 		return;
 
+	start_timer_auto(resolve, STATISTICS_GROUP_PHYSICS);
+
+#ifndef _FINAL_VERSION_
+	// Old quadratic solver, to compare timings and results
+	static bool reference = check_command_line("contact_solver_reference") != 0;
+	if(reference){
+		resolveReference();
+		prepare();
+		return;
+	}
+#endif
+
+	int index = 0;
+	ContactList::iterator ci;
+	FOR_EACH(contacts, ci){
+		ci->index = index++;
+		ci->island = -1;
+	}
+
+	int islands = 0;
+	FOR_EACH(contacts, ci){
+		if(ci->island != -1)
+			continue;
+
+		island_.clear();
+		island_.push_back(&*ci);
+		ci->island = islands;
+		for(int i = 0; i < island_.size(); i++){
+			Contact* c = island_[i];
+			if(!c->body1_unmovable)
+				addIslandContacts(c->body1->contacts, islands);
+			if(!c->body2_unmovable)
+				addIslandContacts(c->body2->contacts, islands);
+		}
+
+		resolveIsland();
+		islands++;
+	}
+
+	statistics_add(contacts, STATISTICS_GROUP_PHYSICS, contacts.size());
+	statistics_add(contact_islands, STATISTICS_GROUP_PHYSICS, islands);
+
+	//xassert("Unable to resolve collision" && i < contacts.size()*collision_resolve_iterations_per_contact);
+	prepare();
+}
+
+void MultiBodyDispatcher::addIslandContacts(ContactPtrList& body_contacts, int island)
+{
+	ContactPtrList::iterator cpi;
+	FOR_EACH(body_contacts, cpi)
+		if((*cpi)->island == -1){
+			(*cpi)->island = island;
+			island_.push_back(*cpi);
+		}
+}
+
+void MultiBodyDispatcher::resolveIsland()
+{
+	heap_.clear();
+	ContactPtrList::iterator cpi;
+	FOR_EACH(island_, cpi){
+		(*cpi)->normal_velocity();
+		(*cpi)->heap_position = heap_.size();
+		heap_.push_back(*cpi);
+	}
+	for(int i = heap_.size()/2 - 1; i >= 0; i--)
+		heapDown(i);
+
+	int iterations = island_.size()*collision_resolve_iterations_per_contact;
+	for(int i = 0; i < iterations; i++){
+		Contact* c_min = heap_.front();
+		if(c_min->u_n > collision_resolve_velocity_tolerance)
+			break;
+
+		c_min->resolve();
+
+		// resolve() has reset u_n_calculated of every contact of its movable bodies
+		if(!c_min->body1_unmovable)
+			updateContacts(c_min->body1->contacts);
+		if(!c_min->body2_unmovable)
+			updateContacts(c_min->body2->contacts);
+		}
+}
+
+void MultiBodyDispatcher::updateContacts(ContactPtrList& body_contacts)
+{
+	ContactPtrList::iterator cpi;
+	FOR_EACH(body_contacts, cpi){
+		Contact* c = *cpi;
+		if(!c->u_n_calculated){
+			c->normal_velocity();
+			heapUp(c->heap_position);
+			heapDown(c->heap_position);
+		}
+	}
+}
+
+void MultiBodyDispatcher::heapUp(int pos)
+{
+	Contact* c = heap_[pos];
+	while(pos > 0){
+		int parent = (pos - 1) >> 1;
+		if(!heapLess(c, heap_[parent]))
+			break;
+		heap_[pos] = heap_[parent];
+		heap_[pos]->heap_position = pos;
+		pos = parent;
+	}
+	heap_[pos] = c;
+	c->heap_position = pos;
+}
+
+void MultiBodyDispatcher::heapDown(int pos)
+{
+	int size = heap_.size();
+	Contact* c = heap_[pos];
+	for(;;){
+		int child = 2*pos + 1;
+		if(child >= size)
+			break;
+		if(child + 1 < size && heapLess(heap_[child + 1], heap_[child]))
+			child++;
+		if(!heapLess(heap_[child], c))
+			break;
+		heap_[pos] = heap_[child];
+		heap_[pos]->heap_position = pos;
+		pos = child;
+	}
+	heap_[pos] = c;
+	c->heap_position = pos;
+}
+
+void MultiBodyDispatcher::resolveReference()
+{
 	for(int i = 0; i < contacts.size()*collision_resolve_iterations_per_contact; i++){
 		float u_n, u_n_min = FLT_INF;
 		Contact* c_min;
@@ -82,9 +231,6 @@ void MultiBodyDispatcher::resolve()
 
 		c_min->resolve();
 		}
-
-	//xassert("Unable to resolve collision" && i < contacts.size()*collision_resolve_iterations_per_contact);
-	prepare();
 }
 
 void MultiBodyDispatcher::resolveSmart()
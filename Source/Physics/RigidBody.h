@@ -34,6 +34,11 @@ private:
 	char body1_unmovable;
 	char body2_unmovable;
 
+	// MultiBodyDispatcher::resolve() bookkeeping
+	int index; // order in the contact list, breaks ties between equal normal velocities
+	int island;
+	int heap_position;
+
 	friend class RigidBody;
 	friend class MultiBodyDispatcher;
 };
@@ -298,11 +303,29 @@ public:
 
 	void prepare(); // clears previos contacts information only now, so You can use it for AI
 	bool test(RigidBody& b1, RigidBody& b2, const MatXf& X12, bool addContact); // call from Grid operator()
+	// test() split in two: detect() doesn't change anything and may be called from job threads,
+	// pushContact() adds the detected contact
+	bool detect(const RigidBody& b1, const RigidBody& b2, const MatXf& X12, float& penetration, Vect3f& cp1, Vect3f& cp2) const;
+	void pushContact(RigidBody& b1, RigidBody& b2, float penetration, const Vect3f& cp1, const Vect3f& cp2);
 	void resolve(); // call before evolve
 	void resolveSmart(); // call before evolve
 
 private:
 	ContactList contacts;
+
+	// resolve() working buffers, kept between quants to avoid reallocations
+	ContactPtrList island_;
+	ContactPtrList heap_;
+
+	void resolveIsland();
+	void resolveReference();
+	void addIslandContacts(ContactPtrList& body_contacts, int island);
+	void updateContacts(ContactPtrList& body_contacts);
+
+	// Min-heap by (normal_velocity, index)
+	static bool heapLess(const Contact* c1, const Contact* c2) { return c1->u_n < c2->u_n || (c1->u_n == c2->u_n && c1->index < c2->index); }
+	void heapUp(int pos);
+	void heapDown(int pos);
 	
 	friend RigidBody;
 };
@@ -34,17 +34,38 @@ void ZIPClose()
 #endif _NOZIP
 }
 
+const char* ZIPMap(const char* fname,unsigned& size)
+{
+#ifndef _NOZIP
+	if(pzip)
+		return pzip->map(fname,size);
+#endif _NOZIP
+	return 0;
+}
+
+bool ZIPBenchmark(sZIPBench& result)
+{
+#ifndef _NOZIP
+	if(pzip)
+	{
+		pzip->benchmark(result);
+		return true;
+	}
+#endif _NOZIP
+	return false;
+}
+
 ZIPStream::ZIPStream(const char* fname)
 :XStream(0)
 {
+	archive=INVALID_HANDLE_VALUE;
 	if(!fname)return;
 	bool b_open=false;
 #ifndef _NOZIP
 	if(pzip)	
 	{
-		b_open=open(fname)!=0;
-		if(!b_open)
-			b_open=pzip->open((char*)fname,*this)!=0;
+		//    pzip  
+		b_open=pzip->open(fname,*this,archive)!=0;
 		if(!b_open)
 			b_open=open(fname)!=0;
 	}else
@@ -53,3 +74,10 @@ ZIPStream::ZIPStream(const char* fname)
 		b_open=open(fname)!=0;
 	}
 }
+
+ZIPStream::~ZIPStream()
+{
+	close();
+	if(archive!=INVALID_HANDLE_VALUE)
+		CloseHandle(archive);
+}
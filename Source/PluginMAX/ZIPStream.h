@@ -7,6 +7,10 @@ class ZIPStream : public XStream
 {
 public:
 	ZIPStream(const char* name);
+	~ZIPStream();
+private:
+	//      ZIP, XStream::close    
+	XSHANDLE archive;
 };
 
 //   ZIPOpen,      
@@ -14,4 +18,22 @@ void ZIPOpen(const char* zip_filename);
 void ZIPClose();
 bool ZIPIsOpen();
 
+//      ,     .
+//0 -   ,    ,     
+//  (  ,   ZIPStream; 
+//    ).
+const char* ZIPMap(const char* fname,unsigned& size);
+
+struct sZIPBench
+{
+	int files;
+	unsigned bytes;
+	unsigned checksum;
+	double index_time;//      ZIPOpen
+	double lookup_time;//  
+	double read_time;//  
+};
+//false -   
+bool ZIPBenchmark(sZIPBench& result);
+
 #endif  _ZIPSTREAM_H_
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "SceneMesh.h"
 #include <xutil.h>
+#include <vector>
 #include "zip_resource.h"
 #include "zip_headers.h"
+#include "ZIPStream.h"
 
 
 XZIP_FileHeader::XZIP_FileHeader(void)
@@ -12,6 +14,7 @@ XZIP_FileHeader::XZIP_FileHeader(void)
 
 	extDataSize = 0;
 	extData = NULL;
+	external = -1;
 }
 
 void XZIP_FileHeader::set(const char* fname,unsigned offs,unsigned size,void* ext_ptr,int ext_sz)
@@ -61,6 +64,13 @@ void XZIP_FileHeader::SetName(const char* p)
 		if(fileName[i] == '/') fileName[i] = '\\';
 }
 
+bool XZIP_FileHeader::stored() const
+{
+	if(extData && extDataSize == sizeof(local_file_header))
+		return !((local_file_header*)extData)->compression_method;
+	return true;
+}
+
 void XZIP_FileHeader::save(XStream& fh)
 {
 	int sz = strlen(fileName);
@@ -83,11 +93,61 @@ XZIP_Resource::XZIP_Resource(const char* fname,int fl)
 	idxName[sz - 2] = 'd';
 	idxName[sz - 3] = 'i';
 
+	mapping = 0;
+	view = 0;
+	viewSize = 0;
+
+	double time = clockf();
 	file.open(fname,XS_IN);
 	if(flags & XZIP_ENABLE_ZIP_HEADERS)
 		LoadHeaders();
 	else 
 		LoadIndex();
+	BuildIndex();
+	indexTime = clockf() - time;
+
+	MapFile();
+}
+
+XZIP_Resource::~XZIP_Resource()
+{
+	if(view)
+		UnmapViewOfFile(view);
+	if(mapping)
+		CloseHandle(mapping);
+}
+
+string XZIP_Resource::key(const char* fname)
+{
+	string k = fname;
+	for(int i = 0; i < k.size(); i ++)
+		if(k[i] == '/')
+			k[i] = '\\';
+		else
+			k[i] = tolower(k[i]);
+	return k;
+}
+
+void XZIP_Resource::BuildIndex()
+{
+	//insert   -     ,     
+	index.clear();
+	FileList::iterator fi;
+	FOR_EACH(fileList, fi)
+		index.insert(FileIndex::value_type(key(fi->name()), &*fi));
+}
+
+void XZIP_Resource::MapFile()
+{
+	mapping = CreateFileMapping(file.handler,0,PAGE_READONLY,0,0,0);
+	if(mapping)
+		view = (const char*)MapViewOfFile(mapping,FILE_MAP_READ,0,0,0);
+	if(view)
+		viewSize = file.size();
+	else if(mapping){
+		CloseHandle(mapping);
+		mapping = 0;
+	}
 }
 
 void XZIP_Resource::LoadIndex(void)
@@ -191,22 +251,41 @@ void XZIP_Resource::SaveIndex(void)
 
 XZIP_FileHeader* XZIP_Resource::find(const char* fname)
 {
-	FileList::iterator fi;
-	FOR_EACH(fileList, fi)
-		if(!stricmp(fi->name(),fname))
-			return &*fi;
-
-	return 0;
+	FileIndex::const_iterator it = index.find(key(fname));
+	return it != index.end() ? it->second : 0;
 }
 
-int XZIP_Resource::open(const char* fname,XStream& fh,int mode)
+XZIP_FileHeader* XZIP_Resource::findPacked(const char* fname)
 {
 	XZIP_FileHeader* p = find(fname);
-	if(p){
-		 fh.open(&file,p -> offset(),p -> size());
-		 return 1;
-	}
-	return 0;
+	// :       
+	if(p && p->external < 0)
+		p->external = GetFileAttributes(fname) != (DWORD)-1;
+	return p && !p->external ? p : 0;
+}
+
+int XZIP_Resource::open(const char* fname,XStream& fh,XStream::XSHANDLE& handle)
+{
+	XZIP_FileHeader* p = findPacked(fname);
+	if(!p)
+		return 0;
+	//  -   ,  file  
+	XStream own(0);
+	if(!own.open(fileName.c_str(),XS_IN))
+		return 0;
+	fh.open(&own,p -> offset(),p -> size());
+	handle = own.handler;
+	own.handler = INVALID_HANDLE_VALUE;
+	return 1;
+}
+
+const char* XZIP_Resource::map(const char* fname,unsigned& size)
+{
+	XZIP_FileHeader* p = findPacked(fname);
+	if(!view || !p || !p->stored() || p->offset() + p->size() > viewSize)
+		return 0;
+	size = p->size();
+	return view + p->offset();
 }
 
 void XZIP_Resource::dump(const char* fname)
@@ -217,3 +296,42 @@ void XZIP_Resource::dump(const char* fname)
 		fh < fi->name() < " " <= fi->size() < "/" <= fi->offset() < "\r\n";
 	fh.close();
 }
+
+void XZIP_Resource::benchmark(sZIPBench& result)
+{
+	result.files = fileList.size();
+	result.bytes = 0;
+	result.index_time = indexTime;
+
+	FileList::iterator fi;
+	double time = clockf();
+	FOR_EACH(fileList, fi)
+		if(!find(fi->name()))
+			result.files --;
+	result.lookup_time = clockf() - time;
+
+	//         open
+	unsigned sum = 0;
+	vector<char> buffer;
+	time = clockf();
+	FOR_EACH(fileList, fi){
+		unsigned size = 0;
+		const char* data = map(fi->name(),size);
+		if(!data){
+			XStream fh(0);
+			XStream::XSHANDLE handle;
+			buffer.resize(fi->size() + 1);
+			if(open(fi->name(),fh,handle)){
+				size = fh.read(&buffer[0],fi->size());
+				fh.close();
+				CloseHandle(handle);
+			}
+			data = &buffer[0];
+		}
+		for(unsigned i = 0; i < size; i ++)
+			sum += (unsigned char)data[i];
+		result.bytes += size;
+	}
+	result.read_time = clockf() - time;
+	result.checksum = sum;
+}
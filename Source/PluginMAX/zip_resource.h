@@ -4,8 +4,11 @@
 
 #include <string>
 #include <list>
+#include <hash_map>
 using namespace std;
 
+struct sZIPBench;
+
 class XZIP_FileHeader 
 {
 	char* fileName;
@@ -22,6 +25,11 @@ public:
 	unsigned offset() const { return dataOffset; }
 	char* data() const { return extData; }
 	const char* name() const { return fileName; }
+	//    -     
+	bool stored() const;
+	//        :
+	//-1 -   ,    
+	int external;
 
 	void save(XStream& fh);
 
@@ -45,19 +53,44 @@ class XZIP_Resource
 	typedef list<XZIP_FileHeader> FileList;
 	FileList fileList;
 
+	//     ,     
+	//     - find     .
+	typedef hash_map<string,XZIP_FileHeader*> FileIndex;
+	FileIndex index;
+	double indexTime;
+
 	XStream file;
 
+	//    , 0 -  ,   file
+	HANDLE mapping;
+	const char* view;
+	unsigned viewSize;
+
+	static string key(const char* fname);
+	void BuildIndex();
+	void MapFile();
 	XZIP_FileHeader* find(const char* fname);
+	//find  ,     
+	XZIP_FileHeader* findPacked(const char* fname);
 public:
-	int open(const char* fname,XStream& fh,int mode = 0);
+	//fh -        ,  
+	//. XStream::close     -  
+	// handle,  . 0 -     .
+	int open(const char* fname,XStream& fh,XStream::XSHANDLE& handle);
+	//      , 0 -  ,
+	// ,     .     XZIP_Resource.
+	const char* map(const char* fname,unsigned& size);
 
 	void LoadHeaders();
 	void LoadIndex();
 	void SaveIndex();
 
 	void dump(const char* fname);
+	//       
+	void benchmark(sZIPBench& result);
 
 	XZIP_Resource(const char* fname,int fl);
+	~XZIP_Resource();
 };
 
 #endif 
\ No newline at end of file
@@ -98,6 +98,7 @@ cD3DRender::cD3DRender()
 	hWnd=0;
 	
 	lpD3D=0;
+	DeviceType=D3DDEVTYPE_HAL;
 	lpD3DDevice=0;
     lpZBuffer=lpBackBuffer=0;
 
@@ -170,6 +171,8 @@ int cD3DRender::Init(int xscr,int yscr,int Mode,void *lphWnd,int RefreshRateInHz
 
 	hWnd=(HWND)lphWnd;
 	RenderMode=Mode;
+	xScr=xscr;
+	yScr=yscr;
 
 	if(!lpD3D)
 		//RDERR((lpD3D=Direct3DCreate9(D3D_SDK_VERSION))==0);
@@ -178,7 +181,8 @@ int cD3DRender::Init(int xscr,int yscr,int Mode,void *lphWnd,int RefreshRateInHz
 	if(lpD3D==0) return 2;
 	D3DDISPLAYMODE d3ddm;
 	DWORD Adapter=0/*D3DADAPTER_DEFAULT*/;
-	RDERR(lpD3D->GetAdapterDisplayMode(Adapter,&d3ddm));
+	DeviceType=(Mode&RENDERDEVICE_MODE_NULLREF)?D3DDEVTYPE_NULLREF:D3DDEVTYPE_HAL;
+	RDERR(GetDisplayMode(Adapter,d3ddm));
 	if(Mode&RENDERDEVICE_MODE_WINDOW)
 		if(d3ddm.Format==D3DFMT_X8R8G8B8||d3ddm.Format==D3DFMT_R8G8B8||d3ddm.Format==D3DFMT_A8R8G8B8)
 			RenderMode&=~RENDERDEVICE_MODE_RGB16,RenderMode|=RENDERDEVICE_MODE_RGB32;
@@ -190,7 +194,7 @@ int cD3DRender::Init(int xscr,int yscr,int Mode,void *lphWnd,int RefreshRateInHz
 		
 //	if(TexFmtData[SURFMT_RENDERMAP].TexFmtD3D==D3DFMT_UNKNOWN||TexFmtData[SURFMT_COLORALPHA].TexFmtD3D==D3DFMT_UNKNOWN||TexFmtData[SURFMT_COLOR].TexFmtD3D==D3DFMT_UNKNOWN)
 //		return 5; // don't support render to texture
-	RDCALL(lpD3D->GetDeviceCaps(Adapter,D3DDEVTYPE_HAL,&DeviceCaps));
+	RDCALL(lpD3D->GetDeviceCaps(Adapter,DeviceType,&DeviceCaps));
 	ZeroMemory(&d3dpp,sizeof(d3dpp));
 	d3dpp.BackBufferWidth			= xScr=xscr;
 	d3dpp.BackBufferHeight			= yScr=yscr;
@@ -212,19 +216,23 @@ int cD3DRender::Init(int xscr,int yscr,int Mode,void *lphWnd,int RefreshRateInHz
 	if(RenderMode&RENDERDEVICE_MODE_MULTITHREAD)
 		mt|=D3DCREATE_MULTITHREADED;
 
+	if(RenderMode&RENDERDEVICE_MODE_NULLREF)
+	{
+		RDERR(lpD3D->CreateDevice(Adapter,D3DDEVTYPE_NULLREF,hWnd,D3DCREATE_SOFTWARE_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice));
+	}else
 	if(RenderMode&RENDERDEVICE_MODE_REF)
 	{
 		RDERR(lpD3D->CreateDevice(Adapter,D3DDEVTYPE_REF,hWnd,D3DCREATE_SOFTWARE_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice));
 	}else
 	if(bSupportVertexShaderHardware)
 	{
-		if(lpD3D->CreateDevice(Adapter,D3DDEVTYPE_HAL,hWnd,D3DCREATE_HARDWARE_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice))
-			if(lpD3D->CreateDevice(Adapter,D3DDEVTYPE_HAL,hWnd,D3DCREATE_MIXED_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice))
-				RDERR(lpD3D->CreateDevice(Adapter,D3DDEVTYPE_HAL,hWnd,D3DCREATE_SOFTWARE_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice));
+		if(lpD3D->CreateDevice(Adapter,DeviceType,hWnd,D3DCREATE_HARDWARE_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice))
+			if(lpD3D->CreateDevice(Adapter,DeviceType,hWnd,D3DCREATE_MIXED_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice))
+				RDERR(lpD3D->CreateDevice(Adapter,DeviceType,hWnd,D3DCREATE_SOFTWARE_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice));
 	}
 	else
-		if(lpD3D->CreateDevice(Adapter,D3DDEVTYPE_HAL,hWnd,D3DCREATE_MIXED_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice))
-			RDERR(lpD3D->CreateDevice(Adapter,D3DDEVTYPE_HAL,hWnd,D3DCREATE_SOFTWARE_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice));
+		if(lpD3D->CreateDevice(Adapter,DeviceType,hWnd,D3DCREATE_MIXED_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice))
+			RDERR(lpD3D->CreateDevice(Adapter,DeviceType,hWnd,D3DCREATE_SOFTWARE_VERTEXPROCESSING|mt,&d3dpp,&lpD3DDevice));
 
 	if(lpD3DDevice==0) return 3;
 
@@ -246,6 +254,10 @@ int cD3DRender::Init(int xscr,int yscr,int Mode,void *lphWnd,int RefreshRateInHz
 	RDCALL(lpD3DDevice->GetDeviceCaps(&DeviceCaps));
 	dwSuportMaxSizeTextureX=DeviceCaps.MaxTextureWidth;
 	dwSuportMaxSizeTextureY=DeviceCaps.MaxTextureHeight;
+	if(RenderMode&RENDERDEVICE_MODE_NULLREF)
+	{//NULLREF   ,    
+		dwSuportMaxSizeTextureX=dwSuportMaxSizeTextureY=4096;
+	}
 	bSupportVertexShader=(D3DSHADER_VERSION_MAJOR(DeviceCaps.VertexShaderVersion)>=1)?1:0;
 	bSupportVertexFog=(DeviceCaps.RasterCaps&D3DPRASTERCAPS_FOGVERTEX)?1:0;
 	bSupportTableFog=(DeviceCaps.RasterCaps&D3DPRASTERCAPS_FOGTABLE)?1:0;
@@ -275,14 +287,14 @@ int cD3DRender::Init(int xscr,int yscr,int Mode,void *lphWnd,int RefreshRateInHz
 	Flush();
 
 	dtFixed=new DrawTypeFixedPipeline;
-	if(DeviceCaps.PixelShaderVersion>= D3DPS_VERSION(2,0) && lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_D16)==0)
+	if(DeviceCaps.PixelShaderVersion>= D3DPS_VERSION(2,0) && lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_D16)==0)
 		dtAdvanceOriginal=new DrawTypeGeforceFX;
 	else
 	if( DeviceCaps.PixelShaderVersion>= D3DPS_VERSION(2,0) && 
-		lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_R32F)==0)
+		lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_R32F)==0)
 		dtAdvanceOriginal=new DrawTypeRadeon9700;
 	else
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_D16)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_D16)==0)
 		dtAdvanceOriginal=new DrawTypeGeforce3;
 	else
 	if( DeviceCaps.PixelShaderVersion>= D3DPS_VERSION(1,4))
@@ -303,6 +315,19 @@ int cD3DRender::Init(int xscr,int yscr,int Mode,void *lphWnd,int RefreshRateInHz
 	return 0;
 }
 
+HRESULT cD3DRender::GetDisplayMode(DWORD Adapter,D3DDISPLAYMODE& d3ddm)
+{
+	if(RenderMode&RENDERDEVICE_MODE_NULLREF)
+	{//    
+		d3ddm.Width=xScr;
+		d3ddm.Height=yScr;
+		d3ddm.RefreshRate=0;
+		d3ddm.Format=D3DFMT_X8R8G8B8;
+		return D3D_OK;
+	}
+	return lpD3D->GetAdapterDisplayMode(Adapter,&d3ddm);
+}
+
 D3DFORMAT cD3DRender::GetBackBufferFormat(int Mode)
 {
 	DWORD Adapter=0;
@@ -311,7 +336,7 @@ D3DFORMAT cD3DRender::GetBackBufferFormat(int Mode)
 	{
 		D3DDISPLAYMODE d3ddm;
 		DWORD Adapter=0;
-		RDCALL(lpD3D->GetAdapterDisplayMode(Adapter,&d3ddm));
+		RDCALL(GetDisplayMode(Adapter,d3ddm));
 		BackBufferFormat = d3ddm.Format;
 	}else
 	{
@@ -360,84 +385,84 @@ void cD3DRender::UpdateRenderMode()
 
 	D3DDISPLAYMODE d3ddm;
 	DWORD Adapter=0;
-	RDCALL(lpD3D->GetAdapterDisplayMode(Adapter,&d3ddm));
+	RDCALL(GetDisplayMode(Adapter,d3ddm));
 	if(RenderMode&RENDERDEVICE_MODE_COMPRESS)
 	{
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_DXT5)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_DXT5)==0)
 			TexFmtData[SURFMT_COLOR].Set(4,8,8,8,8,16,8,0,24,D3DFMT_DXT5);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_DXT3)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_DXT3)==0)
 			TexFmtData[SURFMT_COLOR].Set(4,8,8,8,8,16,8,0,24,D3DFMT_DXT3);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_DXT4)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_DXT4)==0)
 			TexFmtData[SURFMT_COLORALPHA].Set(4,8,8,8,8,16,8,0,24,D3DFMT_DXT4);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_DXT2)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_DXT2)==0)
 			TexFmtData[SURFMT_COLORALPHA].Set(4,8,8,8,8,16,8,0,24,D3DFMT_DXT2);
     }
 	else if(RenderMode&RENDERDEVICE_MODE_RGB32)
 	{
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
 			TexFmtData[SURFMT_COLOR].Set(4,8,8,8,8,16,8,0,24,D3DFMT_A8R8G8B8);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_X8R8G8B8)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_X8R8G8B8)==0)
 			TexFmtData[SURFMT_COLOR].Set(4,8,8,8,8,16,8,0,24,D3DFMT_X8R8G8B8);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_R8G8B8)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_R8G8B8)==0)
 			TexFmtData[SURFMT_COLOR].Set(3,8,8,8,0,16,8,0,0,D3DFMT_R8G8B8);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
 			TexFmtData[SURFMT_COLORALPHA].Set(4,8,8,8,8,16,8,0,24,D3DFMT_A8R8G8B8);
 	}
 	else // if(RenderMode&RENDERDEVICE_MODE_RGB16)
 	{
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A4R4G4B4)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A4R4G4B4)==0)
 			TexFmtData[SURFMT_COLOR].Set(2,4,4,4,4,8,4,0,12,D3DFMT_A4R4G4B4);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_X4R4G4B4)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_X4R4G4B4)==0)
 			TexFmtData[SURFMT_COLOR].Set(2,4,4,4,4,8,4,0,12,D3DFMT_X4R4G4B4);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_X1R5G5B5)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_X1R5G5B5)==0)
 			TexFmtData[SURFMT_COLOR].Set(2,5,5,5,1,10,5,0,15,D3DFMT_X1R5G5B5);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_R5G6B5)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_R5G6B5)==0)
 			TexFmtData[SURFMT_COLOR].Set(2,5,6,5,0,11,5,0,0,D3DFMT_R5G6B5);
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A4R4G4B4)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A4R4G4B4)==0)
 			TexFmtData[SURFMT_COLORALPHA].Set(2,4,4,4,4,8,4,0,12,D3DFMT_A4R4G4B4);
 	}
 
 	//32
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
 		TexFmtData[SURFMT_COLOR32].Set(4,8,8,8,8,16,8,0,24,D3DFMT_A8R8G8B8);
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_X8R8G8B8)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_X8R8G8B8)==0)
 		TexFmtData[SURFMT_COLOR32].Set(4,8,8,8,8,16,8,0,24,D3DFMT_X8R8G8B8);
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
 		TexFmtData[SURFMT_COLORALPHA32].Set(4,8,8,8,8,16,8,0,24,D3DFMT_A8R8G8B8);
 
 	// bump map format
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_Q8W8V8U8)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_Q8W8V8U8)==0)
 		TexFmtData[SURFMT_BUMP].Set(4,8,8,8,8,16,8,0,24,D3DFMT_Q8W8V8U8);
 		
 	// render map format
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_X8R8G8B8)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_X8R8G8B8)==0)
 		TexFmtData[SURFMT_RENDERMAP32].Set(4,8,8,8,8,16,8,0,24,D3DFMT_X8R8G8B8);
 	else
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_A8R8G8B8)==0)
 		TexFmtData[SURFMT_RENDERMAP32].Set(4,8,8,8,8,16,8,0,24,D3DFMT_A8R8G8B8);
 	else
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_R8G8B8)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_R8G8B8)==0)
 		TexFmtData[SURFMT_RENDERMAP32].Set(3,8,8,8,0,16,8,0,0,D3DFMT_R8G8B8);
 
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_R5G6B5)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_R5G6B5)==0)
 		TexFmtData[SURFMT_RENDERMAP16].Set(2,5,6,5,0,11,5,0,0,D3DFMT_R5G6B5);
 	else
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_A4R4G4B4)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_A4R4G4B4)==0)
 		TexFmtData[SURFMT_RENDERMAP16].Set(2,4,4,4,4,8,4,0,12,D3DFMT_A4R4G4B4);
 	else
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_X1R5G5B5)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_X1R5G5B5)==0)
 		TexFmtData[SURFMT_RENDERMAP16].Set(2,5,5,5,1,10,5,0,15,D3DFMT_X1R5G5B5);
 
 	TexFmtData[SURFMT_RENDERMAP_FLOAT].Set(0,0,0,0,0,0,0,0,0,0);
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_R32F)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,D3DUSAGE_RENDERTARGET,D3DRTYPE_TEXTURE,D3DFMT_R32F)==0)
 		TexFmtData[SURFMT_RENDERMAP_FLOAT].Set(0,0,0,0,0,0,0,0,0,D3DFMT_R32F);
 
 	{
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8)==0)
 		{
 			TexFmtData[SURFMT_GRAYALPHA].Set(1, 0,0,0,8, 0,0,0,0,D3DFMT_A8);
 		}else
-		if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8L8)==0)
+		if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_A8L8)==0)
 		{
 			TexFmtData[SURFMT_GRAYALPHA].Set(2, 8,8,8,8, 0,0,0,8,D3DFMT_A8L8);
 		}else
@@ -450,11 +475,11 @@ void cD3DRender::UpdateRenderMode()
 
 	}
 
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_V8U8)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_V8U8)==0)
 	{
 		TexFmtData[SURFMT_UV].Set(2, 8,8,8,8, 0,0,0,8,D3DFMT_V8U8);
 	}
-	if(lpD3D->CheckDeviceFormat(Adapter,D3DDEVTYPE_HAL,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_V16U16)==0)
+	if(lpD3D->CheckDeviceFormat(Adapter,DeviceType,d3ddm.Format,0,D3DRTYPE_TEXTURE,D3DFMT_V16U16)==0)
 	{
 		TexFmtData[SURFMT_U16V16].Set(4, 16,16,16,16, 0,0,0,16,D3DFMT_V16U16);
 	}
@@ -206,6 +206,7 @@ public:
 	HWND						hWnd;
 
 	LPDIRECT3D9					lpD3D;
+	D3DDEVTYPE					DeviceType;
 	LPDIRECT3DDEVICE9			lpD3DDevice;
     LPDIRECT3DSURFACE9			lpBackBuffer,lpZBuffer;
 	D3DPRESENT_PARAMETERS		d3dpp;
@@ -508,6 +509,7 @@ protected:
 
 	void UpdateRenderMode();
 
+	HRESULT GetDisplayMode(DWORD Adapter,D3DDISPLAYMODE& d3ddm);
 	D3DFORMAT GetBackBufferFormat(int Mode);
 
 	friend class cTileMapRender;
@@ -12,8 +12,6 @@ FieldDispatcher* field_dispatcher = NULL;
 void FieldDispatcher::Cell::clear()
 {
 	field = 0;
-	height_initial = FieldCluster::ZeroGround;
-	velocity = 0;
 	cluster = 0;
 	
 	specify_delta.set(0, 0);
@@ -33,30 +31,21 @@ void FieldDispatcher::Cell::specify(const Vect2i& delta, const Vect2i& tangenta,
 	}
 }
 
-void FieldDispatcher::Cell::integrate(float& height)
-{
-	//  Vz *= damping
-	//   z += Vz
-	float k = force_field_damping - sqr(velocity)*force_field_damping2;
-	if(k < force_field_damping_min)
-		k = force_field_damping_min;
-	velocity *= k;
-	height += velocity*force_field_time_step;
-}
-
-
 //--------------------------------------
 
 FieldDispatcher::FieldDispatcher(int xmax, int ymax, int zeroLayerHeight) 
 : cIUnkObj(KIND_FORCEFIELD),
-map_(xmax, ymax, Cell(zeroLayerHeight)),
+map_(xmax, ymax, Cell()),
 map_height(xmax, ymax, zeroLayerHeight), 
+map_height_initial(xmax, ymax, zeroLayerHeight), 
+map_velocity(xmax, ymax, 0.f), 
 tile_map_(xmax, ymax, 0)
 {
 	FieldCluster::ZeroGround = zeroLayerHeight;
 	inv_scale_shl=1.0f/float(1<<scale);
 
 	tile_global = 0;
+	clusters_revision = 0;
 
 	pDrawData = 0;
 	int i;
@@ -75,6 +64,12 @@ tile_map_(xmax, ymax, 0)
 	hmapRotate();
 	MTINIT(hmap_lock);
 	interpolation_factor=0;
+
+	map_dz.resize(map_.sizeX()*(map_.sizeY() + 2) + 2, 0.f);
+	row_quant.resize(map_.sizeY(), 0);
+	for(i = 0; i < 3; i++)
+		hmap_quant[i] = 0;
+	logic_quant = 1;
 }
 
 FieldDispatcher::~FieldDispatcher()
@@ -111,23 +106,25 @@ void FieldDispatcher::hmapRotate()
 void FieldDispatcher::logicQuant()
 {
 	MTL();
+
 	ClusterList::iterator ki;
 	FOR_EACH(clusters, ki)
 		ki->logicQuant();
 
 	evolveField();
 
+	// hmap_logic -  ,       
+	int logic_index=(hmap_index+2)%3;
+	int size_x=map_.sizeX();
 	const float* in=map_height.map();
 	float* out=hmap_logic->map();
 	for(int y=0;y<map_.sizeY();y++)
-	{
-		int index=y*map_.sizeX();
-		int index_max=index+map_.sizeX();
-		for(;index<index_max;index++)
-		{
-			out[index]=in[index];
-		}
-	}
+		if(row_quant[y]>hmap_quant[logic_index])
+			memcpy(out+y*size_x,in+y*size_x,size_x*sizeof(float));
+	hmap_quant[logic_index]=logic_quant;
+	//,    (calcHeight  EconomicQuant),
+	//    ,     
+	logic_quant++;
 
 	MTEnter lock(hmap_lock);
 	hmapRotate();
@@ -298,11 +295,12 @@ void FieldDispatcher::calcHeight(FieldCluster* cluster)
 		int y = i->y;
 		for(int x = i->xl; x <= i->xr; x++){
 			Cell& c = map(x, y);
-			c.height_initial = FieldCluster::ZeroGround + force_field_height*c.field;
+			map_height_initial(x, y) = FieldCluster::ZeroGround + force_field_height*c.field;
 			map_height(x,y) = FieldCluster::ZeroGround - 1;
-			c.velocity = 0;
+			map_velocity(x, y) = 0;
 			c.cluster = cluster;
 		}
+		markRows(y, y);
 	}
 
 	UpdateTile();
@@ -310,16 +308,25 @@ void FieldDispatcher::calcHeight(FieldCluster* cluster)
 
 void FieldDispatcher::clearCluster(FieldCluster* cluster)
 {
+	clusters_revision++;
+
 	FieldCluster::iterator i;
 	FOR_EACH(*cluster, i){
 		int y = i->y;
 		for(int x = i->xl; x <= i->xr; x++)
-			map(x, y).clear();
+			clearCell(x, y);
 	}
 	
 	UpdateTile();
 }
 
+void FieldDispatcher::clearCell(int x, int y)
+{
+	map(x, y).clear();
+	map_height_initial(x, y) = FieldCluster::ZeroGround;
+	map_velocity(x, y) = 0;
+}
+
 void FieldDispatcher::removeCluster(FieldCluster* cluster) 
 { 
 	ClusterList::iterator i; 
@@ -332,39 +339,67 @@ void FieldDispatcher::removeCluster(FieldCluster* cluster)
 	}
 }
 
+//	   -   : dz  ,
+//	        ( 
+//	  x),    .
+//	   -     .
 void FieldDispatcher::evolveField()
 {
 //	start_timer_auto(evolveField, 1);
 
+	int size_x = map_.sizeX();
+	float* height = map_height.map();
+	const float* height0 = map_height_initial.map();
+	float* velocity = map_velocity.map();
+	float* dz = dzRow(0);
+	float dz_factor = force_field_stiffness*force_field_time_step;
+
 	for(int i = 0; i < evolve_field_iterations; i++){
 		ClusterList::iterator ki;
 		FOR_EACH(clusters, ki){
-			if(!ki->started_logic())
+			if(!ki->started_logic() || ki->empty())
 				continue;
+
 			//  Heights elastic evolution
 			//  Vz -= k_elasticity*(z - z_avr)
-			float dz_factor = force_field_stiffness*force_field_time_step;
-			FieldCluster::iterator i;
-			FOR_EACH(*ki, i){
-				int y = i->y;
-				for(int x = i->xl; x <= i->xr; x++){
-					float dz = dz_factor*(height(x, y) - height_initial(x, y));
-					map(x, y).velocity -= dz;
-					dz *= force_field_spawn_factor;
-					map(x - 1, y).velocity += dz;
-					map(x + 1, y).velocity += dz;
-					map(x, y - 1).velocity += dz;
-					map(x, y + 1).velocity += dz;
-				}
+			int x0 = ki->front().xl, x1 = ki->front().xr;
+			int y0 = ki->front().y, y1 = y0;
+			FieldCluster::iterator ii;
+			FOR_EACH(*ki, ii){
+				int offset = ii->y*size_x;
+				for(int x = ii->xl; x <= ii->xr; x++)
+					dz[offset + x] = dz_factor*(height[offset + x] - height0[offset + x]);
+				x0 = min(x0, (int)ii->xl);
+				x1 = max(x1, (int)ii->xr);
+				y0 = min(y0, (int)ii->y);
+				y1 = max(y1, (int)ii->y);
+			}
+
+			for(int y = y0 - 1; y <= y1 + 1; y++){
+				float* v = velocity + y*size_x;
+				const float* d = dz + y*size_x;
+				const float* d_up = d - size_x;
+				const float* d_down = d + size_x;
+				for(int x = x0 - 1; x <= x1 + 1; x++)
+					v[x] += (d[x - 1] + d[x + 1] + d_up[x] + d_down[x])*force_field_spawn_factor - d[x];
 			}
 
 			//  Vz *= damping
 			//   z += Vz
-			FOR_EACH(*ki, i){
-				int y = i->y;
-				for(int x = i->xl; x <= i->xr; x++)
-					map(x, y).integrate(map_height(x,y));
+			FOR_EACH(*ki, ii){
+				int offset = ii->y*size_x;
+				for(int x = ii->xl; x <= ii->xr; x++){
+					float& v = velocity[offset + x];
+					float k = force_field_damping - sqr(v)*force_field_damping2;
+					if(k < force_field_damping_min)
+						k = force_field_damping_min;
+					v *= k;
+					height[offset + x] += v*force_field_time_step;
+					dz[offset + x] = 0;
+				}
 			}
+
+			markRows(y0, y1);
 		}
 	}
 }
@@ -439,7 +474,7 @@ bool FieldDispatcher::checkPlace(const Vect2f& pos, const Vect2f& delta)
 	for(int y = p.y - d.y; y <= p.y + d.y; y++)
 		for(int x = p.x - d.x; x <= p.x + d.x; x++)
 			if(attribute(x, y) != attr || //  
-				attr && map(x, y).height_initial < FieldCluster::ZeroGround + force_field_check_place_height) //    
+				attr && height_initial(x, y) < FieldCluster::ZeroGround + force_field_check_place_height) //    
 					return false;
 	return true;
 }
@@ -161,19 +161,16 @@ public:
 		half = (scale ? 1 << (scale - 1) : 0)
 		};
 
+	// ,       
 	struct Cell 
 	{
 		float field;
-		float height_initial;
-		float velocity;
 		FieldCluster* cluster;
 
 		Cell() { clear(); }
-		Cell(float h) { clear(); height_initial = h; }
 		void clear();
 		void specify(const Vect2i& delta, const Vect2i& tangenta, const FieldCluster* cluster);
 		bool specified() const { return specify_error != max_error; }
-		void integrate(float& height);
 
 		Vect2s specify_delta;
 		int specify_error;
@@ -214,13 +211,16 @@ public:
 	int mapSizeY() const { return map_.sizeY(); }
 	float* height_array(){ return map_height.map();}
 
+	//       (clearCluster)
+	int clustersRevision() const { return clusters_revision; }
+
 	Cell& map(int x, int y) { return map_(x, y); } 
 	const Cell& map(int x, int y) const { return map_(x, y); } 
 
 	const Vect3f& normal(int x, int y) const { return normals(height(x + 1, y) - height(x - 1, y), height(x, y + 1) - height(x, y - 1)); }
 	
 	float height(int x, int y) const { return map_height(x, y); } 
-	float height_initial(int x, int y) const { return map(x, y).height_initial; } 
+	float height_initial(int x, int y) const { return map_height_initial(x, y); } 
 
 	FieldCluster* getCluster(int x, int y) const { return map(x, y).cluster; } 
 	int attribute(int x,int y){ FieldCluster* p = getCluster(x,y); if(p) return p->get_attribute(); return 0; }
@@ -262,6 +262,22 @@ private:
 	typedef Map2D<float, scale> HMap;
 	Map map_;
 	HMap map_height;
+	HMap map_height_initial;
+	HMap map_velocity;
+
+	// dz        ,   - 
+	vector<float> map_dz;
+	float* dzRow(int y) { return &map_dz[(y + 1)*map_.sizeX() + 1]; }
+
+	//  map_height,        logic_quant,
+	//        hmap[i]
+	vector<int> row_quant;
+	int hmap_quant[3];
+	int logic_quant;
+	void markRows(int y0, int y1) { for(int y = y0; y <= y1; y++) row_quant[y] = logic_quant; }
+	void clearCell(int x, int y);
+
+	int clusters_revision;
 
 	float inv_scale_shl;
 	
@@ -20,6 +20,7 @@ enum eModeRenderDevice
 	//Internal
 	RENDERDEVICE_MODE_RETURNERROR=	1<<17, //  ChangeSize
 	RENDERDEVICE_MODE_ONEBACKBUFFER=1<<18,
+	RENDERDEVICE_MODE_NULLREF	=	1<<19,	//      ,  
 };
 
 enum eRenderStateOption
@@ -5,6 +5,7 @@ enum
 {
 	MT_GRAPH_THREAD=1,
 	MT_LOGIC_THREAD=2,
+	MT_LOGIC_JOB_THREAD=4, //  LogicJobDispatcher, MTL()    
 };
 
 #define MTG() xassert(tls_is_graph&MT_GRAPH_THREAD)
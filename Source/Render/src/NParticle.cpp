@@ -501,14 +501,23 @@ cEmitterInt::~cEmitterInt()
 {
 }
 
-template<class nParticle> __forceinline int cEmitterBase::PutToBuf(nParticle& p, Vect3f& npos, float& dt,
+void cEmitterBase::InitPlume(int ix,const Vect3f& pos)
+{
+	if(plume_pos.size()<(ix+1)*TraceCount)
+		plume_pos.resize((ix+1)*TraceCount);
+	Vect3f* plume=PlumePos(ix);
+	for(int i=0;i<TraceCount;i++)
+		plume[i]=pos;
+}
+
+template<class nParticle> __forceinline int cEmitterBase::PutToBuf(nParticle& p, Vect3f* plume, Vect3f& npos, float& dt,
 										cQuadBuffer<sVertexXYZDT1>*& pBuf, 
 										const sColor4c& color, const Vect3f& PosCamera,
 										const float& size, const cTextureAviScale::RECT& rt,
 										const UCHAR mode, MatXf* iGM)
 
 {
-	xassert(!p.plume_pos.empty());
+	xassert(plume);
 	float dv1 = (rt.right - rt.left)/TraceCount;
 	float v1 = rt.left;
 	Vect3f prev_lt,prev_lb;
@@ -516,7 +525,7 @@ template<class nParticle> __forceinline int cEmitterBase::PutToBuf(nParticle& p,
 	Vect3f vCameraToObject;
 	if(mode&1) vCameraToObject.set(0,0,1);
 	else vCameraToObject = PosCamera - /*GetGlobalMatrix()*/npos;
-	sy.cross(vCameraToObject, npos - p.plume_pos[0]);
+	sy.cross(vCameraToObject, npos - plume[0]);
 	FastNormalize(sy);
 	sy*=size;
 	prev_lt = npos - sy;
@@ -554,7 +563,7 @@ template<class nParticle> __forceinline int cEmitterBase::PutToBuf(nParticle& p,
 		v[0].pos=prev_lt; v[0].diffuse=color; v[0].GetTexel().set(v1, rt.top);		//	(0,0);
 		v[1].pos=prev_lb; v[1].diffuse=color; v[1].GetTexel().set(v1, rt.bottom);	//	(0,1);
 
-		Vect3f pos = p.plume_pos[i];
+		Vect3f pos = plume[i];
 		pos+= (prev_pos - pos)*(dt/(real_interval+dt));
 		if(mode&2) 
 		{
@@ -592,7 +601,7 @@ template<class nParticle> __forceinline int cEmitterBase::PutToBuf(nParticle& p,
 		else
 		{
 			real_interval = interval;
-			p.plume_pos[i] = pos;
+			plume[i] = pos;
 		}
 		if (p.time_summary<=1)v1+=dv1*(real_interval/interval);
 		v[2].pos=prev_lt; v[2].diffuse=color; v[2].GetTexel().set(v1,rt.top);		//  (1,0);
@@ -696,8 +705,13 @@ void cEmitterInt::Draw(cCamera *pCamera)
 		if (chPlume) CameraPos = pCamera->GetPos();
 		pBuf->BeginDraw();
 	}
-	int size=Particle.size();
-	for(int i=size-1;i>=0;i--)
+	FillColumns(true);
+	const int* index=columns.index();
+	const float *pos_x=columns[PC_POS_X],*pos_y=columns[PC_POS_Y],*pos_z=columns[PC_POS_Z];
+	const float *color_r=columns[PC_COLOR_R],*color_g=columns[PC_COLOR_G],*color_b=columns[PC_COLOR_B],*color_a=columns[PC_COLOR_A];
+	const float *size=columns[PC_SIZE],*tss=columns[PC_TS];
+	int count=columns.size();
+	for(int j=0;j<count;j++)
 	{
 /*		nParticle& p=Particle[i];
 		if(p.key<0)continue;
@@ -711,31 +725,29 @@ void cEmitterInt::Draw(cCamera *pCamera)
 					Bound, rt, mat, pBuf, this, pos, dtime, p.time, 1.0f);
 */
 
+		int i=index[j];
 		nParticle& p=Particle[i];
-		if(p.key<0)continue;
 		Vect3f pos;
 		float angle;
-		sColor4f fcolor;
-		float psize;
+		sColor4f fcolor(color_r[j],color_g[j],color_b[j],color_a[j]);
+		float psize=size[j];
 
 		float dtime=dtime_global*p.inv_life_time;
 		KeyParticleInt& k0=keys[p.key];
 		KeyParticleInt& k1=keys[p.key+1];
 		
 		float& t=p.time;
-		float ts=t*k0.inv_dtime;
+		float ts=tss[j];
 		if (calc_pos)
-			pos = p.pos0+p.vdir*(t*(k0.vel+ts*0.5f*(k1.vel-k0.vel)))+g*((p.gvel0+t*k0.gravity*0.5f)*t);
+			pos.set(pos_x[j],pos_y[j],pos_z[j]);
 		else pos = p.pos0; ///temp
 		Bound.AddBound(pos);
 		angle = p.angle0+ p.angle_dir*(k0.angle_vel*t+t*ts*0.5f*(k1.angle_vel-k0.angle_vel));
-		fcolor = k0.color+(k1.color-k0.color)*ts;
-		psize = k0.size+(k1.size-k0.size)*ts;
 
 		//  
 		Vect3f sx,sy;
 		Vect2f rot=rotate_angle[round(angle*rotate_angle_size)&rotate_angle_mask];
-		rot*=psize*=p.begin_size;
+		rot*=psize;
 		mat.invXformVect(Vect3f(+rot.x,-rot.y,0),sx);
 		mat.invXformVect(Vect3f(+rot.y,+rot.x,0),sy);
 
@@ -746,7 +758,7 @@ void cEmitterInt::Draw(cCamera *pCamera)
 						cTextureAviScale::RECT::ID;	
 		if (chPlume)
 		{
-			if (PutToBuf(p,pos,dtime,pBuf,color,CameraPos,psize, rt, false))
+			if (PutToBuf(p,PlumePos(i),pos,dtime,pBuf,color,CameraPos,psize, rt, false))
 				continue;
 		}
 		else 
@@ -762,11 +774,12 @@ void cEmitterInt::Draw(cCamera *pCamera)
 				parent->AddSquareTriangle(psize*psize);
 			#endif
 		}
-		ProcessTime(p,dtime,i,pos);
+		if(!AdvanceTime(p,dtime))
+			ProcessTime(p,dtime,i,pos);
 	}
 
 	pBuf->EndDraw();
-	Particle.Compress();
+	Particle.Compress(chPlume ? &plume_pos : NULL,TraceCount);
 
 	old_time=time;
 }
@@ -906,29 +919,79 @@ void cEmitterInt::ProcessTime(nParticle& p,float dt,int i,Vect3f& cur_pos)
 void cEmitterInt::DummyQuant()
 {
 	float dtime_global=(time-old_time);
-	int size=Particle.size();
 	Vect3f pos;
 	Bound.SetInvalidBox();
 	
-	for(int i=0;i<size;i++)
+	FillColumns(false);
+	const int* index=columns.index();
+	const float *pos_x=columns[PC_POS_X],*pos_y=columns[PC_POS_Y],*pos_z=columns[PC_POS_Z];
+	int count=columns.size();
+	for(int j=0;j<count;j++)
 	{
+		int i=index[j];
 		nParticle& p=Particle[i];
-		if(p.key<0)continue;
 		float dtime=dtime_global*p.inv_life_time;
 
-		KeyParticleInt& k0=keys[p.key];
-		KeyParticleInt& k1=keys[p.key+1];
-		float& t=p.time;
-		float ts=t*k0.inv_dtime;
-		pos = p.pos0+p.vdir*(t*(k0.vel+ts*0.5f*(k1.vel-k0.vel)))+g*((p.gvel0+t*k0.gravity*0.5f)*t);
+		pos.set(pos_x[j],pos_y[j],pos_z[j]);
 		Bound.AddBound(pos);
 		
-		ProcessTime(p,dtime,i,pos);
+		if(!AdvanceTime(p,dtime))
+			ProcessTime(p,dtime,i,pos);
 	}
 
 	old_time=time;
 }
 
+void cEmitterInt::FillColumns(bool color_size)
+{
+	int size=Particle.size();
+	columns.Reserve(size);
+	int* index=columns.index();
+	float *pos0_x=columns[PC_POS0_X],*pos0_y=columns[PC_POS0_Y],*pos0_z=columns[PC_POS0_Z];
+	float *vdir_x=columns[PC_VDIR_X],*vdir_y=columns[PC_VDIR_Y],*vdir_z=columns[PC_VDIR_Z];
+	float *gvel0=columns[PC_GVEL0],*ptime=columns[PC_TIME],*inv_dtime=columns[PC_INV_DTIME];
+	float *vel0=columns[PC_VEL0],*vel1=columns[PC_VEL1],*gravity=columns[PC_GRAVITY];
+	float *size0=columns[PC_SIZE0],*size1=columns[PC_SIZE1],*begin_size=columns[PC_BEGIN_SIZE];
+	float *color0_r=columns[PC_COLOR0_R],*color0_g=columns[PC_COLOR0_G],*color0_b=columns[PC_COLOR0_B],*color0_a=columns[PC_COLOR0_A];
+	float *color1_r=columns[PC_COLOR1_R],*color1_g=columns[PC_COLOR1_G],*color1_b=columns[PC_COLOR1_B],*color1_a=columns[PC_COLOR1_A];
+
+	int n=0;
+	for(int i=size-1;i>=0;i--)
+	{
+		nParticle& p=Particle[i];
+		if(p.key<0)continue;
+		KeyParticleInt& k0=keys[p.key];
+		KeyParticleInt& k1=keys[p.key+1];
+
+		index[n]=i;
+		pos0_x[n]=p.pos0.x; pos0_y[n]=p.pos0.y; pos0_z[n]=p.pos0.z;
+		vdir_x[n]=p.vdir.x; vdir_y[n]=p.vdir.y; vdir_z[n]=p.vdir.z;
+		gvel0[n]=p.gvel0;
+		ptime[n]=p.time;
+		inv_dtime[n]=k0.inv_dtime;
+		vel0[n]=k0.vel;
+		vel1[n]=k1.vel;
+		gravity[n]=k0.gravity;
+		if(color_size)
+		{
+			size0[n]=k0.size;
+			size1[n]=k1.size;
+			begin_size[n]=p.begin_size;
+			color0_r[n]=k0.color.r; color0_g[n]=k0.color.g; color0_b[n]=k0.color.b; color0_a[n]=k0.color.a;
+			color1_r[n]=k1.color.r; color1_g[n]=k1.color.g; color1_b[n]=k1.color.b; color1_a[n]=k1.color.a;
+		}
+		n++;
+	}
+	columns.SetCount(n);
+
+	ParticleIntegrate(columns,g);
+	if(color_size)
+	{
+		ParticleColorKey(columns);
+		ParticleSizeKey(columns);
+	}
+}
+
 void cEmitterInt::EmitInstantly(float tmin,float tmax)
 {
 	CKey::iterator it;
@@ -1076,13 +1139,7 @@ void cEmitterInt::EmitOne(int ix_cur/*nParticle& cur*/,float begin_time)
 
 	CalcColor(cur);
 	if (chPlume)
-	{	
-		cur.plume_pos.resize(TraceCount);
-		vector<Vect3f>::iterator it;
-		Vect3f& bpos = /*GetGlobalMatrix()*/cur.pos0;
-		FOR_EACH(cur.plume_pos,it)
-			*it = bpos;
-	}
+		InitPlume(ix_cur,/*GetGlobalMatrix()*/cur.pos0);
 }
 
 Vect3f cEmitterInt::CalcVelocity(const EffectBeginSpeedMatrix& s,const nParticle& cur,float mul)
@@ -1510,7 +1567,7 @@ void cEmitterSpl::Draw(cCamera *pCamera)
 						cTextureAviScale::RECT::ID;	
 		if (chPlume)
 		{
-			if (PutToBuf(p,pos,dtime,pBuf,color,CameraPos,psize, rt, false))
+			if (PutToBuf(p,PlumePos(i),pos,dtime,pBuf,color,CameraPos,psize, rt, false))
 				continue;
 		}
 		else 
@@ -1525,7 +1582,8 @@ void cEmitterSpl::Draw(cCamera *pCamera)
 				parent->AddSquareTriangle(psize*psize);
 			#endif
 		}
-		ProcessTime(p,dtime,i);
+		if(!AdvanceTime(p,dtime))
+			ProcessTime(p,dtime,i);
 	}
 
 	pBuf->EndDraw();
@@ -1590,7 +1648,7 @@ void cEmitterSpl::Draw(cCamera *pCamera)
 
 	pBuf->EndDraw();
 */
-	Particle.Compress();
+	Particle.Compress(chPlume ? &plume_pos : NULL,TraceCount);
 	old_time=time;
 }
 
@@ -1843,13 +1901,7 @@ void cEmitterSpl::EmitOne(int ix_cur/*nParticle& cur*/,float begin_time)
 	if (need_transform) 
 		cur.pos= relative ? cur.pos : GetGlobalMatrix()*cur.pos;
 	if (chPlume)
-	{	
-		cur.plume_pos.resize(TraceCount);
-		vector<Vect3f>::iterator it;
-		Vect3f bpos = /*GetGlobalMatrix()*/cur.pos.trans();
-		FOR_EACH(cur.plume_pos,it)
-			*it = bpos;
-	}
+		InitPlume(ix_cur,/*GetGlobalMatrix()*/cur.pos.trans());
 }
 
 void cEmitterSpl::ProcessTime(nParticle& p,float delta_time,int i)
@@ -1931,7 +1983,8 @@ void cEmitterSpl::DummyQuant()
 			Bound.AddBound(pos);
 		}
 
-		ProcessTime(p,dtime,i);
+		if(!AdvanceTime(p,dtime))
+			ProcessTime(p,dtime,i);
 	}
 }
 
@@ -1966,6 +2019,63 @@ void cEffect::SetFunctorGetZ(FunctorGetZ* func)
 
 }
 
+void cEffect::Benchmark(cScene* scene,EffectLibrary* lib,int frames,float dt,sEffectBench& result)
+{
+	result.effects=0;
+	result.particles=0;
+	result.time=0;
+	result.time_scalar=0;
+	if(!lib)
+		return;
+
+	//     ParticleColumns,  
+	result.time=BenchmarkPass(scene,lib,frames,dt,result);
+	bool simd=ParticleSimdEnable(false);
+	sEffectBench scalar;
+	result.time_scalar=BenchmarkPass(scene,lib,frames,dt,scalar);
+	ParticleSimdEnable(simd);
+}
+
+double cEffect::BenchmarkPass(cScene* scene,EffectLibrary* lib,int frames,float dt,sEffectBench& result)
+{
+	result.particles=0;
+	vector<cEffect*> effects;
+	EffectLibrary::iterator it_key;
+	FOR_EACH(*lib,it_key)
+	{
+		cEffect* effect=scene->CreateEffect(**it_key,NULL);
+		effect->SetCycled(true);
+		vector<cEmitterInterface*>::iterator it;
+		FOR_EACH(effect->emitters,it)
+			(*it)->SetDummyTime(0);
+		effects.push_back(effect);
+	}
+
+	vector<cEffect*>::iterator it_effect;
+	double time=clockf();
+	for(int frame=0;frame<frames;frame++)
+	{
+		FOR_EACH(effects,it_effect)
+			(*it_effect)->Animate(dt);
+	}
+	time=clockf()-time;
+
+	FOR_EACH(effects,it_effect)
+	{
+		cEffect* effect=*it_effect;
+		vector<cEmitterInterface*>::iterator it;
+		FOR_EACH(effect->emitters,it)
+		{
+			cEmitterBase* emitter=dynamic_cast<cEmitterBase*>(*it);
+			if(emitter)
+				result.particles+=emitter->GetParticleCount();
+		}
+		effect->Release();
+	}
+	result.effects=effects.size();
+	return time;
+}
+
 void cEffect::SetAutoDeleteAfterLife(bool auto_delete_after_life_)
 {
 	auto_delete_after_life=auto_delete_after_life_;
@@ -3827,8 +3937,13 @@ void cEmitterZ::Draw(cCamera *pCamera)
 		pBuf->BeginDraw(GM);
 	}
 	else pBuf->BeginDraw();
-	int size=Particle.size();
-	for(int i=size-1;i>=0;i--)
+	FillColumns(true);
+	const int* index=columns.index();
+	const float *pos_x=columns[PC_POS_X],*pos_y=columns[PC_POS_Y];
+	const float *color_r=columns[PC_COLOR_R],*color_g=columns[PC_COLOR_G],*color_b=columns[PC_COLOR_B],*color_a=columns[PC_COLOR_A];
+	const float *size=columns[PC_SIZE],*tss=columns[PC_TS];
+	int count=columns.size();
+	for(int j=0;j<count;j++)
 	{
 /*		nParticle& p=Particle[i];
 		if(p.key<0)continue;
@@ -3842,12 +3957,12 @@ void cEmitterZ::Draw(cCamera *pCamera)
 					Bound, rt, mat, pBuf, this, pos, dtime, p.time, 1.0f);
 		ProcessTime(p,dtime,i,pos);
 */
+		int i=index[j];
 		nParticle& p=Particle[i];
-		if(p.key<0)continue;
 		Vect3f pos;
 		float angle;
-		sColor4f fcolor;
-		float psize;
+		sColor4f fcolor(color_r[j],color_g[j],color_b[j],color_a[j]);
+		float psize=size[j];
 
 		float dtime=dtime_global*p.inv_life_time;
 		
@@ -3855,9 +3970,9 @@ void cEmitterZ::Draw(cCamera *pCamera)
 		KeyParticleInt& k1=keys[p.key+1];
 		
 		float& t=p.time;
-		float ts=t*k0.inv_dtime;
-		pos.x = p.pos0.x+p.vdir.x*(t*(k0.vel+ts*0.5f*(k1.vel-k0.vel)))+g.x*((p.gvel0+t*k0.gravity*0.5f)*t);
-		pos.y = p.pos0.y+p.vdir.y*(t*(k0.vel+ts*0.5f*(k1.vel-k0.vel)))+g.y*((p.gvel0+t*k0.gravity*0.5f)*t);
+		float ts=tss[j];
+		pos.x = pos_x[j];
+		pos.y = pos_y[j];
 /*		if (relative)
 		{
 			Vect3f pp; //word coordinate
@@ -3874,13 +3989,11 @@ void cEmitterZ::Draw(cCamera *pCamera)
 //		pos.z = (iGM.rot().zrow().x*pp.x + iGM.rot().zrow().y*pp.y + iGM.rot().zrow().z*pp.z) + iGM.trans().z;
 		Bound.AddBound(pos);
 		angle = p.angle0+ p.angle_dir*(k0.angle_vel*t+t*ts*0.5f*(k1.angle_vel-k0.angle_vel));
-		fcolor = k0.color+(k1.color-k0.color)*ts;
-		psize = k0.size+(k1.size-k0.size)*ts;
 
 		//  
 		Vect3f sx,sy;
 		Vect2f rot=rotate_angle[round(angle*rotate_angle_size)&rotate_angle_mask];
-		rot*=psize*=p.begin_size;
+		rot*=psize;
 		if(planar)
 		{
 			sx.x=+rot.x;
@@ -3901,7 +4014,7 @@ void cEmitterZ::Draw(cCamera *pCamera)
 						cTextureAviScale::RECT::ID;	
 		if (chPlume)
 		{
-			if (PutToBuf(p,pos,dtime,pBuf,color,CameraPos,psize, rt, mode, &iGM))
+			if (PutToBuf(p,PlumePos(i),pos,dtime,pBuf,color,CameraPos,psize, rt, mode, &iGM))
 				continue;
 		}
 		else 
@@ -3918,7 +4031,8 @@ void cEmitterZ::Draw(cCamera *pCamera)
 			#endif
 
 		}
-		ProcessTime(p,dtime,i,pos);
+		if(!AdvanceTime(p,dtime))
+			ProcessTime(p,dtime,i,pos);
 	}
 
 	pBuf->EndDraw();
@@ -3989,7 +4103,7 @@ void cEmitterZ::Draw(cCamera *pCamera)
 
 	pBuf->EndDraw();
 */
-	Particle.Compress();
+	Particle.Compress(chPlume ? &plume_pos : NULL,TraceCount);
 
 	old_time=time;
 }
@@ -4062,9 +4176,9 @@ void cEmitterZ::EmitOne(int ix_cur/*nParticle& cur*/,float begin_time)
 */
 		}else
 			z = CalcZ(cur.pos0.x,cur.pos0.y);
-		vector<Vect3f>::iterator it;
-		FOR_EACH(cur.plume_pos,it)
-			it->z = z;
+		Vect3f* plume=PlumePos(ix_cur);
+		for(int i=0;i<TraceCount;i++)
+			plume[i].z = z;
 	}
 }
 
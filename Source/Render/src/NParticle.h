@@ -2,6 +2,7 @@
 
 #include "..\saver\saver.h"
 #include "NParticleKey.h"
+#include "NParticleSimd.h"
 #include "observer.h"
 #include "texture.h"
 #define EXPORT_TO_GAME 1
@@ -536,7 +537,13 @@ protected:
 	int   TraceCount;
 	float PlumeInterval;
 
-	template<class nParticle> int PutToBuf(nParticle& p, Vect3f& npos, float& dt,
+	//      ,  TraceCount   ,
+	// -    Particle (  BackVector::Compress)
+	vector<Vect3f> plume_pos;
+	Vect3f* PlumePos(int ix){return &plume_pos[ix*TraceCount];}
+	void InitPlume(int ix,const Vect3f& pos);
+
+	template<class nParticle> int PutToBuf(nParticle& p, Vect3f* plume, Vect3f& npos, float& dt,
 										cQuadBuffer<sVertexXYZDT1>*& pBuf, 
 										const sColor4c& color, const Vect3f& PosCamera,
 										const float& size, const cTextureAviScale::RECT& rt,
@@ -604,7 +611,6 @@ public:
 		sColor4c begin_color;
 
 		Vect3f normal;
-		vector<Vect3f> plume_pos;
 /*
 		void PutToBuf(const float& dtime_global, const KeyParticleInt& k0, 
 								const KeyParticleInt& k1, sBox6f& Bound, 
@@ -663,8 +669,23 @@ protected:
 	Vect3f CalcVelocity(const EffectBeginSpeedMatrix& s,const nParticle& cur,float mul);
 
 	virtual void ProcessTime(nParticle& p,float dt,int i,Vect3f& cur_pos);
+	//          -  ,
+	//  ProcessTime.   cEmitterInt  cEmitterZ.
+	bool AdvanceTime(nParticle& p,float dt)
+	{
+		if(p.key_begin_time>=0 || p.time+dt>keys[p.key].dtime)
+			return false;
+		p.time+=dt;
+		p.time_summary+=dt;
+		return true;
+	}
 	void DummyQuant();
 	void CalcColor(nParticle& cur);
+
+	//    ,    Draw (  Particle)
+	ParticleColumns columns;
+	// columns   ,   color_size -   
+	void FillColumns(bool color_size);
 protected:
 	bool calc_pos;
 public:
@@ -674,10 +695,11 @@ public:
 	virtual void ResetPlumePos(int ix)
 	{
 		xassert((UINT)ix<Particle.size());
-		nParticle& p = Particle[ix]; 
-		vector<Vect3f>::iterator i;
-		FOR_EACH(p.plume_pos,i)
-			*i = p.pos0;
+		if(!chPlume)
+			return;
+		Vect3f* plume = PlumePos(ix);
+		for(int i=0;i<TraceCount;i++)
+			plume[i] = Particle[ix].pos0;
 	};
 };
 
@@ -745,7 +767,6 @@ class cEmitterSpl:public cEmitterBase
 		//-,   
 		int   hkey;
 		float htime;
-		vector<Vect3f> plume_pos;
 		MatXf pos;
 		float angle0,angle_dir;
 		//color0,size0 - 
@@ -787,6 +808,16 @@ protected:
 	virtual bool GetRndPos(Vect3f& pos, Vect3f* norm);
 	virtual Vect3f GetVdir(int i);
 	void ProcessTime(nParticle& p,float dt,int i);
+	//     -  
+	bool AdvanceTime(nParticle& p,float dt)
+	{
+		if(p.time+dt>keys[p.key].dtime || p.htime+dt>hkeys[p.hkey].dtime)
+			return false;
+		p.time_summary+=dt;
+		p.time+=dt;
+		p.htime+=dt;
+		return true;
+	}
 	void DummyQuant();
 };
 
@@ -811,6 +842,15 @@ protected:
 	CKeyColor emitter_color;
 };
 
+//  Benchmark
+struct sEffectBench
+{
+	int effects;
+	int particles;//   
+	double time;//   
+	double time_scalar;//   SSE
+};
+
 class cEffect:public cIUnkObjScale
 {
 	friend class cEmitterBase;
@@ -894,6 +934,13 @@ public:
 	vector<Vect3f>& GetNorm(){return normal_position;}
 	cEmitterBase* GetEmitN(int n){xassert((UINT)n<emitters.size()); return (cEmitterBase*)emitters[n];}
 	void SetFunctorGetZ(FunctorGetZ* func);//  addref,release
+
+	//     : frames   dt ,
+	//DummyQuant   -    .
+	static void Benchmark(class cScene* scene,class EffectLibrary* lib,int frames,float dt,sEffectBench& result);
+protected:
+	static double BenchmarkPass(class cScene* scene,class EffectLibrary* lib,int frames,float dt,sEffectBench& result);
+public:
 protected:
 #ifdef  NEED_TREANGLE_COUNT
 	int count_triangle;
@@ -937,5 +984,8 @@ public:
 	typedef vector<EffectKey*>::iterator iterator;
 	inline iterator begin(){return lst.begin();}
 	inline iterator end(){return lst.end();}
+	typedef vector<EffectKey*>::const_iterator const_iterator;
+	inline const_iterator begin()const{return lst.begin();}
+	inline const_iterator end()const{return lst.end();}
 	void ClearNoDelete();
 };
@@ -211,7 +211,8 @@ public:
 	int GetIndexFree();
 	void SetFree(int n);
 
-	void Compress();
+	//plume -    plume_size   ,    
+	void Compress(vector<Vect3f>* plume=NULL,int plume_size=0);
 };
 
 
@@ -256,7 +257,7 @@ void BackVector<type>::SetFree(int n)
 }
 
 template <class type>
-void BackVector<type>::Compress()
+void BackVector<type>::Compress(vector<Vect3f>* plume,int plume_size)
 {
 	if(size()<6)
 		return;
@@ -269,10 +270,16 @@ void BackVector<type>::Compress()
 		if((*this)[i].key!=-1)
 		{
 			if(i!=curi)
+			{
 				(*this)[curi]=(*this)[i];
+				if(plume && plume_size)
+					copy(plume->begin()+i*plume_size,plume->begin()+(i+1)*plume_size,plume->begin()+curi*plume_size);
+			}
 			curi++;
 		}
 	}
 
 	resize(curi);
+	if(plume && plume_size)
+		plume->resize(curi*plume_size);
 }
@@ -0,0 +1,208 @@
+#include "StdAfxRD.h"
+#include "NParticleSimd.h"
+#include <malloc.h>
+#include <xmmintrin.h>
+
+static bool particle_simd_enable=true;
+
+bool ParticleSimdSupported()
+{
+	static int supported=-1;
+	if(supported<0)
+	{
+		int result=0;
+		__try
+		{
+			unsigned int features=0;
+			__asm
+			{
+				mov eax,1
+				cpuid
+				mov features,edx
+			}
+			if(features&(1<<25))
+			{
+				//     SSE,   
+				float probe;
+				_mm_store_ss(&probe,_mm_setzero_ps());
+				result=1;
+			}
+		}
+		__except(EXCEPTION_EXECUTE_HANDLER)
+		{
+			result=0;
+		}
+		supported=result;
+	}
+	return supported!=0;
+}
+
+bool ParticleSimdEnabled()
+{
+	return particle_simd_enable && ParticleSimdSupported();
+}
+
+bool ParticleSimdEnable(bool enable)
+{
+	bool prev=particle_simd_enable;
+	particle_simd_enable=enable;
+	return prev;
+}
+
+///////////////////////////ParticleColumns///////////////////////////
+ParticleColumns::ParticleColumns()
+{
+	data=NULL;
+	index_=NULL;
+	count=0;
+	stride=0;
+}
+
+ParticleColumns::~ParticleColumns()
+{
+	if(data)
+		_aligned_free(data);
+	delete[] index_;
+}
+
+void ParticleColumns::Reserve(int n)
+{
+	count=0;
+	int need=(n+3)&~3;
+	if(need<=stride)
+		return;
+
+	if(data)
+		_aligned_free(data);
+	delete[] index_;
+	stride=max(need,stride*2);
+	data=(float*)_aligned_malloc(stride*PC_MAX*sizeof(float),16);
+	index_=new int[stride];
+}
+
+void ParticleColumns::SetCount(int n)
+{
+	VISASSERT(n<=stride);
+	count=n;
+	int end=padded();
+	if(end==n)
+		return;
+	for(int c=0;c<PC_TS;c++)
+	{
+		float* column=data+c*stride;
+		for(int i=n;i<end;i++)
+			column[i]=0;
+	}
+}
+
+//////////////////////////////////////////////////////
+static void ParticleIntegrateScalar(ParticleColumns& c,const Vect3f& g)
+{
+	const float *pos0_x=c[PC_POS0_X],*pos0_y=c[PC_POS0_Y],*pos0_z=c[PC_POS0_Z];
+	const float *vdir_x=c[PC_VDIR_X],*vdir_y=c[PC_VDIR_Y],*vdir_z=c[PC_VDIR_Z];
+	const float *gvel0=c[PC_GVEL0],*time=c[PC_TIME],*inv_dtime=c[PC_INV_DTIME];
+	const float *vel0=c[PC_VEL0],*vel1=c[PC_VEL1],*gravity=c[PC_GRAVITY];
+	float *ts=c[PC_TS],*pos_x=c[PC_POS_X],*pos_y=c[PC_POS_Y],*pos_z=c[PC_POS_Z];
+
+	int n=c.size();
+	for(int i=0;i<n;i++)
+	{
+		float t=time[i];
+		ts[i]=t*inv_dtime[i];
+		float s=t*(vel0[i]+ts[i]*0.5f*(vel1[i]-vel0[i]));
+		float gs=(gvel0[i]+t*gravity[i]*0.5f)*t;
+		pos_x[i]=pos0_x[i]+vdir_x[i]*s+g.x*gs;
+		pos_y[i]=pos0_y[i]+vdir_y[i]*s+g.y*gs;
+		pos_z[i]=pos0_z[i]+vdir_z[i]*s+g.z*gs;
+	}
+}
+
+static void ParticleIntegrateSSE(ParticleColumns& c,const Vect3f& g)
+{
+	const float *pos0_x=c[PC_POS0_X],*pos0_y=c[PC_POS0_Y],*pos0_z=c[PC_POS0_Z];
+	const float *vdir_x=c[PC_VDIR_X],*vdir_y=c[PC_VDIR_Y],*vdir_z=c[PC_VDIR_Z];
+	const float *gvel0=c[PC_GVEL0],*time=c[PC_TIME],*inv_dtime=c[PC_INV_DTIME];
+	const float *vel0=c[PC_VEL0],*vel1=c[PC_VEL1],*gravity=c[PC_GRAVITY];
+	float *ts=c[PC_TS],*pos_x=c[PC_POS_X],*pos_y=c[PC_POS_Y],*pos_z=c[PC_POS_Z];
+
+	__m128 half=_mm_set1_ps(0.5f);
+	__m128 gx=_mm_set1_ps(g.x),gy=_mm_set1_ps(g.y),gz=_mm_set1_ps(g.z);
+	int n=c.padded();
+	for(int i=0;i<n;i+=4)
+	{
+		__m128 t=_mm_load_ps(time+i);
+		__m128 tsi=_mm_mul_ps(t,_mm_load_ps(inv_dtime+i));
+		__m128 v0=_mm_load_ps(vel0+i);
+		__m128 dv=_mm_sub_ps(_mm_load_ps(vel1+i),v0);
+		__m128 s=_mm_mul_ps(t,_mm_add_ps(v0,_mm_mul_ps(_mm_mul_ps(tsi,half),dv)));
+		__m128 gt=_mm_mul_ps(_mm_mul_ps(t,_mm_load_ps(gravity+i)),half);
+		__m128 gs=_mm_mul_ps(_mm_add_ps(_mm_load_ps(gvel0+i),gt),t);
+
+		_mm_store_ps(ts+i,tsi);
+		_mm_store_ps(pos_x+i,_mm_add_ps(_mm_add_ps(_mm_load_ps(pos0_x+i),_mm_mul_ps(_mm_load_ps(vdir_x+i),s)),_mm_mul_ps(gx,gs)));
+		_mm_store_ps(pos_y+i,_mm_add_ps(_mm_add_ps(_mm_load_ps(pos0_y+i),_mm_mul_ps(_mm_load_ps(vdir_y+i),s)),_mm_mul_ps(gy,gs)));
+		_mm_store_ps(pos_z+i,_mm_add_ps(_mm_add_ps(_mm_load_ps(pos0_z+i),_mm_mul_ps(_mm_load_ps(vdir_z+i),s)),_mm_mul_ps(gz,gs)));
+	}
+}
+
+void ParticleIntegrate(ParticleColumns& c,const Vect3f& g)
+{
+	if(ParticleSimdEnabled())
+		ParticleIntegrateSSE(c,g);
+	else
+		ParticleIntegrateScalar(c,g);
+}
+
+//    ts: out=a+(b-a)*ts
+static void ParticleLerpScalar(const float* a,const float* b,const float* ts,float* out,int n)
+{
+	for(int i=0;i<n;i++)
+		out[i]=a[i]+(b[i]-a[i])*ts[i];
+}
+
+static void ParticleLerpSSE(const float* a,const float* b,const float* ts,float* out,int n)
+{
+	for(int i=0;i<n;i+=4)
+	{
+		__m128 va=_mm_load_ps(a+i);
+		__m128 d=_mm_sub_ps(_mm_load_ps(b+i),va);
+		_mm_store_ps(out+i,_mm_add_ps(va,_mm_mul_ps(d,_mm_load_ps(ts+i))));
+	}
+}
+
+void ParticleColorKey(ParticleColumns& c)
+{
+	const float* ts=c[PC_TS];
+	for(int k=0;k<4;k++)
+	{
+		const float* a=c[PARTICLE_COLUMN(PC_COLOR0_R+k)];
+		const float* b=c[PARTICLE_COLUMN(PC_COLOR1_R+k)];
+		float* out=c[PARTICLE_COLUMN(PC_COLOR_R+k)];
+		if(ParticleSimdEnabled())
+			ParticleLerpSSE(a,b,ts,out,c.padded());
+		else
+			ParticleLerpScalar(a,b,ts,out,c.size());
+	}
+}
+
+void ParticleSizeKey(ParticleColumns& c)
+{
+	const float *size0=c[PC_SIZE0],*size1=c[PC_SIZE1],*ts=c[PC_TS],*begin_size=c[PC_BEGIN_SIZE];
+	float* size=c[PC_SIZE];
+	if(ParticleSimdEnabled())
+	{
+		int n=c.padded();
+		for(int i=0;i<n;i+=4)
+		{
+			__m128 s0=_mm_load_ps(size0+i);
+			__m128 d=_mm_sub_ps(_mm_load_ps(size1+i),s0);
+			__m128 s=_mm_add_ps(s0,_mm_mul_ps(d,_mm_load_ps(ts+i)));
+			_mm_store_ps(size+i,_mm_mul_ps(s,_mm_load_ps(begin_size+i)));
+		}
+	}else
+	{
+		int n=c.size();
+		for(int i=0;i<n;i++)
+			size[i]=(size0[i]+(size1[i]-size0[i])*ts[i])*begin_size[i];
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/*
+   cEmitterInt/cEmitterZ.
+      (SoA),  
+  4   SSE   ,   SSE  .
+*/
+
+bool ParticleSimdSupported();//SSE     (CPUID + )
+bool ParticleSimdEnabled();
+bool ParticleSimdEnable(bool enable);//false -   ,  .  
+
+enum PARTICLE_COLUMN
+{
+	//,  
+	PC_POS0_X,PC_POS0_Y,PC_POS0_Z,
+	PC_VDIR_X,PC_VDIR_Y,PC_VDIR_Z,
+	PC_GVEL0,
+	PC_TIME,
+	PC_INV_DTIME,// k0
+	PC_VEL0,PC_VEL1,//k0.vel,k1.vel
+	PC_GRAVITY,
+	PC_SIZE0,PC_SIZE1,
+	PC_BEGIN_SIZE,
+	PC_COLOR0_R,PC_COLOR0_G,PC_COLOR0_B,PC_COLOR0_A,
+	PC_COLOR1_R,PC_COLOR1_G,PC_COLOR1_B,PC_COLOR1_A,
+	// 
+	PC_TS,//   
+	PC_POS_X,PC_POS_Y,PC_POS_Z,
+	PC_COLOR_R,PC_COLOR_G,PC_COLOR_B,PC_COLOR_A,
+	PC_SIZE,//   begin_size
+
+	PC_MAX
+};
+
+class ParticleColumns
+{
+public:
+	ParticleColumns();
+	~ParticleColumns();
+
+	//  n ,   
+	void Reserve(int n);
+	// n ,    4 
+	void SetCount(int n);
+	int size()const{return count;}
+	// ,    4 -   
+	int padded()const{return (count+3)&~3;}
+
+	//   16 
+	float* operator[](PARTICLE_COLUMN c){return data+c*stride;}
+	int* index(){return index_;}//   Particle
+protected:
+	float* data;
+	int* index_;
+	int count;
+	int stride;
+};
+
+//pos=pos0+vdir*(t*(vel0+ts*0.5*(vel1-vel0)))+g*((gvel0+t*gravity*0.5)*t), ts=t*inv_dtime
+void ParticleIntegrate(ParticleColumns& c,const Vect3f& g);
+//color=color0+(color1-color0)*ts,  ParticleIntegrate
+void ParticleColorKey(ParticleColumns& c);
+//size=(size0+(size1-size0)*ts)*begin_size,  ParticleIntegrate
+void ParticleSizeKey(ParticleColumns& c);
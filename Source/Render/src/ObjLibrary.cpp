@@ -6,6 +6,8 @@
 #include "ObjLight.h"
 #include "MeshBank.h"
 #include "NParticle.h"
+#include "VisGeneric.h"
+#include "ResourcePrefetch.h"
 
 bool is_old_model=false;
 bool WinVGIsOldModel()
@@ -15,6 +17,34 @@ bool WinVGIsOldModel()
 
 int ResourceFileRead(const char *fname,char *&buf,int &size)
 {
+	if(GetResourcePrefetch()->Take(fname,buf,size))
+		return 0;
+	const char* view;
+	int ret=ResourceFileReadNoCache(fname,buf,size,view);
+	if(ret)
+		return ret;
+	if(view)
+	{
+		//  :      ,
+		//    
+		buf=new char[size];
+		memcpy(buf,view,size);
+	}
+	return 0;
+}
+
+int ResourceFileReadNoCache(const char *fname,char *&buf,int &size,const char*& view)
+{
+	unsigned map_size;
+	view=ZIPMap(fname,map_size);
+	if(view)
+	{
+		buf=0;
+		size=map_size;
+		return 0;
+	}
+
+	//  ZIPStream    -   
 	buf=0; size=0;
 	ZIPStream f(fname);
 	if(!!f) { f.close(); return -1<<0; }
@@ -593,6 +623,36 @@ void cObjLibrary::FreeOne(FILE* f)
 		fprintf(f,"Objects free %i, not free %i\n",compacted,objects.size()-compacted);
 		fflush(f);
 	}
+	RebuildIndex();
+}
+
+static string object_key(const char* fname)
+{
+	string key=fname;
+	for(int i=0;i<key.size();i++)
+		key[i]=tolower(key[i]);
+	return key;
+}
+
+void cObjLibrary::Add(cAllMeshBank* bank)
+{
+	objects.push_back(bank);
+	index[object_key(bank->GetFileName())].push_back(bank);
+}
+
+void cObjLibrary::RebuildIndex()
+{
+	index.clear();
+	OBJECTS::iterator it;
+	FOR_EACH(objects,it)
+	if(*it)
+		index[object_key((*it)->GetFileName())].push_back(*it);
+}
+
+bool cObjLibrary::IsLoaded(const char* pFileName)
+{
+	MTAuto mtlock(&lock);
+	return index.find(object_key(pFileName))!=index.end();
 }
 
 void cObjLibrary::Compact(FILE* f)
@@ -607,6 +667,7 @@ void cObjLibrary::Free(FILE* f)
 	MTAuto mtlock(&lock);
 	FreeOne(f);
 	objects.clear();
+	index.clear();
 }
 
 cObjectNodeRoot* cObjLibrary::GetElement(const char* pFileName,const char* pTexturePath)
@@ -652,20 +713,30 @@ cObjectNodeRoot* cObjLibrary::GetElementInternal(const char* pFileName,const cha
 		strcpy(TexturePath,DefPath);
 	}
 
+	sResourceStat& stat=GetResourceStat();
+	stat.model_requests++;
+
 	cAllMeshBank* nearest_bank=NULL;
-	for(i=0;i<GetNumberObj();i++)
-	if(stricmp(GetObj(i)->GetFileName(),fname)==0)
+	ObjectIndex::iterator it_index=index.find(fname);
+	if(it_index!=index.end())
 	{
-		cAllMeshBank* bank=GetObj(i);
-		nearest_bank=bank;
-
-		if(stricmp(bank->GetTexturePath(),TexturePath)==0)
+		OBJECTS::iterator it;
+		FOR_EACH(it_index->second,it)
 		{
-			cObjectNodeRoot* tmp=(cObjectNodeRoot*)bank->root->BuildCopy();
-			return tmp;
+			cAllMeshBank* bank=*it;
+			nearest_bank=bank;
+
+			if(stricmp(bank->GetTexturePath(),TexturePath)==0)
+			{
+				cObjectNodeRoot* tmp=(cObjectNodeRoot*)bank->root->BuildCopy();
+				return tmp;
+			}
 		}
 	}
 
+	stat.model_loads++;
+	double time=clockf();
+
 	cAllMeshBank *ObjNode=NULL;
 	cAllMeshBank *ObjNodeLod=NULL;
 	if(nearest_bank)
@@ -686,11 +757,12 @@ cObjectNodeRoot* cObjLibrary::GetElementInternal(const char* pFileName,const cha
 	cObjectNodeRoot *tmp=NULL;
 	if(ObjNode)
 	{
-		objects.push_back(ObjNode); 
+		Add(ObjNode);
 		if(ObjNodeLod)
-			objects.push_back(ObjNodeLod); 
+			Add(ObjNodeLod);
 		tmp=(cObjectNodeRoot*)ObjNode->root->BuildCopy(); 
 	}
+	stat.model_load_time+=clockf()-time;
 	return tmp;
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <hash_map>
 
 class cTexLibrary;
 class cObjectNode;
@@ -16,9 +17,16 @@ public:
 	virtual cObjectNodeRoot* GetElement(const char* pFileName,const char* pTexturePath);
 
 	MTSection* GetLock(){return &lock;}
+	//        (  )
+	bool IsLoaded(const char* pFileName);
 private:
 	typedef vector<cAllMeshBank*> OBJECTS;
 	OBJECTS objects;
+	//     ->      
+	typedef hash_map<string,OBJECTS> ObjectIndex;
+	ObjectIndex index;
+	void Add(cAllMeshBank* bank);
+	void RebuildIndex();
 	cAllMeshBank* LoadM3D(char *fname,char *TexturePath,char *DefTexturePath,bool enable_error_not_found);
 	inline int GetNumberObj()									{ return objects.size(); }
 	inline cAllMeshBank* GetObj(int number)						{ return objects[number]; }
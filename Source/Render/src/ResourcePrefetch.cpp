@@ -0,0 +1,198 @@
+#include "StdAfxRD.h"
+#include "VisGeneric.h"
+#include "ResourcePrefetch.h"
+#include <process.h>
+#include <algorithm>
+
+static cResourcePrefetch resource_prefetch;
+static sResourceStat resource_stat;
+static volatile unsigned touch_sum;//     
+
+cResourcePrefetch* GetResourcePrefetch()
+{
+	return &resource_prefetch;
+}
+
+sResourceStat& GetResourceStat()
+{
+	return resource_stat;
+}
+
+unsigned __stdcall resource_prefetch_thread(void* argument)
+{
+	((cResourcePrefetch*)argument)->Work();
+	return 0;
+}
+
+cResourcePrefetch::cResourcePrefetch()
+{
+	ready_size=0;
+	thread=NULL;
+	wake_event=NULL;
+	done_event=NULL;
+	stop=false;
+}
+
+cResourcePrefetch::~cResourcePrefetch()
+{
+	if(thread)
+	{
+		stop=true;
+		SetEvent(wake_event);
+		WaitForSingleObject(thread,INFINITE);
+		CloseHandle(thread);
+		CloseHandle(wake_event);
+		CloseHandle(done_event);
+	}
+	Clear();
+}
+
+string cResourcePrefetch::Key(const char* fname)
+{
+	string key=fname;
+	for(int i=0;i<key.size();i++)
+		key[i]=tolower(key[i]);
+	return key;
+}
+
+void cResourcePrefetch::Start()
+{
+	//     -      
+	wake_event=CreateEvent(0,FALSE,FALSE,0);
+	done_event=CreateEvent(0,TRUE,TRUE,0);
+	unsigned thread_id;
+	thread=(HANDLE)_beginthreadex(0,0,resource_prefetch_thread,this,0,&thread_id);
+	if(thread)
+		SetThreadPriority(thread,THREAD_PRIORITY_BELOW_NORMAL);
+}
+
+void cResourcePrefetch::Add(const char* fname)
+{
+	if(!fname || !fname[0])
+		return;
+	string key=Key(fname);
+
+	MTAuto mtenter(&lock);
+	if(!thread)
+	{
+		Start();
+		if(!thread)
+			return;
+	}
+
+	if(key==current || ready.find(key)!=ready.end() ||
+		find(queue.begin(),queue.end(),key)!=queue.end())
+		return;
+
+	queue.push_back(key);
+	SetEvent(wake_event);
+}
+
+bool cResourcePrefetch::Take(const char* fname,char*& buf,int& size)
+{
+	if(!thread)
+		return false;
+	string key=Key(fname);
+
+	MTAuto mtenter(&lock);
+	while(key==current)
+	{
+		lock.Unlock();
+		WaitForSingleObject(done_event,INFINITE);
+		lock.Lock();
+	}
+
+	FileMap::iterator it=ready.find(key);
+	if(it!=ready.end())
+	{
+		size=it->second.size;
+		if(it->second.buf)
+		{
+			buf=it->second.buf;
+			ready_size-=size;
+		}
+		else
+		{
+			//   ,    
+			buf=new char[size];
+			memcpy(buf,it->second.view,size);
+		}
+		ready.erase(it);
+		resource_stat.prefetch_hits++;
+		return true;
+	}
+
+	//   -       
+	deque<string>::iterator iq=find(queue.begin(),queue.end(),key);
+	if(iq!=queue.end())
+		queue.erase(iq);
+	return false;
+}
+
+void cResourcePrefetch::Clear()
+{
+	MTAuto mtenter(&lock);
+	queue.clear();
+	//   -  ,     ready.
+	// ,     
+	while(!current.empty())
+	{
+		lock.Unlock();
+		WaitForSingleObject(done_event,INFINITE);
+		lock.Lock();
+	}
+
+	FileMap::iterator it;
+	FOR_EACH(ready,it)
+		delete[] it->second.buf;
+	ready.clear();
+	ready_size=0;
+}
+
+void cResourcePrefetch::Work()
+{
+	for(;;)
+	{
+		WaitForSingleObject(wake_event,INFINITE);
+		for(;;)
+		{
+			string key;
+			{
+				MTAuto mtenter(&lock);
+				if(stop)
+					return;
+				if(queue.empty())
+					break;
+				key=queue.front();
+				queue.pop_front();
+				if(ready_size>READY_LIMIT)
+					continue;
+				current=key;
+				ResetEvent(done_event);
+			}
+
+			sFile file;
+			bool ok=!ResourceFileReadNoCache(key.c_str(),file.buf,file.size,file.view);
+			if(ok && file.view)
+			{
+				//          
+				unsigned sum=0;
+				for(int i=0;i<file.size;i+=4096)
+					sum+=file.view[i];
+				touch_sum=sum;
+			}
+
+			{
+				MTAuto mtenter(&lock);
+				if(ok)
+				{
+					ready[key]=file;
+					if(file.buf)
+						ready_size+=file.size;
+				}
+				current.erase();
+				SetEvent(done_event);
+			}
+		}
+	}
+}
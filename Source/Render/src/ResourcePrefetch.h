@@ -0,0 +1,64 @@
+#pragma once
+#include <hash_map>
+#include <deque>
+
+/*
+    (m3d, tga, jpg)   .
+      -  ZIP   .
+      :  
+   ,  ready    .
+       ,
+D3D  .
+ResourceFileRead   Take,   .
+*/
+class cResourcePrefetch
+{
+public:
+	cResourcePrefetch();
+	~cResourcePrefetch();
+
+	//   ,  
+	void Add(const char* fname);
+	//   (buf  ), false -  
+	bool Take(const char* fname,char*& buf,int& size);
+	//    -  .
+	// ,    
+	void Clear();
+
+private:
+	enum {
+		READY_LIMIT=64<<20//   ( ),    
+	};
+
+	struct sFile
+	{
+		char* buf;//new[], 0 -    
+		const char* view;
+		int size;
+	};
+	typedef hash_map<string,sFile> FileMap;
+
+	deque<string> queue;
+	FileMap ready;
+	int ready_size;
+	string current;//   
+
+	MTSection lock;
+	HANDLE thread;
+	HANDLE wake_event;
+	HANDLE done_event;//,  current  
+	volatile bool stop;
+
+	static string Key(const char* fname);
+	void Start();
+	void Work();
+	friend unsigned __stdcall resource_prefetch_thread(void* argument);
+};
+
+cResourcePrefetch* GetResourcePrefetch();
+sResourceStat& GetResourceStat();
+
+//   ,  .
+//      : view -   
+//( ,  ), buf=0.  view=0, buf - new[],  .
+int ResourceFileReadNoCache(const char *fname,char *&buf,int &size,const char*& view);
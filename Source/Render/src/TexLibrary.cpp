@@ -1,5 +1,7 @@
 #include "StdAfxRD.h"
 #include "FileImage.h"
+#include "VisGeneric.h"
+#include "ResourcePrefetch.h"
 
 #ifdef TEXTURE_NOTFREE
 struct BeginNF
@@ -69,6 +71,7 @@ void cTexLibrary::FreeOne(FILE* f)
 	}
 
 	if(f)fprintf(f,"Texture free %i, not free %i\n",compacted,textures.size()-compacted);
+	RebuildIndex();
 
 	if(f)
 	{
@@ -87,6 +90,56 @@ void cTexLibrary::Free(FILE* f)
 {
 	FreeOne(f);
 	textures.clear();
+	index.clear();
+}
+
+static string texture_key(const char* TextureName)
+{
+	string key=TextureName;
+	for(int i=0;i<key.size();i++)
+		key[i]=tolower(key[i]);
+	return key;
+}
+
+void cTexLibrary::Add(cTexture* Texture)
+{
+	textures.push_back(Texture); Texture->IncRef();
+	if(Texture->GetName() && Texture->GetName()[0])
+		index[texture_key(Texture->GetName())].push_back(Texture);
+}
+
+vector<cTexture*>* cTexLibrary::Find(const char* TextureName)
+{
+	TextureIndex::iterator it=index.find(texture_key(TextureName));
+	return it!=index.end()?&it->second:NULL;
+}
+
+void cTexLibrary::RebuildIndex()
+{
+	index.clear();
+	vector<cTexture*>::iterator it;
+	FOR_EACH(textures,it)
+	{
+		cTexture* p=*it;
+		if(p && p->GetName() && p->GetName()[0])
+			index[texture_key(p->GetName())].push_back(p);
+	}
+}
+
+bool cTexLibrary::IsLoaded(const char* TextureName)
+{
+	MTAuto mtenter(&lock);
+	return Find(TextureName)!=NULL;
+}
+
+bool cTexLibrary::Load(cTexture* Texture,char *pMode,Vect2f kscale)
+{
+	sResourceStat& stat=GetResourceStat();
+	stat.texture_loads++;
+	double time=clockf();
+	bool ok=LoadTexture(Texture,pMode,kscale);
+	stat.texture_load_time+=clockf()-time;
+	return ok;
 }
 
 cTexture* cTexLibrary::CreateRenderTexture(int width,int height,DWORD attr,bool enable_assert)
@@ -105,7 +158,7 @@ cTexture* cTexLibrary::CreateRenderTexture(int width,int height,DWORD attr,bool
 
 	int err=gb_RenderDevice->CreateTexture(Texture,NULL,-1,-1,enable_assert);
 	if(err) { Texture->Release(); return 0; }
-	textures.push_back(Texture); Texture->IncRef();
+	Add(Texture);
 	return Texture;
 }
 
@@ -147,19 +200,16 @@ cTexture* cTexLibrary::GetElementAviScale(const char* TextureName,char *pMode)
 {
 	MTAuto mtenter(&lock);
 	if(TextureName==0||TextureName[0]==0) return 0; //   
+	GetResourceStat().texture_requests++;
 
-	for(int i=0;i<GetNumberTexture();i++)
+	if(vector<cTexture*>* same=Find(TextureName))
 	{
-		cTexture* cur=GetTexture(i);
-		xassert(cur->GetX()>=0 && cur->GetX()<=15);
-		xassert(cur->GetY()>=0 && cur->GetY()<=15);
-		if( cur && stricmp(cur->GetName(),TextureName)==0)
-		{
-			cur->IncRef();
-			return cur;
-		}
+		cTexture* cur=same->front();
+		cur->IncRef();
+		return cur;
 	}
 
+	GetResourceStat().texture_loads++;
 	cAviScaleFileImage avi_images;
 	std::string fName = TextureName;
 	if (avi_images.Init(fName.c_str())==false)
@@ -177,7 +227,7 @@ cTexture* cTexLibrary::GetElementAviScale(const char* TextureName,char *pMode)
 		return NULL;
 	}
 
-	textures.push_back(Texture); Texture->IncRef();
+	Add(Texture);
 	return Texture;
 }
 
@@ -185,27 +235,25 @@ cTexture* cTexLibrary::GetElement(const char* TextureName,char *pMode)
 {
 	MTAuto mtenter(&lock);
 	if(TextureName==0||TextureName[0]==0) return 0; //   
+	GetResourceStat().texture_requests++;
 
-	for(int i=0;i<GetNumberTexture();i++)
+	if(vector<cTexture*>* same=Find(TextureName))
 	{
-		cTexture* cur=GetTexture(i);
+		cTexture* cur=same->front();
 		xassert(cur->GetX()>=0 && cur->GetX()<=15);
 		xassert(cur->GetY()>=0 && cur->GetY()<=15);
-		if( cur && stricmp(cur->GetName(),TextureName)==0)
-		{
-			cur->IncRef();
-			return cur;
-		}
+		cur->IncRef();
+		return cur;
 	}
 
 	cTexture *Texture=new cTexture(TextureName);
 
-	if(!LoadTexture(Texture,pMode,Vect2f(1.0f,1.0f)))
+	if(!Load(Texture,pMode,Vect2f(1.0f,1.0f)))
 	{
 		return false;
 	}
 
-	textures.push_back(Texture); Texture->IncRef();
+	Add(Texture);
 	return Texture;
 }
 
@@ -219,28 +267,31 @@ cTexture* cTexLibrary::GetElementColor(const char *TextureName,sColor4c color,ch
 		color.set(255,255,255,0);
 	}
 
-	for(int i=0;i<GetNumberTexture();i++)
+	GetResourceStat().texture_requests++;
+
+	if(vector<cTexture*>* same=Find(TextureName))
 	{
-		cTexture* cur=GetTexture(i);
-		xassert(cur->GetX()>=0 && cur->GetX()<=15);
-		xassert(cur->GetY()>=0 && cur->GetY()<=15);
-		if( cur && stricmp(cur->GetName(),TextureName)==0 && 
-			cur->skin_color.RGBA()==color.RGBA())
+		vector<cTexture*>::iterator it;
+		FOR_EACH(*same,it)
 		{
-			cur->IncRef();
-			return cur;
+			cTexture* cur=*it;
+			if(cur->skin_color.RGBA()==color.RGBA())
+			{
+				cur->IncRef();
+				return cur;
+			}
 		}
 	}
 
 	cTexture *Texture=new cTexture(TextureName);
 	Texture->skin_color=color;
 
-	if(!LoadTexture(Texture,pMode,Vect2f(1.0f,1.0f)))
+	if(!Load(Texture,pMode,Vect2f(1.0f,1.0f)))
 	{
 		return false;
 	}
 
-	textures.push_back(Texture); Texture->IncRef();
+	Add(Texture);
 	return Texture;
 }
 
@@ -249,19 +300,21 @@ cTextureScale* cTexLibrary::GetElementScale(const char *TextureName,Vect2f scale
 	MTAuto mtenter(&lock);
 	if(TextureName==0||TextureName[0]==0) return 0; //   
 	cTextureScale* Texture=NULL;
+	GetResourceStat().texture_requests++;
 
-	for(int i=0;i<GetNumberTexture();i++)
+	if(vector<cTexture*>* same=Find(TextureName))
 	{
-		cTexture* cur=GetTexture(i);
-		if(!cur)
-			continue;
-
-		if( cur->IsScaleTexture() && stricmp(cur->GetName(),TextureName)==0)
+		vector<cTexture*>::iterator it;
+		FOR_EACH(*same,it)
 		{
-			cur->IncRef();
-			Texture=(cTextureScale*)cur;
-			if((Texture->GetCreateScale()-scale).norm2()<1e-8f)
-				return Texture;
+			cTexture* cur=*it;
+			if(cur->IsScaleTexture())
+			{
+				cur->IncRef();
+				Texture=(cTextureScale*)cur;
+				if((Texture->GetCreateScale()-scale).norm2()<1e-8f)
+					return Texture;
+			}
 		}
 	}
 
@@ -270,10 +323,10 @@ cTextureScale* cTexLibrary::GetElementScale(const char *TextureName,Vect2f scale
 	else
 		gb_RenderDevice->DeleteTexture(Texture);
 
-	if(!LoadTexture(Texture,"NoMipMap NoBlur",scale))
+	if(!Load(Texture,"NoMipMap NoBlur",scale))
 		return false;
 
-	textures.push_back(Texture); Texture->IncRef();
+	Add(Texture);
 	return Texture;
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <hash_map>
 
 class cTexture;
 class cTextureScale;
@@ -27,12 +28,23 @@ public:
 
 	MTSection* GetLock(){return &lock;}
 	void ReloadAllTexture();
+
+	//        ( )
+	bool IsLoaded(const char* TextureName);
 private:
 	cTexture* CreateTexture(int sizex,int sizey,bool alpha,bool default_pool);
 	bool enable_error;
 	vector<cTexture*> textures;
+	//    ->     (, )
+	typedef hash_map<string,vector<cTexture*> > TextureIndex;
+	TextureIndex index;
 	void FreeOne(FILE* f);
 
+	void Add(cTexture* Texture);
+	vector<cTexture*>* Find(const char* TextureName);
+	void RebuildIndex();
+	bool Load(cTexture* Texture,char *pMode,Vect2f kscale);
+
 	bool LoadTexture(cTexture* Texture,char *pMode,Vect2f kscale);
 	bool ReLoadTexture(cTexture* Texture,Vect2f kscale);
 	bool ReLoadTexture(cTexture* Texture);
@@ -4,6 +4,7 @@
 #include "Scene.h"
 #include "Font.h"
 #include "..\3dx\Lib3dx.h"
+#include "ResourcePrefetch.h"
 
 void Init3dxshader();
 void Done3dxshader();
@@ -502,6 +503,59 @@ EffectLibrary* cVisGeneric::GetEffectLibrary(const char* filename,bool quiet)
 	return lib;
 }
 
+void cVisGeneric::PrefetchModel(const char* filename)
+{
+	if(!filename || !filename[0] || ObjLibrary->IsLoaded(filename))
+		return;
+	GetResourcePrefetch()->Add(filename);
+
+	//LoadLod      _lod
+	char path_buffer[_MAX_PATH];
+	char drive[_MAX_DRIVE];
+	char dir[_MAX_DIR];
+	char fname[_MAX_FNAME];
+	char ext[_MAX_EXT];
+	_splitpath(filename,drive,dir,fname,ext);
+	strcat(fname,"_lod");
+	_makepath(path_buffer,drive,dir,fname,ext);
+	GetResourcePrefetch()->Add(path_buffer);
+}
+
+void cVisGeneric::PrefetchEffects(const EffectLibrary* lib)
+{
+	if(!lib)
+		return;
+	EffectLibrary::const_iterator it_effect;
+	FOR_EACH(*lib,it_effect)
+	{
+		vector<EmitterKeyInterface*>::iterator it;
+		FOR_EACH((*it_effect)->key,it)
+		{
+			const string& name=(*it)->texture_name;
+			//avi   cAviScaleFileImage  
+			if(name.empty() || name.find(".avi")!=-1)
+				continue;
+			if(!GetTexLibrary()->IsLoaded(name.c_str()))
+				GetResourcePrefetch()->Add(name.c_str());
+		}
+	}
+}
+
+void cVisGeneric::ClearPrefetch()
+{
+	GetResourcePrefetch()->Clear();
+}
+
+const sResourceStat& cVisGeneric::GetResourceStat()
+{
+	return ::GetResourceStat();
+}
+
+void cVisGeneric::ClearResourceStat()
+{
+	::GetResourceStat().clear();
+}
+
 void cVisGeneric::SetLinkEffectToModel(bool link)
 {
 	Option_EnableLinkEffectToModel=link;
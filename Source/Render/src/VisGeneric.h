@@ -35,6 +35,25 @@ enum eShowType
 	SHOW_MAX
 };
 
+//    ,   ClearResourceStat
+struct sResourceStat
+{
+	int texture_requests;
+	int texture_loads;// -    
+	double texture_load_time;//
+	int model_requests;
+	int model_loads;
+	double model_load_time;
+	int prefetch_hits;//     
+
+	sResourceStat(){clear();}
+	void clear()
+	{
+		texture_requests=texture_loads=model_requests=model_loads=prefetch_hits=0;
+		texture_load_time=model_load_time=0;
+	}
+};
+
 class cVisGeneric : public cUnknownClass
 {
 public:
@@ -143,6 +162,14 @@ public:
 
 	cObjLibrary* GetObjLib(){return ObjLibrary;}
 
+	//     - ,    
+	void PrefetchModel(const char* filename);
+	void PrefetchEffects(const EffectLibrary* lib);
+	//  -  
+	void ClearPrefetch();
+	const sResourceStat& GetResourceStat();
+	void ClearResourceStat();
+
 	void SetShadowHint(int hint);
 	int GetShadowHint();
 private:
@@ -123,44 +123,301 @@ int s_f3d::calcTree(int x, int y, int z)
 	return tmp;
 }
 
-void s_f3d::recalcWorld(void)
+//  .      (terraPlaneRead),
+//   getColorIndexArray.
+struct sF3DRowContext {
+	vector<unsigned char> dam, geo, atr;
+	vector<int> xs;
+	vector<short> heights;
+	vector<unsigned char> indices;
+#ifdef _TX3D_LIBRARY_
+	vector<tx3d::Vector3D> points;
+	tx3d::Texture3D* texture; //0 - f3d.indexedTexture
+#endif
+
+	sF3DRowContext() : dam(vMap.H_SIZE), geo(vMap.H_SIZE), atr(vMap.H_SIZE), xs(vMap.H_SIZE), heights(vMap.H_SIZE), indices(vMap.H_SIZE) {
+#ifdef _TX3D_LIBRARY_
+		points.resize(vMap.H_SIZE);
+		texture = 0;
+#endif
+	}
+};
+
+int s_f3d::selectRow(int Y, bool spec, sF3DRowContext& context)
 {
-	int i,j;
-	for(i=0; i<vMap.V_SIZE; i++){
-		for(j=0; j<vMap.H_SIZE; j++){
-			int of=vMap.offsetBuf(j,i);
-			if(vMap.VxDBuf[of]==0) {
-				short v=(vMap.VxGBuf[of]<<VX_FRACTION)|(vMap.AtrBuf[of]&VX_FRACTION_MASK);
+	int of=vMap.offsetBuf(0, Y);
+	terraPlaneRead(vMap.VxDBuf, of, &context.dam[0], vMap.H_SIZE);
+	terraPlaneRead(vMap.VxGBuf, of, &context.geo[0], vMap.H_SIZE);
+	if(!spec)
+		terraPlaneRead(vMap.AtrBuf, of, &context.atr[0], vMap.H_SIZE);
+	int n=0;
+	for(int x=0; x<vMap.H_SIZE; x++){
+		if((context.dam[x]!=0) != spec)
+			continue;
+		short v=context.geo[x]<<VX_FRACTION;
+		if(!spec){
+			v|=context.atr[x]&VX_FRACTION_MASK;
 #ifdef _PERIMETER_
-				if(v) 
+			if(!v)
+				continue;
 #endif
-					vMap.SurBuf[of]=calc(j,i, v);
-			}
 		}
+		context.xs[n]=x;
+		context.heights[n]=v;
+		n++;
 	}
+	return n;
 }
 
+int s_f3d::calcRow(int Y, bool spec, sF3DRowContext& context)
+{
+	int n=selectRow(Y, spec, context);
+	int k;
+#ifdef _TX3D_LIBRARY_
+	for(k=0; k<n; k++){
+		tx3d::Vector3D& point=context.points[k];
+		point.x=context.xs[k];
+		point.y=Y;
+		point.z=(float)context.heights[k] * 0.03125f;//  /32.0f;   calc
+	}
+	if(n)
+		indexedTexture->getColorIndexArray(&context.indices[0], &context.points[0], n, context.texture);
+#else
+	for(k=0; k<n; k++)
+		context.indices[k]=calc(context.xs[k], Y, context.heights[k]);
+#endif
+
+	int of=vMap.offsetBuf(0, Y);
+	if(spec){
 #ifdef _SURMAP_
-void s_f3d::calcSpecBuf(void)
+		for(k=0; k<n; k++)
+			vMap.SpecSurBuf[of+context.xs[k]]=context.indices[k];
+#endif
+	}
+	else{
+		for(k=0; k<n; k++)
+			vMap.SurBuf[of+context.xs[k]]=context.indices[k];
+	}
+	return n;
+}
+
+//  ;     ,   WorldChunksJob
+const int F3D_BAND_ROWS=16;
+// ( )  
+const int F3D_JOBS_MAX=8;
+
+// =     : tx3d  
+//   .  : calcRow  
+//     SurBuf (SpecSurBuf).
+class F3DRowsJob : public TerraJob
 {
-	int i,j;
-	for(i=0; i<vMap.V_SIZE; i++){
-		for(j=0; j<vMap.H_SIZE; j++){
-			int of=vMap.offsetBuf(j,i);
-			if(vMap.VxDBuf[of]!=0) vMap.SpecSurBuf[of]=calc(j,i, (vMap.VxGBuf[of]<<VX_FRACTION));
+public:
+	F3DRowsJob(s_f3d& f3d, bool spec, int jobs) : f3d_(f3d), spec_(spec), points_(jobs, 0) {
+		next_band_=0;
+		bands_=(vMap.V_SIZE + F3D_BAND_ROWS - 1)/F3D_BAND_ROWS;
+#ifdef _TX3D_LIBRARY_
+		//  ,   :  tx3d  
+		textures_.push_back(0);
+		for(int i=1; i<jobs; i++){
+			tx3d::Texture3D* texture = tx3d::Texture3DFactory::createTexture3D(f3d.textureXML);
+			if(texture)
+				texture->referenced();
+			textures_.push_back(texture);
 		}
+#endif
+	}
+	~F3DRowsJob() {
+#ifdef _TX3D_LIBRARY_
+		vector<tx3d::Texture3D*>::iterator ti;
+		FOR_EACH(textures_, ti)
+			if(*ti)
+				(*ti)->released();
+#endif
+	}
+
+	void execute(int index) {
+		sF3DRowContext context;
+#ifdef _TX3D_LIBRARY_
+		context.texture=textures_[index];
+		//   -    ,   
+		if(index && !context.texture)
+			return;
+#endif
+		for(;;){
+			int band=InterlockedIncrement(&next_band_) - 1;
+			if(band >= bands_)
+				break;
+			int y1=min((band + 1)*F3D_BAND_ROWS, vMap.V_SIZE);
+			for(int y=band*F3D_BAND_ROWS; y<y1; y++)
+				points_[index]+=f3d_.calcRow(y, spec_, context);
+		}
+	}
+
+	int points() const {
+		int sum=0;
+		for(int i=0; i<points_.size(); i++)
+			sum+=points_[i];
+		return sum;
 	}
+
+private:
+	s_f3d& f3d_;
+	bool spec_;
+	volatile LONG next_band_;
+	int bands_;
+	vector<int> points_;
+#ifdef _TX3D_LIBRARY_
+	vector<tx3d::Texture3D*> textures_;
+#endif
+};
+
+void s_f3d::calcRows(bool spec)
+{
+	int jobs=1;
+	// tx3d  turbulence*,     -   
+#ifdef _TX3D_LIBRARY_
+	if(vMap.jobRunner){
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		jobs=min((int)info.dwNumberOfProcessors, F3D_JOBS_MAX);
+	}
+#endif
+	F3DRowsJob job(*this, spec, jobs);
+	vMap.runJobs(job, jobs);
+	stat.points=job.points();
+	stat.jobs=jobs;
 }
-void s_f3d::calcSpecBufStr(int Y)
+
+void s_f3d::recalcWorld(void)
 {
-	int j;
-	for(j=0; j<vMap.H_SIZE; j++){
-		int of=vMap.offsetBuf(j, Y);
-		if(vMap.VxDBuf[of]!=0) vMap.SpecSurBuf[of]=calc(j, Y, (vMap.VxGBuf[of]<<VX_FRACTION));
+	double time=clockf();
+	unsigned int key=cacheKey();
+	stat.cached=loadCache(key);
+	if(!stat.cached){
+		calcRows(false);
+		saveCache(key);
 	}
+	stat.time=clockf()-time;
+}
+
+#ifdef _SURMAP_
+void s_f3d::calcSpecBuf(void)
+{
+	double time=clockf();
+	stat.cached=false;
+	calcRows(true);
+	stat.time=clockf()-time;
+}
+void s_f3d::calcSpecBufStr(int Y)
+{
+	sF3DRowContext context;
+	calcRow(Y, true, context);
 }
 #endif
 
+////////////////  recalcWorld
+const char * f3dCacheFile="f3dCache.bin";
+const char F3D_CACHE_ID[4]={'F', '3', 'D', 'C'};
+const int F3D_CACHE_VERSION=1;
+
+struct sF3DCacheHeader {
+	char id[4];
+	int version;
+	int hSize, vSize;
+	unsigned int key;
+	int points; // -   selectRow(Y, false)   
+};
+
+unsigned int s_f3d::cacheKey()
+{
+	int params[6]={ vMap.H_SIZE, vMap.V_SIZE, currentFunction, kmx, kmy, kmz };
+	unsigned int crc=crc32((const unsigned char*)params, sizeof(params), startCRC32);
+#ifdef _TX3D_LIBRARY_
+	if(!textureXML.empty())
+		crc=crc32((const unsigned char*)textureXML.c_str(), textureXML.size(), crc);
+	crc=crc32(indexLattice, sizeof(indexLattice), crc);
+#endif
+	int size=vMap.H_SIZE*vMap.V_SIZE;
+	crc=terraPlaneCRC(vMap.VxGBuf, 0, size, crc);
+	crc=terraPlaneCRC(vMap.VxDBuf, 0, size, crc);
+	crc=terraPlaneCRC(vMap.AtrBuf, 0, size, crc);
+	return crc;
+}
+
+bool s_f3d::loadCache(unsigned int key)
+{
+	XStream ff(0);
+	if(!ff.open(GetTargetName(f3dCacheFile), XS_IN))
+		return false;
+	sF3DCacheHeader header;
+	if(ff.size() < sizeof(header) || ff.read(&header, sizeof(header)) != sizeof(header)
+	  || memcmp(header.id, F3D_CACHE_ID, sizeof(header.id)) || header.version != F3D_CACHE_VERSION
+	  || header.hSize != vMap.H_SIZE || header.vSize != vMap.V_SIZE || header.key != key
+	  || header.points < 0 || ff.size() != sizeof(header) + header.points){
+		ff.close();
+		return false;
+	}
+	vector<unsigned char> data(header.points + 1);
+	ff.read(&data[0], header.points);
+	bool error=ff.ioError();
+	ff.close();
+	if(error)
+		return false;
+
+	//   :    ,  
+	sF3DRowContext context;
+	int points=0, y;
+	for(y=0; y<vMap.V_SIZE; y++)
+		points+=selectRow(y, false, context);
+	if(points != header.points)
+		return false;
+
+	const unsigned char* p=&data[0];
+	for(y=0; y<vMap.V_SIZE; y++){
+		int n=selectRow(y, false, context);
+		int of=vMap.offsetBuf(0, y);
+		for(int k=0; k<n; k++)
+			vMap.SurBuf[of+context.xs[k]]=*p++;
+	}
+	stat.points=points;
+	stat.jobs=0;
+	return true;
+}
+
+void s_f3d::saveCache(unsigned int key)
+{
+	sF3DRowContext context;
+	vector<unsigned char> data;
+	data.reserve(stat.points);
+	for(int y=0; y<vMap.V_SIZE; y++){
+		int n=selectRow(y, false, context);
+		int of=vMap.offsetBuf(0, y);
+		for(int k=0; k<n; k++)
+			data.push_back(vMap.SurBuf[of+context.xs[k]]);
+	}
+
+	sF3DCacheHeader header;
+	memcpy(header.id, F3D_CACHE_ID, sizeof(header.id));
+	header.version=F3D_CACHE_VERSION;
+	header.hSize=vMap.H_SIZE;
+	header.vSize=vMap.V_SIZE;
+	header.key=key;
+	header.points=data.size();
+
+	//       -   
+	string name=GetTargetName(f3dCacheFile);
+	XStream ff(0);
+	if(!ff.open(name.c_str(), XS_OUT))
+		return;
+	ff.write(&header, sizeof(header));
+	if(!data.empty())
+		ff.write(&data[0], data.size());
+	bool error=ff.ioError();
+	ff.close();
+	if(error)
+		remove(name.c_str());
+}
+
 //////////////// Fuction load-save f3d variable
 const char * Section3DFParametrs="3DF Parameters";
 void s_f3d::saveVariable(void)
@@ -186,11 +443,14 @@ void s_f3d::loadVariable(void)
 
 	ifstream ifsTx(GetTargetName("geoTx.xml"));
 	char szBuffer[1024 * 10];
+	szBuffer[0] = 0;
 	ifsTx.get(szBuffer, 1024 * 10, '\0');
 
-	tx3d::Texture3D* pTx = tx3d::Texture3DFactory::createTexture3D(string(szBuffer));
+	textureXML = szBuffer;
+	tx3d::Texture3D* pTx = tx3d::Texture3DFactory::createTexture3D(textureXML);
 	if (!pTx) {
-		pTx = tx3d::Texture3DFactory::createTexture3D("<texture type='Clear'/>");
+		textureXML = "<texture type='Clear'/>";
+		pTx = tx3d::Texture3DFactory::createTexture3D(textureXML);
 	}
 	indexedTexture->setTexture(pTx);
 
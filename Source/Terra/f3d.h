@@ -7,6 +7,19 @@
 
 #define MAX_3D_FUNCTION 2
 
+//       (f3d.cpp)
+struct sF3DRowContext;
+
+//  recalcWorld/calcSpecBuf
+struct sF3DStat {
+	int points; // 
+	int jobs;
+	bool cached; //SurBuf   , points -  
+	double time; //
+
+	sF3DStat() { points = jobs = 0; cached = false; time = 0; }
+};
+
 
 struct s_f3d {
 	s_f3d(void);
@@ -20,6 +33,7 @@ struct s_f3d {
 	unsigned char indexLattice[65536];
 	tx3d::IndexedTexture3D *indexedTexture;
 	tx3d::Vector3D calcPoint;
+	string textureXML; //geoTx.xml,       
 	~s_f3d(void);
 #endif
 
@@ -39,11 +53,26 @@ struct s_f3d {
 
 	int calcMarble(int x, int y, int z);
 	int calcTree(int x, int y, int z);
+	//     vMap.jobRunner,   
+	//  .  recalcWorld    (cacheKey).
 	void recalcWorld(void);
 #ifdef _SURMAP_
 	void calcSpecBuf(void);
 	void calcSpecBufStr(int Y);
 #endif
+	// Y: SurBuf (spec=false)  SpecSurBuf (spec=true),   
+	int calcRow(int Y, bool spec, sF3DRowContext& context);
+	void calcRows(bool spec);
+	// ,   calcRow: x -  context.xs,  -  context.heights
+	int selectRow(int Y, bool spec, sF3DRowContext& context);
+
+	// :  ,     VxGBuf, VxDBuf, AtrBuf
+	unsigned int cacheKey();
+	bool loadCache(unsigned int key);
+	void saveCache(unsigned int key);
+
+	sF3DStat stat;
+
 	void saveVariable(void);
 	void loadVariable(void);
 
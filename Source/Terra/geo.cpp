@@ -395,9 +395,9 @@ CGeoInfluence::CGeoInfluence(int _x, int _y, int _sx, int _sy)
 	tmpltGeo=new int[sx*sy];
 	tmpltSur=new unsigned char[sx*sy];
 	prepTmplt();
-	unsigned char* geo=vMap.VxGBuf;
-	unsigned char* dam=vMap.VxDBuf;
-	unsigned char* atr=vMap.AtrBuf;
+	TerraPlane& geo=vMap.VxGBuf;
+	TerraPlane& dam=vMap.VxDBuf;
+	TerraPlane& atr=vMap.AtrBuf;
 	int i,j,cnt=0;
 	int vmin=MAX_VX_HEIGHT;
 	int vmax=0;
@@ -406,9 +406,9 @@ CGeoInfluence::CGeoInfluence(int _x, int _y, int _sx, int _sy)
 		for(j=0; j<sx; j++){
 			int off=offy+vMap.XCYCL(x+j);
 			int v;
-			if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;//v=( *(inVxG+cnt)= *(geo+off) )<<VX_FRACTION;
-			else v= *(dam+off) <<VX_FRACTION;//v=( *(inVxG+cnt)= *(dam+off) )<<VX_FRACTION;
-			v|=*(atr+off) &VX_FRACTION_MASK;//v|=( *(inAtr+cnt) = *(atr+off) )&VX_FRACTION_MASK;
+			if(dam[off]==0) v= geo[off] <<VX_FRACTION;//v=( *(inVxG+cnt)= *(geo+off) )<<VX_FRACTION;
+			else v= dam[off] <<VX_FRACTION;//v=( *(inVxG+cnt)= *(dam+off) )<<VX_FRACTION;
+			v|=atr[off] &VX_FRACTION_MASK;//v|=( *(inAtr+cnt) = *(atr+off) )&VX_FRACTION_MASK;
 			*(inVx+cnt)=v;
 			if( v < vmin) vmin=v;
 			if( v > vmax) vmax=v;
@@ -609,9 +609,9 @@ CWormOut::CWormOut(int _x, int _y)
 		}
 	}
 
-	unsigned char* geo=vMap.VxGBuf;
-	unsigned char* dam=vMap.VxDBuf;
-	unsigned char* atr=vMap.AtrBuf;
+	TerraPlane& geo=vMap.VxGBuf;
+	TerraPlane& dam=vMap.VxDBuf;
+	TerraPlane& atr=vMap.AtrBuf;
 	//int i,j,cnt=0;
 	cnt=0;
 	int vmin=MAX_VX_HEIGHT;
@@ -621,9 +621,9 @@ CWormOut::CWormOut(int _x, int _y)
 		for(j=0; j<sx_; j++){
 			int off=offy+vMap.XCYCL(x_+j);
 			int v;
-			if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;//v=( *(inVxG+cnt)= *(geo+off) )<<VX_FRACTION;
-			else v= *(dam+off) <<VX_FRACTION;//v=( *(inVxG+cnt)= *(dam+off) )<<VX_FRACTION;
-			v|=*(atr+off) &VX_FRACTION_MASK;//v|=( *(inAtr+cnt) = *(atr+off) )&VX_FRACTION_MASK;
+			if(dam[off]==0) v= geo[off] <<VX_FRACTION;//v=( *(inVxG+cnt)= *(geo+off) )<<VX_FRACTION;
+			else v= dam[off] <<VX_FRACTION;//v=( *(inVxG+cnt)= *(dam+off) )<<VX_FRACTION;
+			v|=atr[off] &VX_FRACTION_MASK;//v|=( *(inAtr+cnt) = *(atr+off) )&VX_FRACTION_MASK;
 			*(inVx+cnt)=v;
 			if( v < vmin) vmin=v;
 			if( v > vmax) vmax=v;
@@ -2087,10 +2087,10 @@ CLandslip::CLandslip(int _x, int _y, int _sx, int _sy, int _hmin, int _hmax, flo
 	surVxB=new short[sx*sy];
 	tmpltGeo=new int[sx*sy];
 	prepTmplt();
-	unsigned char* geo=vMap.VxGBuf;
-	unsigned char* dam=vMap.VxDBuf;
-	unsigned char* atr=vMap.AtrBuf;
-	unsigned char* sur=vMap.SurBuf;
+	TerraPlane& geo=vMap.VxGBuf;
+	TerraPlane& dam=vMap.VxDBuf;
+	TerraPlane& atr=vMap.AtrBuf;
+	TerraPlane& sur=vMap.SurBuf;
 	int i,j,cnt=0;
 	int vmin=MAX_VX_HEIGHT;
 	int vmax=0;
@@ -2099,9 +2099,9 @@ CLandslip::CLandslip(int _x, int _y, int _sx, int _sy, int _hmin, int _hmax, flo
 		for(j=0; j<sx; j++){
 			int off=vMap.offsetBuf(vMap.XCYCL((rbmp.getX(j)+xPrec)>>16), vMap.YCYCL((rbmp.getY(j)+yPrec)>>16));
 			int v;
-			if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;
-			else v= *(dam+off) <<VX_FRACTION;
-			v|=*(atr+off) &VX_FRACTION_MASK;
+			if(dam[off]==0) v= geo[off] <<VX_FRACTION;
+			else v= dam[off] <<VX_FRACTION;
+			v|=atr[off] &VX_FRACTION_MASK;
 			float xx=(float)rbmp.getX(j)/(sx/2)/(1<<16);
 			float yy=(float)rbmp.getY(j)/(sy/2)/(1<<16);
 
@@ -2118,7 +2118,7 @@ CLandslip::CLandslip(int _x, int _y, int _sx, int _sy, int _hmin, int _hmax, flo
 					*(deltaVx+cnt)=v-curV ;
 					//if((v-curV)>(1<<VX_FRACTION))
 					surVx[cnt]=sur[off];
-					if(*(dam+off)!=0) surVx[cnt]|=256;//2^8
+					if(dam[off]!=0) surVx[cnt]|=256;//2^8
 				}
 				else *(deltaVx+cnt)=0;
 			}
@@ -2170,17 +2170,17 @@ int CLandslip::geoQuant(void)
 /*	static float al=0;//M_PI/4.0;//+M_PI/18.0;
 	srBmp rbmp(al, sx, sy);
 	al=al+M_PI/18.0;
-	unsigned char* geo=vMap.VxGBuf;
-	unsigned char* dam=vMap.VxDBuf;
-	unsigned char* atr=vMap.AtrBuf;
+	TerraPlane& geo=vMap.VxGBuf;
+	TerraPlane& dam=vMap.VxDBuf;
+	TerraPlane& atr=vMap.AtrBuf;
 	int i,j,cnt=0;
 	for(i=-2*sy; i<2*sy; i++){
 		int offy=vMap.offsetBuf(0, vMap.YCYCL(y+i));
 		for(j=-2*sx; j<2*sx; j++){
 			int off=offy+vMap.XCYCL(x+j);
 			int v=70<<VX_FRACTION;
-			*(geo+off)=v>>VX_FRACTION;
-			*(atr+off)= (*(atr+off)&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
+			geo[off]=v>>VX_FRACTION;
+			atr[off]= (atr[off]&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
 		}
 	}
 	cnt=0;
@@ -2201,17 +2201,17 @@ int CLandslip::geoQuant(void)
 //			int off=vMap.offsetBuf(vMap.XCYCL(rbmp.begShiftX + x+cx), vMap.YCYCL(rbmp.begShiftY + y+cy));
 			int off=vMap.offsetBuf(vMap.XCYCL(rbmp.getX(j)+ x), vMap.YCYCL(rbmp.getY(j)+ y));
 			int v;
-			if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;
-			else v= *(dam+off) <<VX_FRACTION;
-			v|=*(atr+off) &VX_FRACTION_MASK;
+			if(dam[off]==0) v= geo[off] <<VX_FRACTION;
+			else v= dam[off] <<VX_FRACTION;
+			v|=atr[off] &VX_FRACTION_MASK;
 			v+=10<<VX_FRACTION;
 			if(j==sx-1 && i==0) v=200<<VX_FRACTION;
 			if(j==sx/2 && i==sy/2) v=200<<VX_FRACTION;
 			//*(inVx+cnt)=v;
 			//fullVx[cnt]=v;
 			//if(atrVx[cnt]!=2) v-=(int)(*(deltaVx+cnt));
-			*(geo+off)=v>>VX_FRACTION;
-			*(atr+off)= (*(atr+off)&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
+			geo[off]=v>>VX_FRACTION;
+			atr[off]= (atr[off]&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
 			cnt++;
 		}
 	}
@@ -2245,10 +2245,10 @@ int CLandslip::geoQuant(void)
 	short* outBuf=new short[bufSize];
 	for(int k=0; k<bufSize; k++) { buf[k]=0; } //outBuf[k]=0; }
 
-	unsigned char* geo=vMap.VxGBuf;
-	unsigned char* dam=vMap.VxDBuf;
-	unsigned char* atr=vMap.AtrBuf;
-	unsigned char* sur=vMap.SurBuf;
+	TerraPlane& geo=vMap.VxGBuf;
+	TerraPlane& dam=vMap.VxDBuf;
+	TerraPlane& atr=vMap.AtrBuf;
+	TerraPlane& sur=vMap.SurBuf;
 
 /*
 // 
@@ -2259,16 +2259,16 @@ int CLandslip::geoQuant(void)
 			int off=vMap.offsetBuf(vMap.XCYCL((rbmpT.getX(j)+xPrec)>>16), vMap.YCYCL((rbmpT.getY(j)+yPrec)>>16));
 			int offb=((rbmpT.getX(j)+bxoldPrec)>>16)+ ((rbmpT.getY(j)+byoldPrec)>>16)*bsx;
 			int v;
-			if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;
-			else v= *(dam+off) <<VX_FRACTION;
-			v|=*(atr+off) &VX_FRACTION_MASK;
+			if(dam[off]==0) v= geo[off] <<VX_FRACTION;
+			else v= dam[off] <<VX_FRACTION;
+			v|=atr[off] &VX_FRACTION_MASK;
 			//*(inVx+cnt)=v;
 			fullVx[cnt]=v;
 			v+=(int)deltaVx[cnt];
 			buf[offb]+=deltaVx[cnt];
 			if(v<0)v=0;
-			*(geo+off)=v>>VX_FRACTION;
-			*(atr+off)= (*(atr+off)&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
+			geo[off]=v>>VX_FRACTION;
+			atr[off]= (atr[off]&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
 			cnt++;
 		}
 	}
@@ -2284,9 +2284,9 @@ int CLandslip::geoQuant(void)
 //				int a=5;
 //			}
 			int v;
-			if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;
-			else v= *(dam+off) <<VX_FRACTION;
-			v|=*(atr+off) &VX_FRACTION_MASK;
+			if(dam[off]==0) v= geo[off] <<VX_FRACTION;
+			else v= dam[off] <<VX_FRACTION;
+			v|=atr[off] &VX_FRACTION_MASK;
 
 			v-=(int)deltaVx[cnt];
 			buf[offb]-=deltaVx[cnt];
@@ -2294,8 +2294,8 @@ int CLandslip::geoQuant(void)
 
 			if(v<0)v=0;
 			if(dam[off]!=0) dam[off]=v>>VX_FRACTION;
-			else *(geo+off)=v>>VX_FRACTION;
-			*(atr+off)= (*(atr+off)&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
+			else geo[off]=v>>VX_FRACTION;
+			atr[off]= (atr[off]&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
 			cnt++;
 		}
 	}
@@ -2425,15 +2425,15 @@ int CLandslip::geoQuant(void)
 		for(j=0; j<bsx; j++){
 			int off=vMap.offsetBuf(vMap.XCYCL(shiftBX-bsx05+j), vMap.YCYCL(shiftBY-bsy05+i));
 			int v;
-			if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;
-			else v= *(dam+off) <<VX_FRACTION;
-			v|=*(atr+off) &VX_FRACTION_MASK;
+			if(dam[off]==0) v= geo[off] <<VX_FRACTION;
+			else v= dam[off] <<VX_FRACTION;
+			v|=atr[off] &VX_FRACTION_MASK;
 			int dsm=outBuf[cnt]-buf[cnt];
 			v+=dsm;
 			if( abs(dsm)< ((1<<VX_FRACTION)+(1<<(VX_FRACTION-1)) ) ){
-				if(dam[off]!=0) *(dam+off)=v>>VX_FRACTION;
-				else *(geo+off)=v>>VX_FRACTION;
-				*(atr+off)= (*(atr+off)&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
+				if(dam[off]!=0) dam[off]=v>>VX_FRACTION;
+				else geo[off]=v>>VX_FRACTION;
+				atr[off]= (atr[off]&(~VX_FRACTION_MASK)) | (v&VX_FRACTION_MASK);
 			}
 			cnt++;
 		}
@@ -2520,9 +2520,9 @@ sTVolcano::sTVolcano(int _x, int _y, int _sx, int _sy)
 	sx = _sx; 
 	sy = _sy;
 	inVx = new unsigned short[sx*sy];
-	unsigned char* geo=vMap.VxGBuf;
-	unsigned char* dam=vMap.VxDBuf;
-	unsigned char* atr=vMap.AtrBuf;
+	TerraPlane& geo=vMap.VxGBuf;
+	TerraPlane& dam=vMap.VxDBuf;
+	TerraPlane& atr=vMap.AtrBuf;
 	int cnt = 0;
 	int vmin = MAX_VX_HEIGHT;
 	int vmax = 0;
@@ -2531,8 +2531,8 @@ sTVolcano::sTVolcano(int _x, int _y, int _sx, int _sy)
 		int offy=vMap.offsetBuf(0, vMap.YCYCL(y+i));
 		for(int j=0; j<sx; j++){
 			int off = offy+vMap.XCYCL(x+j);
-			int v = *(dam+off) == 0 ? *(geo + off) << VX_FRACTION : *(dam + off) << VX_FRACTION;
-			v |= *(atr+off) & VX_FRACTION_MASK;
+			int v = dam[off] == 0 ? geo[off] << VX_FRACTION : dam[off] << VX_FRACTION;
+			v |= atr[off] & VX_FRACTION_MASK;
 			inVx[cnt] = v;
 			if(v < vmin) 
 				vmin=v;
@@ -2775,9 +2775,9 @@ sTBubble::sTBubble(int _x, int _y, int _sx, int _sy, bool _flag_occurrenceGeo)
 	inVx=new short[sx*sy];
 	tmpVx=new short[sx*sy];
 	substare=new short[sx*sy];
-	unsigned char* geo=vMap.VxGBuf;
-	unsigned char* dam=vMap.VxDBuf;
-	unsigned char* atr=vMap.AtrBuf;
+	TerraPlane& geo=vMap.VxGBuf;
+	TerraPlane& dam=vMap.VxDBuf;
+	TerraPlane& atr=vMap.AtrBuf;
 	int i,j,cnt=0;
 	int vmin=MAX_VX_HEIGHT;
 	int vmax=0;
@@ -2786,11 +2786,11 @@ sTBubble::sTBubble(int _x, int _y, int _sx, int _sy, bool _flag_occurrenceGeo)
 		for(j=0; j<sx; j++){
 			int off=offy+vMap.XCYCL(x+j);
 			int v;
-			if(*(dam+off)==0) 
-				v = *(geo+off) <<VX_FRACTION;
+			if(dam[off]==0) 
+				v = geo[off] <<VX_FRACTION;
 			else 
-				v = *(dam+off) <<VX_FRACTION;
-			v |= *(atr+off) & VX_FRACTION_MASK;
+				v = dam[off] <<VX_FRACTION;
+			v |= atr[off] & VX_FRACTION_MASK;
 			*(inVx+cnt)=v;
 			*(tmpVx+cnt)=v;
 			if( v < vmin) vmin=v;
@@ -3281,7 +3281,7 @@ bool sTorpedo::quant(void)
 			if(dh==0) continue;
 			int offsetG=(vMap.XCYCL(j)>>kmGrid) + offGY;
 			if( (vMap.GABuf[offsetG]&GRIDAT_BUILDING) != 0){
-				vMap.GABuf[offsetG]|=GRIDAT_BASE_OF_BUILDING_CORRUPT;
+				vMap.setGridAttribute(offsetG, GRIDAT_BASE_OF_BUILDING_CORRUPT);
 				///continue;
 			}
 
@@ -4851,7 +4851,7 @@ bool sUPoligonN::quant(float angle_grad)
 					for(; xWrk<=(AET[i+1].x>>16); xWrk++) {
 						int offsetG=(vMap.XCYCL(xWrk)>>kmGrid) + offGY;
 						if( (vMap.GABuf[offsetG]&GRIDAT_BUILDING) != 0){
-							vMap.GABuf[offsetG]|=GRIDAT_BASE_OF_BUILDING_CORRUPT;
+							vMap.setGridAttribute(offsetG, GRIDAT_BASE_OF_BUILDING_CORRUPT);
 						}
 						/*else*/ {
 							//short addVx=arrayVx[(vMap.XCYCL(xWrk)-leftBorder) + sx*(vMap.YCYCL(yWrk)-upBorder)];
@@ -4981,7 +4981,7 @@ loc_begDraw2Part:
 					for(; xWrk<=(AET[i+1].x>>16); xWrk++) {
 						int offsetG=(vMap.XCYCL(xWrk)>>kmGrid) + offGY;
 						if( (vMap.GABuf[offsetG]&GRIDAT_BUILDING) != 0){
-							vMap.GABuf[offsetG]|=GRIDAT_BASE_OF_BUILDING_CORRUPT;
+							vMap.setGridAttribute(offsetG, GRIDAT_BASE_OF_BUILDING_CORRUPT);
 						}
 						/*else*/ {
 							//short addVx=arrayVx[(vMap.XCYCL(xWrk)-leftBorder) + sx*(vMap.YCYCL(yWrk)-upBorder)];
@@ -5944,9 +5944,9 @@ void s_EarthUnit::init(int xMap, int yMap)
 	tmpVx=new short[meshDate->sizeX*meshDate->sizeY];
 	substare=new short[meshDate->sizeX*meshDate->sizeY];
 
-	unsigned char* geo=vMap.VxGBuf;
-	unsigned char* dam=vMap.VxDBuf;
-	unsigned char* atr=vMap.AtrBuf;
+	TerraPlane& geo=vMap.VxGBuf;
+	TerraPlane& dam=vMap.VxDBuf;
+	TerraPlane& atr=vMap.AtrBuf;
 	int i,j,cnt=0;
 	int vmin=MAX_VX_HEIGHT;
 	int vmax=0;
@@ -5955,9 +5955,9 @@ void s_EarthUnit::init(int xMap, int yMap)
 		for(j=0; j<meshDate->sizeX; j++){
 			int off=offy+vMap.XCYCL(xL+j);
 			int v;
-			if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;
-			else v= *(dam+off) <<VX_FRACTION;
-			v|=*(atr+off) &VX_FRACTION_MASK;
+			if(dam[off]==0) v= geo[off] <<VX_FRACTION;
+			else v= dam[off] <<VX_FRACTION;
+			v|=atr[off] &VX_FRACTION_MASK;
 			*(inVx+cnt)=v;
 			*(tmpVx+cnt)=v;
 			if( v < vmin) vmin=v;
@@ -6033,9 +6033,9 @@ bool s_EarthUnit::quant()
 	unsigned short sy=meshDate->sizeY;
 
 	if(flag_move){
-		unsigned char* geo=vMap.VxGBuf;
-		unsigned char* dam=vMap.VxDBuf;
-		unsigned char* atr=vMap.AtrBuf;
+		TerraPlane& geo=vMap.VxGBuf;
+		TerraPlane& dam=vMap.VxDBuf;
+		TerraPlane& atr=vMap.AtrBuf;
 		int i,j,cnt=0;
 		for(i=0; i<meshDate->sizeY; i++){
 			int offy=vMap.offsetBuf(0, vMap.YCYCL(yL+i));
@@ -6070,9 +6070,9 @@ bool s_EarthUnit::quant()
 			for(j=0; j<meshDate->sizeX; j++){
 				int off=offy+vMap.XCYCL(nxL+j);
 				int v;
-				if(*(dam+off)==0) v= *(geo+off) <<VX_FRACTION;
-				else v= *(dam+off) <<VX_FRACTION;
-				v|=*(atr+off) &VX_FRACTION_MASK;
+				if(dam[off]==0) v= geo[off] <<VX_FRACTION;
+				else v= dam[off] <<VX_FRACTION;
+				v|=atr[off] &VX_FRACTION_MASK;
 				*(inVx+cnt)=v;
 				*(tmpVx+cnt)=v;
 				if( v < vmin) vmin=v;
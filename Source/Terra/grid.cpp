@@ -134,6 +134,7 @@ void vrtMap::initGrid(void)
 		}
 	}
 */
+	invalidateWorldCRC();
 }
 
 void vrtMap::recalcArea2Grid(int xl, int yt, int xr, int yb )
@@ -196,6 +197,7 @@ void vrtMap::recalcArea2Grid(int xl, int yt, int xr, int yb )
 			//if(ZPE==(sizeCellGrid*sizeCellGrid)) atg|=GRIDAT_ZEROPLASTEMPTY;
 			if(/*(ZPE) ||*/ (ZP)) atg|=GRIDAT_ZEROPLAST_IS_PRESENT;
 			GABuf[ofG]=atg;
+			gridCellChanged(XCYCLG(xlG+j), YCYCLG(ytG+i));
 		}
 	}
 
@@ -259,5 +261,6 @@ void vrtMap::loadGrid(XStream & ff)
 		//	GABuf[offsetGBuf(j,i)] &= ~(GRIDAT_BUILDING|GRIDAT_BASE_OF_BUILDING_CORRUPT);
 		//}
 	}
+	invalidateWorldCRC();
 }
 
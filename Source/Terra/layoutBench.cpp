@@ -0,0 +1,128 @@
+#include "stdafxTr.h"
+
+////////////////////////////////////////////////////////////////////
+//	   VxGBuf/VxDBuf/AtrBuf.
+//	              _TERRA_TILED_
+//	  -     :    
+//	 , geo.cpp, deltaZone, renderBox.
+//	   , XRnd .
+////////////////////////////////////////////////////////////////////
+static volatile unsigned int layoutBenchSink;
+
+class LayoutBenchRnd
+{
+public:
+	LayoutBenchRnd() : value_(83838383) {}
+	unsigned int operator()(unsigned int m) { value_ = value_*1103515245 + 12345; return (value_ >> 8) % m; }
+
+private:
+	unsigned int value_;
+};
+
+void vrtMap::benchmarkLayout(sTerraLayoutBench& result, int passes)
+{
+	xassert(IsFullLoad());
+#ifdef _TERRA_TILED_
+	result.tiled = true;
+#else
+	result.tiled = false;
+#endif
+	unsigned int sum = 0;
+	int pass, x, y;
+
+	//   - crc, ,   
+	double time = clockf();
+	for(pass = 0; pass < passes; pass++)
+		for(y = 0; y < V_SIZE; y++)
+			for(x = 0; x < H_SIZE; x++)
+				sum += GetAlt(offsetBuf(x, y));
+	result.rowScan = clockf() - time;
+
+	//  -     
+	time = clockf();
+	for(pass = 0; pass < passes; pass++)
+		for(x = 0; x < H_SIZE; x++)
+			for(y = 0; y < V_SIZE; y++)
+				sum += GetAlt(offsetBuf(x, y));
+	result.columnScan = clockf() - time;
+
+	// -     ;  ,
+	//     (fullLoad). XRnd 
+	//  geo.cpp -   
+	unsigned int rndSave = XRndGet();
+	bool recordSave = flag_record_operation;
+	flag_record_operation = false;
+	LayoutBenchRnd rnd;
+	const int margin = 128;
+	const int spots = 256;
+
+	// :      
+	time = clockf();
+	for(pass = 0; pass < passes; pass++){
+		for(int i = 0; i < spots; i++){
+			x = margin + rnd(H_SIZE - 2*margin);
+			y = margin + rnd(V_SIZE - 2*margin);
+			digToolzer4K dig;
+			dig.setHAppoximation(0);
+			dig.start(x, y);
+			while(dig.quant(x, y));
+			putToolzer4K put;
+			put.setHAppoximation(0);
+			put.start(x, y);
+			while(put.quant(x, y));
+		}
+	}
+	result.toolzer = clockf() - time;
+	renderQuant();
+
+	//geo.cpp: , ,  -   
+	const int geoSpots = 8;
+	time = clockf();
+	for(pass = 0; pass < passes; pass++){
+		for(int i = 0; i < geoSpots; i++){
+			x = margin + rnd(H_SIZE - 2*margin);
+			y = margin + rnd(V_SIZE - 2*margin);
+			sGeoWave wave(x, y, margin);
+			while(wave.quant());
+			sGeoSwelling swelling(x, y);
+			while(swelling.quant());
+			sGeoFault fault(Vect2f(x, y), (float)rnd(360)*M_PI/180.f, margin);
+			while(fault.quant());
+		}
+	}
+	result.geo = clockf() - time;
+	renderQuant();
+
+	//deltaZone:   ,   
+	time = clockf();
+	for(pass = 0; pass < passes; pass++){
+		for(int i = 0; i < spots; i++){
+			x = margin + rnd(H_SIZE - 2*margin);
+			y = margin + rnd(V_SIZE - 2*margin);
+			sToolzerPMO pmo;
+			pmo.set(x, y, 32, 2, (i & 1 ? 2 : -2) << VX_FRACTION, 0, 0, 0);
+			deltaZone(pmo);
+			pmo.set(x, y, 32, 2, 0, 0, 0, 0);
+			deltaZone(pmo);
+		}
+	}
+	result.deltaZone = clockf() - time;
+	renderQuant();
+
+	//renderBox + renderQuant  
+	const int box = 128;
+	time = clockf();
+	for(pass = 0; pass < passes; pass++){
+		for(int i = 0; i < spots; i++){
+			x = rnd(H_SIZE - box);
+			y = rnd(V_SIZE - box);
+			sum += renderBox(x, y, x + box, y + box, 1);
+			renderQuant();
+		}
+	}
+	result.renderBox = clockf() - time;
+
+	flag_record_operation = recordSave;
+	XRndSet(rndSave);
+	layoutBenchSink = sum;
+}
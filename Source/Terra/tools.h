@@ -122,7 +122,7 @@ inline void damagingBuildingsTolzer(int _x, int _y, int _r)
 		for(int j = 0;j < max;j++) {
 			int offG = vMap.offsetGBuf(vMap.XCYCLG(x + xx[j]), vMap.YCYCLG(y + yy[j]));
 			if(vMap.GABuf[offG]&GRIDAT_BUILDING){
-				vMap.GABuf[offG] |= GRIDAT_BASE_OF_BUILDING_CORRUPT;
+				vMap.setGridAttribute(offG, GRIDAT_BASE_OF_BUILDING_CORRUPT);
 			}
 		}
 	}
@@ -139,7 +139,7 @@ inline void damagingBuildingsTolzerS(int _xL, int _yU, int _xR, int _yD)
 		int offGY=vMap.offsetGBuf(0,i);
 		for(j=xL; j<=xR; j++){
 			if(vMap.GABuf[offGY+j]&GRIDAT_BUILDING){
-				vMap.GABuf[offGY+j]|=GRIDAT_BASE_OF_BUILDING_CORRUPT;
+				vMap.setGridAttribute(offGY+j, GRIDAT_BASE_OF_BUILDING_CORRUPT);
 			}
 		}
 	}
@@ -733,7 +733,7 @@ inline void clearAtrBaseOfBuildingCorrupt(int x, int y, int rad)
 		for(i=begxg; i<=endxg; i++){
 			int curoff=offGB+vMap.XCYCLG(i);
 			if(vMap.GABuf[curoff]&GRIDAT_BUILDING && ((vMap.GABuf[curoff]&GRIDAT_LEVELED)==0) ) continue; //          
-			vMap.GABuf[curoff]&=~GRIDAT_BASE_OF_BUILDING_CORRUPT;
+			vMap.clearGridAttribute(curoff, GRIDAT_BASE_OF_BUILDING_CORRUPT);
 		}
 	}
 }
@@ -0,0 +1,617 @@
+#include "stdafxTr.h"
+#include <process.h>
+
+////////////////////////////////////////////////////////////////////
+//	LZ  .
+//	: - ( 4  -  ,
+//	 -  -4, 15 -     255),
+//	,   (2 ).  -  .
+//	   -     .
+////////////////////////////////////////////////////////////////////
+const int LZ_HASH_BITS = 12;
+const int LZ_MIN_MATCH = 4;
+const int LZ_MAX_OFFSET = 0xffff;
+const int LZ_LAST_LITERALS = 5;
+
+inline unsigned int lzRead32(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24);
+}
+
+inline unsigned char* lzPutLength(unsigned char* op, int len)
+{
+	for(; len >= 255; len -= 255)
+		*op++ = 255;
+	*op++ = len;
+	return op;
+}
+
+inline int lzPackBound(int size)
+{
+	return size + size/255 + 16;
+}
+
+//  , dst    lzPackBound(size)
+static int lzPack(const unsigned char* src, int size, unsigned char* dst)
+{
+	int table[1 << LZ_HASH_BITS];
+	for(int i = 0; i < (1 << LZ_HASH_BITS); i++)
+		table[i] = -1;
+
+	unsigned char* op = dst;
+	int anchor = 0;
+	int ip = 0;
+	int limit = size - LZ_LAST_LITERALS - LZ_MIN_MATCH;
+	while(ip <= limit){
+		unsigned int sequence = lzRead32(src + ip);
+		unsigned int hash = (sequence*2654435761U) >> (32 - LZ_HASH_BITS);
+		int ref = table[hash];
+		table[hash] = ip;
+		if(ref < 0 || ip - ref > LZ_MAX_OFFSET || lzRead32(src + ref) != sequence){
+			ip++;
+			continue;
+		}
+
+		int len = LZ_MIN_MATCH;
+		while(ip + len < size - LZ_LAST_LITERALS && src[ref + len] == src[ip + len])
+			len++;
+
+		int literals = ip - anchor;
+		unsigned char* token = op++;
+		*token = (min(literals, 15) << 4) | min(len - LZ_MIN_MATCH, 15);
+		if(literals >= 15)
+			op = lzPutLength(op, literals - 15);
+		memcpy(op, src + anchor, literals);
+		op += literals;
+		*op++ = (ip - ref) & 0xff;
+		*op++ = (ip - ref) >> 8;
+		if(len - LZ_MIN_MATCH >= 15)
+			op = lzPutLength(op, len - LZ_MIN_MATCH - 15);
+
+		ip += len;
+		anchor = ip;
+	}
+
+	int literals = size - anchor;
+	*op++ = min(literals, 15) << 4;
+	if(literals >= 15)
+		op = lzPutLength(op, literals - 15);
+	memcpy(op, src + anchor, literals);
+	op += literals;
+	return op - dst;
+}
+
+//false -  
+static bool lzUnpack(const unsigned char* src, int size, unsigned char* dst, int dst_size)
+{
+	const unsigned char* ip = src;
+	const unsigned char* ip_end = src + size;
+	unsigned char* op = dst;
+	unsigned char* op_end = dst + dst_size;
+	for(;;){
+		if(ip >= ip_end)
+			return false;
+		int token = *ip++;
+
+		int literals = token >> 4;
+		if(literals == 15){
+			int c;
+			do {
+				if(ip >= ip_end)
+					return false;
+				c = *ip++;
+				literals += c;
+			} while(c == 255);
+		}
+		if(literals > ip_end - ip || literals > op_end - op)
+			return false;
+		memcpy(op, ip, literals);
+		ip += literals;
+		op += literals;
+		if(ip == ip_end)
+			return op == op_end;
+
+		if(ip_end - ip < 2)
+			return false;
+		int offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		int len = token & 15;
+		if(len == 15){
+			int c;
+			do {
+				if(ip >= ip_end)
+					return false;
+				c = *ip++;
+				len += c;
+			} while(c == 255);
+		}
+		len += LZ_MIN_MATCH;
+		if(!offset || offset > op - dst || len > op_end - op)
+			return false;
+		const unsigned char* ref = op - offset;
+		while(len--)
+			*op++ = *ref++; //    
+	}
+}
+
+// (   )     
+static void deltaEncode(const sWorldChunksHeader& header, unsigned char* raw)
+{
+	int sx = 1 << header.chunkPower;
+	for(unsigned char* row = raw; row < raw + 2*sx*sx; row += sx)
+		for(int x = sx - 1; x > 0; x--)
+			row[x] -= row[x - 1];
+}
+
+static void deltaDecode(const sWorldChunksHeader& header, unsigned char* raw)
+{
+	int sx = 1 << header.chunkPower;
+	for(unsigned char* row = raw; row < raw + 2*sx*sx; row += sx)
+		for(int x = 1; x < sx; x++)
+			row[x] += row[x - 1];
+}
+
+////////////////////////////////////////////////////////////////////
+//	WorldChunksJob
+////////////////////////////////////////////////////////////////////
+const int WORLD_CHUNKS_THREADS_MAX = 8;
+
+unsigned __stdcall world_chunks_thread(void* argument)
+{
+	((WorldChunksJob*)argument)->executeAll();
+	return 0;
+}
+
+int WorldChunksJob::run(int jobs)
+{
+	jobs_ = jobs;
+	next_index_ = 0;
+
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int workers = min(min((int)info.dwNumberOfProcessors, WORLD_CHUNKS_THREADS_MAX), jobs) - 1;
+
+	vector<HANDLE> threads;
+	for(int i = 0; i < workers; i++){
+		unsigned thread_id;
+		HANDLE thread = (HANDLE)_beginthreadex(0, 0, world_chunks_thread, this, 0, &thread_id);
+		if(!thread)
+			break;
+		threads.push_back(thread);
+	}
+
+	executeAll();
+
+	if(!threads.empty())
+		WaitForMultipleObjects(threads.size(), &threads[0], TRUE, INFINITE);
+	vector<HANDLE>::iterator ti;
+	FOR_EACH(threads, ti)
+		CloseHandle(*ti);
+
+	return threads.size() + 1;
+}
+
+void WorldChunksJob::executeAll()
+{
+	for(;;){
+		int index = InterlockedIncrement(&next_index_) - 1;
+		if(index >= jobs_)
+			break;
+		execute(index);
+	}
+}
+
+////////////////////////////////////////////////////////////////////
+//	WorldChunksPacker
+////////////////////////////////////////////////////////////////////
+WorldChunksPacker::WorldChunksPacker(const sWorldChunksHeader& header)
+: header_(header)
+{
+	memcpy(header_.id, WORLD_CHUNKS_ID, sizeof(header_.id));
+	header_.version = WORLD_CHUNKS_VERSION;
+	header_.blocks = header_.chunks() + header_.gridStripes();
+}
+
+void WorldChunksPacker::execute(int index)
+{
+	vector<unsigned char>& packed = packed_[index];
+	int raw_size = header_.rawBlockSize(index);
+	vector<unsigned char> raw(raw_size);
+	if(!getBlock(index, &raw[0]))
+		return;
+
+	if(index < header_.chunks())
+		deltaEncode(header_, &raw[0]);
+
+	packed.resize(lzPackBound(raw_size));
+	int size = lzPack(&raw[0], raw_size, &packed[0]);
+	if(size < raw_size)
+		packed.resize(size);
+	else
+		packed.swap(raw);
+}
+
+bool WorldChunksPacker::save(const char* fname)
+{
+	packed_.clear();
+	packed_.resize(header_.blocks);
+	run(header_.blocks);
+
+	vector<sWorldChunkEntry> entries(header_.blocks);
+	unsigned int offset = sizeof(header_) + entries.size()*sizeof(sWorldChunkEntry);
+	int i;
+	for(i = 0; i < header_.blocks; i++){
+		entries[i].offset = offset;
+		entries[i].size = packed_[i].size();
+		entries[i].crc = entries[i].size ? crc32(&packed_[i][0], entries[i].size, startCRC32) : 0;
+		offset += entries[i].size;
+	}
+
+	XStream ff(fname, XS_OUT);
+	ff.write(&header_, sizeof(header_));
+	ff.write(&entries[0], entries.size()*sizeof(sWorldChunkEntry));
+	for(i = 0; i < header_.blocks; i++)
+		if(!packed_[i].empty())
+			ff.write(&packed_[i][0], packed_[i].size());
+	bool result = !ff.ioError();
+	ff.close();
+
+	packed_.clear();
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////
+//	WorldChunksSnapshot
+////////////////////////////////////////////////////////////////////
+WorldChunksSnapshot::WorldChunksSnapshot(const sWorldChunksHeader& header)
+: WorldChunksPacker(header)
+{
+	blocks_.resize(header.chunks() + header.gridStripes());
+	size_ = 0;
+}
+
+void WorldChunksSnapshot::setBlock(int index, const unsigned char* raw, int size)
+{
+	blocks_[index].assign(raw, raw + size);
+	size_ += size;
+}
+
+bool WorldChunksSnapshot::getBlock(int index, unsigned char* raw)
+{
+	const vector<unsigned char>& block = blocks_[index];
+	if(block.empty())
+		return false;
+	memcpy(raw, &block[0], block.size());
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////
+//	WorldChunksUnpacker
+////////////////////////////////////////////////////////////////////
+WorldChunksUnpacker::WorldChunksUnpacker()
+{
+	entries_ = 0;
+	data_ = 0;
+	size_ = 0;
+	file_ = INVALID_HANDLE_VALUE;
+	mapping_ = 0;
+	verifying_ = false;
+}
+
+WorldChunksUnpacker::~WorldChunksUnpacker()
+{
+	close();
+}
+
+bool WorldChunksUnpacker::readHeader(const char* fname, sWorldChunksHeader& header)
+{
+	XStream ff(0);
+	if(!ff.open(fname, XS_IN))
+		return false;
+	if(ff.size() < sizeof(header))
+		return false;
+	ff.read(&header, sizeof(header));
+	return !memcmp(header.id, WORLD_CHUNKS_ID, sizeof(header.id)) && header.version == WORLD_CHUNKS_VERSION;
+}
+
+bool WorldChunksUnpacker::open(const char* fname)
+{
+	close();
+
+	file_ = CreateFile(fname, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if(file_ != INVALID_HANDLE_VALUE){
+		size_ = GetFileSize(file_, 0);
+		mapping_ = CreateFileMapping(file_, 0, PAGE_READONLY, 0, 0, 0);
+		if(mapping_)
+			data_ = (const unsigned char*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+	}
+
+	if(!data_){
+		//  (,   ) -  
+		close();
+		XStream ff(0);
+		if(!ff.open(fname, XS_IN))
+			return false;
+		size_ = ff.size();
+		buffer_.resize(size_);
+		if(size_)
+			ff.read(&buffer_[0], size_);
+		data_ = size_ ? &buffer_[0] : 0;
+	}
+
+	if(size_ < sizeof(header_)){
+		close();
+		return false;
+	}
+	memcpy(&header_, data_, sizeof(header_));
+	if(memcmp(header_.id, WORLD_CHUNKS_ID, sizeof(header_.id)) || header_.version != WORLD_CHUNKS_VERSION
+	  || header_.blocks != header_.chunks() + header_.gridStripes()
+	  || size_ < sizeof(header_) + header_.blocks*sizeof(sWorldChunkEntry)){
+		close();
+		return false;
+	}
+
+	entries_ = (const sWorldChunkEntry*)(data_ + sizeof(header_));
+	for(int i = 0; i < header_.blocks; i++)
+		if(entries_[i].offset > size_ || entries_[i].size > size_ - entries_[i].offset){
+			close();
+			return false;
+		}
+
+	return true;
+}
+
+void WorldChunksUnpacker::close()
+{
+	if(mapping_){
+		if(data_)
+			UnmapViewOfFile(data_);
+		CloseHandle(mapping_);
+		mapping_ = 0;
+	}
+	if(file_ != INVALID_HANDLE_VALUE){
+		CloseHandle(file_);
+		file_ = INVALID_HANDLE_VALUE;
+	}
+	buffer_.clear();
+	data_ = 0;
+	entries_ = 0;
+	size_ = 0;
+}
+
+bool WorldChunksUnpacker::unpack(sWorldChunksStat& stat)
+{
+	xassert(data_);
+	error_ = 0;
+	blocks_ = 0;
+	packed_size_ = 0;
+	raw_size_ = 0;
+
+	double time = clockf();
+	verifying_ = true;
+	run(header_.blocks);
+	verifying_ = false;
+	if(!error_)
+		stat.threads = run(header_.blocks);
+	stat.unpackTime = clockf() - time;
+	stat.mapped = mapping_ != 0;
+	stat.blocks = blocks_;
+	stat.packedSize = packed_size_;
+	stat.rawSize = raw_size_;
+	return !error_;
+}
+
+void WorldChunksUnpacker::execute(int index)
+{
+	const sWorldChunkEntry& entry = entries_[index];
+	if(!entry.size || error_)
+		return;
+
+	if(verifying_){
+		if(crc32(data_ + entry.offset, entry.size, startCRC32) != entry.crc)
+			InterlockedIncrement(&error_);
+		return;
+	}
+
+	int raw_size = header_.rawBlockSize(index);
+	vector<unsigned char> raw(raw_size);
+	if(entry.size == (unsigned int)raw_size)
+		memcpy(&raw[0], data_ + entry.offset, raw_size);
+	else if(!lzUnpack(data_ + entry.offset, entry.size, &raw[0], raw_size)){
+		//CRC  -       
+		xassert(0 && "World chunks: unpack error");
+		InterlockedIncrement(&error_);
+		return;
+	}
+
+	if(index < header_.chunks())
+		deltaDecode(header_, &raw[0]);
+	putBlock(index, &raw[0]);
+
+	InterlockedIncrement(&blocks_);
+	InterlockedExchangeAdd(&packed_size_, entry.size);
+	InterlockedExchangeAdd(&raw_size_, raw_size);
+}
+
+////////////////////////////////////////////////////////////////////
+//	vrtMap
+////////////////////////////////////////////////////////////////////
+//false -     ,  
+static bool getSourceStamp(const char* source, sWorldChunksHeader& header)
+{
+	header.sourceSize = header.sourceTimeLow = header.sourceTimeHigh = 0;
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if(!source || !GetFileAttributesEx(source, GetFileExInfoStandard, &data))
+		return false;
+	header.sourceSize = data.nFileSizeLow;
+	header.sourceTimeLow = data.ftLastWriteTime.dwLowDateTime;
+	header.sourceTimeHigh = data.ftLastWriteTime.dwHighDateTime;
+	return true;
+}
+
+class vrtMapChunksPacker : public WorldChunksPacker
+{
+public:
+	vrtMapChunksPacker(vrtMap& map, const sWorldChunksHeader& header, const unsigned char* chunk_mask, bool with_grid)
+	: WorldChunksPacker(header), map_(map), chunk_mask_(chunk_mask), with_grid_(with_grid), chunks_(header.chunks()) {}
+
+	//   WorldChunksSnapshot
+	bool getBlock(int index, unsigned char* raw)
+	{
+		if(index < chunks_){
+			if(chunk_mask_ && !chunk_mask_[index])
+				return false;
+			int hSizeGCA = map_.H_SIZE >> kmGridChA;
+			int x0 = (index % hSizeGCA) << kmGridChA;
+			int y0 = (index / hSizeGCA) << kmGridChA;
+			TerraPlane* layers[WORLD_CHUNKS_LAYERS] = { &map_.VxGBuf, &map_.VxDBuf, &map_.AtrBuf, &map_.SurBuf };
+			for(int l = 0; l < WORLD_CHUNKS_LAYERS; l++)
+				for(int k = 0; k < sizeCellGridCA; k++){
+					terraPlaneRead(*layers[l], map_.offsetBuf(x0, y0 + k), raw, sizeCellGridCA);
+					raw += sizeCellGridCA;
+				}
+			return true;
+		}
+
+		if(!with_grid_)
+			return false;
+		const int rows = sizeCellGridCA >> kmGrid;
+		int y0 = (index - chunks_)*rows;
+		for(int y = y0; y < y0 + rows; y++){
+			memcpy(raw, &map_.GVBuf[map_.offsetGBuf(0, y)], map_.GH_SIZE*sizeof(map_.GVBuf[0]));
+			raw += map_.GH_SIZE*sizeof(map_.GVBuf[0]);
+			memcpy(raw, &map_.GABuf[map_.offsetGBuf(0, y)], map_.GH_SIZE*sizeof(map_.GABuf[0]));
+			raw += map_.GH_SIZE*sizeof(map_.GABuf[0]);
+		}
+		return true;
+	}
+
+private:
+	vrtMap& map_;
+	const unsigned char* chunk_mask_;
+	bool with_grid_;
+	int chunks_;
+};
+
+class vrtMapChunksUnpacker : public WorldChunksUnpacker
+{
+public:
+	vrtMapChunksUnpacker(vrtMap& map) : map_(map) {}
+
+protected:
+	void putBlock(int index, const unsigned char* raw)
+	{
+		int chunks = header().chunks();
+		if(index < chunks){
+			int hSizeGCA = map_.H_SIZE >> kmGridChA;
+			int x0 = (index % hSizeGCA) << kmGridChA;
+			int y0 = (index / hSizeGCA) << kmGridChA;
+			TerraPlane* layers[WORLD_CHUNKS_LAYERS] = { &map_.VxGBuf, &map_.VxDBuf, &map_.AtrBuf, &map_.SurBuf };
+			for(int l = 0; l < WORLD_CHUNKS_LAYERS; l++)
+				for(int k = 0; k < sizeCellGridCA; k++){
+					terraPlaneWrite(*layers[l], map_.offsetBuf(x0, y0 + k), raw, sizeCellGridCA);
+					raw += sizeCellGridCA;
+				}
+			return;
+		}
+
+		const int rows = sizeCellGridCA >> kmGrid;
+		int y0 = (index - chunks)*rows;
+		for(int y = y0; y < y0 + rows; y++){
+			memcpy(&map_.GVBuf[map_.offsetGBuf(0, y)], raw, map_.GH_SIZE*sizeof(map_.GVBuf[0]));
+			raw += map_.GH_SIZE*sizeof(map_.GVBuf[0]);
+			memcpy(&map_.GABuf[map_.offsetGBuf(0, y)], raw, map_.GH_SIZE*sizeof(map_.GABuf[0]));
+			raw += map_.GH_SIZE*sizeof(map_.GABuf[0]);
+		}
+	}
+
+private:
+	vrtMap& map_;
+};
+
+bool vrtMap::isWorldChunksFile(const char* fname)
+{
+	sWorldChunksHeader header;
+	return WorldChunksUnpacker::readHeader(fname, header);
+}
+
+void vrtMap::getChunksHeader(sWorldChunksHeader& header, const char* sourceName)
+{
+	header.world = cWorld;
+	header.hSizePower = H_SIZE_POWER;
+	header.vSizePower = V_SIZE_POWER;
+	header.chunkPower = kmGridChA;
+	header.gridPower = kmGrid;
+	getSourceStamp(sourceName, header);
+}
+
+bool vrtMap::saveWorldChunks(const char* fname, const unsigned char* chunkMask, bool withGrid, const char* sourceName)
+{
+	sWorldChunksHeader header;
+	getChunksHeader(header, sourceName);
+
+	vrtMapChunksPacker packer(*this, header, chunkMask, withGrid);
+	return packer.save(fname);
+}
+
+WorldChunksSnapshot* vrtMap::snapshotWorldChunks(const unsigned char* chunkMask, bool withGrid, const char* sourceName)
+{
+	sWorldChunksHeader header;
+	getChunksHeader(header, sourceName);
+
+	//    ,  -  WorldChunksSnapshot::save
+	vrtMapChunksPacker packer(*this, header, chunkMask, withGrid);
+	WorldChunksSnapshot* snapshot = new WorldChunksSnapshot(header);
+	int blocks = header.chunks() + header.gridStripes();
+	vector<unsigned char> raw;
+	for(int i = 0; i < blocks; i++){
+		int size = header.rawBlockSize(i);
+		raw.resize(size);
+		if(packer.getBlock(i, &raw[0]))
+			snapshot->setBlock(i, &raw[0], size);
+	}
+	return snapshot;
+}
+
+bool vrtMap::loadWorldChunks(const char* fname, bool markChanged, const char* sourceName)
+{
+	chunksStat.clear();
+	double time = clockf();
+
+	vrtMapChunksUnpacker unpacker(*this);
+	if(!unpacker.open(fname))
+		return false;
+
+	const sWorldChunksHeader& header = unpacker.header();
+	if(header.world != cWorld || header.hSizePower != H_SIZE_POWER || header.vSizePower != V_SIZE_POWER
+	  || header.chunkPower != kmGridChA || header.gridPower != kmGrid)
+		return false;
+
+	if(sourceName){
+		sWorldChunksHeader source;
+		if(getSourceStamp(sourceName, source)){
+			if(source.sourceSize != header.sourceSize
+			  || source.sourceTimeLow != header.sourceTimeLow || source.sourceTimeHigh != header.sourceTimeHigh)
+				return false; //VMP    
+		}
+		else if(header.sourceSize)
+			return false; //   VMP,        -  
+	}
+	chunksStat.openTime = clockf() - time;
+
+	if(!unpacker.unpack(chunksStat))
+		return false;
+
+	if(markChanged)
+		for(int i = 0; i < header.chunks(); i++)
+			gridChAreas[i] = unpacker.present(i) ? 1 : 0;
+
+	invalidateWorldCRC();
+	return true;
+}
+
+bool vrtMap::convertWorld2Chunks(void)
+{
+	string vmpName=GetTargetName(worldDataFileLinear);
+	return saveWorldChunks(GetTargetName(worldChunksFile), 0, false, vmpName.c_str());
+}
@@ -0,0 +1,164 @@
+#ifndef __WORLDCHUNKS_H__
+#define __WORLDCHUNKS_H__
+
+/*
+ ,    sizeCellGridCA x sizeCellGridCA.
+
+    (LZ),    -   
+ ,       
+     .
+
+ 0..chunks-1 - :  VxG, VxD, Atr, Sur  64x64 
+(   gmp).       .
+ chunks..blocks-1 -    64/4 ,   
+ GVBuf,   GABuf (  saveGrid).
+  0 -   ,   -   .
+   CRC  ; CRC    
+,         .
+*/
+
+const char WORLD_CHUNKS_ID[4]={'S','2','T','C'};
+const int WORLD_CHUNKS_VERSION=1;
+const int WORLD_CHUNKS_LAYERS=4;
+
+struct sWorldChunksHeader {
+	char id[4];
+	int version;
+	int world;
+	int hSizePower;
+	int vSizePower;
+	int chunkPower;
+	int gridPower;
+	int blocks;
+	//     VMP -      
+	unsigned int sourceSize;
+	unsigned int sourceTimeLow;
+	unsigned int sourceTimeHigh;
+
+	int chunks() const { return 1<<(hSizePower + vSizePower - 2*chunkPower); }
+	int gridStripes() const { return 1<<(vSizePower - chunkPower); }
+	int rawBlockSize(int index) const {
+		if(index < chunks())
+			return WORLD_CHUNKS_LAYERS<<(2*chunkPower);
+		return (1<<(chunkPower - gridPower))*(1<<(hSizePower - gridPower))*(sizeof(unsigned char) + sizeof(unsigned short));
+	}
+};
+
+struct sWorldChunkEntry {
+	unsigned int offset;
+	unsigned int size;
+	unsigned int crc; // 
+};
+
+//   (  )
+struct sWorldChunksStat {
+	int blocks;
+	int packedSize;
+	int rawSize;
+	int threads;
+	bool mapped;
+	double openTime;
+	double unpackTime;
+	double totalTime;
+
+	sWorldChunksStat() { clear(); }
+	void clear() { blocks = packedSize = rawSize = threads = 0; mapped = false; openTime = unpackTime = totalTime = 0; }
+};
+
+// execute(0..jobs-1)   ,   
+class WorldChunksJob
+{
+public:
+	virtual ~WorldChunksJob() {}
+	//   
+	int run(int jobs);
+
+protected:
+	virtual void execute(int index) = 0;
+
+private:
+	int jobs_;
+	volatile LONG next_index_;
+
+	void executeAll();
+	friend unsigned __stdcall world_chunks_thread(void* argument);
+};
+
+class WorldChunksPacker : public WorldChunksJob
+{
+public:
+	WorldChunksPacker(const sWorldChunksHeader& header);
+	bool save(const char* fname);
+
+protected:
+	//  , false -   .    .
+	virtual bool getBlock(int index, unsigned char* raw) = 0;
+
+private:
+	sWorldChunksHeader header_;
+	vector<vector<unsigned char> > packed_;
+
+	void execute(int index);
+};
+
+//  :  ,    ,
+//       vrtMap
+class WorldChunksSnapshot : public WorldChunksPacker
+{
+public:
+	WorldChunksSnapshot(const sWorldChunksHeader& header);
+
+	void setBlock(int index, const unsigned char* raw, int size);
+	int size() const { return size_; }
+
+protected:
+	bool getBlock(int index, unsigned char* raw);
+
+private:
+	vector<vector<unsigned char> > blocks_;
+	int size_;
+};
+
+class WorldChunksUnpacker : public WorldChunksJob
+{
+public:
+	WorldChunksUnpacker();
+	~WorldChunksUnpacker();
+
+	// ,   
+	static bool readHeader(const char* fname, sWorldChunksHeader& header);
+
+	bool open(const char* fname);
+	void close();
+
+	const sWorldChunksHeader& header() const { return header_; }
+	bool present(int index) const { return entries_[index].size != 0; }
+
+	// CRC   ,   .
+	//false -  , putBlock    
+	bool unpack(sWorldChunksStat& stat);
+
+protected:
+	//   ,   
+	virtual void putBlock(int index, const unsigned char* raw) = 0;
+
+private:
+	sWorldChunksHeader header_;
+	const sWorldChunkEntry* entries_;
+	const unsigned char* data_;
+	unsigned int size_;
+
+	HANDLE file_;
+	HANDLE mapping_;
+	vector<unsigned char> buffer_;
+
+	bool verifying_; //  CRC,  
+	volatile LONG error_;
+	volatile LONG blocks_;
+	volatile LONG packed_size_;
+	volatile LONG raw_size_;
+
+	void execute(int index);
+};
+
+#endif //__WORLDCHUNKS_H__
@@ -409,7 +409,7 @@ void vrtMap::calc_Flood(int x0,int y0,int level,int ttype,int ti)
 	num[0] = 1;
 
 //	unsigned char** lt = vMap -> lineT;
-	unsigned char *pf;//* pv,
+	int pf;//* pv, -   SurBuf
 	int na,h,t;
 
 	int log = 1,i,j,x,y;
@@ -417,7 +417,7 @@ void vrtMap::calc_Flood(int x0,int y0,int level,int ttype,int ti)
 		log = 0;
 		for(j = 0,i = 0;i < num[index];i++){
 			y = yy[index][i];
-			pf = &(SurBuf[(y)*XS_Buf]);
+			pf = (y)*XS_Buf;
 			{ //if(pv){
 				//pv += (x = xx[index][i]);
 				x = xx[index][i];
@@ -425,9 +425,9 @@ void vrtMap::calc_Flood(int x0,int y0,int level,int ttype,int ti)
 				na = level;
 				h = GetAlt(x,y);//*pv;
 				if(ti) na += (level - h)*DriftPower/16 + XRnd(DriftNoise);
-				t = *pf;
+				t = SurBuf[pf];
 				if(h < level && t != ttype && j < N - 4 ){ //&& ActiveTerrain[t]
-					*pf = ttype; log=1;
+					SurBuf[pf] = ttype; log=1;
 
 					if(ti) PutAlt(x,y,na);//*pv = (unsigned char)na;
 
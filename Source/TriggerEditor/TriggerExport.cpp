@@ -42,6 +42,15 @@ void ConditionSwitcher::clear()
 			ci->condition->clear();
 }
 
+bool ConditionSwitcher::subscribe(ConditionSubscription& subscription) const
+{
+	vector<ConditionNode>::const_iterator ci;
+	FOR_EACH(conditions, ci)
+		if(ci->condition && !ci->condition->subscribe(subscription))
+			return false;
+	return true;
+}
+
 void ConditionSwitcher::writeInfo(XBuffer& buffer, string offset) const
 {
 	if(conditions.empty())
@@ -105,6 +114,10 @@ void Trigger::initialize()
 //	state_ = SLEEPING;
 //	executionCounter_ = 0;
 	selected_ = false;
+	subscribed_ = false;
+	conditionChecked_ = false;
+	conditionState_ = false;
+	conditionStamp_ = 0;
 	if(!condition)
 		condition = new ConditionSwitcher;
 }
@@ -59,6 +59,29 @@ public:
     { return size_t(-1) / sizeof(T); }
 };
 
+//-----------------------------
+//     Condition::check()
+struct ConditionSubscription
+{
+	int events; //  1 << Event::Type,    checkEvent
+	vector<int, TriggerAllocator<int> > unitCounters; // terUnitAttributeID, . terUniverse::unitCountStamp
+
+	ConditionSubscription() {
+		events = 0;
+	}
+
+	void clear() {
+		events = 0;
+		unitCounters.clear();
+	}
+	void addEvent(int type) {
+		events |= 1 << type;
+	}
+	void addUnitCounter(int attributeID) {
+		unitCounters.push_back(attributeID);
+	}
+};
+
 //-----------------------------
 struct Condition : ShareHandleBase //    (  )
 {
@@ -74,6 +97,9 @@ struct Condition : ShareHandleBase // 
 	}
 	virtual_ void checkEvent(AIPlayer& aiPlayer, const class Event& event) {}
 	virtual_ void clear() {}
+	// false - check()    ,
+	// true -         subscription
+	virtual_ bool subscribe(ConditionSubscription& subscription) const { return false; }
 	virtual_ void writeInfo(XBuffer& buffer, string offset) const {}
 
 	bool state() const {
@@ -144,6 +170,7 @@ struct ConditionSwitcher : Condition // 
 	bool check(AIPlayer& aiPlayer);
 	void checkEvent(AIPlayer& aiPlayer, const Event& event);
 	void clear();
+	bool subscribe(ConditionSubscription& subscription) const;
 	void writeInfo(XBuffer& buffer, string offset) const;
 
 	template<class Archive>	
@@ -347,6 +374,7 @@ public:
 	}
 	void setState(State state) {
 		state_ = state;
+		conditionChecked_ = false;
 	}
 	
 	int color() const {
@@ -425,6 +453,15 @@ private:
 	CRectSerialized boundingRect_;
 	bool selected_;
 
+	//    CHECKING:     
+	ConditionSubscription subscription_;
+	bool subscribed_;
+	bool conditionChecked_; // false -  
+	bool conditionState_;
+	int conditionStamp_; // terUniverse::unitCountStamp()   
+
+	bool checkCondition(AIPlayer& aiPlayer);
+
 	friend TriggerChain;
 };
 
@@ -1,60 +1,179 @@
 #include "StdAfx.h"
 #include "DefenceMap.h"
 #include "AIMain.h"
+#include "IronBuilding.h"
 #include "ClusterFind.h"
 #include "ForceField.h"
 #include "AIPrm.h"
 #include "runtime.h"
 
-DefenceMap::DefenceMap(int hsize,int vsize) 
+DefenceMap::DefenceMap(int hsize, int vsize, int clan) 
 : Map2D<BYTE, 4>(hsize, vsize, 0)
 { 
-	path_finder = new ClusterFind(sizeX(), sizeY(), defenceMapPathFind.clusterSize);
-	path_finder2 = new ClusterFind(sizeX(), sizeY(), defenceMapPathFind.clusterSize);
+	clan_ = clan;
+
+	int size = sizeX()*sizeY();
+	chaos_.resize(size, 0);
+	field_.resize(size, 0);
+	fieldNew_.resize(size, 0);
+	gunCount_.resize(size, 0);
 
+	chaosRevision_ = -1;
+	fieldRevision_ = -1;
+	gunStamp_ = -1;
+	rebuild_ = false;
+
+	path_finder = new ClusterFind(sizeX(), sizeY(), defenceMapPathFind.clusterSize);
 	rebuildWalkMap(path_finder->GetWalkMap());
 	path_finder->Set(defenceMapPathFind.enableSmoothing);
-
-	memcpy(path_finder2->GetWalkMap(),path_finder->GetWalkMap(),sizeX()*sizeY()*sizeof(path_finder2->GetWalkMap()[0]));
-	path_finder2->SetLater(defenceMapPathFind.enableSmoothing, defenceMapPathFind.rebuildQuants);
+	clustersBuilt_ = path_finder->GetNumCluster();
 }
 
 DefenceMap::~DefenceMap()
 {
 	delete path_finder;
-	delete path_finder2;
 }
 
-void DefenceMap::startRecalcMap()
+void DefenceMap::update()
 {
-	xassert(path_finder2->ready());
-	swap(path_finder2,path_finder);
+	if(ai_tile_map->chaosRevision() != chaosRevision_)
+		updateChaos();
+
+	if(field_dispatcher && field_dispatcher->clustersRevision() != fieldRevision_)
+		updateField();
+
+	for(int id = UNIT_ATTRIBUTE_LASER_CANNON; id <= UNIT_ATTRIBUTE_GUN_SUBCHASER; id++)
+		if(universe()->unitCountStamp(terUnitAttributeID(id)) > gunStamp_){
+			updateGuns();
+			break;
+		}
 
-	rebuildWalkMap(path_finder2->GetWalkMap());
-	path_finder2->SetLater(defenceMapPathFind.enableSmoothing,defenceMapPathFind.rebuildQuants);
+	recalcPathFind();
 }
 
-bool DefenceMap::recalcMapQuant()
+BYTE DefenceMap::cellValue(int index) const
 {
-	return path_finder2->SetLaterQuant();
+	//   ,     
+	BYTE value = field_[index] ? BLOCK_VALUE : chaos_[index];
+	for(int i = min((int)gunCount_[index], 7); i > 0; i--)
+		value |= (value + 1) & ClusterFind::DOWN_MASK;
+	return value;
 }
 
-void DefenceMap::addGun(const Vect2f& positionWorld, float radiusWorld)
+void DefenceMap::recalcPathFind()
 {
-	Vect2i position = w2m(positionWorld);
-	int radius = w2m(round(radiusWorld) + defenceMapPathFind.gunExtraRadius);
-	for(int y = -radius; y <= radius; y++){
-		int yc = position.y + y;
-		if(yc < 0 || yc >= sizeY())
-			continue;
-		int delta = round(sqrtf(sqr(radius) - sqr(y)));
-		int xl = clamp(position.x - delta, 0, sizeX() - 1);
-		int xr = clamp(position.x + delta, 0, sizeX() - 1);
+	if(!rebuild_ && changed_.empty())
+		return;
+
+	start_timer_auto(DefenceMap_recalcPathFind, STATISTICS_GROUP_AI);
+
+	BYTE* walk_map = path_finder->GetWalkMap();
+	if(!rebuild_ && changed_.size() <= REBUILD_RECTS){
+		vector<sRect>::iterator ri;
+		FOR_EACH(changed_, ri){
+			for(int y = ri->y; y <= ri->y1(); y++)
+				for(int x = ri->x; x <= ri->x1(); x++){
+					int index = y*sizeX() + x;
+					walk_map[index] = (*this)(x, y) = cellValue(index);
+				}
+
+			path_finder->UpdateRect(ri->x, ri->y, ri->x1(), ri->y1(), defenceMapPathFind.enableSmoothing);
+		}
+		statistics_add(DefenceMap_rects, STATISTICS_GROUP_AI, changed_.size());
+
+		//    AITileMap::recalcPathFind:     
+		rebuild_ = path_finder->GetNumCluster() > clustersBuilt_*3/2;
+	}
+	else
+		rebuild_ = true;
+
+	if(rebuild_){
+		start_timer_auto(DefenceMap_rebuild, STATISTICS_GROUP_AI);
+		int size = sizeX()*sizeY();
+		for(int i = 0; i < size; i++)
+			map()[i] = cellValue(i);
+		rebuildWalkMap(walk_map);
+		path_finder->Set(defenceMapPathFind.enableSmoothing);
+		clustersBuilt_ = path_finder->GetNumCluster();
+	}
+
+	rebuild_ = false;
+	changed_.clear();
+}
+
+void DefenceMap::addGun(const Gun& gun, int delta)
+{
+	const Vect2i& position = gun.position;
+	int radius = gun.radius;
+	int y0 = max(position.y - radius, 0);
+	int y1 = min(position.y + radius, sizeY() - 1);
+	if(y0 > y1)
+		return;
+
+	int xmin = sizeX(), xmax = -1;
+	for(int yc = y0; yc <= y1; yc++){
+		int y = yc - position.y;
+		int d = round(sqrtf(sqr(radius) - sqr(y)));
+		int xl = clamp(position.x - d, 0, sizeX() - 1);
+		int xr = clamp(position.x + d, 0, sizeX() - 1);
+		unsigned short* count = &gunCount_[yc*sizeX()];
 		for(int x = xl; x <= xr; x++){
-			BYTE& byte = (*this)(x, yc);
-			byte |= (byte + 1) & ClusterFind::DOWN_MASK;
+			xassert(delta > 0 || count[x]);
+			count[x] += delta;
+		}
+		xmin = min(xmin, xl);
+		xmax = max(xmax, xr);
+	}
+
+	changed_.push_back(sRect(xmin, y0, xmax - xmin, y1 - y0));
+}
+
+void DefenceMap::updateGuns()
+{
+	start_timer_auto(DefenceMap_updateGuns, STATISTICS_GROUP_AI);
+
+	GunList guns;
+	PlayerVect::iterator pi;
+	FOR_EACH(universe()->Players, pi){
+		terPlayer* player = *pi;
+		if(player->isWorld() || player->clan() == clan_)
+			continue;
+		for(int id = UNIT_ATTRIBUTE_LASER_CANNON; id <= UNIT_ATTRIBUTE_GUN_SUBCHASER; id++){
+			terBuildingList& list = player->buildingList(id);
+			terBuildingList::iterator bi;
+			FOR_EACH(list, bi){
+				terBuilding* building = *bi;
+				Gun gun;
+				gun.playerID = building->playerID();
+				gun.unitID = building->unitID();
+				gun.position = w2m(building->position2D());
+				gun.radius = w2m(round(building->attr().fireRadius()) + defenceMapPathFind.gunExtraRadius);
+				guns.push_back(gun);
+			}
+		}
+	}
+	sort(guns.begin(), guns.end());
+
+	//    :  ,  
+	GunList::iterator i = guns_.begin();
+	GunList::iterator j = guns.begin();
+	while(i != guns_.end() || j != guns.end()){
+		if(j == guns.end() || (i != guns_.end() && *i < *j))
+			addGun(*i++, -1);
+		else if(i == guns_.end() || *j < *i)
+			addGun(*j++, 1);
+		else{
+			if(!i->samePlace(*j)){
+				addGun(*i, -1);
+				addGun(*j, 1);
+			}
+			++i;
+			++j;
 		}
 	}
+
+	guns_.swap(guns);
+	gunStamp_ = universe()->unitCountStamp();
 }
 
 //////////////////////////////////////////////////////////////
@@ -138,6 +257,8 @@ private:
 
 bool DefenceMap::findPathToPoint(const Vect2i& from_w, const Vect2i& to_w, vector<Vect2i>& out_path)
 {
+	update();
+
 	Vect2i from = w2m(from_w);
 	if(!inside(from))
 		return false;
@@ -167,6 +288,8 @@ bool DefenceMap::findPathToPoint(const Vect2i& from_w, const Vect2i& to_w, vecto
 
 terUnitBase* DefenceMap::findPathToTarget(const Vect2i& from_w, const UnitList& targets, vector<Vect2i>& out_path)
 {
+	update();
+
 	Vect2i from = w2m(from_w);
 	if(!inside(from))
 		return 0;
@@ -222,73 +345,141 @@ void DefenceMap::rebuildWalkMap(BYTE* walk_map)
 	memcpy(walk_map, map(), sizeY()*sizeX());
 }
 
-void DefenceMap::analizeChaos()
+void DefenceMap::updateChaos()
 {
-	const BYTE value = 64;
+	start_timer_auto(DefenceMap_updateChaos, STATISTICS_GROUP_AI);
 
-	for(int x = 0; x < sizeX(); x++)
-		(*this)(x, 0) = (*this)(x, sizeY() - 1) = value;
-	for(int y = 0; y < sizeY(); y++)
-		(*this)(0, y) = (*this)(sizeX() - 1, y) = value;
+	vector<sRect> rects;
+	if(chaosRevision_ < 0 || !ai_tile_map->chaosChanges(chaosRevision_, rects)){
+		calcChaos(0, 0, sizeX() - 1, sizeY() - 1);
+		rebuild_ = true;
+	}
+	else{
+		//     chaosSmoothSteps - 1  
+		int radius = max(defenceMapPathFind.chaosSmoothSteps - 1, 0);
+		vector<sRect>::iterator ri;
+		FOR_EACH(rects, ri){
+			int x0 = max(ri->x - radius, 0);
+			int y0 = max(ri->y - radius, 0);
+			int x1 = min(ri->x1() + radius, sizeX() - 1);
+			int y1 = min(ri->y1() + radius, sizeY() - 1);
+			calcChaos(x0, y0, x1, y1);
+			changed_.push_back(sRect(x0, y0, x1 - x0, y1 - y0));
+		}
+		statistics_add(DefenceMap_chaosRects, STATISTICS_GROUP_AI, rects.size());
+	}
+
+	chaosRevision_ = ai_tile_map->chaosRevision();
+}
+
+//    [x0, x1]x[y0, y1].     - BLOCK_VALUE,  
+// ;        ,
+//  chaos_    
+void DefenceMap::calcChaos(int x0, int y0, int x1, int y1)
+{
+	int sx = sizeX(), sy = sizeY();
+	int radius = max(defenceMapPathFind.chaosSmoothSteps - 1, 0);
+	int bx0 = max(x0 - radius, 0), by0 = max(y0 - radius, 0);
+	int bx1 = min(x1 + radius, sx - 1), by1 = min(y1 + radius, sy - 1);
+	int bsx = bx1 - bx0 + 1, bsy = by1 - by0 + 1;
+	chaosBuffer_.resize(bsx*bsy);
+	BYTE* chaos = &chaosBuffer_[0];
 
 	xassert(tileSize == AITileMap::tileSize);
-	for(int y = 1; y < sizeY() - 1; y++)
-		for(int x = 1; x < sizeX() - 1; x++)
-			if(!(*ai_tile_map)(x, y).height_min)
-				(*this)(x, y) = value;
-
-	for(int step = value - 1; step > value - defenceMapPathFind.chaosSmoothSteps; step--)
-		for(int y = 1; y < sizeY() - 1; y++)
-			for(int x = 1; x < sizeX() - 1; x++)
-				if(!(*this)(x, y) && ((*this)(x - 1, y) > step || (*this)(x + 1, y) > step || (*this)(x, y - 1) > step || (*this)(x, y + 1) > step))
-					(*this)(x, y) = step;
+	for(int y = by0; y <= by1; y++){
+		BYTE* row = chaos + (y - by0)*bsx - bx0;
+		for(int x = bx0; x <= bx1; x++)
+			row[x] = !x || !y || x == sx - 1 || y == sy - 1 || !(*ai_tile_map)(x, y).height_min ? BLOCK_VALUE : 0;
+	}
+
+	//   step     step,  
+	//            
+	for(int step = BLOCK_VALUE - 1; step > BLOCK_VALUE - defenceMapPathFind.chaosSmoothSteps; step--)
+		for(int y = 1; y < bsy - 1; y++)
+			for(int x = 1; x < bsx - 1; x++){
+				BYTE* p = chaos + y*bsx + x;
+				if(!*p && (p[-1] > step || p[1] > step || p[-bsx] > step || p[bsx] > step))
+					*p = step;
+			}
+
+	for(int y = y0; y <= y1; y++)
+		memcpy(&chaos_[y*sx + x0], chaos + (y - by0)*bsx + x0 - bx0, x1 - x0 + 1);
 }
 
-void DefenceMap::analizeField(int playerID)
+void DefenceMap::updateField()
 {
-	const BYTE value = 64;
-
-	if(field_dispatcher){
-		xassert(FieldDispatcher::scale == tileSizeShl);
-
-		int delta = w2m(defenceMapPathFind.fieldExtraRadius);
-
-		FieldDispatcher::ClusterList::iterator ci;
-		FOR_EACH(field_dispatcher->clusters, ci){
-			FieldCluster& cluster = *ci;
-			if(cluster.get_player_id() != playerID || cluster.empty())
-				continue;
-
-			int yc = cluster.front().y - 1;
-			int xl, xr;
-			bool beginUp = true;
-			vector<FieldInterval>::iterator ii;
-			FOR_EACH(cluster, ii){
-				FieldInterval& in = *ii;
-				
-				if(yc != in.y - 1){
-					int y1 = clamp(yc + 1, 0, sizeY() - 1);
-					int y2 = clamp(yc + delta, 0, sizeY() - 1);
-					for(int y = y1; y <= y2; y++)
-						memset(&(*this)(xl, y), value, xr - xl + 1);
-					beginUp = true;
-				}
-				
-				xl = clamp(in.xl - delta, 0, sizeX() - 1);
-				xr = clamp(in.xr + delta, 0, sizeX() - 1);
-				yc = clamp(in.y, 0, sizeY() - 1);
-				memset(&(*this)(xl, yc), value, xr - xl + 1);
-	
-				if(beginUp){
-					int y1 = clamp(yc - delta, 0, sizeY() - 1);
-					int y2 = clamp(yc - 1, 0, sizeY() - 1);
-					for(int y = y1; y <= y2; y++)
-						memset(&(*this)(xl, y), value, xr - xl + 1);
-					beginUp = false;
-				}
+	start_timer_auto(DefenceMap_updateField, STATISTICS_GROUP_AI);
+
+	int sx = sizeX(), sy = sizeY();
+	BYTE* field = &fieldNew_[0];
+	memset(field, 0, sx*sy);
+
+	xassert(FieldDispatcher::scale == tileSizeShl);
+
+	int delta = w2m(defenceMapPathFind.fieldExtraRadius);
+
+	FieldDispatcher::ClusterList::iterator ci;
+	FOR_EACH(field_dispatcher->clusters, ci){
+		FieldCluster& cluster = *ci;
+		if(cluster.empty())
+			continue;
+		terPlayer* player = universe()->findPlayer(cluster.get_player_id());
+		if(player->isWorld() || player->clan() == clan_)
+			continue;
+
+		int yc = cluster.front().y - 1;
+		int xl, xr;
+		bool beginUp = true;
+		vector<FieldInterval>::iterator ii;
+		FOR_EACH(cluster, ii){
+			FieldInterval& in = *ii;
+			
+			if(yc != in.y - 1){
+				int y1 = clamp(yc + 1, 0, sy - 1);
+				int y2 = clamp(yc + delta, 0, sy - 1);
+				for(int y = y1; y <= y2; y++)
+					memset(field + y*sx + xl, 1, xr - xl + 1);
+				beginUp = true;
+			}
+			
+			xl = clamp(in.xl - delta, 0, sx - 1);
+			xr = clamp(in.xr + delta, 0, sx - 1);
+			yc = clamp(in.y, 0, sy - 1);
+			memset(field + yc*sx + xl, 1, xr - xl + 1);
+
+			if(beginUp){
+				int y1 = clamp(yc - delta, 0, sy - 1);
+				int y2 = clamp(yc - 1, 0, sy - 1);
+				for(int y = y1; y <= y2; y++)
+					memset(field + y*sx + xl, 1, xr - xl + 1);
+				beginUp = false;
 			}
 		}
 	}
+
+	//        
+	int xmin = sx, xmax = -1, ymin = sy, ymax = -1;
+	for(int y = 0; y < sy; y++){
+		const BYTE* oldRow = &field_[y*sx];
+		const BYTE* newRow = field + y*sx;
+		if(!memcmp(oldRow, newRow, sx))
+			continue;
+		int x0 = 0, x1 = sx - 1;
+		while(oldRow[x0] == newRow[x0])
+			x0++;
+		while(oldRow[x1] == newRow[x1])
+			x1--;
+		xmin = min(xmin, x0);
+		xmax = max(xmax, x1);
+		ymin = min(ymin, y);
+		ymax = y;
+	}
+
+	field_.swap(fieldNew_);
+	if(xmin <= xmax)
+		changed_.push_back(sRect(xmin, ymin, xmax - xmin, ymax - ymin));
+
+	fieldRevision_ = field_dispatcher->clustersRevision();
 }
 
 void DefenceMap::showDebugInfo()
@@ -1,36 +1,88 @@
 #ifndef __DEFENCE_MAP_H__
 #define __DEFENCE_MAP_H__
 
+#include "terra.h"
 #include "map2d.h"
 #include "GenericControls.h"
 
 class ClusterFind;
 
+/*
+     AI,    (terUniverse::defenceMap).
+
+:  ( ai_tile_map),      
+  .    :  - 
+AITileMap::chaosChanges()      ,  -  FieldDispatcher::clustersRevision(),
+ -  terUniverse::unitCountStamp()   (,
+, ).    
+ClusterFind::UpdateRect,       .
+*/
 class DefenceMap : public Map2D<BYTE, 4>
 {
 public:
-	DefenceMap(int hsize, int vsize);
+	DefenceMap(int hsize, int vsize, int clan);
 	~DefenceMap();
 
-	void analizeChaos();
-	void analizeField(int playerID);
-	void addGun(const Vect2f& position, float radius); 
+	int clan() const { return clan_; }
+
+	//     ;   ,   
+	void update();
 
 	int calcDefenceFactor(const Vect2f& position, float radius); 
 
 	bool findPathToPoint(const Vect2i& from_w, const Vect2i& to_w, vector<Vect2i>& out_path);
 	terUnitBase* findPathToTarget(const Vect2i& from_w, const UnitList& targets, vector<Vect2i>& out_path);
 
-	void startRecalcMap();
-	bool recalcMapQuant(); // return recalcStarted_
-
 	void showDebugInfo();
 
 protected:
 	ClusterFind* path_finder;
-	ClusterFind* path_finder2;
 
 	void rebuildWalkMap(BYTE* walk_map);
+
+private:
+	enum { 
+		BLOCK_VALUE = 64, //   
+		REBUILD_RECTS = 32 //     -  
+	};
+
+	struct Gun
+	{
+		unsigned int playerID;
+		unsigned int unitID;
+		Vect2i position; // map coords
+		int radius; // map coords
+
+		bool operator<(const Gun& gun) const { return playerID != gun.playerID ? playerID < gun.playerID : unitID < gun.unitID; }
+		bool samePlace(const Gun& gun) const { return position == gun.position && radius == gun.radius; }
+	};
+	typedef vector<Gun> GunList;
+
+	int clan_;
+
+	vector<BYTE> chaos_;
+	vector<BYTE> chaosBuffer_;
+	vector<BYTE> field_;
+	vector<BYTE> fieldNew_;
+	vector<unsigned short> gunCount_;
+	GunList guns_; //   ID
+
+	int chaosRevision_;
+	int fieldRevision_;
+	int gunStamp_;
+
+	vector<sRect> changed_;
+	bool rebuild_;
+	int clustersBuilt_;
+
+	void updateChaos();
+	void calcChaos(int x0, int y0, int x1, int y1);
+	void updateField();
+	void updateGuns();
+	void addGun(const Gun& gun, int delta);
+	void recalcPathFind();
+
+	BYTE cellValue(int index) const;
 };
 
 
@@ -26,6 +26,8 @@ terUnitBase::terUnitBase(const UnitTemplate& data)
 	setPose(Se3f::ID, false);
 
 	RealCollisionCount = 0;
+	RealCollisionOrderCount = 0;
+	RealCollisionOrder = 0;
 	MapUpdatedCount = 0;
 
 	collisionGroup_ = attr().CollisionGroup;
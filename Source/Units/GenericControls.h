@@ -44,7 +44,7 @@ public:
 
 	//----------------------------------------------------
 	int collisionGroup() const { return collisionGroup_; }
-	void setCollisionGroup(int group) { collisionGroup_ = group; }
+	virtual void setCollisionGroup(int group) { collisionGroup_ = group; }
 	int excludeCollision() const { return attr().ExcludeCollision; }
 
 	int GetMapUpdatedCount() const { return MapUpdatedCount; }
@@ -216,6 +216,9 @@ public:
 	//-----------------------------------------------------
 	int GetRealCollisionCount() const { return RealCollisionCount; }
 	void SetRealCollisionCount(int count){ RealCollisionCount = count; }
+	//    terUniverse::CollisionQuant,   count == terRealCollisionCount
+	bool realCollisionBefore(int count, int order) const { return RealCollisionOrderCount == count && RealCollisionOrder < order; }
+	void SetRealCollisionOrder(int count, int order){ RealCollisionOrderCount = count; RealCollisionOrder = order; }
 	
 	//-----------------------------------------
 
@@ -259,6 +262,8 @@ private:
 	Se3f pose_;
 
 	int RealCollisionCount;
+	int RealCollisionOrderCount;
+	int RealCollisionOrder;
 	int MapUpdatedCount;
 
 	terInterpolationBase* avatar_;
@@ -64,9 +64,16 @@ void terUnitGeneric::setPose(const Se3f& pose, bool initPose)
 	terUnitBase::setPose(pose, initPose);
 
 	if(inserted())
-		universe()->UnitGrid.Move(*this, round(position().x), round(position().y), round(radius()));
+		universe()->UnitGrid.Move(*this, round(position().x), round(position().y), round(radius()), collisionGroup());
 	else
-		universe()->UnitGrid.Insert(*this, round(position().x), round(position().y), round(radius()));
+		universe()->UnitGrid.Insert(*this, round(position().x), round(position().y), round(radius()), collisionGroup());
+}
+
+void terUnitGeneric::setCollisionGroup(int group)
+{
+	terUnitBase::setCollisionGroup(group);
+	if(inserted())
+		universe()->UnitGrid.SetMask(*this, group);
 }
 
 void terUnitGeneric::Quant()
@@ -13,6 +13,8 @@ public:
 	void Kill();
 
 	void setPose(const Se3f& pose, bool initPose);
+	//  UnitGrid - collisionGroup
+	void setCollisionGroup(int group);
 
 	void Start();
 	void Quant();
@@ -178,7 +178,7 @@ class SpriteInterpolationOp
 public:
 	void operator()(cIUnkObj* cur,Vect3f p[2])
 	{
-		stream_interpolator.set(fSpriteInterpolation,cur)<<p;
+		stream_interpolator.AddSprite(cur,p);
 	}
 };
 
@@ -189,7 +189,7 @@ public:
 	{
 //		xassert(cur->GetAttr(ATTRUNKOBJ_DELETED)==0);
 //		cur->SetAttr(ATTRUNKOBJ_TEMP_USED);
-		stream_interpolator.set(fSe3fInterpolation,cur)<<p;
+		stream_interpolator.AddPose(cur,p);
 	}
 };
 class PhaseInterpolationOp
@@ -215,7 +215,7 @@ class FloatInterpolationOp
 public:
 	void operator()(cIUnkObj* cur,float p[2])
 	{
-		stream_interpolator.set(fFloatInterpolation,cur)<<p;
+		//   -   
 	}
 };
 
@@ -224,7 +224,7 @@ class ColorInterpolationOp
 public:
 	void operator()(cIUnkObj* cur,sColorInterpolate p[2])
 	{
-		stream_interpolator.set(fColorInterpolation,cur)<<p;
+		stream_interpolator.AddColor(cur,p);
 	}
 };
 
@@ -233,7 +233,7 @@ class ColorDiffuseInterpolationOp
 public:
 	void operator()(cIUnkObj* cur,sColor4f p[2])
 	{
-		stream_interpolator.set(fColorDiffuseInterpolation,cur)<<p;
+		stream_interpolator.AddColorDiffuse(cur,p);
 	}
 };
 
@@ -242,7 +242,7 @@ class ParticleRateInterpolationOp
 public:
 	void operator()(cIUnkObj* cur,float p[2])
 	{
-		stream_interpolator.set(fParticleRateInterpolation,cur)<<p;
+		stream_interpolator.AddParticleRate(cur,p);
 	}
 };
 
@@ -265,7 +265,7 @@ public:
 	{ 
 		if(update_)
 		{
-			stream_interpolator.set(fAngleInterpolation,cur)<<x_<<(int)axis;
+			stream_interpolator.AddAngle(cur,x_,axis);
 		}
 		update_=false;
 	}
@@ -283,7 +283,7 @@ public:
 	{ 
 		if(update_)
 		{
-			stream_interpolator.set(fPhaseInterpolation,cur)<<x_<<recursive;
+			stream_interpolator.AddPhase(cur,x_,recursive);
 		}
 		update_=false;
 	}
@@ -324,7 +324,7 @@ public:
 	void operator()(cIUnkObj* cur)
 	{ 
 		if(update_)
-			stream_interpolator.set(fLineInterpolation,cur)<<x0_<<x1_;
+			stream_interpolator.AddLine(cur,x0_,x1_);
 
 		update_=false;
 	}
@@ -43,7 +43,7 @@ terBuilding::terBuilding(const UnitTemplate& data)
 	connection_icon_(terModelBuildingNoConnection),
 	energy_icon_(terModelBuildingLowEnergy)
 {
-	setBuildingStatus(BUILDING_STATUS_PLUGGED_IN);
+	buildingStatus_ = BUILDING_STATUS_PLUGGED_IN;
 	cancelConstructionTime_ = cancelConstructionTime;
 	visible_ = true;
 }
@@ -642,6 +642,14 @@ bool terBuilding::canUpgrade() const
 		return false; 
 }
 
+void terBuilding::setBuildingStatus(int st)
+{
+	//countBuildingsConstructed  -  
+	if((buildingStatus_ ^ st) & BUILDING_STATUS_CONSTRUCTED)
+		universe()->changeUnitCount(attr().ID);
+	buildingStatus_ = st;
+}
+
 void terBuilding::ChangeUnitOwner(terPlayer* player)
 {
 	terUnitReal::ChangeUnitOwner(player);
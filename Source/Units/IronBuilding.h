@@ -104,7 +104,7 @@ public:
 	void MapUpdateHit(float x0,float y0,float x1,float y1);
 
 	int buildingStatus() const { return buildingStatus_; }
-	void setBuildingStatus(int st){ buildingStatus_ = st; }
+	void setBuildingStatus(int st);
 	
 	int isBuildingPowerOn(){ return buildingStatus() & BUILDING_STATUS_POWERED; }
 	int isSingleSelection(){ return 0; }
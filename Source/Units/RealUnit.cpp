@@ -235,9 +235,9 @@ class terScanInstallLineOp
 public:
 	void operator()(int x1,int x2,int y)
 	{
-		unsigned short* buf = vMap.GABuf + vMap.offsetGBufC(0, y);
+		int offG = vMap.offsetGBufC(0, y);
 		while(x1 <= x2)
-			*(buf + vMap.XCYCLG(x1++)) |= GRIDAT_BUILDING;
+			vMap.setGridAttribute(offG + vMap.XCYCLG(x1++), GRIDAT_BUILDING);
 	}
 };
 
@@ -262,9 +262,9 @@ class terScanUninstallLineOp
 public:
 	void operator()(int x1,int x2,int y)
 	{
-		unsigned short* buf = vMap.GABuf + vMap.offsetGBufC(0,y);
+		int offG = vMap.offsetGBufC(0,y);
 		while(x1 <= x2)
-			*(buf + vMap.XCYCLG(x1++)) &= ~GRIDAT_BUILDING;
+			vMap.clearGridAttribute(offG + vMap.XCYCLG(x1++), GRIDAT_BUILDING);
 	}
 };
 
@@ -1868,7 +1868,7 @@ private:
 terUnitBase* terUnitSquad::findBestTarget(const Vect2f& pos, float radius)
 {
 	SquadSearchTargetScanOp op(pos, radius, *this);
-	universe()->UnitGrid.Scan(pos.x, pos.y, radius, op);
+	universe()->UnitGrid.ScanCircle(pos, radius, -1, op);
 	return op.result();
 }
 
@@ -1924,7 +1924,7 @@ void terUnitSquad::attackQuant()
 				float fire_radius = offensiveMode() && !patrolMode() ? currentAttribute()->sightRadius() : currentAttribute()->fireRadius();
 				fire_radius += radius();
 				SquadSearchTargetsScanOp op(position2D(), fire_radius, *this);
-				universe()->UnitGrid.Scan(position().x, position().y, fire_radius, op);
+				universe()->UnitGrid.ScanCircle(position2D(), fire_radius, -1, op);
 				op.sortTargets();
 
 				if(!targets_clean_timer()){
@@ -2241,7 +2241,7 @@ void terUnitSquad::techniciansQuant()
 	float fire_radius = offensiveMode() && !patrolMode() ? currentAttribute()->sightRadius() : currentAttribute()->fireRadius();
 	fire_radius += radius();
 	SquadTechnicianSearchTargetsScanOp op(position2D(), fire_radius, *this);
-	universe()->UnitGrid.Scan(position().x, position().y, fire_radius, op);
+	universe()->UnitGrid.ScanCircle(position2D(), fire_radius, -1, op);
 	op.sortTargets();
 
 	if(op.targets().empty()) return;
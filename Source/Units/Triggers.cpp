@@ -175,6 +175,12 @@ bool ConditionObjectExists::check(AIPlayer& aiPlayer)
 	return false;
 }
 
+bool ConditionObjectExists::subscribe(ConditionSubscription& subscription) const
+{
+	subscription.addUnitCounter(object);
+	return true;
+}
+
 void ConditionCreateObject::checkEvent(AIPlayer& aiPlayer, const Event& event) 
 {
 	if(event.type() == Event::CREATE_OBJECT){
@@ -189,6 +195,13 @@ void ConditionCreateObject::checkEvent(AIPlayer& aiPlayer, const Event& event)
 	}
 }
 
+bool ConditionCreateObject::subscribe(ConditionSubscription& subscription) const
+{
+	subscription.addEvent(Event::CREATE_OBJECT);
+	subscription.addEvent(Event::DESTROY_OBJECT);
+	return true;
+}
+
 void ConditionKillObject::checkEvent(AIPlayer& aiPlayer, const Event& event) 
 {
 	if(event.type() == Event::ATTACK_OBJECT){
@@ -201,6 +214,12 @@ void ConditionKillObject::checkEvent(AIPlayer& aiPlayer, const Event& event)
 	}
 }
 
+bool ConditionKillObject::subscribe(ConditionSubscription& subscription) const
+{
+	subscription.addEvent(Event::ATTACK_OBJECT);
+	return true;
+}
+
 void ConditionCaptureBuilding::checkEvent(AIPlayer& aiPlayer, const Event& event) 
 {
 	if(event.type() == Event::CAPTURE_BUILDING){
@@ -246,6 +265,12 @@ void ConditionClickOnButton::checkEvent(AIPlayer& aiPlayer, const Event& event)
 			counter_++;
 }
 
+bool ConditionClickOnButton::subscribe(ConditionSubscription& subscription) const
+{
+	subscription.addEvent(Event::CLICK_ON_BUTTON);
+	return true;
+}
+
 bool ConditionToolzerSelectedNearObjectByLabel::check(AIPlayer& aiPlayer) 
 { 
 	terUnitBase* unit = universe()->findUnitByLabel(label);
@@ -365,6 +390,15 @@ bool ConditionNumberOfBuildingByCoresCapacity::check(AIPlayer& aiPlayer)
 	return compare(round(player->countUnits(building)*factor), player->countUnits(building2), compareOp);
 }
 
+bool ConditionNumberOfBuildingByCoresCapacity::subscribe(ConditionSubscription& subscription) const
+{
+	if(playerType == AI_PLAYER_TYPE_ENEMY) // enemyPlayer()   
+		return false;
+	subscription.addUnitCounter(building);
+	subscription.addUnitCounter(building2);
+	return true;
+}
+
 void ConditionUnitClassUnderAttack::checkEvent(AIPlayer& aiPlayer, const Event& event)
 {
 	if(event.type() == Event::ATTACK_OBJECT){
@@ -503,6 +537,12 @@ void ConditionPlayerState::checkEvent(AIPlayer& aiPlayer, const Event& event)
 	}
 }
 
+bool ConditionPlayerState::subscribe(ConditionSubscription& subscription) const
+{
+	subscription.addEvent(Event::PLAYER_STATE);
+	return true;
+}
+
 bool ConditionIsFieldOn::check(AIPlayer& aiPlayer)
 {
 	return aiPlayer.isFieldOn();
@@ -1478,6 +1518,9 @@ void Trigger::quant(AIPlayer& aiPlayer, TriggerChain& triggerChain)
 	if((action && action->onlyIfAI() && !aiPlayer.isAI()) || (gameShell->triggersDisabled() && aiPlayer.active()) || gameShell->missionEditor())
 		return;
 
+	if(state_ != CHECKING)
+		conditionChecked_ = false;
+
 	switch(state_){
 	case SLEEPING:
 	case DONE:{
@@ -1500,7 +1543,7 @@ void Trigger::quant(AIPlayer& aiPlayer, TriggerChain& triggerChain)
 		}
 
 	case CHECKING:
-		if((!condition || condition->checkDebug(aiPlayer)) && (!action || action->automaticCondition(aiPlayer))){
+		if((!condition || checkCondition(aiPlayer)) && (!action || action->automaticCondition(aiPlayer))){
 			activate(aiPlayer, triggerChain);
 			triggerChain.addLogRecord(*this, (string(": ") + name()).c_str());
 		}
@@ -1523,8 +1566,32 @@ void Trigger::quant(AIPlayer& aiPlayer, TriggerChain& triggerChain)
 
 void Trigger::checkEvent(AIPlayer& aiPlayer, const Event& event)
 {
-	if(state_ == CHECKING && condition)
+	if(state_ == CHECKING && condition){
 		condition->checkEvent(aiPlayer, event);
+		if(subscription_.events & (1 << event.type()))
+			conditionChecked_ = false;
+	}
+}
+
+bool Trigger::checkCondition(AIPlayer& aiPlayer)
+{
+	if(conditionChecked_ && subscribed_){
+		vector<int>::const_iterator ci;
+		FOR_EACH(subscription_.unitCounters, ci)
+			if(universe()->unitCountStamp(terUnitAttributeID(*ci)) > conditionStamp_){
+				conditionChecked_ = false;
+				break;
+			}
+		if(conditionChecked_)
+			return conditionState_;
+	}
+
+	subscription_.clear();
+	subscribed_ = condition->subscribe(subscription_);
+	conditionStamp_ = universe()->unitCountStamp();
+	conditionState_ = condition->checkDebug(aiPlayer);
+	conditionChecked_ = true;
+	return conditionState_;
 }
 
 void Trigger::activate(AIPlayer& aiPlayer, TriggerChain& triggerChain)
@@ -1551,6 +1618,7 @@ void Trigger::activate(AIPlayer& aiPlayer, TriggerChain& triggerChain)
 	if(action)
 		action->activate(aiPlayer);
 	state_ = WORKING;
+	conditionChecked_ = false;
 	executionCounter_++;
 }
 
@@ -1589,6 +1657,7 @@ void TriggerChain::initializeTriggersAndLinks()
 	TriggerList::iterator ti;
 	FOR_EACH(triggers, ti){
 		ti->state_ = Trigger::SLEEPING;
+		ti->conditionChecked_ = false;
 		ti->executionCounter_ = 0;
 		vector<TriggerLink>::iterator li;
 		FOR_EACH(ti->outcomingLinks_, li)
@@ -1601,6 +1670,7 @@ void TriggerChain::initializeCameraTrigger(int playerIndex)
 {
 	Trigger* trigger = find("Camera");
 	trigger->state_ = Trigger::CHECKING;
+	trigger->conditionChecked_ = false;
 	if(!trigger->action)
 		trigger->action = new ActionSetCamera;
 	XBuffer buf;
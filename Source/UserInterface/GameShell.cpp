@@ -40,6 +40,7 @@
 
 #include "EditArchive.h"
 #include "XPrmArchive.h"
+#include "BinaryArchive.h"
 #include "SoundScript.h"
 
 int terShowFPS = 0;
@@ -123,6 +124,67 @@ CommandLineData::CommandLineData(bool host, string name, bool p2p, string ip, GU
 
 string GameShell::locale;
 
+//     :    spg  spb,
+//         ,   spg
+static void convertSavesToBinary(const char* dir)
+{
+	string path = dir;
+	if(!path.empty() && path[path.size() - 1] != '\\')
+		path += "\\";
+
+	int files = 0;
+	int failed = 0;
+	int mismatched = 0;
+	double textTime = 0;
+	double binaryTime = 0;
+
+	WIN32_FIND_DATA findData;
+	HANDLE hf = FindFirstFile((path + "*.spg").c_str(), &findData);
+	if(hf != INVALID_HANDLE_VALUE){
+		do {
+			string name = path + findData.cFileName;
+			MissionDescription mission(name.c_str());
+			SavePrm textPrm;
+			double time = clockf();
+			if(!mission.loadMission(textPrm)){
+				failed++;
+				continue;
+			}
+			textTime += clockf() - time;
+
+			mission.setSaveName(setExtention(name.c_str(), "spb").c_str());
+			SavePrm binaryPrm;
+			if(!mission.writeMission(textPrm)){
+				failed++;
+				continue;
+			}
+			time = clockf();
+			if(!mission.loadMission(binaryPrm)){
+				failed++;
+				continue;
+			}
+			binaryTime += clockf() - time;
+
+			BinaryOArchive textArchive;
+			textArchive << WRAP_NAME(textPrm, "SavePrm");
+			BinaryOArchive binaryArchive;
+			binaryArchive << WRAP_NAME(binaryPrm, "SavePrm");
+			const XBuffer& textBuffer = textArchive.buffer();
+			const XBuffer& binaryBuffer = binaryArchive.buffer();
+			if(textBuffer.tell() != binaryBuffer.tell() || memcmp(textBuffer, binaryBuffer, textBuffer.tell()))
+				mismatched++;
+			files++;
+		} while(FindNextFile(hf, &findData));
+		FindClose(hf);
+	}
+
+	statistics_add(convertSaves_files, STATISTICS_GROUP_NUMERIC, files);
+	statistics_add(convertSaves_failed, STATISTICS_GROUP_NUMERIC, failed);
+	statistics_add(convertSaves_mismatched, STATISTICS_GROUP_NUMERIC, mismatched);
+	statistics_add(convertSaves_textLoad, STATISTICS_GROUP_TOTAL, textTime);
+	statistics_add(convertSaves_binaryLoad, STATISTICS_GROUP_TOTAL, binaryTime);
+}
+
 //------------------------
 GameShell::GameShell(bool mission_edit) :
 chaos(0),
@@ -162,9 +224,18 @@ windowClientSize_(1024, 768)
 	debug_allow_replay = true; //IniManager("Perimeter.ini", false).getInt("Game","EnableReplay");
 
 	check_command_line_parameter("mainmenu", MainMenuEnable);
-	if(mission_edit)
+	if(mission_edit || terHeadless)
 		MainMenuEnable = false;
 
+	int binarySaves = IniManager("Perimeter.ini", false).getInt("Game","BinarySaves");
+	check_command_line_parameter("binary_saves", binarySaves);
+	MissionDescription::binarySaves = binarySaves != 0;
+
+	//     : convert_saves:<>
+	const char* convertSavesDir = check_command_line("convert_saves:");
+	if(convertSavesDir)
+		convertSavesToBinary(convertSavesDir);
+
 	currentSingleProfile.scanProfiles();
 	currentSingleProfile.setCurrentProfile(getStringFromReg(mainCurrUserRegFolder, "ProfileName"));
 	if (!MainMenuEnable && currentSingleProfile.getCurrentProfileIndex() == -1) {
@@ -386,6 +457,9 @@ void GameShell::createNetClient(PNetCenter::e_PNCWorkMode _workMode, const char*
 {
 	#ifndef _SINGLE_DEMO_
 		stopNetClient();
+		//-net_loopback:     NetLoopbackHub 
+		if(_workMode == PNetCenter::PNCWM_LAN && check_command_line("net_loopback"))
+			_workMode = PNetCenter::PNCWM_LOOPBACK;
 		NetClient = new PNetCenter(_workMode, playerName, InternetAddress, password);
 	#endif
 }
@@ -397,6 +471,39 @@ void GameShell::stopNetClient() {
 	}
 }
 
+//    ,   ,
+//  ,   
+static void prefetchMissionResources(const MissionDescription& mission)
+{
+	AttributeLibrary::Map::iterator i;
+	FOR_EACH(attributeLibrary().map(), i){
+		const AttributeBase* attribute = i->second;
+		for(int player = 0; player < NETWORK_PLAYERS_MAX; player++){
+			const PlayerData& data = mission.playersData[player];
+			if(data.realPlayerType == REAL_PLAYER_TYPE_CLOSE || data.realPlayerType == REAL_PLAYER_TYPE_OPEN)
+				continue;
+			if(attribute->enabledByBelligerent(data.belligerent)){
+				terVisGeneric->PrefetchModel(attribute->modelData.modelName);
+				terVisGeneric->PrefetchEffects(attribute->EffectLib);
+				break;
+			}
+		}
+	}
+}
+
+static void reportResourceStat()
+{
+	const sResourceStat& stat = terVisGeneric->GetResourceStat();
+	statistics_add(textureRequests, STATISTICS_GROUP_NUMERIC, stat.texture_requests);
+	statistics_add(textureLoads, STATISTICS_GROUP_NUMERIC, stat.texture_loads);
+	statistics_add(textureLoadTime, STATISTICS_GROUP_NUMERIC, stat.texture_load_time);
+	statistics_add(modelRequests, STATISTICS_GROUP_NUMERIC, stat.model_requests);
+	statistics_add(modelLoads, STATISTICS_GROUP_NUMERIC, stat.model_loads);
+	statistics_add(modelLoadTime, STATISTICS_GROUP_NUMERIC, stat.model_load_time);
+	statistics_add(prefetchHits, STATISTICS_GROUP_NUMERIC, stat.prefetch_hits);
+	terVisGeneric->ClearResourceStat();
+}
+
 void GameShell::GameStart(const MissionDescription& mission)
 {
 	_WaitCursor();
@@ -446,6 +553,8 @@ void GameShell::GameStart(const MissionDescription& mission)
 
 	LoadProgressBlock(0.6f);
 	CurrentMission.packPlayerIDs();
+	terVisGeneric->ClearResourceStat();
+	prefetchMissionResources(CurrentMission);
 	new terUniverse(NetClient, CurrentMission, savePrm(), LoadProgressUpdate);
 
 	IniManager world_ini(GetTargetName(vMap.worldIniFile));
@@ -521,6 +630,8 @@ void GameShell::GameClose()
 {
 	getLogicUpdater().reset();
 	stream_interpolator.ClearData();
+	terVisGeneric->ClearPrefetch();
+	reportResourceStat();
 	m_ShellDispatcher.close();
 	//_shellIconManager.Done();
 
@@ -559,7 +670,7 @@ void GameShell::GameClose()
 	debugPrm_.save();
 }
 
-bool GameShell::universalSave(const char* name, bool userSave)
+bool GameShell::universalSave(const char* name, bool userSave, bool background)
 {
 	MTAuto lock(HTManager::instance()->GetLockLogic());
 	MTAutoSkipAssert skip_assert;
@@ -572,7 +683,7 @@ bool GameShell::universalSave(const char* name, bool userSave)
 		mission.gameSpeed = game_speed ? game_speed : game_speed_to_resume;
 		mission.gamePaused = !gamePausedByMenu && !game_speed;
 	}
-	return universe()->universalSave(mission, userSave);
+	return universe()->universalSave(mission, userSave, background);
 }
 
 void GameShell::NetQuant()
@@ -1129,7 +1240,7 @@ bool GameShell::DebugKeyPressed(sKey& Key)
 			if(pos != string::npos)
 				name.erase(0, pos + 1);
 			name = string("Resource\\Saves\\") + name;
-			universalSave(name.c_str(), true);
+			universalSave(name.c_str(), true, true);
 		}
 		break;
 
@@ -1139,7 +1250,7 @@ bool GameShell::DebugKeyPressed(sKey& Key)
 			size_t pos = saveName.rfind("RESOURCE\\");
 			if(pos != string::npos)
 				saveName.erase(0, pos);
-			universalSave(saveName.c_str(), false);
+			universalSave(saveName.c_str(), false, true);
 			defaultSaveName_ = saveName;
 		}
 		break;
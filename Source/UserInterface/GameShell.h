@@ -53,7 +53,8 @@ public:
 
 	void LANGameStart(const MissionDescription& mission);
 
-	bool universalSave(const char* name, bool userSave);
+	//background -     ,    
+	bool universalSave(const char* name, bool userSave, bool background = false);
 	SavePrm& savePrm() { return savePrm_; }
 	const SaveManualData& manualData() { return savePrm_.manualData; }
 	
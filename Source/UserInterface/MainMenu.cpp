@@ -6,6 +6,7 @@
 #include "Terra.h"
 #include "GenericControls.h"
 #include "Universe.h"
+#include "SaveWriter.h"
 #include "UniverseInterface.h"
 #include "GameShell.h"
 #include "PerimeterShellUI.h"
@@ -2358,13 +2359,20 @@ int toSaveQuant( float, float ) {
 	return 1;
 }
 
-STARFORCE_API int saveGame_(float i, float) {
-	gameShell->currentSingleProfile.deleteSave(savedGames[i].missionName());
-	string saveName = gameShell->currentSingleProfile.getSavesDirectory() + savedGames[i].missionName();
-	if ( gameShell->universalSave(saveName.c_str(), true) ) {
-		hideMessageBox();
-		_shellIconManager.AddDynamicHandler( toSaveQuant, CBCODE_QUANT );
-//		_shellIconManager.SwitchMenuScreens( SQSH_MM_SAVE_GAME_SCR, SQSH_MM_INMISSION_SCR );
+//    (GameSaveWriter),   ,   
+static bool saveFromMessageBox;
+
+int waitSaveQuant( float, float ) {
+	if (GameSaveWriter::instance().busy()) {
+		return 1;
+	}
+	if ( GameSaveWriter::instance().wait() ) {
+		if (saveFromMessageBox) {
+			hideMessageBox();
+			_shellIconManager.AddDynamicHandler( toSaveQuant, CBCODE_QUANT );
+		} else {
+			_shellIconManager.SwitchMenuScreens( SQSH_MM_SAVE_GAME_SCR, SQSH_MM_INMISSION_SCR );
+		}
 	} else {
 		setupOkMessageBox(
 			0,
@@ -2372,8 +2380,25 @@ STARFORCE_API int saveGame_(float i, float) {
 			qdTextDB::instance().getText("Interface.Menu.Messages.DiskFull"),
 			MBOX_BACK );
 
-		showMessageBoxButtons();
+		if (saveFromMessageBox) {
+			showMessageBoxButtons();
+		} else {
+			showMessageBox();
+		}
 	}
+	return 0;
+}
+
+static void startSaveGame(const string& saveName, bool fromMessageBox) {
+	saveFromMessageBox = fromMessageBox;
+	gameShell->universalSave(saveName.c_str(), true, true);
+	_shellIconManager.AddDynamicHandler( waitSaveQuant, CBCODE_QUANT );
+}
+
+STARFORCE_API int saveGame_(float i, float) {
+	gameShell->currentSingleProfile.deleteSave(savedGames[i].missionName());
+	string saveName = gameShell->currentSingleProfile.getSavesDirectory() + savedGames[i].missionName();
+	startSaveGame(saveName, true);
 	
 	return 1;
 }
@@ -2412,7 +2437,7 @@ void onMMSaveGameMapList(CShellWindow* pWnd, InterfaceEventCode code, int param)
 	}
 }
 void onMMSaveGameGoButton(CShellWindow* pWnd, InterfaceEventCode code, int param) {
-	if( code == EVENT_UNPRESSED && intfCanHandleInput() ) {
+	if( code == EVENT_UNPRESSED && intfCanHandleInput() && !GameSaveWriter::instance().busy() ) {
 		CListBoxWindow* list = (CListBoxWindow*)_shellIconManager.GetWnd(SQSH_MM_SAVE_GAME_MAP_LIST);
 		CEditWindow* input = (CEditWindow*)_shellIconManager.GetWnd(SQSH_MM_SAVE_NAME_INPUT);
 		int i;
@@ -2432,17 +2457,7 @@ void onMMSaveGameGoButton(CShellWindow* pWnd, InterfaceEventCode code, int param
 			showMessageBox();
 		} else {
 			string path = gameShell->currentSingleProfile.getSavesDirectory() + input->getText();
-			if ( gameShell->universalSave(path.c_str(), true) ) {
-				_shellIconManager.SwitchMenuScreens( pWnd->m_pParent->ID, SQSH_MM_INMISSION_SCR );
-			} else {
-				setupOkMessageBox(
-					0,
-					0,
-					qdTextDB::instance().getText("Interface.Menu.Messages.DiskFull"),
-					MBOX_BACK );
-
-				showMessageBox();
-			}
+			startSaveGame(path, false);
 		}
 	}		
 }
@@ -17,7 +17,7 @@ BinaryOArchive::~BinaryOArchive()
 
 void BinaryOArchive::open(const char* fname, int version)
 {
-	fileName_ = fname;
+	fileName_ = fname ? fname : "";
 	buffer_.init();
 	buffer_.alloc(10000);
 	buffer_ < "BinX" < version;
@@ -25,6 +25,8 @@ void BinaryOArchive::open(const char* fname, int version)
 
 bool BinaryOArchive::close()
 {
+	if(fileName_.empty())
+		return true;
 	XStream ff(0);
 	if(ff.open(fileName_.c_str(), XS_IN)){
 		if(ff.size() == buffer_.tell()){
@@ -44,6 +46,8 @@ bool BinaryOArchive::close()
 BinaryIArchive::BinaryIArchive(const char* fname) :
 buffer_(10, 1)
 {
+	file_ = INVALID_HANDLE_VALUE;
+	mapping_ = 0;
 	if(fname && !open(fname))
 		ErrH.Abort("File not found: ", XERR_USER, 0, fname);
 }
@@ -55,13 +59,55 @@ BinaryIArchive::~BinaryIArchive()
 
 bool BinaryIArchive::open(const char* fname)
 {
+	close();
 	fileName_ = fname;
+
+	//       :   
+	//  ,      
+	file_ = CreateFile(fname, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+	if(file_ == INVALID_HANDLE_VALUE)
+		return false;
+	unsigned int size = GetFileSize(file_, 0);
+	if(size && size != 0xffffffff)
+		mapping_ = CreateFileMapping(file_, 0, PAGE_READONLY, 0, 0, 0);
+	char* view = mapping_ ? (char*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : 0;
+	if(view){
+		buffer_.free();
+		buffer_.buf = view;
+		buffer_.size = size;
+		buffer_.offset = 0;
+		buffer_.MakeFree = 0;
+		return openHeader();
+	}
+
+	close();
 	XStream ff(0);
 	if(!ff.open(fname, XS_IN))
 		return false;
+	buffer_.free();
 	buffer_.alloc(ff.size() + 1);
 	ff.read(buffer_.address(), ff.size());
 	buffer_[(int)ff.size()] = 0;
+	return openHeader();
+}
+
+bool BinaryIArchive::open(const char* data, int size)
+{
+	close();
+	fileName_ = "";
+	buffer_.free();
+	buffer_.alloc(size + 1);
+	memcpy(buffer_.address(), data, size);
+	buffer_[size] = 0;
+	return openHeader();
+}
+
+bool BinaryIArchive::openHeader()
+{
+	if(buffer_.length() < 4 + sizeof(version_)){
+		close();
+		return false;
+	}
 	if(buffer_[0] != 'B' || buffer_[1] != 'i' || buffer_[2] != 'n' || buffer_[3] != 'X'){
 		close();
 		return false;
@@ -72,18 +118,39 @@ bool BinaryIArchive::open(const char* fname)
 
 void BinaryIArchive::close()
 {
+	if(mapping_){
+		UnmapViewOfFile(buffer_.buf);
+		CloseHandle(mapping_);
+		mapping_ = 0;
+	}
+	else
+		buffer_.free();
+	if(file_ != INVALID_HANDLE_VALUE){
+		CloseHandle(file_);
+		file_ = INVALID_HANDLE_VALUE;
+	}
 	buffer_.alloc(10);
 }
 
 bool BinaryIArchive::loadString(string& str)
 {
-	char c;
-	buffer_ > c;
+	//    ,    :
+	//      
+	char c = 0;
+	if(buffer_.tell() < buffer_.length())
+		buffer_ > c;
 	if(c){
-		str = &buffer_();
-		while(buffer_())
-			++buffer_;
-		++buffer_;
+		const char* begin = &buffer_();
+		unsigned int left = buffer_.length() - buffer_.tell();
+		const char* end = (const char*)memchr(begin, 0, left);
+		if(end){
+			str.assign(begin, end - begin);
+			buffer_.offset += end - begin + 1;
+		}
+		else{
+			str.assign(begin, left);
+			buffer_.offset = buffer_.length();
+		}
 		return true;
 	}
 	else{
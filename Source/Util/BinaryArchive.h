@@ -53,12 +53,14 @@ inline unsigned int stringHash(const char *str)
 class BinaryOArchive 
 {
 public:
-	BinaryOArchive(const char* fname, int version = 0);
+	BinaryOArchive(const char* fname = 0, int version = 0); // fname == 0 -   , . buffer()
 	~BinaryOArchive();
 
 	void open(const char* fname, int version = 0); 
 	bool close();  // true if there were changes, so file was updated
 
+	const XBuffer& buffer() const { return buffer_; }
+
 	int type() const {
 		return ARCHIVE_BINARY;
 	}
@@ -259,9 +261,12 @@ public:
 	BinaryIArchive(const char* fname = 0);
 	~BinaryIArchive();
 
-	bool open(const char* fname);  // true if file exists
+	bool open(const char* fname);  // true if file exists;    ,   
+	bool open(const char* data, int size); //   (, BinaryOArchive::buffer())
 	void close();
 
+	int version() const { return version_; }
+
 	int type() const {
 		return ARCHIVE_BINARY;
 	}
@@ -316,6 +321,10 @@ private:
 	string fileName_;
 	XBuffer buffer_;
 	int version_;
+	HANDLE file_;
+	HANDLE mapping_; //buffer_    
+
+	bool openHeader();
 
 	/////////////////////////////////////
 	bool loadString(string& value); // false if zero string should be loaded
@@ -73,6 +73,7 @@ struct ConditionCreateObject : Condition // 
 
 	bool check(AIPlayer& aiPlayer) { return created_ >= counter; }
 	void checkEvent(AIPlayer& aiPlayer, const Event& event);
+	bool subscribe(ConditionSubscription& subscription) const;
 
 	template<class Archive>	
 	void serialize(Archive& ar) {
@@ -102,6 +103,7 @@ struct ConditionKillObject : Condition // 
 
 	bool check(AIPlayer& aiPlayer) { return killed_ >= counter; }
 	void checkEvent(AIPlayer& aiPlayer, const Event& event);
+	bool subscribe(ConditionSubscription& subscription) const;
 
 	template<class Archive>	
 	void serialize(Archive& ar){
@@ -131,6 +133,7 @@ struct ConditionObjectExists : Condition // 
 	}
 
 	bool check(AIPlayer& aiPlayer);
+	bool subscribe(ConditionSubscription& subscription) const;
 
 	template<class Archive>	
 	void serialize(Archive& ar) {
@@ -279,6 +282,7 @@ struct ConditionNumberOfBuildingByCoresCapacity : Condition // 
 	}
 
 	bool check(AIPlayer& aiPlayer);
+	bool subscribe(ConditionSubscription& subscription) const;
 
 	template<class Archive>	
 	void serialize(Archive& ar) {
@@ -490,6 +494,7 @@ struct ConditionPlayerState : Condition // 
 
 	bool check(AIPlayer& aiPlayer) { return active_; }
 	void checkEvent(AIPlayer& aiPlayer, const Event& event);
+	bool subscribe(ConditionSubscription& subscription) const;
 
 	template<class Archive>	
 	void serialize(Archive& ar) {
@@ -624,6 +629,7 @@ struct ConditionClickOnButton : Condition // 
 
 	bool check(AIPlayer& aiPlayer) { return counter_ >= counter; }
 	void checkEvent(AIPlayer& aiPlayer, const Event& event);
+	bool subscribe(ConditionSubscription& subscription) const;
 
 	template<class Archive>	
 	void serialize(Archive& ar) {
@@ -17,74 +17,162 @@ struct GridRectangle
 	friend XStream& operator<= (XStream& s,const GridRectangle& r){ s <= r.x0 < " " <= r.y0 < " " <= r.x1 < " " <= r.y1 < " ";  return s; }
 };
 
-//    ,   
+//    ,   .
+//         ,
+//        .
 class GridElementType
 {
-	mutable int PassCounter;
-	mutable int insert_counter;
-	mutable GridRectangle rectangle;
-	friend class GridPassDispatcher;
+	mutable int grid_slot;
+	friend class GridElementAccess;
 public:
-	GridElementType() : PassCounter(0), insert_counter(0) {}
-	int belongSquare(int x0, int y0, int sx, int sy) const { return 1; } // pseudo-virtual due to template using
-	const GridRectangle& getRectangle() const { return rectangle; }
-	int inserted() const { return insert_counter; }
-	void incrInsertion() const { ++insert_counter; }
-	void decrInsertion() const { --insert_counter; }
+	GridElementType() : grid_slot(-1) {}
+	int inserted() const { return grid_slot >= 0; }
 };
 
-//     
-//   
-class GridPassDispatcher
+class GridElementAccess
+{
+protected:
+	static int slot(const GridElementType& el) { return el.grid_slot; }
+	static void setSlot(const GridElementType& el, int slot) { el.grid_slot = slot; }
+};
+
+//    : ,   ,
+//   ,     
+struct GridRecord
+{
+	GridRectangle cells; //  
+	int x, y, side; //    Insert/Move
+	int mask; //   (  - collisionGroup)
+};
+
+//     (ScanBatch)
+struct GridQuery
+{
+	int x0, y0, x1, y1;
+	int mask;
+	int index; //   op   
+
+	GridQuery(){}
+	GridQuery(int xc, int yc, int side, int mask_, int index_) : x0(xc - side), y0(yc - side), x1(xc + side), y1(yc + side), mask(mask_), index(index_) {}
+};
+
+//         
+// (, , ).    , 
+//  ,   ,     .
+class GridPassSet
 {
-	mutable int PassCounter;
 public:
-	GridPassDispatcher(){ PassCounter = 0; }
-	void beginPass() const { PassCounter++; }
-	int doPass(const GridElementType& el) const 
-	{ 
-		int log = el.PassCounter != PassCounter;
-		el.PassCounter = PassCounter; 
-		return log; 
-	}
-	static void setRectangle(const GridElementType& el, const GridRectangle& rect) { el.rectangle = rect; }
+	GridPassSet() : table_(local_), capacity_(LOCAL_SIZE), size_(0) { memset(local_, -1, sizeof(local_)); }
+	~GridPassSet() { if(table_ != local_) delete[] table_; }
+
+	// 1 -   
+	int pass(int slot)
+	{
+		int mask = capacity_ - 1;
+		for(int i = hash(slot) & mask;;i = (i + 1) & mask){
+			if(table_[i] == slot)
+				return 0;
+			if(table_[i] < 0){
+				table_[i] = slot;
+				if(++size_*2 > capacity_)
+					grow();
+				return 1;
+			}
+		}
+	}
+
+private:
+	enum { LOCAL_SIZE = 64 }; //  
+	int local_[LOCAL_SIZE];
+	int* table_;
+	int capacity_;
+	int size_;
+
+	static int hash(int slot) { return (unsigned int)slot*2654435761u >> 8; }
+
+	void grow()
+	{
+		int* old = table_;
+		int old_capacity = capacity_;
+		capacity_ *= 2;
+		table_ = new int[capacity_];
+		memset(table_, -1, capacity_*sizeof(int));
+		int mask = capacity_ - 1;
+		for(int j = 0;j < old_capacity;j++)
+			if(old[j] >= 0){
+				int i = hash(old[j]) & mask;
+				while(table_[i] >= 0)
+					i = (i + 1) & mask;
+				table_[i] = old[j];
+			}
+		if(old != local_)
+			delete[] old;
+	}
 };
 
 //       
-//  ,    
+//  ,    .
+//   -    (T -    )
 template<class T, int reserve_size = 0>
-class GridVector : public vector<T*>
+class GridVector : public vector<int>
 {
 public:
 	GridVector() { if(reserve_size) reserve(reserve_size); }
-	void insert(T* obj) { push_back(obj); obj->incrInsertion(); }
-	void remove(T* obj) 
+	void insert(int slot) { push_back(slot); }
+	void remove(int slot) 
 	{  //      ,
 		// ..      .
 		xassert(!empty()); //   
 		for(iterator i = end() - 1; i >= begin(); --i)
-			if(*i == obj)
+			if(*i == slot)
 			{ 
 				erase(i); 
-				obj->decrInsertion();
 				return;
 			} 
+		xassert(0 && "Grid: element not found in cell");
 	}
 };
 
 //      
 template<class T>
-class GridSingleList : public slist<T*>
+class GridSingleList : public slist<int>
 {
 public:
-	void insert(T* obj) { push_front(obj); obj->incrInsertion(); }
-	void remove(T* obj) { obj->decrInsertion(); slist<T*>::remove(obj); }
+	void insert(int slot) { push_front(slot); }
+	void remove(int slot) { slist<int>::remove(slot); }
+};
+
+//    GridRecord
+struct GridNoFilter
+{
+	int operator()(const GridRecord& r) const { return 1; }
+};
+
+struct GridMaskFilter
+{
+	int mask;
+	GridMaskFilter(int mask_) : mask(mask_) {}
+	int operator()(const GridRecord& r) const { return r.mask & mask; }
 };
 
+//    radius (+1     Insert/Move)
+struct GridCircleFilter
+{
+	float x, y, radius2;
+	int mask;
+	GridCircleFilter(const Vect2f& center, float radius, int mask_) : x(center.x), y(center.y), radius2(sqr(radius + 1)), mask(mask_) {}
+	int operator()(const GridRecord& r) const { return (r.mask & mask) && sqr(r.x - x) + sqr(r.y - y) <= radius2; }
+};
 
-//	
+
+//	.
+//	    ,  :  , 
+//	  ,     ( 
+//	      ),  
+//	 -  GridPassSet  .    , 
+//	   .
 template <class T, int cell_size_len, class CellList >	
-class Grid2D : GridPassDispatcher
+class Grid2D : GridElementAccess
 {
 public:	
 
@@ -113,52 +201,59 @@ public:
 			cell_table[i] = new CellList[size_x];
 	}
 
-	void Insert(T& obj, int xc, int yc, int side)
+	// mask -   ScanMask/ScanCircle/ScanBatch
+	void Insert(T& obj, int xc, int yc, int side, int mask = -1)
 	{
 		xassert(!obj.inserted() && "Grid: multiple Insert");
-		GridRectangle rect(xc - side, yc - side, xc + side, yc + side);
-		prepRectangle(rect);
-		setRectangle(obj, rect);
-		for(int y = rect.y0;y <= rect.y1;y++)
-			for(int x = rect.x0;x <= rect.x1;x++)
-				if(obj.belongSquare(x*cell_size, y*cell_size, cell_size, cell_size))
-					table(x, y).insert(&obj);
+		int slot;
+		if(!free_slots.empty()){
+			slot = free_slots.back();
+			free_slots.pop_back();
+		}
+		else{
+			slot = records.size();
+			records.push_back(GridRecord());
+			objects.push_back(0);
+		}
+		setSlot(obj, slot);
+		objects[slot] = &obj;
+
+		GridRecord& record = records[slot];
+		setRecord(record, xc, yc, side, mask);
+		insertCells(slot, record.cells);
 	}
 
-	void Move(T& obj, int xc, int yc, int side)
+	void Move(T& obj, int xc, int yc, int side, int mask = -1)
 	{
 		xassert(obj.inserted() && "Grid: Move without Insert");
 
-		GridRectangle rect(xc - side, yc - side, xc + side, yc + side);
-		prepRectangle(rect);
-		const GridRectangle& prev_rect = obj.getRectangle();
-		if(prev_rect == rect)
+		int slot = this->slot(obj);
+		GridRecord& record = records[slot];
+		GridRectangle prev_rect = record.cells;
+		setRecord(record, xc, yc, side, mask);
+		if(prev_rect == record.cells)
 			return;
 
-		for(int y = prev_rect.y0;y <= prev_rect.y1;y++)
-			for(int x = prev_rect.x0;x <= prev_rect.x1;x++)
-				table(x, y).remove(&obj);
-
-		xassert(!obj.inserted() && "Grid: incomplete remove in Move");
-
-		setRectangle(obj, rect);
-		for(int y = rect.y0;y <= rect.y1;y++)
-			for(int x = rect.x0;x <= rect.x1;x++)
-				if(obj.belongSquare(x*cell_size, y*cell_size, cell_size, cell_size))
-					table(x, y).insert(&obj);
+		removeCells(slot, prev_rect);
+		insertCells(slot, record.cells);
 	}
 
 	void Remove(T& obj)
 	{
 		xassert(obj.inserted() && "Grid: Remove without Insert");
 		
-		const GridRectangle& rect = obj.getRectangle();
-		for(int y = rect.y0;y <= rect.y1;y++)
-			for(int x = rect.x0;x <= rect.x1;x++)
-				if(obj.belongSquare(x * cell_size, y * cell_size, cell_size, cell_size))
-					table(x, y).remove(&obj);
+		int slot = this->slot(obj);
+		removeCells(slot, records[slot].cells);
+		objects[slot] = 0;
+		free_slots.push_back(slot);
+		setSlot(obj, -1);
+	}
 
-		xassert(!obj.inserted() && "Grid: incomplete remove in Remove");
+	//    
+	void SetMask(T& obj, int mask)
+	{
+		xassert(obj.inserted() && "Grid: SetMask without Insert");
+		records[slot(obj)].mask = mask;
 	}
 
 	void Clear()
@@ -167,13 +262,14 @@ public:
 			for(int x = 0;x < size_x;x++){
 				cell_table[y][x].clear();
 			}
+		clearRecords();
 	}
 
 	int size() const // for Debug purpose mostly
 	{
 		int sz = 0;
-		for(int y = 0;y < sy;y++)
-			for(int x = 0;x < sx;x++)
+		for(int y = 0;y < size_y;y++)
+			for(int x = 0;x < size_x;x++)
 				sz += cell_table[y][x].size();
 		return sz;
 	}
@@ -190,17 +286,66 @@ public:
 	template <class Op>
 	void Scan(int x0, int y0, int x1, int y1, Op& op) const
 	{
-		beginPass();
 		GridRectangle rect(x0, y0, x1, y1);
 		prepRectangle(rect);
-		for(int y = rect.y0;y <= rect.y1;y++)
-			for(int x = rect.x0;x <= rect.x1;x++){
-				CellList& root = table(x, y);
-				CellList::iterator i;
-				FOR_EACH(root, i)
-					if(doPass(**i))
-						op(*i);
-			}
+		scanRectangle(rect, GridNoFilter(), op);
+	}
+
+	//  Scan,       mask    
+	template <class Op>
+	void ScanMask(int xc, int yc, int side, int mask, Op& op) const { ScanMask(xc - side, yc - side, xc + side, yc + side, mask, op); }
+
+	template <class Op>
+	void ScanMask(int x0, int y0, int x1, int y1, int mask, Op& op) const
+	{
+		GridRectangle rect(x0, y0, x1, y1);
+		prepRectangle(rect);
+		scanRectangle(rect, GridMaskFilter(mask), op);
+	}
+
+	//   ,   Scan(center.x, center.y, radius) (  ),
+	//   ,    radius  center.
+	//  op,        .
+	template <class Op>
+	void ScanCircle(const Vect2f& center, float radius, int mask, Op& op) const
+	{
+		int xc = (int)center.x;
+		int yc = (int)center.y;
+		int side = (int)radius;
+		GridRectangle rect(xc - side, yc - side, xc + side, yc + side);
+		prepRectangle(rect);
+		scanRectangle(rect, GridCircleFilter(center, radius, mask), op);
+	}
+
+	//    ScanBatch:        
+	void SortQueries(GridQuery* queries, int count) const
+	{
+		sort(queries, queries + count, QueryOrder());
+	}
+
+	//   ScanMask: op(query.index, element).
+	//     ,   Scan.
+	template <class Op>
+	void ScanBatch(const GridQuery* queries, int count, Op& op) const
+	{
+		for(int i = 0;i < count;i++){
+			const GridQuery& query = queries[i];
+			GridRectangle rect(query.x0, query.y0, query.x1, query.y1);
+			prepRectangle(rect);
+			GridMaskFilter filter(query.mask);
+			for(int y = rect.y0;y <= rect.y1;y++)
+				for(int x = rect.x0;x <= rect.x1;x++){
+					CellList& root = table(x, y);
+					CellList::iterator ci;
+					FOR_EACH(root, ci){
+						const GridRecord& r = records[*ci];
+						if(firstCell(r, rect, x, y) && filter(r)){
+							T* object = objects[*ci];
+							op(query.index, object);
+						}
+					}
+				}
+		}
 	}
 
 	template <class Op>
@@ -209,7 +354,6 @@ public:
 	template <class Op>
 	int ConditionScan(int x0, int y0, int x1, int y1, Op& op) const
 	{
-		beginPass();
 		GridRectangle rect(x0, y0, x1, y1);
 		prepRectangle(rect);
 		for(int y = rect.y0;y <= rect.y1;y++)
@@ -217,9 +361,11 @@ public:
 				CellList& root = table(x, y);
 				CellList::iterator i;
 				FOR_EACH(root, i)
-					if(doPass(**i))
-						if(!(op(*i)))
+					if(firstCell(records[*i], rect, x, y)){
+						T* object = objects[*i];
+						if(!(op(object)))
 							return 0;
+					}
 				}
 		return 1;
 	}
@@ -231,9 +377,10 @@ public:
 		{
 			CellList& root = table(x, y);
 			CellList::iterator i;
-			FOR_EACH(root, i)
-				if(doPass(**i))
-					op(*i);
+			FOR_EACH(root, i){
+				T* object = objects[*i];
+				op(object);
+			}
 		}
 	}
 
@@ -244,10 +391,11 @@ public:
 		{
 			CellList& root = table(x, y);
 			CellList::iterator i;
-			FOR_EACH(root, i)
-				if(doPass(**i))
-					if(!(op(*i)))
-						return 0;
+			FOR_EACH(root, i){
+				T* object = objects[*i];
+				if(!(op(object)))
+					return 0;
+			}
 		}
 		return 1;
 	}
@@ -262,14 +410,14 @@ public:
 		int step,max_step;
 		const int PRECISION = 16;
 
-		beginPass();
+		GridPassSet pass;
 		GridRectangle rect(x0, y0, x1, y1);
 		prepRectangle(rect);
 		dx = rect.x1 - rect.x0;
 		dy = rect.y1 - rect.y0;
 
 		if(!dx && !dy)
-			Cell(rect.x0,rect.y0,op);
+			cellPass(rect.x0,rect.y0, pass, op);
 		else{
 			if(abs(dx) > abs(dy)){
 				if(dx > 0){
@@ -289,10 +437,10 @@ public:
 				while(step > 0){
 					tx = x >> PRECISION;
 					ty = y >> PRECISION;
-					Cell(tx,ty,op);
+					cellPass(tx,ty, pass, op);
 					for(i = 1;i <= width;i++){
-						Cell(tx,ty + i,op);
-						Cell(tx,ty - i,op);
+						cellPass(tx,ty + i, pass, op);
+						cellPass(tx,ty - i, pass, op);
 					}
 
 					x += dx;
@@ -318,10 +466,10 @@ public:
 					tx = x >> PRECISION;
 					ty = y >> PRECISION;
 
-					Cell(tx,ty,op);
+					cellPass(tx,ty, pass, op);
 					for(i = 1;i <= width;i++){
-						Cell(tx + i,ty,op);
-						Cell(tx - i,ty,op);
+						cellPass(tx + i,ty, pass, op);
+						cellPass(tx - i,ty, pass, op);
 					}
 
 					x += dx;
@@ -342,14 +490,14 @@ public:
 		int step,max_step;
 		const int PRECISION = 16;
 
-		beginPass();
+		GridPassSet pass;
 		GridRectangle rect(x0, y0, x1, y1);
 		prepRectangle(rect);
 		dx = rect.x1 - rect.x0;
 		dy = rect.y1 - rect.y0;
 
 		if(!dx && !dy)
-			return ConditionCell(rect.x0,rect.y0,op);
+			return conditionCellPass(rect.x0,rect.y0, pass, op);
 		else{
 			if(abs(dx) > abs(dy)){
 				if(dx > 0){
@@ -369,12 +517,12 @@ public:
 				while(step > 0){
 					tx = x >> PRECISION;
 					ty = y >> PRECISION;
-					if(!ConditionCell(tx,ty,op))
+					if(!conditionCellPass(tx,ty, pass, op))
 						return 0;
 					for(i = 1;i <= width;i++){
-						if(!ConditionCell(tx,ty + i,op))
+						if(!conditionCellPass(tx,ty + i, pass, op))
 							return 0;
-						if(!ConditionCell(tx,ty - i,op))
+						if(!conditionCellPass(tx,ty - i, pass, op))
 							return 0;
 					}
 
@@ -401,12 +549,12 @@ public:
 					tx = x >> PRECISION;
 					ty = y >> PRECISION;
 
-					if(!ConditionCell(tx,ty,op))
+					if(!conditionCellPass(tx,ty, pass, op))
 						return 0;
 					for(i = 1;i <= width;i++){
-						if(!ConditionCell(tx + i,ty,op))
+						if(!conditionCellPass(tx + i,ty, pass, op))
 							return 0;
-						if(!ConditionCell(tx - i,ty,op))
+						if(!conditionCellPass(tx - i,ty, pass, op))
 							return 0;
 					}
 
@@ -426,7 +574,7 @@ public:
 		#define CCW(i)	(i == 0 ? n - 1 : i - 1)
 		#define CW(i)	(i == n - 1 ? 0 : i + 1)
 
-		beginPass();
+		GridPassSet pass;
 
 		for(int i = 0; i < n; i++){
 			pX[i] >>= cell_size_len;
@@ -475,7 +623,7 @@ public:
 					swap(x1, x2);
 
 				while(x1 <= x2)
-					Cell(x1++, Y, op);
+					cellPass(x1++, Y, pass, op);
 
 				Y++;
 				xl += al;
@@ -490,7 +638,7 @@ public:
 						swap(x1, x2);
 
 					while(x1 <= x2)
-						Cell(x1++, Y, op);
+						cellPass(x1++, Y, pass, op);
 					return;
 				}
 				lfv = ltv;
@@ -513,7 +661,7 @@ public:
 						swap(x1, x2);
 
 					while(x1 <= x2)
-						Cell(x1++, Y, op);
+						cellPass(x1++, Y, pass, op);
 					return;
 				}
 				rfv = rtv;
@@ -541,7 +689,7 @@ public:
 		#define CCW(i)	(i == 0 ? n - 1 : i - 1)
 		#define CW(i)	(i == n - 1 ? 0 : i + 1)
 
-		beginPass();
+		GridPassSet pass;
 
 		for(int i = 0; i < n; i++){
 			pX[i] >>= cell_size_len;
@@ -590,7 +738,7 @@ public:
 					swap(x1, x2);
 
 				while(x1 <= x2)
-					if(!ConditionCell(x1++, Y, op))
+					if(!conditionCellPass(x1++, Y, pass, op))
 						return 0;
 
 				Y++;
@@ -606,7 +754,7 @@ public:
 						swap(x1, x2);
 
 					while(x1 <= x2)
-						if(!ConditionCell(x1++, Y, op))
+						if(!conditionCellPass(x1++, Y, pass, op))
 							return 0;
 					return 1;
 				}
@@ -630,7 +778,7 @@ public:
 						swap(x1, x2);
 
 					while(x1 <= x2)
-						if(!ConditionCell(x1++, Y, op))
+						if(!conditionCellPass(x1++, Y, pass, op))
 							return 0;
 					return 1;
 				}
@@ -659,6 +807,7 @@ public:
 		const int Dx[4] = { 0,1, 0,-1};
 		const int Dy[4] = {-1,0, 1, 0};
 		int i,n,d,tx,ty;
+		GridPassSet pass;
 		
 		x >>= cell_size_len;
 		y >>= cell_size_len;
@@ -670,7 +819,7 @@ public:
 		ty = y;
 		while(d <= r){
 			for(i = 0;i < d;i++){
-				Cell(tx,ty,op);
+				cellPass(tx,ty, pass, op);
 				tx += Dx[n];
 				ty += Dy[n];
 			}
@@ -678,7 +827,7 @@ public:
 			n &= 3;
 
 			for(i = 0;i < d;i++){
-				Cell(tx,ty,op);
+				cellPass(tx,ty, pass, op);
 				tx += Dx[n];
 				ty += Dy[n];
 			}
@@ -695,6 +844,7 @@ public:
 		const int Dx[4] = { 0,1, 0,-1};
 		const int Dy[4] = {-1,0, 1, 0};
 		int i,n,d,tx,ty;
+		GridPassSet pass;
 		
 		x >>= cell_size_len;
 		y >>= cell_size_len;
@@ -706,7 +856,7 @@ public:
 		ty = y;
 		while(d <= r){
 			for(i = 0;i < d;i++){
-				if(!ConditionCell(tx,ty,op))
+				if(!conditionCellPass(tx,ty, pass, op))
 					return 0;
 				tx += Dx[n];
 				ty += Dy[n];
@@ -715,7 +865,7 @@ public:
 			n &= 3;
 
 			for(i = 0;i < d;i++){
-				if(!ConditionCell(tx,ty,op))
+				if(!conditionCellPass(tx,ty, pass, op))
 					return 0;
 				tx += Dx[n];
 				ty += Dy[n];
@@ -739,6 +889,26 @@ private:
 	int size_x, size_y;
 //	int m_mask_x, m_mask_y;
 
+	//     (GridElementType::grid_slot),  - ,
+	//       
+	vector<GridRecord> records;
+	vector<T*> objects;
+	vector<int> free_slots;
+
+	struct QueryOrder
+	{
+		bool operator()(const GridQuery& q0, const GridQuery& q1) const
+		{
+			int y0 = q0.y0 >> cell_size_len, y1 = q1.y0 >> cell_size_len;
+			if(y0 != y1)
+				return y0 < y1;
+			int x0 = q0.x0 >> cell_size_len, x1 = q1.x0 >> cell_size_len;
+			if(x0 != x1)
+				return x0 < x1;
+			return q0.index < q1.index;
+		}
+	};
+
 	//  Clamped-:
 	//       ,
 	//      .
@@ -766,13 +936,107 @@ private:
 		rectangle.y1 = clamp_y(rectangle.y1 >> cell_size_len);
 	}
 
+	//  (x, y) -     rect    
+	static int firstCell(const GridRecord& r, const GridRectangle& rect, int x, int y)
+	{
+		return x == max(r.cells.x0, rect.x0) && y == max(r.cells.y0, rect.y0);
+	}
+
+	template <class Filter, class Op>
+	void scanRectangle(const GridRectangle& rect, const Filter& filter, Op& op) const
+	{
+		for(int y = rect.y0;y <= rect.y1;y++)
+			for(int x = rect.x0;x <= rect.x1;x++){
+				CellList& root = table(x, y);
+				CellList::iterator i;
+				FOR_EACH(root, i){
+					const GridRecord& r = records[*i];
+					if(firstCell(r, rect, x, y) && filter(r)){
+						T* object = objects[*i];
+						op(object);
+					}
+				}
+			}
+	}
+
+	template <class Op>
+	void cellPass(int x, int y, GridPassSet& pass, Op& op) const
+	{
+		if(insideMap(x, y))
+		{
+			CellList& root = table(x, y);
+			CellList::iterator i;
+			FOR_EACH(root, i)
+				if(pass.pass(*i)){
+					T* object = objects[*i];
+					op(object);
+				}
+		}
+	}
+
+	template <class Op>
+	int conditionCellPass(int x, int y, GridPassSet& pass, Op& op) const
+	{
+		if(insideMap(x, y))
+		{
+			CellList& root = table(x, y);
+			CellList::iterator i;
+			FOR_EACH(root, i)
+				if(pass.pass(*i)){
+					T* object = objects[*i];
+					if(!(op(object)))
+						return 0;
+				}
+		}
+		return 1;
+	}
+
+	void setRecord(GridRecord& record, int xc, int yc, int side, int mask)
+	{
+		record.x = xc;
+		record.y = yc;
+		record.side = side;
+		record.mask = mask;
+		record.cells = GridRectangle(xc - side, yc - side, xc + side, yc + side);
+		prepRectangle(record.cells);
+	}
+
+	void insertCells(int slot, const GridRectangle& rect)
+	{
+		for(int y = rect.y0;y <= rect.y1;y++)
+			for(int x = rect.x0;x <= rect.x1;x++)
+				table(x, y).insert(slot);
+	}
+
+	void removeCells(int slot, const GridRectangle& rect)
+	{
+		for(int y = rect.y0;y <= rect.y1;y++)
+			for(int x = rect.x0;x <= rect.x1;x++)
+				table(x, y).remove(slot);
+	}
+
+	void clearRecords()
+	{
+		for(int i = 0;i < objects.size();i++)
+			if(objects[i])
+				setSlot(*objects[i], -1);
+		records.clear();
+		objects.clear();
+		free_slots.clear();
+	}
+
+	//         -   
 	void reset()
 	{
+		records.clear();
+		objects.clear();
+		free_slots.clear();
 		if(!cell_table)
 			return;
 		for(int i = 0;i < size_y;i++)
 			delete[] cell_table[i];
 		delete[] cell_table;
+		cell_table = 0;
 	}
 };
 
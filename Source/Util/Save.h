@@ -2549,7 +2549,9 @@ struct SavePlayerManualData
 
 	template<class Archive>	
 	void serialize(Archive& ar) {
-		if(ar.isInput())
+		//     ;   
+		// ,     ,   
+		if(ar.isInput() && !(ar.type() & ARCHIVE_BINARY))
 			ar & WRAP_NAME(triggerChainOld, "strategy");
 		ar & TRANSLATE_NAME(triggerChainNames, "TriggerChainNames", "");
 		ar & WRAP_NAME(triggerChainNamesOld, "triggerChainNames");
@@ -21,6 +21,13 @@ float BackCubicInterpolator3D::interpolate(const Vector3D &v) {
 		depth / CubicInterpolator3D::interpolate(v);
 }
 
+void BackCubicInterpolator3D::interpolateArray(float* dest, const Vector3D* v, int count) {
+	CubicInterpolator3D::interpolateArray(dest, v, count);
+	for (int i = 0; i < count; i++) {
+		dest[i] = depth / dest[i];
+	}
+}
+
 BackCubicInterpolator3D::BackCubicInterpolator3D(const string& paramString) {
 	depth = XMLUtils::floatFromTag(XMLUtils::extractTagFromXML(DEPTH, 0, paramString));
 }
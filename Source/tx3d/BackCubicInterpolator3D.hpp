@@ -25,6 +25,7 @@ namespace tx3d {
 			BackCubicInterpolator3D(float depth = 0.02) : depth(depth) {}
 
 			float interpolate(const Vector3D &v);
+			void interpolateArray(float* dest, const Vector3D* v, int count);
 
 			const string& getType() const {
 				return TYPE_NAME;
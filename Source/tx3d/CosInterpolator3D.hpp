@@ -34,24 +34,6 @@ namespace tx3d {
 			static float getNoise(int x, int y, int z);
 
 			static const string TYPE_NAME;
-
-		protected:
-			//for-performance-purposes
-			int xi;
-			int yi;
-			int zi;
-			float xd;
-			float yd;
-			float zd;
-			float vert1;
-			float vert2;
-			float vert3;
-			float vert4;
-			float vert5;
-			float vert6;
-			float vert7;
-			float vert8;
-			float coss;
 };
 
 }
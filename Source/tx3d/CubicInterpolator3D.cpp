@@ -19,103 +19,112 @@ const string CubicInterpolator3D ::TYPE_NAME = "Cubic";
 const float HALF = 0.5;
 
 float CubicInterpolator3D ::interpolate(const Vector3D &v) {
-	long xi;
-	long yi;
-	long zi;
-	float xd;
-	float yd;
-	float zd;
-
-/*
-	xi = v.x;
-	yi = v.y;
-	zi = v.z;
+	float result;
+	CubicInterpolator3D::interpolateArray(&result, &v, 1);
+	return result;
+}
 
-	xd = v.x - xi;
-	yd = v.y - yi;
-	zd = v.z - zi;
-*/
-	// fast implementation of C code above
-	_asm {
-		mov		esi, v
-		fld		[dword ptr HALF]
-
-		fld		[dword ptr esi]
-		fld		st(0)
-		fsub	st(0), st(2)
-	fistp	[dword ptr xi]	
-	fild	[dword ptr xi]
-		fsubp	st(1), st(0)
-		fstp	[dword ptr xd]
-
-		fld		[dword ptr esi + 4]
-		fld		st(0)
-		fsub	st(0), st(2)
-	fistp	[dword ptr yi]	
-	fild	[dword ptr yi]
-		fsubp	st(1), st(0)
-		fstp	[dword ptr yd]
-
-		fld		[dword ptr esi + 8]
-		fld		st(0)
-		fsub	st(0), st(2)
-	fistp	[dword ptr zi]	
-	fild	[dword ptr zi]
-		fsubp	st(1), st(0)
-		fstp	[dword ptr zd]	
+void CubicInterpolator3D ::interpolateArray(float* dest, const Vector3D* points, int count) {
+	for (int i = 0; i < count; i++) {
+		const Vector3D* v = points + i;
+		long xi;
+		long yi;
+		long zi;
+		float xd;
+		float yd;
+		float zd;
+
+	/*
+		xi = v->x;
+		yi = v->y;
+		zi = v->z;
+
+		xd = v->x - xi;
+		yd = v->y - yi;
+		zd = v->z - zi;
+	*/
+		// fast implementation of C code above
+		_asm {
+			mov		esi, v
+			fld		[dword ptr HALF]
+
+			fld		[dword ptr esi]
+			fld		st(0)
+			fsub	st(0), st(2)
+		fistp	[dword ptr xi]	
+		fild	[dword ptr xi]
+			fsubp	st(1), st(0)
+			fstp	[dword ptr xd]
+
+			fld		[dword ptr esi + 4]
+			fld		st(0)
+			fsub	st(0), st(2)
+		fistp	[dword ptr yi]	
+		fild	[dword ptr yi]
+			fsubp	st(1), st(0)
+			fstp	[dword ptr yd]
+
+			fld		[dword ptr esi + 8]
+			fld		st(0)
+			fsub	st(0), st(2)
+		fistp	[dword ptr zi]	
+		fild	[dword ptr zi]
+			fsubp	st(1), st(0)
+			fstp	[dword ptr zd]	
 	
-		fstp	st(0)
-	};
+			fstp	st(0)
+		};
 
-	xi += yi * 400 + zi * 160000;
+		xi += yi * 400 + zi * 160000;
 
-	xd = xd * xd * (3.0 - 2.0 * xd);
-	yd = yd * yd * (3.0 - 2.0 * yd);
-	zd = zd * zd * (3.0 - 2.0 * zd);
+		xd = xd * xd * (3.0 - 2.0 * xd);
+		yd = yd * yd * (3.0 - 2.0 * yd);
+		zd = zd * zd * (3.0 - 2.0 * zd);
 
-	float xd1 = 1.0 - xd;
-	float yd1 = 1.0 - yd;
-	float zd1 = 1.0 - zd;
+		float xd1 = 1.0 - xd;
+		float yd1 = 1.0 - yd;
+		float zd1 = 1.0 - zd;
 
-	return 
-		Texture3DUtils::lerp(
+		dest[i] =
 			Texture3DUtils::lerp(
-				Texture3DUtils::lerp(getNoise(xi), getNoise(xi + 1), xd1, xd),
-				Texture3DUtils::lerp(getNoise(xi + 400), getNoise(xi + 401), xd1, xd), yd1, yd),
-			Texture3DUtils::lerp(
-				Texture3DUtils::lerp(getNoise(xi + 160000), getNoise(xi + 160001), xd1, xd),
-				Texture3DUtils::lerp(getNoise(xi + 160400), getNoise(xi + 160401), xd1, xd), yd1, yd),
-			zd1, zd
-		);
-/*
-	return 
-		lerp(
+				Texture3DUtils::lerp(
+					Texture3DUtils::lerp(getNoise(xi), getNoise(xi + 1), xd1, xd),
+					Texture3DUtils::lerp(getNoise(xi + 400), getNoise(xi + 401), xd1, xd), yd1, yd),
+				Texture3DUtils::lerp(
+					Texture3DUtils::lerp(getNoise(xi + 160000), getNoise(xi + 160001), xd1, xd),
+					Texture3DUtils::lerp(getNoise(xi + 160400), getNoise(xi + 160401), xd1, xd), yd1, yd),
+				zd1, zd
+			);
+	/*
+		return 
 			lerp(
-				lerp(getNoise(xi), getNoise(xi + 1), xd),
-				lerp(getNoise(xi + 400), getNoise(xi + 401), xd), yd),
-			lerp(
-				lerp(getNoise(xi + 160000), getNoise(xi + 160001), xd),
-				lerp(getNoise(xi + 160400), getNoise(xi + 160401), xd), yd),
-			zd
-		);
-
-
-	return 
-		(
-			(getNoise(xi) * xd1 + getNoise(xi + 1) * xd)
-			* yd1
-			+ (getNoise(xi + 400) * xd1 + getNoise(xi + 401) * xd)
-			* yd
-		)
-		* (1.0 - zd)
-	  + (
-			(getNoise(xi + 160000) * xd1 + getNoise(xi + 160001) * xd)
-			* yd1
-			+ (getNoise(xi + 160400) * xd1 + getNoise(xi + 160401) * xd)
-			* yd
-		)
-		* zd;
-*/
+				lerp(
+					lerp(getNoise(xi), getNoise(xi + 1), xd),
+					lerp(getNoise(xi + 400), getNoise(xi + 401), xd), yd),
+				lerp(
+					lerp(getNoise(xi + 160000), getNoise(xi + 160001), xd),
+					lerp(getNoise(xi + 160400), getNoise(xi + 160401), xd), yd),
+				zd
+			);
+
+
+		return 
+			(
+				(getNoise(xi) * xd1 + getNoise(xi + 1) * xd)
+				* yd1
+				+ (getNoise(xi + 400) * xd1 + getNoise(xi + 401) * xd)
+				* yd
+			)
+			* (1.0 - zd)
+		  + (
+				(getNoise(xi + 160000) * xd1 + getNoise(xi + 160001) * xd)
+				* yd1
+				+ (getNoise(xi + 160400) * xd1 + getNoise(xi + 160401) * xd)
+				* yd
+			)
+			* zd;
+	*/
+	}
 }
 
 /*inline float CubicInterpolator3D ::lerp(float h1, float h2, float shift1, float shift) {
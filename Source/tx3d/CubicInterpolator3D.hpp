@@ -20,6 +20,7 @@ namespace tx3d {
 	class CubicInterpolator3D : public Interpolator3D {
 		public:
 			float interpolate(const Vector3D &v);
+			void interpolateArray(float* dest, const Vector3D* v, int count);
 
 			const string& getType() const {
 				return TYPE_NAME;
@@ -39,6 +39,23 @@ void IndexedTexture3D::setTexture(Texture3D* t) {
 	texture = t;
 }
 
+void IndexedTexture3D::getColorIndexArray(unsigned char* dest, const Vector3D* v, int count, Texture3D* tx) {
+	if (!tx) {
+		tx = texture;
+	}
+	Vector3D clr[BATCH_SIZE];
+	while (count > 0) {
+		int n = count < BATCH_SIZE ? count : BATCH_SIZE;
+		tx->getColorArray(clr, v, n);
+		for (int i = 0; i < n; i++) {
+			dest[i] = getIndex(clr[i]);
+		}
+		dest += n;
+		v += n;
+		count -= n;
+	}
+}
+
 void IndexedTexture3D::fillIndexLattice(Vector3D* colorTable, unsigned char* indexLattice) {
 	Vector3D color;
 	int x, y, z, i;
@@ -42,6 +42,10 @@ namespace tx3d {
 			unsigned char getColorIndex(const Vector3D &v) {
 				Vector3D clr;
 				texture->getColor(&clr, v);
+				return getIndex(clr);
+			}
+
+			unsigned char getIndex(const Vector3D &clr) const {
 				int index =	  Texture3DUtils::floor(clr.x * 31.0) * 2048
 							+ Texture3DUtils::floor(clr.y * 63.0) * 32
 							+ Texture3DUtils::floor(clr.z * 31.0);
@@ -49,6 +53,11 @@ namespace tx3d {
 				return indexLattice[index & 65535];
 			}
 
+			//	Indices for an array of points through getColorArray.
+			//	tx - texture to evaluate (0 - own one); textures keep temporaries
+			//	in members, so every thread passes its own copy of the same texture.
+			void getColorIndexArray(unsigned char* dest, const Vector3D* v, int count, Texture3D* tx = 0);
+
 			unsigned char getHSBColorIndex(const Vector3D &v) {
 				Vector3D clr;
 				texture->getColor(&clr, v);
@@ -24,6 +24,12 @@ namespace tx3d {
 		public:
 			virtual ~Interpolator3D() {}
 			virtual float interpolate(const Vector3D &v) = 0;
+			//	Values for an array of points, one virtual call per array.
+			virtual void interpolateArray(float* dest, const Vector3D* v, int count) {
+				for (int i = 0; i < count; i++) {
+					dest[i] = interpolate(v[i]);
+				}
+			}
 	};
 
 }
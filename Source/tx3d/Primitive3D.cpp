@@ -88,6 +88,27 @@ Primitive3D::~Primitive3D() {
 }
 
 
+void Primitive3D::getColorArray(Vector3D* destClr, const Vector3D* v, int count) {
+	Vector3D shifted[BATCH_SIZE];
+	float noise[BATCH_SIZE];
+	while (count > 0) {
+		int n = count < BATCH_SIZE ? count : BATCH_SIZE;
+		int i;
+		for (i = 0; i < n; i++) {
+			shifted[i] = v[i];
+			shifted[i] &= scale;
+			shifted[i] += shift;
+		}
+		turbulator->turbulate3DArray(noise, shifted, n, persistence, octaveCount, interpolator);
+		for (i = 0; i < n; i++) {
+			colorizer->computeColor(destClr + i, shifted[i], noise[i]);
+		}
+		destClr += n;
+		v += n;
+		count -= n;
+	}
+}
+
 void Primitive3D::setColorizer(Colorizer3D *c) {
 	if (colorizer) {
 		colorizer->released();
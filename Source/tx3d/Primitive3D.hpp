@@ -51,6 +51,9 @@ namespace tx3d {
 																  interpolator )  );
 			}
 
+			//	Shifts the whole array, then one turbulate3DArray for it.
+			void getColorArray(Vector3D* destClr, const Vector3D* v, int count);
+
 			void getColor(Vector3D* destClr, const Vector3D &v, float gPersistence, int gOctaveCount) {
 				shiftedV = v;
 				shiftedV &= scale;
@@ -16,9 +16,10 @@ using namespace tx3d;
 auto_ptr<SimpleTurbulator3D> SimpleTurbulator3D::sharedInstance;
 
 float SimpleTurbulator3D::turbulate3D(const Vector3D &v, float persistence, int octaveCount, Interpolator3D *interpolator) {
+	//	freqV is local: the instance is shared by all primitives and threads
 	float sum = 0.0;
 	float ampl = 1.0;
-	freqV = v;
+	Vector3D freqV = v;
 	for (int i = 0; i < octaveCount; i++) {
 		sum += interpolator->interpolate(freqV) * ampl;
 		freqV *= 2.0;
@@ -27,3 +28,28 @@ float SimpleTurbulator3D::turbulate3D(const Vector3D &v, float persistence, int
 	return sum;
 }
 
+void SimpleTurbulator3D::turbulate3DArray(float* dest, const Vector3D* v, int count, float persistence, int octaveCount, Interpolator3D *interpolator) {
+	Vector3D freqV[BATCH_SIZE];
+	float values[BATCH_SIZE];
+	while (count > 0) {
+		int n = count < BATCH_SIZE ? count : BATCH_SIZE;
+		int k;
+		for (k = 0; k < n; k++) {
+			freqV[k] = v[k];
+			dest[k] = 0.0;
+		}
+		float ampl = 1.0;
+		for (int i = 0; i < octaveCount; i++) {
+			interpolator->interpolateArray(values, freqV, n);
+			for (k = 0; k < n; k++) {
+				dest[k] += values[k] * ampl;
+				freqV[k] *= 2.0;
+			}
+			ampl *= persistence;
+		}
+		dest += n;
+		v += n;
+		count -= n;
+	}
+}
+
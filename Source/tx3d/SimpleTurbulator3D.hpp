@@ -21,6 +21,8 @@ namespace tx3d {
 		public :
 
 			float turbulate3D(const Vector3D &v, float persistence, int octaveCount, Interpolator3D *interpolator);
+			//	Octave by octave for the whole array: one interpolateArray per octave.
+			void turbulate3DArray(float* dest, const Vector3D* v, int count, float persistence, int octaveCount, Interpolator3D *interpolator);
 
 			static SimpleTurbulator3D* getSharedSimpleTurbulator3D() {
 				if (!sharedInstance.get()) {
@@ -31,7 +33,6 @@ namespace tx3d {
 
 		protected:
 			static std::auto_ptr<SimpleTurbulator3D> sharedInstance;
-			Vector3D freqV;
 	};
 
 }
@@ -71,6 +71,8 @@ float SphericSimplexInterpolator3D::interpolate(const Vector3D &v) {
 	float reminderY = v.y + skewLength;
 	float reminderZ = v.z + skewLength;
 */
+	//	local: the factory shares one instance between textures and threads
+	char simplex[3];
 	simplex[0] = 0;
 	simplex[1] = 0;
 	simplex[2] = 0;
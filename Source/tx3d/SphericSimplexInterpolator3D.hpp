@@ -42,10 +42,6 @@ namespace tx3d {
 
 			inline int getBitPattern(int x, int y, int z, char bitNumber);
 
-			//for-performance-purposes
-
-			char simplex[3];
-
 			int bitPatterns[8];
 	};
 
@@ -22,6 +22,13 @@ namespace tx3d {
 		public :
 			virtual ~Turbulator3D() {} 
 			virtual float turbulate3D(const Vector3D &v, float persistence, int octaveCount, Interpolator3D *interpolator) = 0;
+			//	Sums for an array of points. Default keeps per-point semantics
+			//	(CachingTurbulator3D relies on the order of calls).
+			virtual void turbulate3DArray(float* dest, const Vector3D* v, int count, float persistence, int octaveCount, Interpolator3D *interpolator) {
+				for (int i = 0; i < count; i++) {
+					dest[i] = turbulate3D(v[i], persistence, octaveCount, interpolator);
+				}
+			}
 	};
 
 }
@@ -105,6 +105,10 @@ namespace tx3d {
 			float z;
 	};
 
+	//	Points per step of the array methods (getColorArray, turbulate3DArray),
+	//	their temporary arrays live on the stack.
+	const int BATCH_SIZE = 256;
+
 }
 
 #endif
\ No newline at end of file
@@ -1 +1 @@
-"2.00"
+"2.02"